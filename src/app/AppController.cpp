@@ -5,10 +5,11 @@
 #include "console/ConsoleFlow.h"
 #include "GraphicsFlow.h"
 
-AppController::AppController(const std::vector<RtAudio::Api> &apis, bool enableDevTools)
+AppController::AppController(const std::vector<RtAudio::Api> &apis, bool enableDevTools, StartupOptions startup)
     : audio_({22050, 32000, 44100, 48000, 88200, 96000}, {64, 128, 256, 512, 1024, 2048}),
       apis_(apis),
-      enableDevTools_(enableDevTools)
+      enableDevTools_(enableDevTools),
+      startup_(startup)
 {
 }
 
@@ -23,6 +24,6 @@ int AppController::run(std::atomic<bool> &quitFlag)
         return console.run(quitFlag);
     }
 
-    GraphicsFlow graphics(gfx_, audio_, configStore_, noteConverter_, ui_, apis_, enableDevTools_);
+    GraphicsFlow graphics(gfx_, audio_, configStore_, noteConverter_, ui_, apis_, enableDevTools_, startup_);
     return graphics.run(quitFlag);
 }
@@ -9,11 +9,12 @@
 #include "NoteConverter.h"
 #include "AnimatedUI.h"
 #include "ConfigStore.h"
+#include "StartupOptions.h"
 
 class AppController
 {
 public:
-    AppController(const std::vector<RtAudio::Api> &apis, bool enableDevTools);
+    AppController(const std::vector<RtAudio::Api> &apis, bool enableDevTools, StartupOptions startup = {});
     int run(std::atomic<bool> &quitFlag);
 
 private:
@@ -24,4 +25,5 @@ private:
     AnimatedUI ui_{};
     std::vector<RtAudio::Api> apis_;
     bool enableDevTools_ = false;
+    StartupOptions startup_{};
 };
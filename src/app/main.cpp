@@ -1,6 +1,7 @@
 #include <iostream>
 #include <csignal>
 #include <atomic>
+#include <chrono>
 #include <vector>
 #include <string_view>
 
@@ -35,6 +36,9 @@ void signalHandler(int signal)
 
 int main(int argc, char **argv)
 {
+    StartupOptions startup{};
+    startup.launchTime = std::chrono::steady_clock::now();
+
     std::cout << "OpenChordix" << std::endl;
     std::cout << "RtAudio Version: " << RtAudio::getVersion() << std::endl;
 
@@ -48,6 +52,14 @@ int main(int argc, char **argv)
         {
             enableDevTools = true;
         }
+        else if (arg == "--startup-benchmark")
+        {
+            startup.benchmark = true;
+        }
+        else if (arg == "--full-probe")
+        {
+            startup.fastAudioRestore = false;
+        }
     }
 
     std::vector<RtAudio::Api> apis = AudioManager::getAvailableApis();
@@ -57,7 +69,7 @@ int main(int argc, char **argv)
         return 1;
     }
 
-    AppController app(apis, enableDevTools);
+    AppController app(apis, enableDevTools, startup);
     return app.run(g_quit_flag);
 }
 
@@ -41,7 +41,10 @@ void AudioSetupScene::drawInputDeviceList()
     DeviceSelector::list("input_device_list", options, DeviceRole::Input, [&](unsigned int id)
                          {
                              audio_.selectInputDevice(id);
-                             audio_.stopMonitoring(false); }, ImVec2(0, 230));
+                             if (audio_.monitoring())
+                             {
+                                 audio_.reconfigureMonitoring();
+                             } }, ImVec2(0, 230));
 }
 
 void AudioSetupScene::drawOutputDeviceList()
@@ -50,7 +53,10 @@ void AudioSetupScene::drawOutputDeviceList()
     DeviceSelector::list("output_device_list", options, DeviceRole::Output, [&](unsigned int id)
                          {
                              audio_.selectOutputDevice(id);
-                             audio_.stopMonitoring(false); }, ImVec2(0, 230));
+                             if (audio_.monitoring())
+                             {
+                                 audio_.reconfigureMonitoring();
+                             } }, ImVec2(0, 230));
 }
 
 void AudioSetupScene::render(float dt, const FrameInput & /*input*/, GraphicsContext &gfx, std::atomic<bool> & /*quitFlag*/)
@@ -86,7 +92,7 @@ void AudioSetupScene::render(float dt, const FrameInput & /*input*/, GraphicsCon
                     if (audio_.api() != api)
                     {
                         audio_.setApi(api);
-                        audio_.refreshDevices(api);
+                        audio_.refreshDevicesAsync(api);
                     }
                 }
                 if (isSelected)
@@ -117,6 +123,10 @@ void AudioSetupScene::render(float dt, const FrameInput & /*input*/, GraphicsCon
                 if (ImGui::Selectable(label.c_str(), selected))
                 {
                     audio_.setSampleRate(static_cast<unsigned int>(candidate));
+                    if (audio_.monitoring())
+                    {
+                        audio_.reconfigureMonitoring();
+                    }
                 }
                 if (selected)
                 {
@@ -137,6 +147,10 @@ void AudioSetupScene::render(float dt, const FrameInput & /*input*/, GraphicsCon
                 if (ImGui::Selectable(label.c_str(), selected))
                 {
                     audio_.setBufferFrames(static_cast<unsigned int>(candidate));
+                    if (audio_.monitoring())
+                    {
+                        audio_.reconfigureMonitoring();
+                    }
                 }
                 if (selected)
                 {
@@ -150,8 +164,7 @@ void AudioSetupScene::render(float dt, const FrameInput & /*input*/, GraphicsCon
         ImVec2 fullWidth(ImGui::GetContentRegionAvail().x, 0.0f);
         if (ui_.button("Start monitoring", ImVec2(fullWidth.x * 0.65f, 0.0f)))
         {
-            audio_.stopMonitoring(false);
-            audio_.startMonitoring();
+            audio_.reconfigureMonitoring();
         }
         ImGui::SameLine();
         if (ui_.button("Stop", ImVec2(fullWidth.x * 0.33f, 0.0f)))
@@ -232,6 +232,37 @@ void SettingsScene::drawDeviceTab()
     {
         dirty_ = true;
     }
+    if (audioSession_.scanning())
+    {
+        ImGui::TextColored(kMuted, "Scanning audio devices...");
+    }
+    else if (devices_.hotplugNotifications && !audioSession_.deviceChangeNotice().empty())
+    {
+        ImGui::TextColored(kMuted, "%s", audioSession_.deviceChangeNotice().c_str());
+        ImGui::SameLine();
+        if (ImGui::SmallButton("Dismiss"))
+        {
+            audioSession_.clearDeviceChangeNotice();
+        }
+    }
+
+    ImGui::Spacing();
+    ImGui::TextDisabled("Take recorder");
+    ImGui::BeginDisabled(!audioSession_.monitoring());
+    if (audioSession_.recording())
+    {
+        if (ImGui::Button("Stop recording"))
+        {
+            audioSession_.stopRecording();
+        }
+    }
+    else if (ImGui::Button("Record take"))
+    {
+        audioSession_.startRecording();
+    }
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    ImGui::TextColored(kMuted, "%s", audioSession_.recorder().status().c_str());
 
     ImGui::Spacing();
     ImGui::TextDisabled("Controllers");
@@ -299,7 +330,11 @@ void SettingsScene::applyAudio()
 {
     if (audioSettings_.enableInputMonitor)
     {
-        if (!audioSession_.monitoring())
+        if (audioSession_.monitoring())
+        {
+            audioSession_.reconfigureMonitoring();
+        }
+        else
         {
             audioSession_.startMonitoring();
         }
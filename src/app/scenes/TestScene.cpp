@@ -2,18 +2,44 @@
 
 #include <imgui/imgui.h>
 #include <bx/math.h>
+#include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstring>
 #include <filesystem>
 
 #include "TestSceneModelController.h"
+#include "gameplay/HighwayLayout.h"
+#include "render/HighwayRenderer.h"
 #include "render/Model.h"
 #include "render/ModelRenderer.h"
 #include "render/RenderViewIds.h"
+#include "track/ChartFile.h"
 
 namespace
 {
     constexpr float kDegToRad = 0.01745329252f;
+
+    void copyPath(std::array<char, 512> &buffer, const std::string &path)
+    {
+        std::strncpy(buffer.data(), path.c_str(), buffer.size() - 1);
+        buffer[buffer.size() - 1] = '\0';
+    }
+
+    std::array<float, 3> normalizedLightDir(const float (&dir)[3])
+    {
+        float lx = dir[0];
+        float ly = dir[1];
+        float lz = dir[2];
+        float len = std::sqrt(lx * lx + ly * ly + lz * lz);
+        if (len > 1e-4f)
+        {
+            lx /= len;
+            ly /= len;
+            lz /= len;
+        }
+        return {lx, ly, lz};
+    }
 }
 
 TestScene::TestScene(AnimatedUI &ui, TestSceneModelController &modelController)
@@ -24,16 +50,71 @@ TestScene::TestScene(AnimatedUI &ui, TestSceneModelController &modelController)
 {
     if (!data_.assetPath.empty())
     {
-        std::strncpy(modelPath_.data(), data_.assetPath.c_str(), modelPath_.size() - 1);
-        modelPath_[modelPath_.size() - 1] = '\0';
+        copyPath(modelPath_, data_.assetPath);
+    }
+    if (!data_.chartPath.empty())
+    {
+        copyPath(chartPath_, data_.chartPath);
     }
     modelPicker_.setDirectory(std::filesystem::current_path());
     modelPicker_.setExtensions({".gltf", ".glb"});
 }
 
-void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsContext &gfx, std::atomic<bool> & /*quitFlag*/)
+void TestScene::renderHighway(float dt, GraphicsContext &gfx)
+{
+    auto &highway = gfx.highwayRenderer();
+    if (!highway.isInitialized() || !data_.chart)
+    {
+        return;
+    }
+    if (highwayChart_ != data_.chart.get() || highwayPart_ != data_.chartPart)
+    {
+        highway.setChart(data_.chart, data_.chartPart);
+        highwayChart_ = data_.chart.get();
+        highwayPart_ = data_.chartPart;
+    }
+    if (data_.highwayPlaying)
+    {
+        data_.highwaySeconds += dt;
+    }
+
+    HighwaySettings settings;
+    settings.unitsPerSecond = HighwaySettings::unitsPerSecondForSpeed(data_.noteSpeed);
+    const float length = settings.lookAhead * settings.unitsPerSecond;
+
+    // Player's-eye view down the highway from just behind the strike line.
+    float view[16];
+    const bx::Vec3 eye = {0.0f, 2.2f, 3.0f};
+    bx::mtxLookAt(view, eye, bx::Vec3{0.0f, 0.0f, -0.35f * length}, bx::Vec3{0.0f, 1.0f, 0.0f});
+    float proj[16];
+    float aspect = gfx.config().height > 0 ? static_cast<float>(gfx.config().width) / static_cast<float>(gfx.config().height) : 1.0f;
+    bx::mtxProj(proj, 60.0f, aspect, 0.1f, 100.0f, bgfx::getCaps()->homogeneousDepth);
+
+    openchordix::render::ModelFrame frame{};
+    std::memcpy(frame.view.data(), view, sizeof(view));
+    std::memcpy(frame.proj.data(), proj, sizeof(proj));
+    frame.cameraPos = {eye.x, eye.y, eye.z};
+    frame.viewportHeight = static_cast<float>(gfx.config().height);
+    frame.lightDir = normalizedLightDir(data_.lightDir);
+
+    const auto stats = highway.render(openchordix::render::kViewIdScene, data_.highwaySeconds, frame, settings);
+    for (uint32_t count : stats.instances)
+    {
+        highwayInstances_ += count;
+    }
+    highwayDrawCalls_ = stats.drawCalls;
+}
+
+void TestScene::render(float dt, const FrameInput & /*input*/, GraphicsContext &gfx, std::atomic<bool> & /*quitFlag*/)
 {
-    if (data_.model && gfx.modelRenderer().isInitialized())
+    highwayInstances_ = 0;
+    highwayDrawCalls_ = 0;
+    if (data_.showHighway)
+    {
+        renderHighway(dt, gfx);
+    }
+
+    if (!data_.showHighway && data_.model && gfx.modelRenderer().isInitialized())
     {
         const auto &bounds = data_.model->bounds;
         float fitScale = bounds.maxExtent > 0.0f ? 1.8f / bounds.maxExtent : 1.0f;
@@ -78,18 +159,9 @@ void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsConte
         std::memcpy(frame.view.data(), view, sizeof(view));
         std::memcpy(frame.proj.data(), proj, sizeof(proj));
         frame.cameraPos = {eye.x, eye.y, eye.z};
+        frame.viewportHeight = static_cast<float>(gfx.config().height);
         {
-            float lx = data_.lightDir[0];
-            float ly = data_.lightDir[1];
-            float lz = data_.lightDir[2];
-            float len = std::sqrt(lx * lx + ly * ly + lz * lz);
-            if (len > 1e-4f)
-            {
-                lx /= len;
-                ly /= len;
-                lz /= len;
-            }
-            frame.lightDir = {lx, ly, lz};
+            frame.lightDir = normalizedLightDir(data_.lightDir);
             frame.lightColor = {data_.lightColor[0], data_.lightColor[1], data_.lightColor[2]};
             frame.lightIntensity = data_.lightIntensity;
             frame.envTopColor = {data_.envTopColor[0], data_.envTopColor[1], data_.envTopColor[2]};
@@ -110,8 +182,54 @@ void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsConte
         settings.glowColor = {data_.glowColor[0], data_.glowColor[1], data_.glowColor[2]};
         settings.glowIntensity = data_.glowIntensity;
         settings.glowPower = data_.glowPower;
+        settings.lodErrorPixels = data_.lodErrorPixels;
+        settings.frustumCulling = data_.frustumCulling;
 
-        gfx.modelRenderer().renderModel(openchordix::render::kViewIdScene, *data_.model, modelMtx, frame, settings);
+        // Row by row away from the camera; a single copy is the model itself.
+        const std::size_t copyCount = static_cast<std::size_t>(std::max(data_.copies, 1));
+        const std::size_t side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<float>(copyCount))));
+        const float spacing = radius > 0.0f ? radius * 2.2f : 2.0f;
+        copyTransforms_.resize(copyCount);
+        for (std::size_t i = 0; i < copyCount; ++i)
+        {
+            openchordix::render::Matrix4 &copy = copyTransforms_[i];
+            std::memcpy(copy.data(), modelMtx, sizeof(modelMtx));
+            copy[12] += (static_cast<float>(i % side) - 0.5f * static_cast<float>(side - 1)) * spacing;
+            copy[14] -= static_cast<float>(i / side) * spacing;
+        }
+
+        auto &renderer = gfx.modelRenderer();
+        const auto start = std::chrono::steady_clock::now();
+        openchordix::render::ModelRenderStats stats;
+        if (data_.instanced && copyCount > 1)
+        {
+            stats = renderer.renderInstances(openchordix::render::kViewIdScene, *data_.model, copyTransforms_, frame, settings);
+        }
+        else
+        {
+            for (const openchordix::render::Matrix4 &copy : copyTransforms_)
+            {
+                renderer.queueModel(copyQueue_, openchordix::render::kViewIdScene, *data_.model, copy.data(), frame, settings);
+            }
+            stats = renderer.submit(copyQueue_);
+        }
+        modelCpuMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        meshesSubmitted_ = stats.submitted;
+        meshesCulled_ = stats.culled;
+        uniformUpdates_ = stats.uniformUpdates;
+        uniformUpdatesSkipped_ = stats.uniformUpdatesSkipped;
+        textureBinds_ = stats.textureBinds;
+        textureBindsSkipped_ = stats.textureBindsSkipped;
+    }
+    else
+    {
+        meshesSubmitted_ = 0;
+        meshesCulled_ = 0;
+        uniformUpdates_ = 0;
+        uniformUpdatesSkipped_ = 0;
+        textureBinds_ = 0;
+        textureBindsSkipped_ = 0;
+        modelCpuMs_ = 0.0;
     }
 
     ImVec2 screen = ImGui::GetIO().DisplaySize;
@@ -169,15 +287,53 @@ void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsConte
         {
             modelController_.clearModel();
         }
+        if (auto progress = modelController_.loadProgress())
+        {
+            const bool reading = progress->stage == openchordix::render::ModelLoadStage::Reading;
+            ImGui::ProgressBar(reading ? 0.0f : progress->fraction, ImVec2(-1.0f, 0.0f),
+                               reading ? "Reading..." : "Uploading...");
+        }
         if (!data_.assetPath.empty())
         {
             ImGui::TextWrapped("Loaded: %s", data_.assetPath.c_str());
+            ImGui::Text("Meshes: %u drawn, %u culled", meshesSubmitted_, meshesCulled_);
+            ImGui::Text("Uniforms: %u set, %u skipped", uniformUpdates_, uniformUpdatesSkipped_);
+            ImGui::Text("Textures: %u bound, %u skipped", textureBinds_, textureBindsSkipped_);
+            ImGui::Text("CPU: %.3f ms for %zu copies", modelCpuMs_, copyTransforms_.size());
         }
         if (!data_.lastError.empty())
         {
             ImGui::TextColored(ImVec4(1.0f, 0.55f, 0.55f, 1.0f), "%s", data_.lastError.c_str());
         }
 
+        ImGui::Spacing();
+        ImGui::TextUnformatted("Highway");
+        ImGui::Separator();
+        ImGui::Checkbox("Show highway", &data_.showHighway);
+        ImGui::InputText("Chart", chartPath_.data(), chartPath_.size());
+        ImGui::SameLine();
+        if (ImGui::Button("Load chart"))
+        {
+            modelController_.loadChart(chartPath_.data());
+        }
+        if (data_.chart)
+        {
+            const int lastPart = std::max(static_cast<int>(data_.chart->partCount()) - 1, 0);
+            ImGui::SliderInt("Part", &data_.chartPart, 0, lastPart);
+            ImGui::SliderInt("Note speed", &data_.noteSpeed, 1, 10);
+            ImGui::Checkbox("Play", &data_.highwayPlaying);
+            ImGui::SameLine();
+            if (ImGui::Button("Restart"))
+            {
+                data_.highwaySeconds = 0.0;
+            }
+            ImGui::Text("Time: %.2f s", data_.highwaySeconds);
+            if (data_.showHighway)
+            {
+                ImGui::Text("Highway: %u instances in %u draw calls", highwayInstances_, highwayDrawCalls_);
+            }
+        }
+
         ImGui::Spacing();
         ImGui::TextUnformatted("Transform");
         ImGui::Separator();
@@ -186,6 +342,11 @@ void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsConte
         ImGui::SliderFloat3("Rotation", data_.rotation, -180.0f, 180.0f, "%.1f");
         ImGui::SliderFloat3("Position", data_.position, -2.0f, 2.0f, "%.2f");
         ImGui::SliderFloat("Scale", &data_.scale, 0.1f, 4.0f, "%.2f");
+        ImGui::SliderFloat("LOD error (px)", &data_.lodErrorPixels, 0.0f, 16.0f, "%.1f");
+        ImGui::Checkbox("Frustum culling", &data_.frustumCulling);
+        ImGui::SliderInt("Copies", &data_.copies, 1, 1000);
+        ImGui::SameLine();
+        ImGui::Checkbox("Instanced", &data_.instanced);
         if (ImGui::Button("Reset transform"))
         {
             data_.position[0] = 0.0f;
@@ -267,9 +428,7 @@ void TestScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsConte
 
     if (auto chosen = modelPicker_.draw())
     {
-        auto fullPath = chosen->string();
-        std::strncpy(modelPath_.data(), fullPath.c_str(), modelPath_.size() - 1);
-        modelPath_[modelPath_.size() - 1] = '\0';
+        copyPath(modelPath_, chosen->string());
         modelController_.loadModel(gfx.modelRenderer(), modelPath_.data());
     }
 }
@@ -1,14 +1,17 @@
 #pragma once
 
 #include <array>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "AnimatedUI.h"
 #include "Scene.h"
+#include "render/ModelRenderQueue.h"
 #include "ui/FileDialog.h"
 
+class ChartFile;
 class TestSceneModelController;
 namespace openchordix::render
 {
@@ -19,6 +22,7 @@ struct TestSceneData
 {
     std::shared_ptr<openchordix::render::Model> model;
     std::string assetPath;
+    bool fromCache = false;
     std::string lastError;
     float position[3] = {0.0f, 0.0f, 0.0f};
     float rotation[3] = {0.0f, 0.0f, 0.0f};
@@ -44,6 +48,20 @@ struct TestSceneData
     float glowColor[3] = {0.2f, 0.6f, 1.0f};
     float glowIntensity = 1.0f;
     float glowPower = 2.0f;
+    float lodErrorPixels = 1.0f;
+    bool frustumCulling = true;
+    // Copies of the model in a grid going away from the camera, drawn instanced or
+    // queued one model at a time, to compare what each costs the CPU.
+    int copies = 1;
+    bool instanced = true;
+    // Highway preview: replaces the model with the note highway of a chart part.
+    bool showHighway = false;
+    std::shared_ptr<const ChartFile> chart;
+    std::string chartPath;
+    int chartPart = 0;
+    bool highwayPlaying = true;
+    double highwaySeconds = 0.0;
+    int noteSpeed = 5;
 };
 
 class TestScene : public Scene
@@ -55,10 +73,26 @@ public:
     bool finished() const override { return finished_; }
 
 private:
+    void renderHighway(float dt, GraphicsContext &gfx);
+
     AnimatedUI &ui_;
     TestSceneModelController &modelController_;
     TestSceneData &data_;
     std::array<char, 512> modelPath_{};
+    std::array<char, 512> chartPath_{};
     FileDialog modelPicker_;
     bool finished_ = false;
+    uint32_t meshesSubmitted_ = 0; // Last frame's ModelRenderStats
+    uint32_t meshesCulled_ = 0;
+    uint32_t uniformUpdates_ = 0;
+    uint32_t uniformUpdatesSkipped_ = 0;
+    uint32_t textureBinds_ = 0;
+    uint32_t textureBindsSkipped_ = 0;
+    double modelCpuMs_ = 0.0; // Queueing and submitting last frame's copies
+    std::vector<openchordix::render::Matrix4> copyTransforms_;
+    openchordix::render::ModelRenderQueue copyQueue_; // Copies queued one model at a time
+    uint32_t highwayInstances_ = 0; // Last frame's HighwayStats
+    uint32_t highwayDrawCalls_ = 0;
+    const ChartFile *highwayChart_ = nullptr; // What the highway renderer was last given
+    int highwayPart_ = -1;
 };
@@ -1,10 +1,11 @@
 #include "TestSceneModelController.h"
 
+#include <algorithm>
+#include <cstdio>
 #include <filesystem>
 
-#include "gltf/GltfAsset.h"
-#include "render/ModelBuilder.h"
 #include "render/ModelRenderer.h"
+#include "track/ChartFile.h"
 
 TestSceneModelController::~TestSceneModelController()
 {
@@ -13,7 +14,7 @@ TestSceneModelController::~TestSceneModelController()
 
 bool TestSceneModelController::loadModel(openchordix::render::ModelRenderer &renderer, std::string_view path)
 {
-    clearModel();
+    cancelLoad();
     if (!renderer.isInitialized())
     {
         data_.lastError = "Renderer is not initialized.";
@@ -25,36 +26,101 @@ bool TestSceneModelController::loadModel(openchordix::render::ModelRenderer &ren
         modelPath = std::filesystem::current_path() / modelPath;
     }
 
-    auto result = openchordix::assets::loadGltfAsset(modelPath);
-    if (!result.ok())
+    // Cooked copies are kept in the cache directory, so only the first load of a
+    // model pays for the glTF import.
+    openchordix::render::ModelLoadOptions options;
+    options.cacheDir = cacheDir_;
+    options.prepare.packVertices = renderer.supportsPackedVertices();
+    job_ = std::make_unique<openchordix::render::ModelLoadJob>(modelPath, std::move(options));
+    data_.lastError.clear();
+    return true;
+}
+
+void TestSceneModelController::update(openchordix::render::ModelRenderer &renderer)
+{
+    std::erase_if(abandoned_, [](const auto &job)
+                  { return job->idle(); });
+
+    if (!job_ || !job_->update(renderer))
     {
-        data_.lastError = result.error;
-        return false;
+        return;
     }
 
-    openchordix::render::ModelBuilder builder(renderer);
-    openchordix::render::Model model = builder.build(*result.asset);
-    if (model.meshes.empty())
+    if (job_->progress().stage == openchordix::render::ModelLoadStage::Failed)
     {
-        data_.lastError = "Model contains no mesh primitives.";
-        return false;
+        data_.model.reset();
+        data_.assetPath.clear();
+        data_.lastError = job_->error();
     }
+    else
+    {
+        data_.model = std::make_shared<openchordix::render::Model>(job_->take());
+        data_.assetPath = job_->path().string();
+        data_.fromCache = job_->fromCache();
+        data_.lastError.clear();
+    }
+    job_.reset();
+}
 
-    data_.model = std::make_shared<openchordix::render::Model>(std::move(model));
-    data_.assetPath = modelPath.string();
-    data_.lastError.clear();
-    return true;
+std::optional<openchordix::render::ModelLoadProgress> TestSceneModelController::loadProgress() const
+{
+    if (!job_)
+    {
+        return std::nullopt;
+    }
+    return job_->progress();
+}
+
+void TestSceneModelController::cancelLoad()
+{
+    if (job_ && !job_->idle())
+    {
+        // Destroying it now would block on the read; drop it once that returns.
+        abandoned_.push_back(std::move(job_));
+    }
+    job_.reset();
 }
 
 void TestSceneModelController::clearModel()
 {
+    cancelLoad();
     data_.model.reset();
     data_.assetPath.clear();
     data_.lastError.clear();
 }
 
+bool TestSceneModelController::loadChart(std::string_view path)
+{
+    std::string error;
+    auto chart = ChartFile::open(std::filesystem::path(path), error);
+    if (!chart)
+    {
+        data_.lastError = error;
+        return false;
+    }
+    data_.chart = std::move(chart);
+    data_.chartPath = std::string(path);
+    const int lastPart = std::max(static_cast<int>(data_.chart->partCount()) - 1, 0);
+    data_.chartPart = std::clamp(data_.chartPart, 0, lastPart);
+    data_.highwaySeconds = 0.0;
+    data_.lastError.clear();
+    return true;
+}
+
 std::string TestSceneModelController::status() const
 {
+    if (auto progress = loadProgress())
+    {
+        std::string line = "Loading model: " + job_->path().string();
+        if (progress->stage == openchordix::render::ModelLoadStage::Uploading)
+        {
+            char percent[16];
+            std::snprintf(percent, sizeof(percent), "%.0f%%", progress->fraction * 100.0f);
+            return line + (job_->fromCache() ? " | uploading cooked " : " | uploading ") + percent;
+        }
+        return line + " | reading";
+    }
+
     if (!data_.model)
     {
         if (!data_.lastError.empty())
@@ -64,8 +130,11 @@ std::string TestSceneModelController::status() const
         return std::string("No model loaded.");
     }
 
-    return "Loaded model: " + data_.assetPath +
+    const bool packed = !data_.model->meshes.empty() &&
+                        data_.model->meshes.front().vertexFormat == openchordix::render::VertexFormat::Packed;
+    return "Loaded model: " + data_.assetPath + (data_.fromCache ? " (cooked)" : "") +
            " | meshes " + std::to_string(data_.model->meshes.size()) +
            " | materials " + std::to_string(data_.model->materials.size()) +
-           " | textures " + std::to_string(data_.model->textures.size());
+           " | textures " + std::to_string(data_.model->textures.size()) +
+           (packed ? " | packed vertices" : "");
 }
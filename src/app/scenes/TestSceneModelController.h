@@ -1,9 +1,15 @@
 #pragma once
 
+#include <filesystem>
+#include <memory>
+#include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "TestScene.h"
+#include "render/ModelLoadJob.h"
 
 namespace openchordix::render
 {
@@ -13,16 +19,31 @@ namespace openchordix::render
 class TestSceneModelController
 {
 public:
-    TestSceneModelController() = default;
+    // Cooked copies of loaded models go to cacheDir, typically ConfigStore::modelCachePath().
+    explicit TestSceneModelController(std::filesystem::path cacheDir) : cacheDir_(std::move(cacheDir)) {}
     ~TestSceneModelController();
 
     TestSceneData &data() { return data_; }
     const TestSceneData &data() const { return data_; }
 
+    // Starts a background load; the current model stays up until the new one is
+    // ready. Returns false if the load could not be started.
     bool loadModel(openchordix::render::ModelRenderer &renderer, std::string_view path);
+    // Once per frame on the main thread: advances a pending load.
+    void update(openchordix::render::ModelRenderer &renderer);
+    bool loading() const { return job_ != nullptr; }
+    std::optional<openchordix::render::ModelLoadProgress> loadProgress() const;
     void clearModel();
+    // Maps a .occhart for the highway preview and rewinds it.
+    bool loadChart(std::string_view path);
     std::string status() const;
 
 private:
+    void cancelLoad();
+
+    std::filesystem::path cacheDir_;
     TestSceneData data_{};
+    std::unique_ptr<openchordix::render::ModelLoadJob> job_;
+    // Cancelled loads whose background read has not returned yet.
+    std::vector<std::unique_ptr<openchordix::render::ModelLoadJob>> abandoned_;
 };
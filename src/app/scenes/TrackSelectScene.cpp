@@ -4,9 +4,6 @@
 #include <cstdio>
 #include <imgui/imgui.h>
 
-#include "score/ScoreServiceMemory.h"
-#include "track/TrackCatalogMemory.h"
-
 namespace
 {
     const ImVec4 kAccent = ImVec4(0.34f, 0.78f, 0.98f, 1.0f);
@@ -15,16 +12,19 @@ namespace
     const ImVec4 kPanelBorder = ImVec4(0.20f, 0.26f, 0.34f, 0.9f);
 }
 
-TrackSelectScene::TrackSelectScene(AnimatedUI &ui)
-    : ui_(ui)
+TrackSelectScene::TrackSelectScene(AnimatedUI &ui, TrackCatalog &catalog, TrackScoreService &scoreService)
+    : ui_(ui), catalog_(catalog), scoreService_(scoreService)
 {
-    catalog_ = std::make_unique<TrackCatalogMemory>();
-    scoreService_ = std::make_unique<TrackScoreServiceMemory>();
     updateFilter();
 }
 
 void TrackSelectScene::render(float /*dt*/, const FrameInput & /*input*/, GraphicsContext & /*gfx*/, std::atomic<bool> & /*quitFlag*/)
 {
+    if (catalog_.poll())
+    {
+        updateFilter();
+    }
+
     ImVec2 screen = ImGui::GetIO().DisplaySize;
     ImGui::SetNextWindowPos(ImVec2(0.0f, 0.0f), ImGuiCond_Always);
     ImGui::SetNextWindowSize(screen, ImGuiCond_Always);
@@ -111,10 +111,10 @@ void TrackSelectScene::drawMainPane(const ImVec2 &screen, float top, float heigh
     ImVec2 rightPos(leftPos.x + leftWidth + innerPad, innerPad);
 
     ImGui::SetCursorPos(leftPos);
-    const auto &tracks = catalog_->tracks();
+    const auto &tracks = catalog_.tracks();
     if (tracks.empty())
     {
-        ImGui::TextDisabled("No tracks available.");
+        ImGui::TextDisabled(catalog_.scanning() ? "Scanning song library..." : "No tracks available.");
         ImGui::EndChild();
         return;
     }
@@ -259,17 +259,17 @@ void TrackSelectScene::drawMainPane(const ImVec2 &screen, float top, float heigh
         std::string partName = track.parts.empty() ? "" : track.parts[selectedPart_].name;
         if (ImGui::BeginTabItem("Local"))
         {
-            drawScoreRows(scoreService_->scoresFor(track, partName, ScoreCategory::Local));
+            drawScoreRows(scoreService_.scoresFor(track, partName, ScoreCategory::Local));
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("Online"))
         {
-            drawScoreRows(scoreService_->scoresFor(track, partName, ScoreCategory::Online));
+            drawScoreRows(scoreService_.scoresFor(track, partName, ScoreCategory::Online));
             ImGui::EndTabItem();
         }
         if (ImGui::BeginTabItem("Country"))
         {
-            drawScoreRows(scoreService_->scoresFor(track, partName, ScoreCategory::Country));
+            drawScoreRows(scoreService_.scoresFor(track, partName, ScoreCategory::Country));
             ImGui::EndTabItem();
         }
         ImGui::EndTabBar();
@@ -376,7 +376,7 @@ void TrackSelectScene::drawTrackRow(const TrackInfo &track, int index, float wid
 
 void TrackSelectScene::updateFilter()
 {
-    filtered_ = catalog_->filter(search_.data());
+    filtered_ = catalog_.filter(search_.data());
     if (!filtered_.empty())
     {
         if (std::find(filtered_.begin(), filtered_.end(), selectedIndex_) == filtered_.end())
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <array>
-#include <memory>
 #include <string>
 #include <vector>
 
@@ -13,7 +12,9 @@
 class TrackSelectScene : public Scene
 {
 public:
-    explicit TrackSelectScene(AnimatedUI &ui);
+    // The catalog and score store outlive the scene, so entering it neither
+    // rescans the library nor replays the score log.
+    TrackSelectScene(AnimatedUI &ui, TrackCatalog &catalog, TrackScoreService &scoreService);
 
     void render(float dt, const FrameInput &input, GraphicsContext &gfx, std::atomic<bool> &quitFlag) override;
     bool finished() const override { return finished_; }
@@ -26,8 +27,8 @@ private:
     void updateFilter();
 
     AnimatedUI &ui_;
-    std::unique_ptr<TrackCatalog> catalog_;
-    std::unique_ptr<TrackScoreService> scoreService_;
+    TrackCatalog &catalog_;
+    TrackScoreService &scoreService_;
     std::vector<int> filtered_;
     std::array<char, 64> search_{};
     int selectedIndex_ = 0;
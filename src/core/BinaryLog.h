@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Little-endian encoding shared by the score log and the library cache. Strings
+// are a u16 length and the bytes, cut at 64 KiB; fnv1a32 checksums records.
+namespace binlog
+{
+    inline uint32_t fnv1a32(const char *data, std::size_t size)
+    {
+        uint32_t hash = 2166136261u;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash ^= static_cast<uint8_t>(data[i]);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+    inline void putU8(std::vector<char> &out, uint8_t value)
+    {
+        out.push_back(static_cast<char>(value));
+    }
+
+    inline void putU32(std::vector<char> &out, uint32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    inline void putU64(std::vector<char> &out, uint64_t value)
+    {
+        putU32(out, static_cast<uint32_t>(value));
+        putU32(out, static_cast<uint32_t>(value >> 32));
+    }
+
+    inline void putString(std::vector<char> &out, const std::string &value)
+    {
+        const std::size_t size = std::min<std::size_t>(value.size(), 0xFFFF);
+        out.push_back(static_cast<char>(size & 0xFF));
+        out.push_back(static_cast<char>(size >> 8));
+        out.insert(out.end(), value.begin(), value.begin() + static_cast<std::ptrdiff_t>(size));
+    }
+
+    inline uint32_t getU32(const char *data)
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+        }
+        return value;
+    }
+
+    // Bounds-checked cursor; any short read clears ok and later reads return zero.
+    struct Reader
+    {
+        const char *data;
+        std::size_t size;
+        std::size_t pos = 0;
+        bool ok = true;
+
+        uint64_t bytes(int count)
+        {
+            if (!ok || pos + static_cast<std::size_t>(count) > size)
+            {
+                ok = false;
+                return 0;
+            }
+            uint64_t value = 0;
+            for (int i = 0; i < count; ++i)
+            {
+                value |= static_cast<uint64_t>(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+            }
+            pos += static_cast<std::size_t>(count);
+            return value;
+        }
+
+        std::string string()
+        {
+            const std::size_t length = static_cast<std::size_t>(bytes(2));
+            if (!ok || pos + length > size)
+            {
+                ok = false;
+                return {};
+            }
+            std::string value(data + pos, length);
+            pos += length;
+            return value;
+        }
+    };
+}
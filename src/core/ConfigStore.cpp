@@ -67,6 +67,14 @@ std::optional<AudioConfig> ConfigStore::loadAudioConfig() const
                 config.outputDeviceId = outputId;
             }
         }
+        else if (key == "input_device_name")
+        {
+            config.inputDeviceName = value;
+        }
+        else if (key == "output_device_name")
+        {
+            config.outputDeviceName = value;
+        }
         else if (key == "sample_rate")
         {
             unsigned int sr = config.sampleRate;
@@ -112,6 +120,8 @@ bool ConfigStore::saveAudioConfig(const AudioConfig &config) const
     out << "api=" << static_cast<int>(config.api) << '\n';
     out << "input_device=" << config.inputDeviceId << '\n';
     out << "output_device=" << config.outputDeviceId << '\n';
+    out << "input_device_name=" << config.inputDeviceName << '\n';
+    out << "output_device_name=" << config.outputDeviceName << '\n';
     out << "sample_rate=" << config.sampleRate << '\n';
     out << "buffer_frames=" << config.bufferFrames << '\n';
 
@@ -14,6 +14,10 @@ public:
     bool saveAudioConfig(const AudioConfig &config) const;
 
     std::filesystem::path audioConfigPath() const { return audioConfigPath_; }
+    std::filesystem::path scoreLogPath() const { return audioConfigPath_.parent_path() / "scores.log"; }
+    std::filesystem::path songLibraryPath() const { return audioConfigPath_.parent_path() / "songs"; }
+    std::filesystem::path libraryCachePath() const { return audioConfigPath_.parent_path() / "library.cache"; }
+    std::filesystem::path modelCachePath() const { return audioConfigPath_.parent_path() / "model-cache"; }
 
 private:
     std::filesystem::path audioConfigPath_;
@@ -0,0 +1,71 @@
+#include "FileSync.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if !defined(_WIN32)
+    bool syncPath(const std::filesystem::path &path, int flags)
+    {
+        const int fd = ::open(path.c_str(), flags);
+        if (fd < 0)
+        {
+            return false;
+        }
+        const bool synced = ::fsync(fd) == 0;
+        ::close(fd);
+        return synced;
+    }
+#endif
+}
+
+bool syncFile(const std::filesystem::path &path)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+    const bool synced = FlushFileBuffers(file) != 0;
+    CloseHandle(file);
+    return synced;
+#else
+    return syncPath(path, O_RDONLY);
+#endif
+}
+
+bool syncDirectory(const std::filesystem::path &directory)
+{
+#if defined(_WIN32)
+    (void)directory;
+    return true;
+#else
+    return syncPath(directory.empty() ? std::filesystem::path(".") : directory, O_RDONLY | O_DIRECTORY);
+#endif
+}
+
+bool replaceFileDurably(const std::filesystem::path &temp, const std::filesystem::path &target, std::error_code &ec)
+{
+    if (!syncFile(temp))
+    {
+        ec = std::make_error_code(std::errc::io_error);
+        return false;
+    }
+    std::filesystem::rename(temp, target, ec);
+    if (ec)
+    {
+        return false;
+    }
+    // The data is already safe; a failed directory sync only risks the old name
+    // coming back after a crash, so it does not fail the replace.
+    syncDirectory(target.parent_path());
+    return true;
+}
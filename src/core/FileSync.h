@@ -0,0 +1,16 @@
+#pragma once
+
+#include <filesystem>
+#include <system_error>
+
+// Durability helpers for files replaced by writing a temporary and renaming it.
+// A flushed stream only reaches the OS cache; these push data and directory
+// entries to the device so a crash cannot leave a renamed but empty file.
+
+// Flushes the file's data to the device. Close or flush the writing stream first.
+bool syncFile(const std::filesystem::path &path);
+// Makes creates and renames in the directory durable. A no-op on Windows, where
+// the rename itself is journalled.
+bool syncDirectory(const std::filesystem::path &directory);
+// syncFile(temp), rename it over target, then syncDirectory(target's parent).
+bool replaceFileDurably(const std::filesystem::path &temp, const std::filesystem::path &target, std::error_code &ec);
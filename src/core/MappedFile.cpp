@@ -0,0 +1,142 @@
+#include "MappedFile.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        opened_ = std::exchange(other.opened_, false);
+#if defined(_WIN32)
+        fileHandle_ = std::exchange(other.fileHandle_, nullptr);
+        mappingHandle_ = std::exchange(other.mappingHandle_, nullptr);
+#endif
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::filesystem::path &path, std::string &error)
+{
+    close();
+#if defined(_WIN32)
+    HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        error = "Cannot open " + path.string();
+        return false;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size))
+    {
+        CloseHandle(file);
+        error = "Cannot stat " + path.string();
+        return false;
+    }
+    fileHandle_ = file;
+    size_ = static_cast<std::size_t>(size.QuadPart);
+    opened_ = true;
+    if (size_ == 0)
+    {
+        return true;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        close();
+        error = "Cannot map " + path.string();
+        return false;
+    }
+    mappingHandle_ = mapping;
+    data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data_)
+    {
+        close();
+        error = "Cannot map " + path.string();
+        return false;
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = "Cannot open " + path.string();
+        return false;
+    }
+    struct stat info{};
+    if (::fstat(fd, &info) != 0)
+    {
+        ::close(fd);
+        error = "Cannot stat " + path.string();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(info.st_size);
+    opened_ = true;
+    if (size_ > 0)
+    {
+        void *mapped = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED)
+        {
+            ::close(fd);
+            size_ = 0;
+            opened_ = false;
+            error = "Cannot map " + path.string();
+            return false;
+        }
+        data_ = mapped;
+    }
+    // The mapping keeps the file referenced; the descriptor is no longer needed.
+    ::close(fd);
+#endif
+    return true;
+}
+
+void MappedFile::close()
+{
+#if defined(_WIN32)
+    if (data_)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mappingHandle_)
+    {
+        CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    }
+    if (fileHandle_)
+    {
+        CloseHandle(static_cast<HANDLE>(fileHandle_));
+    }
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+#else
+    if (data_)
+    {
+        ::munmap(const_cast<void *>(data_), size_);
+    }
+#endif
+    data_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+
+// Read-only memory mapping of a whole file. Move-only; the view stays valid for
+// the lifetime of the object.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    bool open(const std::filesystem::path &path, std::string &error);
+    void close();
+
+    bool isOpen() const { return opened_; }
+    std::span<const std::byte> bytes() const { return {static_cast<const std::byte *>(data_), size_}; }
+    std::size_t size() const { return size_; }
+
+private:
+    const void *data_ = nullptr;
+    std::size_t size_ = 0;
+    bool opened_ = false;
+#if defined(_WIN32)
+    void *fileHandle_ = nullptr;
+    void *mappingHandle_ = nullptr;
+#endif
+};
@@ -25,6 +25,7 @@ public:
 
     // Convert a frequency (Hz) into full NoteInfo
     NoteInfo getNoteInfo(float frequencyHz) const;
+    float referenceA4() const { return referenceA4_Hz_; }
 
 private:
     float referenceA4_Hz_;
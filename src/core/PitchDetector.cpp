@@ -8,7 +8,9 @@
 PitchDetector::PitchDetector(uint_t bufferSize, uint_t hopSize, uint_t sampleRate, const std::string &method)
     : config_buffer_size_(bufferSize),
       config_hop_size_(hopSize),
-      config_sample_rate_(sampleRate)
+      config_sample_rate_(sampleRate),
+      config_method_(method),
+      pending_(std::max<std::size_t>(static_cast<std::size_t>(hopSize) * 4, 8192))
 {
     // --- Input Validation ---
     if (bufferSize == 0 || hopSize == 0 || sampleRate == 0)
@@ -74,22 +76,102 @@ void PitchDetector::process(const float *inputBuffer, uint_t numFrames, uint_t i
         return;
     }
 
-    if (numFrames != config_hop_size_)
+    if (inputChannelCount < 1)
+        return;
+
+    if (processing_.test_and_set(std::memory_order_acquire))
     {
-        std::cerr << "Warning: PitchDetector::process received numFrames (" << numFrames
-                  << ") != configured hop_size (" << config_hop_size_ << "). Frame skipped." << std::endl;
+        // The other stream is analysing: queue channel 0 for it (or for us, if it
+        // has let go by the time the block is queued).
+        float mono[256];
+        uint_t queued = 0;
+        while (queued < numFrames)
+        {
+            const uint_t count = std::min<uint_t>(numFrames - queued, 256);
+            for (uint_t i = 0; i < count; ++i)
+            {
+                mono[i] = inputBuffer[(queued + i) * inputChannelCount];
+            }
+            const std::size_t written = pending_.write(mono, count);
+            if (written < count)
+            {
+                samples_dropped_.fetch_add(numFrames - queued - written, std::memory_order_relaxed);
+                break;
+            }
+            queued += count;
+        }
+        // Pairs with the fence in drainAndRelease: either the holder sees this
+        // block, or this caller sees the flag released and drains it itself.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (processing_.test_and_set(std::memory_order_acquire))
+        {
+            return;
+        }
+        drainAndRelease();
         return;
     }
 
-    if (inputChannelCount < 1)
-        return;
+    // Queued blocks arrived before this one
+    drainPending();
 
-    // Copy data from the 1 channel to Aubio input fvec
+    // Copy data from the 1 channel to Aubio input fvec, analysing every full hop
     for (uint_t i = 0; i < numFrames; ++i)
     {
-        aubio_input_buffer_->data[i] = inputBuffer[i * inputChannelCount];
+        aubio_input_buffer_->data[hop_fill_++] = inputBuffer[i * inputChannelCount];
+        if (hop_fill_ == config_hop_size_)
+        {
+            analyzeHop();
+            hop_fill_ = 0;
+        }
+    }
+    samples_processed_.fetch_add(numFrames, std::memory_order_relaxed);
+
+    drainAndRelease();
+}
+
+void PitchDetector::appendSamples(const float *samples, uint_t count)
+{
+    for (uint_t i = 0; i < count; ++i)
+    {
+        aubio_input_buffer_->data[hop_fill_++] = samples[i];
+        if (hop_fill_ == config_hop_size_)
+        {
+            analyzeHop();
+            hop_fill_ = 0;
+        }
+    }
+    samples_processed_.fetch_add(count, std::memory_order_relaxed);
+}
+
+void PitchDetector::drainPending()
+{
+    float queuedSamples[256];
+    std::size_t count = 0;
+    while ((count = pending_.read(queuedSamples, 256)) > 0)
+    {
+        appendSamples(queuedSamples, static_cast<uint_t>(count));
     }
+}
 
+void PitchDetector::drainAndRelease()
+{
+    for (;;)
+    {
+        drainPending();
+        processing_.clear(std::memory_order_release);
+
+        // A caller that queued after the drain and then failed to take the flag
+        // relies on someone draining again.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (pending_.readAvailable() == 0 || processing_.test_and_set(std::memory_order_acquire))
+        {
+            return;
+        }
+    }
+}
+
+void PitchDetector::analyzeHop()
+{
     aubio_pitch_do(pitch_object_, aubio_input_buffer_, aubio_pitch_output_);
 
     // Get the pitch result(Hz)
@@ -3,8 +3,19 @@
 
 #include <aubio/aubio.h>
 #include <atomic>
+#include <cstdint>
 #include <string>
 
+#include "audio/SpscRingBuffer.h"
+
+struct PitchDetectorConfig
+{
+    uint_t bufferSize = 0;
+    uint_t hopSize = 0;
+    uint_t sampleRate = 0;
+    std::string method;
+};
+
 class PitchDetector
 {
 public:
@@ -16,16 +27,40 @@ public:
     PitchDetector(const PitchDetector &) = delete;
     PitchDetector &operator=(const PitchDetector &) = delete;
 
+    // Accepts blocks of any size; samples are accumulated until a full hop is
+    // available, so the detector survives stream buffer-size changes. Safe to
+    // call from two audio callbacks at once during a stream hot-swap: a block
+    // that arrives while the other caller is analysing is queued, never waited
+    // on, and the caller holding the detector analyses it before returning.
     void process(const float *inputBuffer, uint_t numFrames, uint_t inputChannelCount);
 
     float getPitchHz() const;
+    // Samples analysed so far, and samples lost because the queue for blocks
+    // arriving during contention was full.
+    uint64_t samplesProcessed() const { return samples_processed_.load(std::memory_order_relaxed); }
+    uint64_t samplesDropped() const { return samples_dropped_.load(std::memory_order_relaxed); }
+    uint_t sampleRate() const { return config_sample_rate_; }
+    uint_t hopSize() const { return config_hop_size_; }
+    PitchDetectorConfig config() const { return {config_buffer_size_, config_hop_size_, config_sample_rate_, config_method_}; }
 
 private:
+    void analyzeHop();
+    void appendSamples(const float *samples, uint_t count);
+    void drainPending();
+    // Analyses queued blocks and releases processing_, taking it back if a block
+    // was queued after the last check.
+    void drainAndRelease();
+
     aubio_pitch_t *pitch_object_ = nullptr;
     fvec_t *aubio_input_buffer_ = nullptr;
     fvec_t *aubio_pitch_output_ = nullptr;
 
     std::atomic<float> latest_pitch_hz_{0.0f};
+    std::atomic_flag processing_ = ATOMIC_FLAG_INIT;
+    SpscRingBuffer<float> pending_; // Mono samples from the caller that found processing_ taken
+    std::atomic<uint64_t> samples_processed_{0};
+    std::atomic<uint64_t> samples_dropped_{0};
+    uint_t hop_fill_ = 0;
     float smoothed_pitch_hz_ = 0.0f;
     bool has_smoothed_ = false;
 
@@ -33,6 +68,7 @@ private:
     uint_t config_buffer_size_;
     uint_t config_hop_size_;
     uint_t config_sample_rate_;
+    std::string config_method_;
     float smoothing_alpha_ = 0.22f;
 };
 
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <string>
+
 #include <rtaudio/RtAudio.h>
 
 struct AudioConfig
@@ -7,6 +9,10 @@ struct AudioConfig
     RtAudio::Api api = RtAudio::Api::UNSPECIFIED;
     unsigned int inputDeviceId = 0;
     unsigned int outputDeviceId = 0;
+    // Device IDs only hold within one probe of one RtAudio instance; the names
+    // identify the devices across runs.
+    std::string inputDeviceName;
+    std::string outputDeviceName;
     unsigned int sampleRate = 48000;
     unsigned int bufferFrames = 1024;
 
@@ -14,4 +20,9 @@ struct AudioConfig
     {
         return inputDeviceId != 0 && outputDeviceId != 0 && sampleRate > 0 && bufferFrames > 0;
     }
+
+    bool hasDeviceNames() const
+    {
+        return !inputDeviceName.empty() && !outputDeviceName.empty();
+    }
 };
@@ -0,0 +1,220 @@
+#include "audio/AudioDeviceMonitor.h"
+
+#include <exception>
+#include <iostream>
+#include <utility>
+
+AudioDeviceMonitor::AudioDeviceMonitor(std::chrono::milliseconds rescanInterval)
+    : rescanInterval_(rescanInterval)
+{
+}
+
+AudioDeviceMonitor::~AudioDeviceMonitor()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void AudioDeviceMonitor::requestApi(RtAudio::Api api)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingApi_ = api;
+        // The old manager is about to be replaced; stop probing it.
+        watched_.reset();
+        watchedDevices_.clear();
+    }
+    ensureThread();
+    wake_.notify_all();
+}
+
+void AudioDeviceMonitor::watch(std::shared_ptr<AudioManager> manager, RtAudio::Api requestedApi, std::vector<DeviceEntry> devices)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pendingApi_.reset();
+        watched_ = std::move(manager);
+        watchedApi_ = requestedApi;
+        watchedDevices_ = std::move(devices);
+    }
+    ensureThread();
+    wake_.notify_all();
+}
+
+void AudioDeviceMonitor::requestRescan()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        rescanRequested_ = true;
+    }
+    wake_.notify_all();
+}
+
+void AudioDeviceMonitor::stopWatching()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    pendingApi_.reset();
+    watched_.reset();
+    watchedDevices_.clear();
+}
+
+std::optional<DeviceSnapshot> AudioDeviceMonitor::poll(uint64_t seenVersion) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (latest_.version <= seenVersion)
+    {
+        return std::nullopt;
+    }
+    return latest_;
+}
+
+bool AudioDeviceMonitor::busy() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return working_ || pendingApi_.has_value();
+}
+
+std::vector<DeviceEntry> AudioDeviceMonitor::probe(AudioManager &manager)
+{
+    std::vector<DeviceEntry> devices;
+    for (unsigned int id : manager.getDeviceIds())
+    {
+        devices.push_back(DeviceEntry{id, manager.getDeviceInfo(id)});
+    }
+    return devices;
+}
+
+bool AudioDeviceMonitor::sameDevices(const std::vector<DeviceEntry> &lhs, const std::vector<DeviceEntry> &rhs)
+{
+    if (lhs.size() != rhs.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        const RtAudio::DeviceInfo &a = lhs[i].info;
+        const RtAudio::DeviceInfo &b = rhs[i].info;
+        if (lhs[i].id != rhs[i].id || a.name != b.name || a.inputChannels != b.inputChannels ||
+            a.outputChannels != b.outputChannels || a.isDefaultInput != b.isDefaultInput ||
+            a.isDefaultOutput != b.isDefaultOutput)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AudioDeviceMonitor::ensureThread()
+{
+    if (!worker_.joinable())
+    {
+        worker_ = std::thread(&AudioDeviceMonitor::run, this);
+    }
+}
+
+void AudioDeviceMonitor::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_)
+    {
+        wake_.wait_for(lock, rescanInterval_, [this]
+                       { return stop_ || pendingApi_.has_value() || rescanRequested_; });
+        if (stop_)
+        {
+            break;
+        }
+
+        if (pendingApi_.has_value())
+        {
+            RtAudio::Api api = *pendingApi_;
+            pendingApi_.reset();
+            working_ = true;
+            lock.unlock();
+
+            // Backend startup (JACK/Pulse connections) and the first probe are the slow part.
+            DeviceSnapshot snapshot{};
+            snapshot.requestedApi = api;
+            try
+            {
+                snapshot.manager = std::make_shared<AudioManager>(api);
+                snapshot.devices = probe(*snapshot.manager);
+                snapshot.defaultInput = snapshot.manager->getDefaultInputDeviceId();
+                snapshot.defaultOutput = snapshot.manager->getDefaultOutputDeviceId();
+                snapshot.manager->prepareStandbyInstance();
+            }
+            catch (const std::exception &e)
+            {
+                snapshot.manager.reset();
+                snapshot.error = e.what();
+            }
+
+            lock.lock();
+            working_ = false;
+            // A newer request supersedes this one; drop the result instead of publishing a stale API.
+            if (!pendingApi_.has_value() && !stop_)
+            {
+                watched_ = snapshot.manager;
+                watchedApi_ = api;
+                watchedDevices_ = snapshot.devices;
+                snapshot.version = nextVersion_++;
+                latest_ = std::move(snapshot);
+            }
+            continue;
+        }
+
+        rescanRequested_ = false;
+        if (!watched_)
+        {
+            continue;
+        }
+
+        // Hotplug rescan: the manager probes on its own RtAudio instance, so the
+        // active stream keeps running and stream changes don't wait for us.
+        std::shared_ptr<AudioManager> manager = watched_;
+        RtAudio::Api api = watchedApi_;
+        working_ = true;
+        lock.unlock();
+
+        std::vector<DeviceEntry> devices;
+        unsigned int defaultInput = 0;
+        unsigned int defaultOutput = 0;
+        bool probed = true;
+        try
+        {
+            devices = probe(*manager);
+            defaultInput = manager->getDefaultInputDeviceId();
+            defaultOutput = manager->getDefaultOutputDeviceId();
+            // Stream changes map device names through the standby instead of probing.
+            manager->prepareStandbyInstance();
+        }
+        catch (const std::exception &e)
+        {
+            // Keep the last good list rather than reporting every device as unplugged.
+            std::cerr << "Device rescan failed: " << e.what() << std::endl;
+            probed = false;
+        }
+
+        lock.lock();
+        working_ = false;
+        if (!probed || watched_ != manager || sameDevices(devices, watchedDevices_))
+        {
+            continue;
+        }
+        watchedDevices_ = devices;
+        DeviceSnapshot snapshot{};
+        snapshot.requestedApi = api;
+        snapshot.manager = std::move(manager);
+        snapshot.devices = std::move(devices);
+        snapshot.defaultInput = defaultInput;
+        snapshot.defaultOutput = defaultOutput;
+        snapshot.version = nextVersion_++;
+        latest_ = std::move(snapshot);
+    }
+}
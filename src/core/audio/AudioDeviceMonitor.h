@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rtaudio/RtAudio.h>
+
+#include "audio/AudioManager.h"
+
+struct DeviceEntry
+{
+    unsigned int id = 0;
+    RtAudio::DeviceInfo info{};
+};
+
+struct DeviceSnapshot
+{
+    uint64_t version = 0;
+    RtAudio::Api requestedApi = RtAudio::Api::UNSPECIFIED;
+    std::shared_ptr<AudioManager> manager;
+    std::vector<DeviceEntry> devices;
+    unsigned int defaultInput = 0;
+    unsigned int defaultOutput = 0;
+    std::string error;
+};
+
+// Builds AudioManager instances and probes devices on a worker thread, then keeps
+// rescanning the active manager so hotplug changes show up without a UI stall.
+// Each scan also keeps the manager's standby stream instance probed. Results are
+// published as versioned snapshots that the UI thread polls.
+class AudioDeviceMonitor
+{
+public:
+    explicit AudioDeviceMonitor(std::chrono::milliseconds rescanInterval = std::chrono::milliseconds(2000));
+    ~AudioDeviceMonitor();
+
+    AudioDeviceMonitor(const AudioDeviceMonitor &) = delete;
+    AudioDeviceMonitor &operator=(const AudioDeviceMonitor &) = delete;
+
+    // Queues construction of a manager for api; only the latest request is honoured.
+    void requestApi(RtAudio::Api api);
+    // Watches a manager that was created on the caller's thread.
+    void watch(std::shared_ptr<AudioManager> manager, RtAudio::Api requestedApi, std::vector<DeviceEntry> devices);
+    void requestRescan();
+    void stopWatching();
+
+    // Returns the latest snapshot if it is newer than seenVersion.
+    std::optional<DeviceSnapshot> poll(uint64_t seenVersion) const;
+    bool busy() const;
+
+    static std::vector<DeviceEntry> probe(AudioManager &manager);
+    static bool sameDevices(const std::vector<DeviceEntry> &lhs, const std::vector<DeviceEntry> &rhs);
+
+private:
+    void ensureThread();
+    void run();
+
+    std::chrono::milliseconds rescanInterval_;
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread worker_;
+    bool stop_ = false;
+    bool rescanRequested_ = false;
+    bool working_ = false;
+    std::optional<RtAudio::Api> pendingApi_;
+    std::shared_ptr<AudioManager> watched_;
+    RtAudio::Api watchedApi_ = RtAudio::Api::UNSPECIFIED;
+    std::vector<DeviceEntry> watchedDevices_;
+    DeviceSnapshot latest_{};
+    uint64_t nextVersion_ = 1;
+};
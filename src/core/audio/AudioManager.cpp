@@ -1,9 +1,13 @@
 #include "audio/AudioManager.h"
+#include "audio/SessionCapture.h"
+#include "audio/TakeRecorder.h"
 #include <iostream>
 #include <stdexcept>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <thread>
 
 namespace
 {
@@ -52,10 +56,8 @@ AudioManager::AudioManager(RtAudio::Api api) : selectedApi_(api),
         throw std::runtime_error("Failed to initialize RtAudio instance.");
     }
 
-    if (audio_ && audio_->getDeviceCount() == 0 && actualApi_ != RtAudio::Api::RTAUDIO_DUMMY)
-    {
-        std::cerr << "Warning: RtAudio initialized, but no devices were found for the selected API.\n";
-    }
+    // Devices are not counted here: that forces a full probe, and the fast startup
+    // path opens the saved devices before anything is enumerated.
 
     if (!audio_)
     {
@@ -64,6 +66,12 @@ AudioManager::AudioManager(RtAudio::Api api) : selectedApi_(api),
     }
 }
 
+AudioManager::~AudioManager()
+{
+    // Streams must be closed before the callback data they reference is released.
+    closeStream();
+}
+
 // --- Static Method: Get Available APIs ---
 std::vector<RtAudio::Api> AudioManager::getAvailableApis()
 {
@@ -90,92 +98,176 @@ std::vector<RtAudio::Api> AudioManager::getAvailableApis()
     return usableApis;
 }
 
-std::vector<unsigned int> AudioManager::getDeviceIds() const
+std::vector<RtAudio::DeviceInfo> AudioManager::probeDevices() const
 {
-    if (!audio_)
+    // Stream changes only wait on this lock to read the device list, never on a probe.
+    std::lock_guard<std::mutex> probeLock(probeMutex_);
+    if (!probeAudio_)
     {
-        AudioManager::defaultErrorCallback(RTAUDIO_INVALID_USE, "getDeviceIds called on uninitialized AudioManager (null audio pointer).");
-        return {};
+        try
+        {
+            probeAudio_ = std::make_unique<RtAudio>(actualApi_, &AudioManager::defaultErrorCallback);
+        }
+        catch (const std::exception &e)
+        {
+            AudioManager::defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception creating enumeration RtAudio instance: " + std::string(e.what()));
+            return {};
+        }
     }
 
+    std::vector<RtAudio::DeviceInfo> devices;
     try
     {
-        return audio_->getDeviceIds();
+        // getDeviceIds runs the full probe; getDeviceInfo only reads its result.
+        for (unsigned int id : probeAudio_->getDeviceIds())
+        {
+            devices.push_back(probeAudio_->getDeviceInfo(id));
+        }
     }
     catch (const std::exception &e)
     {
-        AudioManager::defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during getDeviceIds(): " + std::string(e.what()));
+        AudioManager::defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during device probe: " + std::string(e.what()));
         return {};
     }
+
+    std::lock_guard<std::mutex> devicesLock(devicesMutex_);
+    devices_ = devices;
+    return devices;
 }
 
-// --- Device Listing Method Implementation ---
-bool AudioManager::listDevices() const
+std::vector<RtAudio::DeviceInfo> AudioManager::knownDevices() const
 {
-    if (!audio_)
     {
-        AudioManager::defaultErrorCallback(RTAUDIO_INVALID_USE, "listDevices called on uninitialized AudioManager (null audio pointer).");
-        return false;
+        std::lock_guard<std::mutex> devicesLock(devicesMutex_);
+        if (devices_)
+        {
+            return *devices_;
+        }
+    }
+    return probeDevices();
+}
+
+std::optional<RtAudio::DeviceInfo> AudioManager::findKnownDevice(const std::function<bool(const RtAudio::DeviceInfo &)> &match) const
+{
+    {
+        // Searched in place: the device monitor looks up every device after each probe.
+        std::lock_guard<std::mutex> devicesLock(devicesMutex_);
+        if (devices_)
+        {
+            auto it = std::find_if(devices_->begin(), devices_->end(), match);
+            return it != devices_->end() ? std::optional<RtAudio::DeviceInfo>(*it) : std::nullopt;
+        }
+    }
+    for (const RtAudio::DeviceInfo &info : probeDevices())
+    {
+        if (match(info))
+        {
+            return info;
+        }
+    }
+    return std::nullopt;
+}
+
+// Device queries only touch the probe instance, so they never read the stream
+// instances that a stream change may be swapping on another thread.
+std::vector<unsigned int> AudioManager::getDeviceIds() const
+{
+    std::vector<unsigned int> ids;
+    for (const RtAudio::DeviceInfo &info : probeDevices())
+    {
+        ids.push_back(info.ID);
+    }
+    return ids;
+}
+
+void AudioManager::prepareStandbyInstance()
+{
+    const std::vector<RtAudio::DeviceInfo> known = knownDevices();
+    auto sameDevices = [&known](const std::vector<RtAudio::DeviceInfo> &devices)
+    {
+        // IDs differ between instances; names and channel counts do not.
+        return std::equal(devices.begin(), devices.end(), known.begin(), known.end(),
+                          [](const RtAudio::DeviceInfo &a, const RtAudio::DeviceInfo &b)
+                          { return a.name == b.name && a.inputChannels == b.inputChannels &&
+                                   a.outputChannels == b.outputChannels; });
+    };
+
+    std::unique_ptr<RtAudio> instance;
+    {
+        std::lock_guard<std::mutex> standbyLock(standbyMutex_);
+        if (standbyAudio_ && standbyDevices_ && sameDevices(*standbyDevices_))
+        {
+            return;
+        }
+        // Taken out while probing, so a stream change in the meantime falls back to its own probe.
+        instance = std::move(standbyAudio_);
+        standbyDevices_.reset();
     }
 
-    unsigned int deviceCount = 0;
+    std::vector<RtAudio::DeviceInfo> devices;
     try
     {
-        deviceCount = audio_->getDeviceCount();
+        if (!instance)
+        {
+            instance = std::make_unique<RtAudio>(actualApi_, &AudioManager::defaultErrorCallback);
+        }
+        for (unsigned int id : instance->getDeviceIds())
+        {
+            devices.push_back(instance->getDeviceInfo(id));
+        }
     }
     catch (const std::exception &e)
     {
-        AudioManager::defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during getDeviceCount(): " + std::string(e.what()));
-        return false;
+        AudioManager::defaultErrorCallback(RTAUDIO_WARNING, "Standby instance probe failed: " + std::string(e.what()));
+        return;
+    }
+
+    std::lock_guard<std::mutex> standbyLock(standbyMutex_);
+    // A stream change may have handed back its old, unprobed instance meanwhile; ours replaces it.
+    if (!standbyAudio_ || !standbyDevices_)
+    {
+        standbyAudio_ = std::move(instance);
+        standbyDevices_ = std::move(devices);
     }
+}
 
-    std::cout << "\nFound " << deviceCount << " audio devices for API "
+// --- Device Listing Method Implementation ---
+bool AudioManager::listDevices() const
+{
+    std::vector<RtAudio::DeviceInfo> devices = probeDevices();
+
+    std::cout << "\nFound " << devices.size() << " audio devices for API "
               << RtAudio::getApiDisplayName(actualApi_) << ":" << std::endl;
 
-    if (deviceCount < 1)
+    if (devices.empty())
     {
         std::cerr << "No audio devices found for this API.\n";
         return false;
     }
 
-    std::vector<unsigned int> deviceIds = audio_->getDeviceIds();
-    bool devices_listed = false;
-
-    for (unsigned int id : deviceIds)
+    for (const RtAudio::DeviceInfo &info : devices)
     {
-        try
+        std::cout << "  Device ID " << info.ID << ": " << info.name;
+        if (info.isDefaultInput)
+            std::cout << " (DEFAULT INPUT)";
+        if (info.isDefaultOutput)
+            std::cout << " (DEFAULT OUTPUT)";
+        std::cout << std::endl;
+        std::cout << "    Output Channels: " << info.outputChannels << std::endl;
+        std::cout << "    Input Channels: " << info.inputChannels << std::endl;
+        std::cout << "    Sample Rates: ";
+        if (info.sampleRates.empty())
         {
-            RtAudio::DeviceInfo info = audio_->getDeviceInfo(id);
-
-            std::cout << "  Device ID " << id << ": " << info.name;
-            if (info.isDefaultInput)
-                std::cout << " (DEFAULT INPUT)";
-            if (info.isDefaultOutput)
-                std::cout << " (DEFAULT OUTPUT)";
-            std::cout << std::endl;
-            std::cout << "    Output Channels: " << info.outputChannels << std::endl;
-            std::cout << "    Input Channels: " << info.inputChannels << std::endl;
-            std::cout << "    Sample Rates: ";
-            if (info.sampleRates.empty())
-            {
-                std::cout << "(None reported)";
-            }
-            else
-            {
-                for (unsigned int rate : info.sampleRates)
-                {
-                    std::cout << rate << " ";
-                }
-            }
-            std::cout << std::endl;
-            devices_listed = true;
+            std::cout << "(None reported)";
         }
-        catch (const std::exception &e)
+        else
         {
-            // Catch exceptions specifically from getDeviceInfo
-            AudioManager::defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception getting info for device " + std::to_string(id) + ": " + e.what());
-            // Continue trying to list other devices
+            for (unsigned int rate : info.sampleRates)
+            {
+                std::cout << rate << " ";
+            }
         }
+        std::cout << std::endl;
     }
     std::cout << std::endl;
 
@@ -183,33 +275,27 @@ bool AudioManager::listDevices() const
     std::cout << "Default Output Device ID (for this API): " << getDefaultOutputDeviceId() << std::endl;
     std::cout << "Default Input Device ID (for this API): " << getDefaultInputDeviceId() << std::endl;
 
-    return devices_listed;
+    return true;
 }
 
 // --- Implementation for getDeviceInfo ---
 RtAudio::DeviceInfo AudioManager::getDeviceInfo(unsigned int deviceId) const
 {
-    if (!audio_)
-    {
-        throw std::runtime_error("AudioManager not initialized (getDeviceInfo).");
-    }
-    try
+    std::optional<RtAudio::DeviceInfo> info = findKnownDevice([deviceId](const RtAudio::DeviceInfo &device)
+                                                              { return device.ID == deviceId; });
+    if (info)
     {
-        return audio_->getDeviceInfo(deviceId);
-    }
-    catch (...)
-    { // Catch potential RtAudio errors
-        defaultErrorCallback(RTAUDIO_INVALID_DEVICE, "Failed to get device info for ID: " + std::to_string(deviceId));
-        // Return an empty/default DeviceInfo struct to indicate failure
-        return RtAudio::DeviceInfo{}; // Default constructor initializes members appropriately
+        return *info;
     }
+    defaultErrorCallback(RTAUDIO_INVALID_DEVICE, "Failed to get device info for ID: " + std::to_string(deviceId));
+    // Return an empty/default DeviceInfo struct to indicate failure
+    return RtAudio::DeviceInfo{};
 }
 
 // --- Static Audio Callback Implementation ---
 int AudioManager::monitoringCallback(void *outputBuffer, void *inputBuffer, unsigned int nFrames,
                                      double streamTime, RtAudioStreamStatus status, void *userData)
 {
-    (void)streamTime;
     AudioCallbackData *cbData = static_cast<AudioCallbackData *>(userData);
     PitchDetector *detector = (cbData) ? cbData->pitchDetector : nullptr;
 
@@ -229,10 +315,25 @@ int AudioManager::monitoringCallback(void *outputBuffer, void *inputBuffer, unsi
     float *rt_in_buffer = static_cast<float *>(inputBuffer);
     float *rt_out_buffer = static_cast<float *>(outputBuffer);
 
+    if (cbData->firstCallbackNs.load(std::memory_order_relaxed) == 0)
+    {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        cbData->firstCallbackNs.store(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count(),
+                                      std::memory_order_relaxed);
+    }
+
     // --- Pitch Detection ---
-    if (rt_in_buffer != nullptr)
+    if (rt_in_buffer != nullptr && cbData->feedDetector.load(std::memory_order_acquire))
     {
         detector->process(rt_in_buffer, nFrames, inputChannels);
+        if (cbData->recorder)
+        {
+            cbData->recorder->push(rt_in_buffer, nFrames);
+        }
+        if (cbData->capture)
+        {
+            cbData->capture->push(streamTime, rt_in_buffer, nFrames);
+        }
     }
 
     // --- Monitoring Output ---
@@ -267,12 +368,81 @@ int AudioManager::monitoringCallback(void *outputBuffer, void *inputBuffer, unsi
         memset(rt_out_buffer, 0, nFrames * outputChannels * sizeof(float));
     }
 
+    // --- Crossfade Gain ---
+    float target = cbData->targetGain.load(std::memory_order_acquire);
+    if (rt_out_buffer != nullptr && (cbData->gain != 1.0f || target != 1.0f))
+    {
+        if (cbData->gain == target && target == 0.0f)
+        {
+            memset(rt_out_buffer, 0, nFrames * outputChannels * sizeof(float));
+        }
+        else
+        {
+            // Linear ramp from the current gain to the target across this buffer
+            float gain = cbData->gain;
+            float step = nFrames > 0 ? (target - gain) / static_cast<float>(nFrames) : 0.0f;
+            for (unsigned int i = 0; i < nFrames; ++i)
+            {
+                gain += step;
+                for (unsigned int ch = 0; ch < outputChannels; ++ch)
+                {
+                    rt_out_buffer[i * outputChannels + ch] *= gain;
+                }
+            }
+        }
+    }
+    cbData->gain = target;
+    cbData->faded.store(target == 0.0f, std::memory_order_release);
+
     return 0;
 }
 
 // --- Stream Management Implementations ---
+bool AudioManager::openStreamOn(RtAudio &audio,
+                                unsigned int inputDeviceId,
+                                unsigned int outputDeviceId,
+                                unsigned int sampleRate,
+                                unsigned int &bufferFrames,
+                                AudioCallbackData &callbackData)
+{
+    // --- Set RtAudio Stream Parameters ---
+    RtAudio::StreamParameters iParams;
+    iParams.deviceId = inputDeviceId;
+    iParams.nChannels = callbackData.inputChannels;
+    iParams.firstChannel = 0;
+    RtAudio::StreamParameters oParams;
+    oParams.deviceId = outputDeviceId;
+    oParams.nChannels = callbackData.outputChannels;
+    oParams.firstChannel = 0;
+
+    // --- Open the RtAudio Stream ---
+    std::cout << "Attempting to open RtAudio stream: SR=" << sampleRate << " Buf=" << bufferFrames
+              << " Input Device=" << inputDeviceId << " Output Device=" << outputDeviceId
+              << " Input Ch=" << callbackData.inputChannels << " Output Ch=" << callbackData.outputChannels << std::endl;
+    RtAudioErrorType result = RTAUDIO_NO_ERROR;
+    try
+    {
+        result = audio.openStream(&oParams, &iParams, RTAUDIO_FLOAT32, sampleRate,
+                                  &bufferFrames, // Pass address!
+                                  &AudioManager::monitoringCallback, &callbackData, nullptr);
+    }
+    catch (const std::exception &e)
+    {
+        defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during openStream: " + std::string(e.what()));
+        return false;
+    }
+
+    if (result != RTAUDIO_NO_ERROR)
+    {
+        std::cerr << "RtAudio openStream failed with code: " << result << std::endl;
+        return false;
+    }
+    return true;
+}
+
 bool AudioManager::openMonitoringStream(unsigned int inputDeviceId, unsigned int outputDeviceId, unsigned int sampleRate, unsigned int bufferFrames)
 {
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
     if (!audio_)
     {
         defaultErrorCallback(RTAUDIO_INVALID_USE, "Cannot open stream, AudioManager not initialized.");
@@ -304,62 +474,118 @@ bool AudioManager::openMonitoringStream(unsigned int inputDeviceId, unsigned int
         return false;
     }
 
+    unsigned int streamInputId = 0;
+    unsigned int streamOutputId = 0;
+    RtAudio::DeviceInfo standbyInput;
+    RtAudio::DeviceInfo standbyOutput;
+    if (takeStandbyInstance(audio_, inputInfo.name, outputInfo.name, standbyInput, standbyOutput))
+    {
+        streamInputId = standbyInput.ID;
+        streamOutputId = standbyOutput.ID;
+    }
+    else if (!mapDeviceIds(*audio_, inputDeviceId, outputDeviceId, streamInputId, streamOutputId))
+    {
+        return false;
+    }
+    return openPrimaryStream(streamInputId, streamOutputId, outputInfo.outputChannels,
+                             inputDeviceId, outputDeviceId, sampleRate, bufferFrames);
+}
+
+bool AudioManager::openMonitoringStreamByName(const std::string &inputDeviceName,
+                                              const std::string &outputDeviceName,
+                                              unsigned int sampleRate,
+                                              unsigned int bufferFrames)
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    if (!audio_)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_USE, "Cannot open stream, AudioManager not initialized.");
+        return false;
+    }
+    if (streamIsOpen_)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_USE, "Cannot open stream, another stream is already open.");
+        return false;
+    }
+
+    // One probe of the stream instance; openStream only accepts IDs from it.
+    RtAudio::DeviceInfo inputInfo;
+    RtAudio::DeviceInfo outputInfo;
+    if (takeStandbyInstance(audio_, inputDeviceName, outputDeviceName, inputInfo, outputInfo))
+    {
+        return openPrimaryStream(inputInfo.ID, outputInfo.ID, outputInfo.outputChannels, 0, 0, sampleRate, bufferFrames);
+    }
+    try
+    {
+        for (unsigned int id : audio_->getDeviceIds())
+        {
+            RtAudio::DeviceInfo info = audio_->getDeviceInfo(id);
+            if (inputInfo.ID == 0 && info.name == inputDeviceName && info.inputChannels > 0)
+            {
+                inputInfo = info;
+            }
+            if (outputInfo.ID == 0 && info.name == outputDeviceName && info.outputChannels > 0)
+            {
+                outputInfo = info;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during device probe: " + std::string(e.what()));
+        return false;
+    }
+    if (inputInfo.ID == 0 || outputInfo.ID == 0)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_DEVICE, "Saved devices \"" + inputDeviceName + "\" / \"" + outputDeviceName + "\" are not available.");
+        return false;
+    }
+
+    // Enumeration IDs are unknown until the device monitor has probed.
+    return openPrimaryStream(inputInfo.ID, outputInfo.ID, outputInfo.outputChannels, 0, 0, sampleRate, bufferFrames);
+}
+
+bool AudioManager::openPrimaryStream(unsigned int streamInputId,
+                                     unsigned int streamOutputId,
+                                     unsigned int outputChannels,
+                                     unsigned int inputDeviceId,
+                                     unsigned int outputDeviceId,
+                                     unsigned int sampleRate,
+                                     unsigned int bufferFrames)
+{
     // --- Determine RtAudio Stream Channel Counts ---
-    streamOutputChannels_ = (outputInfo.outputChannels >= 2) ? 2 : 1;
+    streamOutputChannels_ = (outputChannels >= 2) ? 2 : 1;
     streamInputChannels_ = 1; // Request 1 channel for RtAudio input
     std::cout << "Requesting " << streamOutputChannels_ << " output channel(s)." << std::endl;
     std::cout << "Requesting " << streamInputChannels_ << " input channel(s) from RtAudio." << std::endl;
 
-    // --- Set RtAudio Stream Parameters ---
-    RtAudio::StreamParameters iParams;
-    iParams.deviceId = inputDeviceId;
-    iParams.nChannels = streamInputChannels_;
-    iParams.firstChannel = 0;
-    RtAudio::StreamParameters oParams;
-    oParams.deviceId = outputDeviceId;
-    oParams.nChannels = streamOutputChannels_;
-    oParams.firstChannel = 0;
-
     // --- Store Stream Settings ---
     streamSampleRate_ = sampleRate;
     // Store requested size, actual size will be updated by openStream
-    unsigned int requestedBufferFrames = bufferFrames;
-    unsigned int actualBufferFrames = requestedBufferFrames;
+    streamRequestedBufferFrames_ = bufferFrames;
+    unsigned int actualBufferFrames = bufferFrames;
 
     // --- Reset Pitch Detector ---
     pitch_detector_.reset();
 
     // --- Prepare Callback Data ---
-    callbackData_.inputChannels = streamInputChannels_;
-    callbackData_.outputChannels = streamOutputChannels_;
-    callbackData_.pitchDetector = nullptr;
+    callbackData_ = std::make_unique<AudioCallbackData>();
+    callbackData_->inputChannels = streamInputChannels_;
+    callbackData_->outputChannels = streamOutputChannels_;
+    callbackData_->pitchDetector = nullptr;
+    callbackData_->recorder = takeRecorder_;
+    callbackData_->capture = sessionCapture_;
 
-    // --- Open the RtAudio Stream ---
-    std::cout << "Attempting to open RtAudio stream: SR=" << streamSampleRate_ << " Buf=" << requestedBufferFrames
-              << " Input Device=" << inputDeviceId << " Output Device=" << outputDeviceId
-              << " Input Ch=" << streamInputChannels_ << " Output Ch=" << streamOutputChannels_ << std::endl;
-    RtAudioErrorType result = RTAUDIO_NO_ERROR;
-    try
+    if (!openStreamOn(*audio_, streamInputId, streamOutputId, streamSampleRate_, actualBufferFrames, *callbackData_))
     {
-        result = audio_->openStream(&oParams, &iParams, RTAUDIO_FLOAT32, streamSampleRate_,
-                                    &actualBufferFrames, // Pass address!
-                                    &AudioManager::monitoringCallback, &callbackData_, nullptr);
-    }
-    catch (const std::exception &e)
-    {
-        defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during openStream: " + std::string(e.what()));
-        streamIsOpen_ = false;
-        return false;
-    }
-
-    if (result != RTAUDIO_NO_ERROR)
-    {
-        std::cerr << "RtAudio openStream failed with code: " << result << std::endl;
         streamIsOpen_ = false;
         return false;
     }
 
     // --- RtAudio Stream Opened Successfully ---
+    streamOnSpare_ = false;
+    streamInputDeviceId_ = inputDeviceId;
+    streamOutputDeviceId_ = outputDeviceId;
     streamBufferFrames_ = actualBufferFrames;
     streamIsOpen_ = true;
     std::cout << "RtAudio Stream opened successfully. Actual buffer size: " << streamBufferFrames_ << std::endl;
@@ -372,7 +598,7 @@ bool AudioManager::openMonitoringStream(unsigned int inputDeviceId, unsigned int
             hopSize = 1;
 
         pitch_detector_ = std::make_unique<PitchDetector>(streamBufferFrames_, hopSize, streamSampleRate_);
-        callbackData_.pitchDetector = pitch_detector_.get();
+        callbackData_->pitchDetector = pitch_detector_.get();
         std::cout << "PitchDetector initialized successfully." << std::endl;
     }
     catch (const std::runtime_error &e)
@@ -385,9 +611,340 @@ bool AudioManager::openMonitoringStream(unsigned int inputDeviceId, unsigned int
     return true;
 }
 
+RtAudio *AudioManager::acquireIdleInstance()
+{
+    if (streamOnSpare_)
+    {
+        return audio_.get();
+    }
+    if (!spareAudio_)
+    {
+        try
+        {
+            spareAudio_ = std::make_unique<RtAudio>(actualApi_, &AudioManager::defaultErrorCallback);
+        }
+        catch (const std::exception &e)
+        {
+            defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception creating hot-swap RtAudio instance: " + std::string(e.what()));
+            return nullptr;
+        }
+    }
+    return spareAudio_.get();
+}
+
+bool AudioManager::takeStandbyInstance(std::unique_ptr<RtAudio> &slot, const std::string &inputName,
+                                       const std::string &outputName, RtAudio::DeviceInfo &inputInfo,
+                                       RtAudio::DeviceInfo &outputInfo)
+{
+    std::lock_guard<std::mutex> standbyLock(standbyMutex_);
+    if (!standbyAudio_ || !standbyDevices_)
+    {
+        return false;
+    }
+    inputInfo = RtAudio::DeviceInfo{};
+    outputInfo = RtAudio::DeviceInfo{};
+    for (const RtAudio::DeviceInfo &info : *standbyDevices_)
+    {
+        if (inputInfo.ID == 0 && info.name == inputName && info.inputChannels > 0)
+        {
+            inputInfo = info;
+        }
+        if (outputInfo.ID == 0 && info.name == outputName && info.outputChannels > 0)
+        {
+            outputInfo = info;
+        }
+    }
+    if (inputInfo.ID == 0 || outputInfo.ID == 0)
+    {
+        return false;
+    }
+    // The idle instance goes back as the next standby; the monitor re-probes it before reuse.
+    std::swap(slot, standbyAudio_);
+    standbyDevices_.reset();
+    return true;
+}
+
+bool AudioManager::mapDeviceIds(RtAudio &target, unsigned int inputDeviceId, unsigned int outputDeviceId,
+                                unsigned int &targetInputId, unsigned int &targetOutputId) const
+{
+    // Device IDs are assigned per RtAudio instance, so translate through the device name.
+    std::string inputName = getDeviceInfo(inputDeviceId).name;
+    std::string outputName = getDeviceInfo(outputDeviceId).name;
+    targetInputId = 0;
+    targetOutputId = 0;
+    try
+    {
+        // openStream only accepts IDs from the target's own probe; one probe serves both.
+        for (unsigned int id : target.getDeviceIds())
+        {
+            std::string name = target.getDeviceInfo(id).name;
+            if (targetInputId == 0 && !inputName.empty() && name == inputName)
+            {
+                targetInputId = id;
+            }
+            if (targetOutputId == 0 && !outputName.empty() && name == outputName)
+            {
+                targetOutputId = id;
+            }
+        }
+    }
+    catch (const std::exception &e)
+    {
+        defaultErrorCallback(RTAUDIO_WARNING, "Device lookup on stream instance failed: " + std::string(e.what()));
+    }
+    if (targetInputId == 0 || targetOutputId == 0)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_DEVICE, "Selected devices are no longer available.");
+        return false;
+    }
+    return true;
+}
+
+bool AudioManager::fadeOutStream(AudioCallbackData &callbackData) const
+{
+    callbackData.feedDetector.store(false, std::memory_order_release);
+    callbackData.targetGain.store(0.0f, std::memory_order_release);
+
+    // One buffer ramps the gain down; allow a few more before giving up on a stalled callback.
+    double bufferMs = streamSampleRate_ > 0 ? 1000.0 * streamBufferFrames_ / streamSampleRate_ : 0.0;
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::max(20, static_cast<int>(bufferMs * 4.0)));
+    while (!callbackData.faded.load(std::memory_order_acquire) && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    // The callback that reports faded has finished with the input taps, and
+    // having read the zero gain, every later one sees feedDetector cleared.
+    return callbackData.faded.load(std::memory_order_acquire);
+}
+
+bool AudioManager::reconfigureMonitoringStream(unsigned int inputDeviceId,
+                                               unsigned int outputDeviceId,
+                                               unsigned int sampleRate,
+                                               unsigned int bufferFrames)
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    if (!audio_)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_USE, "Cannot reconfigure stream, AudioManager not initialized.");
+        return false;
+    }
+
+    // Rejected targets leave the current stream alone.
+    RtAudio::DeviceInfo inputInfo = getDeviceInfo(inputDeviceId);
+    RtAudio::DeviceInfo outputInfo = getDeviceInfo(outputDeviceId);
+    if (inputInfo.inputChannels == 0 || outputInfo.outputChannels == 0)
+    {
+        defaultErrorCallback(RTAUDIO_INVALID_PARAMETER, "Reconfigure target devices lack input or output channels.");
+        return false;
+    }
+
+    const StreamConfig previous = currentStreamConfig();
+    if (!isStreamRunning() || !callbackData_)
+    {
+        closeStream();
+        if (openMonitoringStream(inputDeviceId, outputDeviceId, sampleRate, bufferFrames) && startStream())
+        {
+            return true;
+        }
+        restoreStream(previous);
+        return false;
+    }
+
+    if (inputDeviceId == streamInputDeviceId_ && outputDeviceId == streamOutputDeviceId_ &&
+        sampleRate == streamSampleRate_ && bufferFrames == streamRequestedBufferFrames_)
+    {
+        return true;
+    }
+
+    // The hot-swap target is whichever instance is idle; a standby probed by the
+    // device monitor replaces it so the switch does not wait on a probe.
+    unsigned int nextInputId = 0;
+    unsigned int nextOutputId = 0;
+    std::unique_ptr<RtAudio> &idle = streamOnSpare_ ? audio_ : spareAudio_;
+    RtAudio::DeviceInfo standbyInput;
+    RtAudio::DeviceInfo standbyOutput;
+    if (takeStandbyInstance(idle, inputInfo.name, outputInfo.name, standbyInput, standbyOutput))
+    {
+        nextInputId = standbyInput.ID;
+        nextOutputId = standbyOutput.ID;
+    }
+    RtAudio *next = nextInputId != 0 ? idle.get() : acquireIdleInstance();
+    if (!next)
+    {
+        closeStream();
+        if (openMonitoringStream(inputDeviceId, outputDeviceId, sampleRate, bufferFrames) && startStream())
+        {
+            return true;
+        }
+        restoreStream(previous);
+        return false;
+    }
+
+    // --- Analysis Pipeline ---
+    // The detector accumulates arbitrary block sizes, so it only has to be rebuilt for a new sample rate.
+    std::unique_ptr<PitchDetector> nextDetector;
+    PitchDetector *detector = pitch_detector_.get();
+    if (!detector || sampleRate != streamSampleRate_)
+    {
+        unsigned int hopSize = detector ? detector->hopSize() : std::max(1u, bufferFrames);
+        try
+        {
+            nextDetector = std::make_unique<PitchDetector>(hopSize, hopSize, sampleRate);
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << "Error initializing PitchDetector: " << e.what() << std::endl;
+            return false;
+        }
+        detector = nextDetector.get();
+    }
+
+    auto nextCallback = std::make_unique<AudioCallbackData>();
+    nextCallback->inputChannels = 1;
+    nextCallback->outputChannels = (outputInfo.outputChannels >= 2) ? 2 : 1;
+    nextCallback->pitchDetector = detector;
+    nextCallback->recorder = takeRecorder_;
+    nextCallback->capture = sessionCapture_;
+    nextCallback->feedDetector.store(false);
+    nextCallback->gain = 0.0f;
+
+    // --- Make Before Break ---
+    if (nextInputId == 0 && !mapDeviceIds(*next, inputDeviceId, outputDeviceId, nextInputId, nextOutputId))
+    {
+        return false;
+    }
+    unsigned int actualBufferFrames = bufferFrames;
+    bool overlapped = openStreamOn(*next, nextInputId, nextOutputId, sampleRate, actualBufferFrames, *nextCallback);
+    if (!overlapped)
+    {
+        // Exclusive backends (e.g. ALSA hw devices) refuse a second open; fall back to break-before-make.
+        std::cout << "Overlapping stream open failed, switching with a short gap instead." << std::endl;
+        fadeOutStream(*callbackData_);
+        if (!nextDetector)
+        {
+            nextDetector = std::move(pitch_detector_);
+        }
+        closeStream();
+        actualBufferFrames = bufferFrames;
+        if (!openStreamOn(*next, nextInputId, nextOutputId, sampleRate, actualBufferFrames, *nextCallback))
+        {
+            restoreStream(previous);
+            return false;
+        }
+    }
+
+    RtAudioErrorType result = RTAUDIO_NO_ERROR;
+    try
+    {
+        result = next->startStream();
+    }
+    catch (const std::exception &e)
+    {
+        defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception during startStream: " + std::string(e.what()));
+        result = RTAUDIO_SYSTEM_ERROR;
+    }
+    if (result != RTAUDIO_NO_ERROR)
+    {
+        std::cerr << "RtAudio startStream failed on reconfigure with code: " << result << std::endl;
+        next->closeStream();
+        if (!overlapped)
+        {
+            restoreStream(previous);
+        }
+        return false;
+    }
+
+    // --- Hand Over ---
+    if (overlapped)
+    {
+        // A stalled callback may still be inside the detector or the recorder; it
+        // is only safe to let the new stream feed them once the old one is
+        // stopped, since stopStream waits for its callback to return.
+        const bool faded = fadeOutStream(*callbackData_);
+        if (faded)
+        {
+            nextCallback->feedDetector.store(true, std::memory_order_release);
+        }
+        try
+        {
+            RtAudio *previous = streamInstance();
+            if (previous && previous->isStreamOpen())
+            {
+                previous->stopStream();
+                previous->closeStream();
+            }
+        }
+        catch (const std::exception &e)
+        {
+            defaultErrorCallback(RTAUDIO_SYSTEM_ERROR, "Exception closing previous stream: " + std::string(e.what()));
+        }
+        if (!faded)
+        {
+            std::cerr << "Previous stream did not fade out in time; handed over after closing it." << std::endl;
+            nextCallback->feedDetector.store(true, std::memory_order_release);
+        }
+    }
+    else
+    {
+        nextCallback->feedDetector.store(true, std::memory_order_release);
+    }
+
+    // The old stream is closed now, so its callback data and detector can go.
+    callbackData_ = std::move(nextCallback);
+    if (nextDetector)
+    {
+        pitch_detector_ = std::move(nextDetector);
+    }
+    streamOnSpare_ = next == spareAudio_.get();
+    streamInputChannels_ = callbackData_->inputChannels;
+    streamOutputChannels_ = callbackData_->outputChannels;
+    streamInputDeviceId_ = inputDeviceId;
+    streamOutputDeviceId_ = outputDeviceId;
+    streamSampleRate_ = sampleRate;
+    streamRequestedBufferFrames_ = bufferFrames;
+    streamBufferFrames_ = actualBufferFrames;
+    streamIsOpen_ = true;
+    streamIsRunning_ = true;
+    std::cout << "Stream reconfigured" << (overlapped ? " without a gap" : "") << ". Actual buffer size: "
+              << streamBufferFrames_ << std::endl;
+    return true;
+}
+
+AudioManager::StreamConfig AudioManager::currentStreamConfig() const
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    StreamConfig config;
+    config.open = isStreamOpen();
+    config.running = isStreamRunning();
+    config.inputDeviceId = streamInputDeviceId_;
+    config.outputDeviceId = streamOutputDeviceId_;
+    config.sampleRate = streamSampleRate_;
+    config.bufferFrames = streamRequestedBufferFrames_;
+    return config;
+}
+
+void AudioManager::restoreStream(const StreamConfig &previous)
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    closeStream();
+    if (!previous.open)
+    {
+        return;
+    }
+    std::cerr << "Reconfigure failed, reopening the previous stream." << std::endl;
+    if (!openMonitoringStream(previous.inputDeviceId, previous.outputDeviceId, previous.sampleRate, previous.bufferFrames) ||
+        (previous.running && !startStream()))
+    {
+        std::cerr << "Could not reopen the previous stream." << std::endl;
+    }
+}
+
 bool AudioManager::startStream()
 {
-    if (!audio_ || !streamIsOpen_)
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    RtAudio *audio = streamInstance();
+    if (!audio || !streamIsOpen_)
     {
         defaultErrorCallback(RTAUDIO_INVALID_USE, "Cannot start stream, stream not open.");
         return false;
@@ -401,7 +958,7 @@ bool AudioManager::startStream()
     RtAudioErrorType result = RTAUDIO_NO_ERROR;
     try
     {
-        result = audio_->startStream();
+        result = audio->startStream();
     }
     catch (const std::exception &e)
     {
@@ -425,7 +982,9 @@ bool AudioManager::startStream()
 
 bool AudioManager::stopStream()
 {
-    if (!audio_ || !streamIsOpen_)
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    RtAudio *audio = streamInstance();
+    if (!audio || !streamIsOpen_)
         return true;
     if (!streamIsRunning_)
         return true;
@@ -434,7 +993,7 @@ bool AudioManager::stopStream()
     std::cout << "Attempting to stop stream..." << std::endl;
     try
     {
-        result = audio_->stopStream();
+        result = audio->stopStream();
     }
     catch (const std::exception &e)
     {
@@ -458,23 +1017,26 @@ bool AudioManager::stopStream()
 
 void AudioManager::closeStream()
 {
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
     if (!audio_ && !pitch_detector_)
         return;
 
+    RtAudio *audio = streamInstance();
+
     // Check RtAudio stream state first
     bool wasStreamOpen = false;
     try
     {
-        if (audio_ && audio_->isStreamOpen())
+        if (audio && audio->isStreamOpen())
         {
             wasStreamOpen = true;
-            if (audio_->isStreamRunning())
+            if (audio->isStreamRunning())
             {
                 std::cout << "Stream is running, stopping it before closing..." << std::endl;
-                audio_->stopStream();
+                audio->stopStream();
             }
             std::cout << "Closing RtAudio stream..." << std::endl;
-            audio_->closeStream();
+            audio->closeStream();
         }
     }
     catch (const std::exception &e)
@@ -484,10 +1046,12 @@ void AudioManager::closeStream()
 
     // Destroy the pitch detector after the stream is closed or confirmed closed
     pitch_detector_.reset();
+    callbackData_.reset();
     if (wasStreamOpen)
         std::cout << "PitchDetector destroyed." << std::endl;
 
     // Reset internal state flags
+    streamOnSpare_ = false;
     streamIsOpen_ = false;
     streamIsRunning_ = false;
     if (wasStreamOpen)
@@ -496,30 +1060,73 @@ void AudioManager::closeStream()
 
 float AudioManager::getLatestPitchHz() const
 {
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
     return pitch_detector_ ? pitch_detector_->getPitchHz() : 0.0f;
 }
 
+void AudioManager::setTakeRecorder(TakeRecorder *recorder)
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    takeRecorder_ = recorder;
+}
+
+void AudioManager::setSessionCapture(SessionCaptureWriter *capture)
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    sessionCapture_ = capture;
+}
+
+std::optional<PitchDetectorConfig> AudioManager::getDetectorConfig() const
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    if (!pitch_detector_)
+    {
+        return std::nullopt;
+    }
+    return pitch_detector_->config();
+}
+
+std::optional<std::chrono::steady_clock::time_point> AudioManager::firstCallbackTime() const
+{
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    int64_t ns = callbackData_ ? callbackData_->firstCallbackNs.load(std::memory_order_relaxed) : 0;
+    if (ns == 0)
+    {
+        return std::nullopt;
+    }
+    return std::chrono::steady_clock::time_point(std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::nanoseconds(ns)));
+}
+
 bool AudioManager::isStreamOpen() const
 {
-    return streamIsOpen_ && audio_ && audio_->isStreamOpen(); // Check internal flag and RtAudio's state
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    RtAudio *audio = streamInstance();
+    return streamIsOpen_ && audio && audio->isStreamOpen(); // Check internal flag and RtAudio's state
 }
 
 bool AudioManager::isStreamRunning() const
 {
-    return streamIsRunning_ && audio_ && audio_->isStreamRunning(); // Check internal flag and RtAudio's state
+    std::lock_guard<std::recursive_mutex> lock(apiMutex_);
+    RtAudio *audio = streamInstance();
+    return streamIsRunning_ && audio && audio->isStreamRunning(); // Check internal flag and RtAudio's state
 }
 
 RtAudio::Api AudioManager::getCurrentApi() const
 {
-    return audio_ ? actualApi_ : RtAudio::Api::UNSPECIFIED;
+    // The constructor throws rather than leave the manager without an instance.
+    return actualApi_;
 }
 
 unsigned int AudioManager::getDefaultInputDeviceId() const
 {
-    return audio_ ? audio_->getDefaultInputDevice() : 0;
+    std::optional<RtAudio::DeviceInfo> info = findKnownDevice([](const RtAudio::DeviceInfo &device)
+                                                              { return device.isDefaultInput; });
+    return info ? info->ID : 0;
 }
 
 unsigned int AudioManager::getDefaultOutputDeviceId() const
 {
-    return audio_ ? audio_->getDefaultOutputDevice() : 0;
+    std::optional<RtAudio::DeviceInfo> info = findKnownDevice([](const RtAudio::DeviceInfo &device)
+                                                              { return device.isDefaultOutput; });
+    return info ? info->ID : 0;
 }
@@ -6,44 +6,82 @@
 #include <memory>
 #include <functional>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
 #include <rtaudio/RtAudio.h>
 
 #include "PitchDetector.h"
 
 // Forward declare PitchDetector
 class PitchDetector;
+class TakeRecorder;
+class SessionCaptureWriter;
 
 struct AudioCallbackData {
     unsigned int inputChannels = 0;
     unsigned int outputChannels = 0;
     PitchDetector* pitchDetector = nullptr; // Detector pointer 
+    // Hot-swap state: only one stream feeds the detector, and the monitor
+    // output ramps towards targetGain over one buffer.
+    std::atomic<bool> feedDetector{true};
+    std::atomic<float> targetGain{1.0f};
+    std::atomic<bool> faded{false};
+    float gain = 1.0f; // Audio thread only
+    std::atomic<int64_t> firstCallbackNs{0}; // steady_clock time of the first callback, for startup timing
+    TakeRecorder* recorder = nullptr;          // Input taps; owned by the caller and outlive the stream
+    SessionCaptureWriter* capture = nullptr;
 };
 
 class AudioManager {
 public:
     explicit AudioManager(RtAudio::Api api = RtAudio::Api::UNSPECIFIED);
     
-    ~AudioManager() = default;
+    ~AudioManager();
     AudioManager(const AudioManager&) = delete;
     AudioManager& operator=(const AudioManager&) = delete;
-    AudioManager(AudioManager&&) = default;
-    AudioManager& operator=(AudioManager&&) = default;
+    AudioManager(AudioManager&&) = delete;
+    AudioManager& operator=(AudioManager&&) = delete;
 
     // --- Device Info / Listing ---
+    // Devices are probed on a dedicated RtAudio instance under its own lock, so a
+    // device monitor may rescan from a worker thread without stalling stream
+    // changes. getDeviceInfo and the defaults answer from the last probe.
     bool listDevices() const;
     // Returns compiled APIs that can be instantiated on this machine.
     static std::vector<RtAudio::Api> getAvailableApis();
     std::vector<unsigned int> getDeviceIds() const;
     RtAudio::DeviceInfo getDeviceInfo(unsigned int deviceId) const;
+    // Probes a spare stream instance so the next stream open or hot-swap can map
+    // device names to its IDs without probing on the caller's thread. The device
+    // monitor calls this after each rescan; it is cheap while the list is unchanged.
+    void prepareStandbyInstance();
 
     // --- Stream Management ---
     bool openMonitoringStream(unsigned int inputDeviceId,
                               unsigned int outputDeviceId,
                               unsigned int sampleRate = 44100,
                               unsigned int bufferFrames = 256);
+    // Startup fast path: opens devices by name after a single probe of the stream
+    // instance (none once a standby is prepared), without waiting for enumeration.
+    // getDeviceIds is not needed first.
+    bool openMonitoringStreamByName(const std::string &inputDeviceName,
+                                    const std::string &outputDeviceName,
+                                    unsigned int sampleRate,
+                                    unsigned int bufferFrames);
     bool startStream();
     bool stopStream();
     void closeStream();
+    // Moves a running stream to new devices/rate/buffer. The replacement stream is
+    // opened and started before the old one is closed (when the backend allows the
+    // devices to be opened twice), the monitor output crossfades over one buffer,
+    // and the PitchDetector is kept unless the sample rate changes. A switch that
+    // fails after the old stream was closed reopens the previous configuration.
+    bool reconfigureMonitoringStream(unsigned int inputDeviceId,
+                                     unsigned int outputDeviceId,
+                                     unsigned int sampleRate,
+                                     unsigned int bufferFrames);
     bool isStreamOpen() const;
     bool isStreamRunning() const;
 
@@ -53,10 +91,25 @@ public:
     unsigned int getDefaultOutputDeviceId() const;
     // Get pitch directly from the detector
     float getLatestPitchHz() const;
+    unsigned int getStreamSampleRate() const { return streamSampleRate_; }
+    unsigned int getStreamInputChannels() const { return streamInputChannels_; }
+    // Taps the input of every stream opened from now on. The recorder must outlive them.
+    void setTakeRecorder(TakeRecorder *recorder);
+    void setSessionCapture(SessionCaptureWriter *capture);
+    // Configuration of the live detector, for session capture headers.
+    std::optional<PitchDetectorConfig> getDetectorConfig() const;
+    // When the current stream delivered its first buffer, if it has yet.
+    std::optional<std::chrono::steady_clock::time_point> firstCallbackTime() const;
 
 private:
     // --- Private Members ---
-    std::unique_ptr<RtAudio> audio_;
+    std::unique_ptr<RtAudio> audio_;       // Stream instance
+    std::unique_ptr<RtAudio> spareAudio_;  // Second stream instance used to overlap streams during a hot-swap
+    mutable std::unique_ptr<RtAudio> probeAudio_; // Enumeration instance; device IDs are reported from here
+    mutable std::optional<std::vector<RtAudio::DeviceInfo>> devices_; // Result of the last probe
+    std::unique_ptr<RtAudio> standbyAudio_; // Idle instance probed by the device monitor, swapped in on the next open
+    std::optional<std::vector<RtAudio::DeviceInfo>> standbyDevices_; // Its probe; unset until probed
+    bool streamOnSpare_ = false;           // Which instance currently owns the stream
     std::unique_ptr<PitchDetector> pitch_detector_;
     RtAudio::Api selectedApi_;
     RtAudio::Api actualApi_;
@@ -67,8 +120,58 @@ private:
     unsigned int streamOutputChannels_ = 0;
     unsigned int streamSampleRate_ = 0;
     unsigned int streamBufferFrames_ = 0;
+    unsigned int streamRequestedBufferFrames_ = 0;
+    unsigned int streamInputDeviceId_ = 0;
+    unsigned int streamOutputDeviceId_ = 0;
 
-    AudioCallbackData callbackData_;
+    std::unique_ptr<AudioCallbackData> callbackData_;
+    TakeRecorder *takeRecorder_ = nullptr;
+    SessionCaptureWriter *sessionCapture_ = nullptr;
+    mutable std::recursive_mutex apiMutex_; // Guards the stream instances and stream state, not the audio callback
+    mutable std::mutex probeMutex_;         // Guards probeAudio_; may be taken while holding apiMutex_, never the reverse
+    mutable std::mutex devicesMutex_;       // Guards devices_; never held across a probe
+    mutable std::mutex standbyMutex_;       // Guards the standby instance; never held across a probe
+
+    // Devices and rate of the open stream, kept so a failed reconfigure can go back to them.
+    struct StreamConfig
+    {
+        bool open = false;
+        bool running = false;
+        unsigned int inputDeviceId = 0;
+        unsigned int outputDeviceId = 0;
+        unsigned int sampleRate = 0;
+        unsigned int bufferFrames = 0;
+    };
+
+    RtAudio *streamInstance() const { return streamOnSpare_ ? spareAudio_.get() : audio_.get(); }
+    StreamConfig currentStreamConfig() const;
+    // Closes whatever a failed reconfigure left open and reopens the previous stream.
+    void restoreStream(const StreamConfig &previous);
+    std::vector<RtAudio::DeviceInfo> probeDevices() const;
+    std::vector<RtAudio::DeviceInfo> knownDevices() const;
+    // First device of the last probe (probing if there is none yet) that matches.
+    std::optional<RtAudio::DeviceInfo> findKnownDevice(const std::function<bool(const RtAudio::DeviceInfo &)> &match) const;
+    RtAudio *acquireIdleInstance();
+    bool takeStandbyInstance(std::unique_ptr<RtAudio> &slot, const std::string &inputName, const std::string &outputName,
+                             RtAudio::DeviceInfo &inputInfo, RtAudio::DeviceInfo &outputInfo);
+    bool mapDeviceIds(RtAudio &target, unsigned int inputDeviceId, unsigned int outputDeviceId,
+                      unsigned int &targetInputId, unsigned int &targetOutputId) const;
+    bool openPrimaryStream(unsigned int streamInputId,
+                           unsigned int streamOutputId,
+                           unsigned int outputChannels,
+                           unsigned int inputDeviceId,
+                           unsigned int outputDeviceId,
+                           unsigned int sampleRate,
+                           unsigned int bufferFrames);
+    bool openStreamOn(RtAudio &audio,
+                      unsigned int inputDeviceId,
+                      unsigned int outputDeviceId,
+                      unsigned int sampleRate,
+                      unsigned int &bufferFrames,
+                      AudioCallbackData &callbackData);
+    // Stops the stream feeding the input taps and ramps its output to silence.
+    // False when the callback did not acknowledge before the timeout.
+    bool fadeOutStream(AudioCallbackData &callbackData) const;
 
     // --- Static Callbacks ---
     static void defaultErrorCallback(RtAudioErrorType type, const std::string &errorText);
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <ctime>
 
 namespace
 {
@@ -15,6 +16,18 @@ namespace
                                    });
         return it != options.end() ? *it : 0u;
     }
+
+    std::optional<unsigned int> findDeviceByName(const std::vector<DeviceEntry> &devices, const std::string &name, bool input)
+    {
+        auto it = std::find_if(devices.begin(), devices.end(), [&](const DeviceEntry &entry)
+                               { return entry.info.name == name &&
+                                        (input ? entry.info.inputChannels > 0 : entry.info.outputChannels > 0); });
+        if (it == devices.end())
+        {
+            return std::nullopt;
+        }
+        return it->id;
+    }
 }
 
 AudioSession::AudioSession(std::vector<int> allowedSampleRates, std::vector<int> allowedBufferSizes)
@@ -30,68 +43,272 @@ AudioSession::AudioSession(std::vector<int> allowedSampleRates, std::vector<int>
     }
 }
 
-void AudioSession::refreshDevices(RtAudio::Api api)
+void AudioSession::resetDevices(RtAudio::Api api)
 {
     stopMonitoring(false);
     devices_.clear();
+    ++deviceListVersion_;
     selectedInputDevice_.reset();
     selectedOutputDevice_.reset();
+    restoredInputName_.clear();
+    restoredOutputName_.clear();
     status_.clear();
+    deviceChangeNotice_.clear();
     api_ = api;
+}
+
+void AudioSession::refreshDevices(RtAudio::Api api)
+{
+    resetDevices(api);
+    scanning_ = false;
 
     try
     {
-        manager_ = std::make_unique<AudioManager>(api_);
+        adoptManager(std::make_shared<AudioManager>(api_));
     }
     catch (const std::exception &e)
     {
         status_ = std::string("Audio initialization failed: ") + e.what();
         manager_.reset();
+        deviceMonitor_.stopWatching();
         return;
     }
 
-    for (unsigned int id : manager_->getDeviceIds())
+    std::vector<DeviceEntry> devices = AudioDeviceMonitor::probe(*manager_);
+    adoptDevices(devices, manager_->getDefaultInputDeviceId(), manager_->getDefaultOutputDeviceId());
+    deviceMonitor_.watch(manager_, api_, std::move(devices));
+}
+
+void AudioSession::adoptManager(std::shared_ptr<AudioManager> manager)
+{
+    manager_ = std::move(manager);
+    if (manager_)
     {
-        devices_.push_back(DeviceEntry{id, manager_->getDeviceInfo(id)});
+        manager_->setTakeRecorder(&recorder_);
+        manager_->setSessionCapture(&capture_);
     }
+}
 
-    unsigned int defaultInput = manager_->getDefaultInputDeviceId();
-    unsigned int defaultOutput = manager_->getDefaultOutputDeviceId();
+void AudioSession::refreshDevicesAsync(RtAudio::Api api)
+{
+    resetDevices(api);
+    manager_.reset();
+    scanning_ = true;
+    status_ = "Scanning audio devices...";
+    deviceMonitor_.requestApi(api);
+}
 
-    auto preferDefaultInput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
-                                           { return entry.id == defaultInput && entry.info.inputChannels > 0; });
-    if (preferDefaultInput != devices_.end())
+bool AudioSession::pollDevices()
+{
+    std::optional<DeviceSnapshot> snapshot = deviceMonitor_.poll(seenSnapshotVersion_);
+    if (!snapshot)
+    {
+        return false;
+    }
+    seenSnapshotVersion_ = snapshot->version;
+    if (snapshot->requestedApi != api_)
     {
-        selectedInputDevice_ = preferDefaultInput->id;
+        return false;
     }
-    else
+
+    if (snapshot->manager && snapshot->manager == manager_)
     {
-        auto firstInput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
-                                       { return entry.info.inputChannels > 0; });
-        if (firstInput != devices_.end())
+        // While scanning, this is the deferred list for a stream restored at startup.
+        bool deferred = scanning_;
+        scanning_ = false;
+        if (deferred)
         {
-            selectedInputDevice_ = firstInput->id;
+            selectedInputDevice_ = findDeviceByName(snapshot->devices, restoredInputName_, true);
+            selectedOutputDevice_ = findDeviceByName(snapshot->devices, restoredOutputName_, false);
         }
+        applyHotplug(std::move(snapshot->devices), snapshot->defaultInput, snapshot->defaultOutput, !deferred);
+        if (deferred && monitoring_)
+        {
+            const DeviceEntry *input = selectedInputDevice_ ? findDevice(*selectedInputDevice_) : nullptr;
+            const DeviceEntry *output = selectedOutputDevice_ ? findDevice(*selectedOutputDevice_) : nullptr;
+            if (input && output)
+            {
+                status_ = "Monitoring " + input->info.name + " -> " + output->info.name;
+            }
+        }
+        return true;
+    }
+    if (!scanning_)
+    {
+        // A scan for a manager we have since replaced synchronously.
+        return false;
     }
 
-    auto preferDefaultOutput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
-                                            { return entry.id == defaultOutput && entry.info.outputChannels > 0; });
-    if (preferDefaultOutput != devices_.end())
+    scanning_ = false;
+    if (!snapshot->manager)
     {
-        selectedOutputDevice_ = preferDefaultOutput->id;
+        status_ = "Audio initialization failed: " + snapshot->error;
+        return true;
     }
-    else
+    adoptManager(std::move(snapshot->manager));
+    adoptDevices(std::move(snapshot->devices), snapshot->defaultInput, snapshot->defaultOutput);
+    return true;
+}
+
+bool AudioSession::restoreMonitoring(const AudioConfig &config)
+{
+    if (!config.isUsable() || !config.hasDeviceNames())
+    {
+        return false;
+    }
+
+    resetDevices(config.api);
+    scanning_ = false;
+    try
+    {
+        adoptManager(std::make_shared<AudioManager>(api_));
+    }
+    catch (const std::exception &e)
     {
-        auto firstOutput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
-                                        { return entry.info.outputChannels > 0; });
-        if (firstOutput != devices_.end())
+        status_ = std::string("Audio initialization failed: ") + e.what();
+        manager_.reset();
+        return false;
+    }
+
+    // Enumeration runs on its own RtAudio instance, so it overlaps the stream open.
+    deviceMonitor_.watch(manager_, api_, {});
+    deviceMonitor_.requestRescan();
+
+    // The saved IDs came from another process's probe; only the names still hold.
+    sampleRate_ = config.sampleRate;
+    bufferFrames_ = config.bufferFrames;
+    if (!manager_->openMonitoringStreamByName(config.inputDeviceName, config.outputDeviceName, sampleRate_, requestedBufferFrames()) ||
+        !manager_->startStream())
+    {
+        manager_->closeStream();
+        deviceMonitor_.stopWatching();
+        manager_.reset();
+        return false;
+    }
+
+    restoredInputName_ = config.inputDeviceName;
+    restoredOutputName_ = config.outputDeviceName;
+    monitoring_ = true;
+    scanning_ = true;
+    status_ = "Monitoring saved devices. Scanning for others...";
+    return true;
+}
+
+std::optional<std::chrono::steady_clock::time_point> AudioSession::firstCallbackTime() const
+{
+    return manager_ ? manager_->firstCallbackTime() : std::nullopt;
+}
+
+void AudioSession::adoptDevices(std::vector<DeviceEntry> devices, unsigned int defaultInput, unsigned int defaultOutput)
+{
+    devices_ = std::move(devices);
+    ++deviceListVersion_;
+    selectDefaultDevices(defaultInput, defaultOutput, true, true);
+    autoDetectPreferredStreamSettings();
+    updateReadyStatus();
+}
+
+void AudioSession::applyHotplug(std::vector<DeviceEntry> devices, unsigned int defaultInput, unsigned int defaultOutput, bool announce)
+{
+    auto containsName = [](const std::vector<DeviceEntry> &list, const std::string &name)
+    {
+        return std::any_of(list.begin(), list.end(), [&](const DeviceEntry &entry)
+                           { return entry.info.name == name; });
+    };
+
+    std::string notice;
+    for (const DeviceEntry &entry : devices)
+    {
+        if (!containsName(devices_, entry.info.name))
+        {
+            notice += (notice.empty() ? "" : "; ") + std::string("Connected: ") + entry.info.name;
+        }
+    }
+    for (const DeviceEntry &entry : devices_)
+    {
+        if (!containsName(devices, entry.info.name))
         {
-            selectedOutputDevice_ = firstOutput->id;
+            notice += (notice.empty() ? "" : "; ") + std::string("Disconnected: ") + entry.info.name;
         }
     }
 
-    autoDetectPreferredStreamSettings();
+    devices_ = std::move(devices);
+    ++deviceListVersion_;
+    if (announce && !notice.empty())
+    {
+        deviceChangeNotice_ = notice;
+    }
+
+    // Surviving selections are kept so the running stream is left alone; only a
+    // device that vanished is replaced by the current default.
+    bool inputLost = selectedInputDevice_.has_value() && !trySelectInputDevice(*selectedInputDevice_, false);
+    bool outputLost = selectedOutputDevice_.has_value() && !trySelectOutputDevice(*selectedOutputDevice_, false);
+    if (inputLost)
+    {
+        selectedInputDevice_.reset();
+    }
+    if (outputLost)
+    {
+        selectedOutputDevice_.reset();
+    }
+    bool pickInput = !selectedInputDevice_.has_value();
+    bool pickOutput = !selectedOutputDevice_.has_value();
+    selectDefaultDevices(defaultInput, defaultOutput, pickInput, pickOutput);
+
+    if (monitoring_ && (inputLost || outputLost))
+    {
+        status_ = "Monitored device disconnected. Restart monitoring to switch devices.";
+    }
+    else if (!monitoring_ && (pickInput || pickOutput))
+    {
+        autoDetectPreferredStreamSettings();
+        updateReadyStatus();
+    }
+}
 
+void AudioSession::selectDefaultDevices(unsigned int defaultInput, unsigned int defaultOutput, bool pickInput, bool pickOutput)
+{
+    if (pickInput)
+    {
+        auto preferDefaultInput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
+                                               { return entry.id == defaultInput && entry.info.inputChannels > 0; });
+        if (preferDefaultInput != devices_.end())
+        {
+            selectedInputDevice_ = preferDefaultInput->id;
+        }
+        else
+        {
+            auto firstInput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
+                                           { return entry.info.inputChannels > 0; });
+            if (firstInput != devices_.end())
+            {
+                selectedInputDevice_ = firstInput->id;
+            }
+        }
+    }
+
+    if (pickOutput)
+    {
+        auto preferDefaultOutput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
+                                                { return entry.id == defaultOutput && entry.info.outputChannels > 0; });
+        if (preferDefaultOutput != devices_.end())
+        {
+            selectedOutputDevice_ = preferDefaultOutput->id;
+        }
+        else
+        {
+            auto firstOutput = std::find_if(devices_.begin(), devices_.end(), [&](const DeviceEntry &entry)
+                                            { return entry.info.outputChannels > 0; });
+            if (firstOutput != devices_.end())
+            {
+                selectedOutputDevice_ = firstOutput->id;
+            }
+        }
+    }
+}
+
+void AudioSession::updateReadyStatus()
+{
     if (devices_.empty())
     {
         status_ = "No audio devices found for this API.";
@@ -110,17 +327,18 @@ void AudioSession::refreshDevices(RtAudio::Api api)
     }
     else
     {
-        RtAudio::DeviceInfo inputInfo = manager_->getDeviceInfo(*selectedInputDevice_);
-        RtAudio::DeviceInfo outputInfo = manager_->getDeviceInfo(*selectedOutputDevice_);
-        status_ = "Ready. Input: " + inputInfo.name + " / Output: " + outputInfo.name;
+        const DeviceEntry *input = findDevice(*selectedInputDevice_);
+        const DeviceEntry *output = findDevice(*selectedOutputDevice_);
+        status_ = "Ready. Input: " + (input ? input->info.name : std::string()) +
+                  " / Output: " + (output ? output->info.name : std::string());
     }
 }
 
-bool AudioSession::startMonitoring()
+bool AudioSession::checkSelectedDevices(RtAudio::DeviceInfo &inputInfo, RtAudio::DeviceInfo &outputInfo)
 {
     if (!manager_)
     {
-        status_ = "Audio stack is not ready.";
+        status_ = scanning_ ? "Still scanning audio devices..." : "Audio stack is not ready.";
         return false;
     }
     if (!selectedInputDevice_.has_value())
@@ -135,8 +353,16 @@ bool AudioSession::startMonitoring()
         return false;
     }
 
-    RtAudio::DeviceInfo inputInfo = manager_->getDeviceInfo(*selectedInputDevice_);
-    RtAudio::DeviceInfo outputInfo = manager_->getDeviceInfo(*selectedOutputDevice_);
+    // Use the cached list; probing the backend here would stall the frame.
+    const DeviceEntry *input = findDevice(*selectedInputDevice_);
+    const DeviceEntry *output = findDevice(*selectedOutputDevice_);
+    if (!input || !output)
+    {
+        status_ = "Selected device is no longer available.";
+        return false;
+    }
+    inputInfo = input->info;
+    outputInfo = output->info;
     if (inputInfo.inputChannels == 0)
     {
         status_ = "Selected device has no input channels.";
@@ -147,14 +373,28 @@ bool AudioSession::startMonitoring()
         status_ = "Selected output has no output channels.";
         return false;
     }
+    return true;
+}
+
+unsigned int AudioSession::requestedBufferFrames() const
+{
+    if (manager_ && manager_->getCurrentApi() == RtAudio::Api::UNIX_JACK)
+    {
+        return 0;
+    }
+    return bufferFrames_;
+}
 
-    unsigned int requestedBuffer = bufferFrames_;
-    if (manager_->getCurrentApi() == RtAudio::Api::UNIX_JACK)
+bool AudioSession::startMonitoring()
+{
+    RtAudio::DeviceInfo inputInfo;
+    RtAudio::DeviceInfo outputInfo;
+    if (!checkSelectedDevices(inputInfo, outputInfo))
     {
-        requestedBuffer = 0;
+        return false;
     }
 
-    if (!manager_->openMonitoringStream(*selectedInputDevice_, *selectedOutputDevice_, sampleRate_, requestedBuffer))
+    if (!manager_->openMonitoringStream(*selectedInputDevice_, *selectedOutputDevice_, sampleRate_, requestedBufferFrames()))
     {
         status_ = "Failed to open the audio stream.";
         return false;
@@ -168,11 +408,55 @@ bool AudioSession::startMonitoring()
 
     status_ = "Monitoring " + inputInfo.name + " -> " + outputInfo.name;
     monitoring_ = true;
+    // The open consumed the standby instance; have the monitor probe the next one.
+    deviceMonitor_.requestRescan();
+    return true;
+}
+
+bool AudioSession::reconfigureMonitoring()
+{
+    if (!manager_ || !manager_->isStreamRunning())
+    {
+        stopMonitoring(false);
+        return startMonitoring();
+    }
+
+    RtAudio::DeviceInfo inputInfo;
+    RtAudio::DeviceInfo outputInfo;
+    if (!checkSelectedDevices(inputInfo, outputInfo))
+    {
+        return false;
+    }
+
+    if (recorder_.recording() && sampleRate_ != manager_->getStreamSampleRate())
+    {
+        // A take has a single sample rate; close it rather than mixing rates in one file.
+        stopRecording();
+    }
+    if (capture_.capturing())
+    {
+        // The capture header describes one stream and detector setup.
+        stopCapture();
+    }
+    if (!manager_->reconfigureMonitoringStream(*selectedInputDevice_, *selectedOutputDevice_, sampleRate_, requestedBufferFrames()))
+    {
+        monitoring_ = manager_->isStreamRunning();
+        status_ = monitoring_ ? "Could not switch the audio stream; kept the previous one."
+                              : "Failed to reopen the audio stream.";
+        return false;
+    }
+
+    status_ = "Monitoring " + inputInfo.name + " -> " + outputInfo.name;
+    monitoring_ = true;
+    // The open consumed the standby instance; have the monitor probe the next one.
+    deviceMonitor_.requestRescan();
     return true;
 }
 
 void AudioSession::stopMonitoring(bool clearStatus)
 {
+    stopRecording();
+    stopCapture();
     if (manager_)
     {
         manager_->stopStream();
@@ -207,6 +491,86 @@ void AudioSession::updatePitch(NoteConverter &noteConverter)
     }
 }
 
+bool AudioSession::startRecording(const std::filesystem::path &path)
+{
+    if (!manager_ || !manager_->isStreamRunning())
+    {
+        status_ = "Start monitoring before recording a take.";
+        return false;
+    }
+
+    std::filesystem::path target = path;
+    if (target.empty())
+    {
+        std::time_t now = std::time(nullptr);
+        char stamp[32] = {};
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+        target = std::filesystem::path("takes") / (std::string("take-") + stamp + ".wav");
+    }
+
+    if (!recorder_.start(target, manager_->getStreamSampleRate(), manager_->getStreamInputChannels()))
+    {
+        status_ = recorder_.status();
+        return false;
+    }
+    status_ = "Recording take to " + target.string();
+    return true;
+}
+
+bool AudioSession::stopRecording()
+{
+    // A failed write ends the take on the writer thread; stop() still finalizes it.
+    if (!recorder_.recording() && !recorder_.writeFailed())
+    {
+        return true;
+    }
+    const bool saved = recorder_.stop();
+    status_ = recorder_.status();
+    return saved;
+}
+
+bool AudioSession::startCapture(const std::filesystem::path &path, float referenceA4)
+{
+    std::optional<PitchDetectorConfig> detector = manager_ ? manager_->getDetectorConfig() : std::nullopt;
+    if (!manager_ || !manager_->isStreamRunning() || !detector)
+    {
+        status_ = "Start monitoring before capturing a session.";
+        return false;
+    }
+
+    CaptureHeader header{};
+    header.audio = currentConfig();
+    header.detector = *detector;
+    header.referenceA4 = referenceA4;
+    header.channels = manager_->getStreamInputChannels();
+
+    std::filesystem::path target = path;
+    if (target.empty())
+    {
+        std::time_t now = std::time(nullptr);
+        char stamp[32] = {};
+        std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", std::localtime(&now));
+        target = std::filesystem::path("captures") / (std::string("session-") + stamp + ".occap");
+    }
+
+    if (!capture_.start(target, header))
+    {
+        status_ = capture_.status();
+        return false;
+    }
+    status_ = "Capturing session to " + target.string();
+    return true;
+}
+
+void AudioSession::stopCapture()
+{
+    if (capture_.capturing())
+    {
+        capture_.stop();
+        status_ = capture_.status();
+    }
+}
+
 void AudioSession::selectInputDevice(unsigned int id, bool autoDetectSettings)
 {
     selectedInputDevice_ = id;
@@ -251,8 +615,16 @@ bool AudioSession::trySelectOutputDevice(unsigned int id, bool autoDetectSetting
 
 bool AudioSession::applyConfig(const AudioConfig &config)
 {
-    bool inputOk = config.inputDeviceId != 0 && trySelectInputDevice(config.inputDeviceId, false);
-    bool outputOk = config.outputDeviceId != 0 && trySelectOutputDevice(config.outputDeviceId, false);
+    // Saved IDs are from an earlier probe; prefer the names when the config has them.
+    unsigned int inputId = config.inputDeviceId;
+    unsigned int outputId = config.outputDeviceId;
+    if (config.hasDeviceNames())
+    {
+        inputId = findDeviceByName(devices_, config.inputDeviceName, true).value_or(0);
+        outputId = findDeviceByName(devices_, config.outputDeviceName, false).value_or(0);
+    }
+    bool inputOk = inputId != 0 && trySelectInputDevice(inputId, false);
+    bool outputOk = outputId != 0 && trySelectOutputDevice(outputId, false);
 
     if (inputOk && outputOk)
     {
@@ -276,6 +648,10 @@ AudioConfig AudioSession::currentConfig() const
     config.api = api_;
     config.inputDeviceId = selectedInputDevice_.value_or(0);
     config.outputDeviceId = selectedOutputDevice_.value_or(0);
+    const DeviceEntry *input = selectedInputDevice_ ? findDevice(*selectedInputDevice_) : nullptr;
+    const DeviceEntry *output = selectedOutputDevice_ ? findDevice(*selectedOutputDevice_) : nullptr;
+    config.inputDeviceName = input ? input->info.name : restoredInputName_;
+    config.outputDeviceName = output ? output->info.name : restoredOutputName_;
     config.sampleRate = sampleRate_;
     config.bufferFrames = bufferFrames_;
     return config;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
 #include <vector>
 #include <optional>
 #include <string>
@@ -9,7 +12,10 @@
 #include <rtaudio/RtAudio.h>
 
 #include "audio/AudioConfig.h"
+#include "audio/AudioDeviceMonitor.h"
 #include "audio/AudioManager.h"
+#include "audio/SessionCapture.h"
+#include "audio/TakeRecorder.h"
 #include "NoteConverter.h"
 
 struct PitchState
@@ -18,23 +24,50 @@ struct PitchState
     NoteInfo note{};
 };
 
-struct DeviceEntry
-{
-    unsigned int id = 0;
-    RtAudio::DeviceInfo info{};
-};
-
 class AudioSession
 {
 public:
     AudioSession(std::vector<int> allowedSampleRates, std::vector<int> allowedBufferSizes);
 
+    // Blocking enumeration; prefer refreshDevicesAsync from the render loop.
     void refreshDevices(RtAudio::Api api);
+    // Queues backend startup and enumeration on the device monitor thread; results
+    // arrive through pollDevices.
+    void refreshDevicesAsync(RtAudio::Api api);
+    // Applies finished scans and hotplug changes. Cheap enough to call every frame;
+    // returns true when the device list changed.
+    bool pollDevices();
+    bool scanning() const { return scanning_; }
+    // Cold-start fast path: opens the saved devices by name after one probe of the
+    // stream instance and leaves the full device list to the monitor thread. Returns
+    // false (leaving the session reset) for configs saved without device names or
+    // when the saved devices are gone.
+    bool restoreMonitoring(const AudioConfig &config);
+    std::optional<std::chrono::steady_clock::time_point> firstCallbackTime() const;
     bool startMonitoring();
+    // Applies the current device/rate/buffer selection to a running stream without
+    // tearing down the analysis pipeline; starts monitoring if it is not running.
+    bool reconfigureMonitoring();
     void stopMonitoring(bool clearStatus);
     void updatePitch(NoteConverter &noteConverter);
 
+    // Records the monitored input; an empty path picks a timestamped file under takes/.
+    bool startRecording(const std::filesystem::path &path = {});
+    // False when the take could not be written completely.
+    bool stopRecording();
+    bool recording() const { return recorder_.recording(); }
+    const TakeRecorder &recorder() const { return recorder_; }
+
+    // Captures raw input blocks plus the stream/detector setup for offline replay.
+    bool startCapture(const std::filesystem::path &path, float referenceA4);
+    void stopCapture();
+    bool capturing() const { return capture_.capturing(); }
+    const SessionCaptureWriter &capture() const { return capture_; }
+
     const std::vector<DeviceEntry> &devices() const { return devices_; }
+    uint64_t deviceListVersion() const { return deviceListVersion_; }
+    const std::string &deviceChangeNotice() const { return deviceChangeNotice_; }
+    void clearDeviceChangeNotice() { deviceChangeNotice_.clear(); }
     std::optional<unsigned int> selectedInputDevice() const { return selectedInputDevice_; }
     std::optional<unsigned int> selectedOutputDevice() const { return selectedOutputDevice_; }
     void selectInputDevice(unsigned int id, bool autoDetectSettings = true);
@@ -57,10 +90,20 @@ public:
     const std::vector<int> &allowedBufferSizes() const { return allowedBufferSizes_; }
 
 private:
-    std::unique_ptr<AudioManager> manager_;
+    // Declared before manager_ so they outlive any stream tapping them
+    TakeRecorder recorder_;
+    SessionCaptureWriter capture_;
+    std::shared_ptr<AudioManager> manager_;
     std::vector<DeviceEntry> devices_;
+    uint64_t deviceListVersion_ = 0;
+    uint64_t seenSnapshotVersion_ = 0;
+    std::string deviceChangeNotice_;
+    bool scanning_ = false;
     std::optional<unsigned int> selectedInputDevice_;
     std::optional<unsigned int> selectedOutputDevice_;
+    // Devices opened by restoreMonitoring, selected once the deferred list arrives
+    std::string restoredInputName_;
+    std::string restoredOutputName_;
     RtAudio::Api api_ = RtAudio::Api::UNSPECIFIED;
     unsigned int sampleRate_ = 48000;
     unsigned int bufferFrames_ = 1024;
@@ -69,8 +112,17 @@ private:
     PitchState pitch_{};
     std::vector<int> allowedSampleRates_;
     std::vector<int> allowedBufferSizes_;
+    AudioDeviceMonitor deviceMonitor_;
 
+    void resetDevices(RtAudio::Api api);
+    void adoptManager(std::shared_ptr<AudioManager> manager);
+    void adoptDevices(std::vector<DeviceEntry> devices, unsigned int defaultInput, unsigned int defaultOutput);
+    void applyHotplug(std::vector<DeviceEntry> devices, unsigned int defaultInput, unsigned int defaultOutput, bool announce);
+    void selectDefaultDevices(unsigned int defaultInput, unsigned int defaultOutput, bool pickInput, bool pickOutput);
+    void updateReadyStatus();
     const DeviceEntry *findDevice(unsigned int id) const;
+    bool checkSelectedDevices(RtAudio::DeviceInfo &inputInfo, RtAudio::DeviceInfo &outputInfo);
+    unsigned int requestedBufferFrames() const;
     void autoDetectPreferredStreamSettings();
     unsigned int choosePreferredSampleRate(const RtAudio::DeviceInfo &inputInfo, const RtAudio::DeviceInfo &outputInfo) const;
     unsigned int choosePreferredBufferFrames(unsigned int sampleRate) const;
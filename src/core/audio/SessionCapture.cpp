@@ -0,0 +1,266 @@
+#include "audio/SessionCapture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+    // File layout (host byte order, little-endian on every platform we ship):
+    //   magic[8] "OCCAP\0\0\1", header fields, then repeated blocks of
+    //   double streamTime | uint32 frames | float samples[frames * channels]
+    constexpr char kMagic[8] = {'O', 'C', 'C', 'A', 'P', '\0', '\0', '\1'};
+    constexpr std::size_t kBlockHeaderBytes = sizeof(double) + sizeof(uint32_t);
+    constexpr std::size_t kWriteChunkBytes = std::size_t(1) << 18;
+
+    template <typename T>
+    void writePod(std::ofstream &out, const T &value)
+    {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readPod(std::ifstream &in, T &value)
+    {
+        in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        return static_cast<std::size_t>(in.gcount()) == sizeof(T);
+    }
+}
+
+SessionCaptureWriter::SessionCaptureWriter(std::size_t ringBytes) : ring_(ringBytes)
+{
+}
+
+SessionCaptureWriter::~SessionCaptureWriter()
+{
+    stop();
+}
+
+bool SessionCaptureWriter::start(const std::filesystem::path &path, const CaptureHeader &header)
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (capturing_.load(std::memory_order_acquire))
+    {
+        error_ = "Already capturing.";
+        return false;
+    }
+    if (header.channels == 0 || header.detector.sampleRate == 0)
+    {
+        error_ = "No active audio stream to capture.";
+        return false;
+    }
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_.good())
+    {
+        error_ = "Cannot open " + path.string() + " for writing.";
+        out_.close();
+        return false;
+    }
+
+    out_.write(kMagic, sizeof(kMagic));
+    writePod(out_, static_cast<int32_t>(header.audio.api));
+    writePod(out_, static_cast<uint32_t>(header.audio.inputDeviceId));
+    writePod(out_, static_cast<uint32_t>(header.audio.outputDeviceId));
+    writePod(out_, static_cast<uint32_t>(header.audio.sampleRate));
+    writePod(out_, static_cast<uint32_t>(header.audio.bufferFrames));
+    writePod(out_, static_cast<uint32_t>(header.detector.bufferSize));
+    writePod(out_, static_cast<uint32_t>(header.detector.hopSize));
+    writePod(out_, static_cast<uint32_t>(header.detector.sampleRate));
+    writePod(out_, static_cast<uint32_t>(header.detector.method.size()));
+    out_.write(header.detector.method.data(), static_cast<std::streamsize>(header.detector.method.size()));
+    writePod(out_, header.referenceA4);
+    writePod(out_, header.channels);
+
+    path_ = path;
+    channels_ = header.channels;
+    error_.clear();
+    ring_.clear();
+    blocksCaptured_.store(0, std::memory_order_relaxed);
+    droppedBlocks_.store(0, std::memory_order_relaxed);
+
+    writerRunning_.store(true, std::memory_order_release);
+    writer_ = std::thread(&SessionCaptureWriter::writerLoop, this);
+    capturing_.store(true, std::memory_order_release);
+    return true;
+}
+
+void SessionCaptureWriter::stop()
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    capturing_.store(false, std::memory_order_release);
+    writerRunning_.store(false, std::memory_order_release);
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+    if (out_.is_open())
+    {
+        out_.close();
+        std::cout << "Session capture saved: " << path_.string() << " (" << blocksCaptured() << " blocks, "
+                  << droppedBlocks() << " dropped)" << std::endl;
+    }
+}
+
+void SessionCaptureWriter::push(double streamTime, const float *samples, unsigned int frames)
+{
+    if (!capturing_.load(std::memory_order_acquire) || samples == nullptr || frames == 0)
+    {
+        return;
+    }
+
+    const std::size_t sampleBytes = static_cast<std::size_t>(frames) * channels_ * sizeof(float);
+    if (ring_.writeAvailable() < kBlockHeaderBytes + sampleBytes)
+    {
+        droppedBlocks_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    unsigned char header[kBlockHeaderBytes];
+    uint32_t frameCount = frames;
+    std::memcpy(header, &streamTime, sizeof(double));
+    std::memcpy(header + sizeof(double), &frameCount, sizeof(uint32_t));
+    ring_.write(header, kBlockHeaderBytes);
+    ring_.write(reinterpret_cast<const unsigned char *>(samples), sampleBytes);
+    blocksCaptured_.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string SessionCaptureWriter::status() const
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (!error_.empty())
+    {
+        return error_;
+    }
+    if (path_.empty())
+    {
+        return "Not capturing.";
+    }
+    std::string state = capturing() ? "Capturing " : "Last capture ";
+    return state + path_.filename().string() + ": " + std::to_string(blocksCaptured()) + " blocks, " +
+           std::to_string(droppedBlocks()) + " dropped";
+}
+
+void SessionCaptureWriter::writerLoop()
+{
+    std::vector<unsigned char> chunk(kWriteChunkBytes);
+    for (;;)
+    {
+        bool running = writerRunning_.load(std::memory_order_acquire);
+        std::size_t available = ring_.readAvailable();
+        if (running && available < chunk.size() / 4)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+
+        // Blocks are pushed whole, so the byte stream can be copied without parsing.
+        std::size_t got = ring_.read(chunk.data(), std::min(chunk.size(), available));
+        if (got > 0)
+        {
+            out_.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(got));
+        }
+        if (!running && ring_.readAvailable() == 0)
+        {
+            break;
+        }
+    }
+    out_.flush();
+}
+
+bool readSessionCapture(const std::filesystem::path &path, SessionCaptureData &out, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+    {
+        error = "Cannot open " + path.string();
+        return false;
+    }
+
+    char magic[sizeof(kMagic)] = {};
+    in.read(magic, sizeof(magic));
+    if (in.gcount() != static_cast<std::streamsize>(sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        error = "Not a session capture: " + path.string();
+        return false;
+    }
+
+    CaptureHeader header{};
+    int32_t api = 0;
+    uint32_t values[8] = {};
+    bool ok = readPod(in, api);
+    for (uint32_t &value : values)
+    {
+        ok = ok && readPod(in, value);
+    }
+    if (!ok || values[7] > 256)
+    {
+        error = "Truncated capture header.";
+        return false;
+    }
+    header.audio.api = static_cast<RtAudio::Api>(api);
+    header.audio.inputDeviceId = values[0];
+    header.audio.outputDeviceId = values[1];
+    header.audio.sampleRate = values[2];
+    header.audio.bufferFrames = values[3];
+    header.detector.bufferSize = values[4];
+    header.detector.hopSize = values[5];
+    header.detector.sampleRate = values[6];
+    header.detector.method.resize(values[7]);
+    in.read(header.detector.method.data(), static_cast<std::streamsize>(values[7]));
+    if (!readPod(in, header.referenceA4) || !readPod(in, header.channels) || header.channels == 0)
+    {
+        error = "Truncated capture header.";
+        return false;
+    }
+
+    std::error_code ec;
+    const uint64_t fileBytes = std::filesystem::file_size(path, ec);
+    if (ec)
+    {
+        error = "Cannot size " + path.string();
+        return false;
+    }
+
+    std::vector<CaptureBlock> blocks;
+    for (;;)
+    {
+        CaptureBlock block;
+        uint32_t frames = 0;
+        if (!readPod(in, block.streamTime))
+        {
+            break; // Clean end of file
+        }
+        if (!readPod(in, frames))
+        {
+            break;
+        }
+        // The frame count is untrusted; never allocate more than the file could hold.
+        const uint64_t blockBytes = uint64_t(frames) * header.channels * sizeof(float);
+        const uint64_t offset = static_cast<uint64_t>(in.tellg());
+        if (blockBytes > fileBytes - std::min(offset, fileBytes))
+        {
+            error = "Capture block " + std::to_string(blocks.size()) + " claims " + std::to_string(frames) +
+                    " frames past the end of " + path.string();
+            return false;
+        }
+        block.samples.resize(static_cast<std::size_t>(frames) * header.channels);
+        std::streamsize bytes = static_cast<std::streamsize>(block.samples.size() * sizeof(float));
+        in.read(reinterpret_cast<char *>(block.samples.data()), bytes);
+        if (in.gcount() != bytes)
+        {
+            break;
+        }
+        blocks.push_back(std::move(block));
+    }
+
+    out.header = std::move(header);
+    out.blocks = std::move(blocks);
+    return true;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "audio/AudioConfig.h"
+#include "audio/SpscRingBuffer.h"
+#include "PitchDetector.h"
+
+// Everything needed to rebuild the analysis path a capture was recorded through.
+struct CaptureHeader
+{
+    AudioConfig audio{};
+    PitchDetectorConfig detector{};
+    float referenceA4 = 440.0f;
+    uint32_t channels = 1;
+};
+
+struct CaptureBlock
+{
+    double streamTime = 0.0;
+    std::vector<float> samples; // Interleaved, header.channels per frame
+};
+
+struct SessionCaptureData
+{
+    CaptureHeader header{};
+    std::vector<CaptureBlock> blocks;
+};
+
+// Streams raw input blocks with their stream timestamps to a .occap file. The audio
+// thread serialises each block into a lock-free byte ring; a writer thread drains it.
+// A block that does not fit is dropped whole and counted, so replay never sees a
+// torn block.
+class SessionCaptureWriter
+{
+public:
+    explicit SessionCaptureWriter(std::size_t ringBytes = std::size_t(16) << 20);
+    ~SessionCaptureWriter();
+
+    SessionCaptureWriter(const SessionCaptureWriter &) = delete;
+    SessionCaptureWriter &operator=(const SessionCaptureWriter &) = delete;
+
+    bool start(const std::filesystem::path &path, const CaptureHeader &header);
+    void stop();
+    bool capturing() const { return capturing_.load(std::memory_order_acquire); }
+
+    // Audio thread.
+    void push(double streamTime, const float *samples, unsigned int frames);
+
+    uint64_t blocksCaptured() const { return blocksCaptured_.load(std::memory_order_relaxed); }
+    uint64_t droppedBlocks() const { return droppedBlocks_.load(std::memory_order_relaxed); }
+    std::string status() const;
+
+private:
+    void writerLoop();
+
+    SpscRingBuffer<unsigned char> ring_;
+    std::atomic<bool> capturing_{false};
+    std::atomic<bool> writerRunning_{false};
+    std::atomic<uint64_t> blocksCaptured_{0};
+    std::atomic<uint64_t> droppedBlocks_{0};
+    std::thread writer_;
+    mutable std::mutex controlMutex_;
+    std::filesystem::path path_;
+    std::ofstream out_;
+    uint32_t channels_ = 1;
+    std::string error_;
+};
+
+bool readSessionCapture(const std::filesystem::path &path, SessionCaptureData &out, std::string &error);
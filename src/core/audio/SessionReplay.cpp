@@ -0,0 +1,206 @@
+#include "audio/SessionReplay.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <sstream>
+
+#include "NoteConverter.h"
+#include "PitchDetector.h"
+
+std::vector<PitchSample> replaySessionCapture(const SessionCaptureData &capture)
+{
+    const CaptureHeader &header = capture.header;
+    PitchDetector detector(header.detector.bufferSize, header.detector.hopSize, header.detector.sampleRate,
+                           header.detector.method);
+    NoteConverter converter(header.referenceA4);
+
+    std::vector<PitchSample> timeline;
+    timeline.reserve(capture.blocks.size());
+    for (const CaptureBlock &block : capture.blocks)
+    {
+        uint_t frames = static_cast<uint_t>(block.samples.size() / header.channels);
+        detector.process(block.samples.data(), frames, header.channels);
+
+        PitchSample sample{};
+        sample.streamTime = block.streamTime;
+        sample.pitchHz = detector.getPitchHz();
+        // Same gate AudioSession::updatePitch applies before converting.
+        if (sample.pitchHz > 10.0f)
+        {
+            NoteInfo note = converter.getNoteInfo(sample.pitchHz);
+            sample.midiNote = note.midiNoteNumber;
+            sample.cents = note.cents;
+        }
+        timeline.push_back(sample);
+    }
+    return timeline;
+}
+
+bool writePitchTimeline(const std::filesystem::path &path, const std::vector<PitchSample> &timeline)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out.good())
+    {
+        return false;
+    }
+    out << "# time pitchHz midi cents\n";
+    char line[128];
+    for (const PitchSample &sample : timeline)
+    {
+        std::snprintf(line, sizeof(line), "%.17g %.9g %d %.9g\n", sample.streamTime,
+                      static_cast<double>(sample.pitchHz), sample.midiNote, static_cast<double>(sample.cents));
+        out << line;
+    }
+    return out.good();
+}
+
+std::optional<std::vector<PitchSample>> readPitchTimeline(const std::filesystem::path &path)
+{
+    std::ifstream in(path);
+    if (!in.good())
+    {
+        return std::nullopt;
+    }
+
+    std::vector<PitchSample> timeline;
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (line.empty() || line.front() == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        PitchSample sample{};
+        if (!(iss >> sample.streamTime >> sample.pitchHz >> sample.midiNote >> sample.cents))
+        {
+            return std::nullopt;
+        }
+        timeline.push_back(sample);
+    }
+    return timeline;
+}
+
+TimelineDiff diffPitchTimelines(const std::vector<PitchSample> &expected,
+                                const std::vector<PitchSample> &actual,
+                                float toleranceCents)
+{
+    TimelineDiff diff{};
+    diff.compared = std::min(expected.size(), actual.size());
+    for (std::size_t i = 0; i < diff.compared; ++i)
+    {
+        const PitchSample &e = expected[i];
+        const PitchSample &a = actual[i];
+        bool same = e.streamTime == a.streamTime && e.midiNote == a.midiNote;
+        if (same && toleranceCents <= 0.0f)
+        {
+            same = e.pitchHz == a.pitchHz && e.cents == a.cents;
+        }
+        else if (same && e.pitchHz > 0.0f && a.pitchHz > 0.0f)
+        {
+            same = std::fabs(1200.0f * std::log2(a.pitchHz / e.pitchHz)) <= toleranceCents;
+        }
+        else if (same)
+        {
+            same = e.pitchHz == a.pitchHz;
+        }
+
+        if (!same)
+        {
+            ++diff.mismatches;
+            if (!diff.firstMismatch)
+            {
+                diff.firstMismatch = i;
+            }
+        }
+    }
+    // Missing or extra rows count as mismatches too.
+    std::size_t lengthDelta = expected.size() > actual.size() ? expected.size() - actual.size()
+                                                              : actual.size() - expected.size();
+    if (lengthDelta > 0 && !diff.firstMismatch)
+    {
+        diff.firstMismatch = diff.compared;
+    }
+    diff.mismatches += lengthDelta;
+
+    std::ostringstream summary;
+    summary << diff.mismatches << " mismatching rows out of " << std::max(expected.size(), actual.size());
+    if (diff.firstMismatch)
+    {
+        std::size_t i = *diff.firstMismatch;
+        summary << "; first at row " << i;
+        if (i < expected.size())
+        {
+            summary << " (t=" << expected[i].streamTime << "s, expected " << expected[i].pitchHz << " Hz";
+            if (i < actual.size())
+            {
+                summary << ", got " << actual[i].pitchHz << " Hz";
+            }
+            summary << ")";
+        }
+    }
+    diff.summary = summary.str();
+    return diff;
+}
+
+ReplayReport replayCaptureFile(const std::filesystem::path &capturePath, const std::filesystem::path &goldenPath)
+{
+    ReplayReport report{};
+    SessionCaptureData capture;
+    std::string error;
+    if (!readSessionCapture(capturePath, capture, error))
+    {
+        report.message = error;
+        return report;
+    }
+
+    std::vector<PitchSample> timeline;
+    auto begin = std::chrono::steady_clock::now();
+    try
+    {
+        timeline = replaySessionCapture(capture);
+    }
+    catch (const std::exception &e)
+    {
+        report.message = std::string("Replay failed: ") + e.what();
+        return report;
+    }
+    double replayMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+    std::size_t frames = 0;
+    for (const CaptureBlock &block : capture.blocks)
+    {
+        frames += block.samples.size() / capture.header.channels;
+    }
+    double audioMs = capture.header.detector.sampleRate > 0 ? 1000.0 * frames / capture.header.detector.sampleRate : 0.0;
+
+    std::ostringstream message;
+    message << "Replayed " << capture.blocks.size() << " blocks (" << audioMs / 1000.0 << " s audio) in " << replayMs << " ms";
+
+    if (goldenPath.empty())
+    {
+        report.ok = true;
+    }
+    else if (!std::filesystem::exists(goldenPath))
+    {
+        report.ok = writePitchTimeline(goldenPath, timeline);
+        message << (report.ok ? "; wrote golden " : "; failed to write golden ") << goldenPath.string();
+    }
+    else if (auto golden = readPitchTimeline(goldenPath))
+    {
+        TimelineDiff diff = diffPitchTimelines(*golden, timeline);
+        report.ok = diff.identical();
+        message << (report.ok ? "; matches golden" : "; differs from golden: " + diff.summary);
+    }
+    else
+    {
+        message << "; unreadable golden " << goldenPath.string();
+    }
+
+    report.message = message.str();
+    return report;
+}
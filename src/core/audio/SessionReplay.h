@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "audio/SessionCapture.h"
+
+struct PitchSample
+{
+    double streamTime = 0.0;
+    float pitchHz = 0.0f;
+    int midiNote = -1;
+    float cents = 0.0f;
+};
+
+struct TimelineDiff
+{
+    std::size_t compared = 0;
+    std::size_t mismatches = 0;
+    std::optional<std::size_t> firstMismatch;
+    std::string summary;
+
+    bool identical() const { return mismatches == 0; }
+};
+
+// Pushes captured blocks through a fresh PitchDetector/NoteConverter built from the
+// capture header, exactly as the audio callback would, and samples the pitch after
+// each block. The result is deterministic for a given capture and detector build.
+std::vector<PitchSample> replaySessionCapture(const SessionCaptureData &capture);
+
+// Golden timelines are text, one "time pitchHz midi cents" row per block, printed
+// with enough digits to round-trip so a zero tolerance diff is bit-exact.
+bool writePitchTimeline(const std::filesystem::path &path, const std::vector<PitchSample> &timeline);
+std::optional<std::vector<PitchSample>> readPitchTimeline(const std::filesystem::path &path);
+TimelineDiff diffPitchTimelines(const std::vector<PitchSample> &expected,
+                                const std::vector<PitchSample> &actual,
+                                float toleranceCents = 0.0f);
+
+struct ReplayReport
+{
+    bool ok = false;
+    std::string message;
+};
+
+// Replays a capture file and reports timing. With a golden path the timeline is
+// diffed against it, or written to it when the file does not exist yet.
+ReplayReport replayCaptureFile(const std::filesystem::path &capturePath, const std::filesystem::path &goldenPath = {});
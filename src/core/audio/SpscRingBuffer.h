@@ -0,0 +1,81 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Single-producer/single-consumer ring for trivially copyable samples. The producer
+// (audio thread) and consumer (writer thread) never block or allocate; capacity only
+// changes through reset(), while neither side is running.
+template <typename T>
+class SpscRingBuffer
+{
+public:
+    explicit SpscRingBuffer(std::size_t capacity) : buffer_(capacity + 1) {}
+
+    std::size_t capacity() const { return buffer_.size() - 1; }
+
+    // Empties the ring and resizes it. Neither side may be running.
+    void reset(std::size_t capacity)
+    {
+        buffer_.resize(capacity + 1);
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+    }
+
+    // Producer side. Returns how many items fit; the rest are dropped by the caller.
+    std::size_t write(const T *data, std::size_t count)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        const std::size_t size = buffer_.size();
+        const std::size_t free = (tail + size - head - 1) % size;
+        const std::size_t n = std::min(count, free);
+
+        const std::size_t first = std::min(n, size - head);
+        std::copy_n(data, first, buffer_.data() + head);
+        std::copy_n(data + first, n - first, buffer_.data());
+        head_.store((head + n) % size, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side.
+    std::size_t read(T *out, std::size_t count)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        const std::size_t head = head_.load(std::memory_order_acquire);
+        const std::size_t size = buffer_.size();
+        const std::size_t available = (head + size - tail) % size;
+        const std::size_t n = std::min(count, available);
+
+        const std::size_t first = std::min(n, size - tail);
+        std::copy_n(buffer_.data() + tail, first, out);
+        std::copy_n(buffer_.data(), n - first, out + first);
+        tail_.store((tail + n) % size, std::memory_order_release);
+        return n;
+    }
+
+    // Consumer side: discards everything currently readable.
+    void clear()
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+    std::size_t writeAvailable() const
+    {
+        const std::size_t size = buffer_.size();
+        return (tail_.load(std::memory_order_acquire) + size - head_.load(std::memory_order_acquire) - 1) % size;
+    }
+
+    std::size_t readAvailable() const
+    {
+        const std::size_t size = buffer_.size();
+        return (head_.load(std::memory_order_acquire) + size - tail_.load(std::memory_order_acquire)) % size;
+    }
+
+private:
+    std::vector<T> buffer_;
+    alignas(64) std::atomic<std::size_t> head_{0};
+    alignas(64) std::atomic<std::size_t> tail_{0};
+};
@@ -0,0 +1,251 @@
+#include "audio/TakeRecorder.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    constexpr std::size_t kWriteChunkSamples = 1 << 16; // 256 KiB per write
+    constexpr uint32_t kHeaderBytes = 44;
+
+    void putLe16(std::array<char, kHeaderBytes> &out, std::size_t offset, uint16_t value)
+    {
+        out[offset] = static_cast<char>(value & 0xff);
+        out[offset + 1] = static_cast<char>((value >> 8) & 0xff);
+    }
+
+    void putLe32(std::array<char, kHeaderBytes> &out, std::size_t offset, uint32_t value)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            out[offset + i] = static_cast<char>((value >> (8 * i)) & 0xff);
+        }
+    }
+}
+
+TakeRecorder::TakeRecorder(std::size_t ringSeconds)
+    : ringSeconds_(ringSeconds)
+{
+}
+
+TakeRecorder::~TakeRecorder()
+{
+    stop();
+}
+
+bool TakeRecorder::start(const std::filesystem::path &path, unsigned int sampleRate, unsigned int channels)
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (recording_.load(std::memory_order_acquire))
+    {
+        error_ = "Already recording.";
+        return false;
+    }
+    if (sampleRate == 0 || channels == 0)
+    {
+        error_ = "No active audio stream to record.";
+        return false;
+    }
+
+    // A take whose writer failed is still open until finalized.
+    finishTake();
+
+    std::error_code ec;
+    if (path.has_parent_path())
+    {
+        std::filesystem::create_directories(path.parent_path(), ec);
+    }
+    out_.open(path, std::ios::binary | std::ios::trunc);
+    if (!out_.good())
+    {
+        error_ = "Cannot open " + path.string() + " for writing.";
+        out_.close();
+        return false;
+    }
+
+    path_ = path;
+    sampleRate_ = sampleRate;
+    channels_ = channels;
+    error_.clear();
+    writeHeader(0);
+    if (!out_.good())
+    {
+        error_ = "Cannot write " + path.string() + ".";
+        out_.close();
+        return false;
+    }
+
+    // Sized in samples, so a stereo take buffers as many seconds as a mono one.
+    // finishTake() waited out any push, so the audio thread is not in the ring.
+    ring_.reset(ringSeconds_ * sampleRate * channels);
+    writeFailed_.store(false, std::memory_order_release);
+    framesWritten_.store(0, std::memory_order_relaxed);
+    droppedFrames_.store(0, std::memory_order_relaxed);
+    dropouts_.store(0, std::memory_order_relaxed);
+
+    writerRunning_.store(true, std::memory_order_release);
+    writer_ = std::thread(&TakeRecorder::writerLoop, this);
+    recording_.store(true, std::memory_order_release);
+    return true;
+}
+
+bool TakeRecorder::stop()
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    return finishTake();
+}
+
+bool TakeRecorder::finishTake()
+{
+    // Sequentially consistent with push(): once no push is in flight, every later one
+    // sees recording_ cleared and stays out of the ring.
+    recording_.store(false);
+    while (pushing_.load() != 0)
+    {
+        std::this_thread::yield();
+    }
+    writerRunning_.store(false, std::memory_order_release);
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+    if (!out_.is_open())
+    {
+        return !writeFailed();
+    }
+
+    uint64_t dataBytes = framesWritten_.load(std::memory_order_relaxed) * channels_ * sizeof(float);
+    writeHeader(static_cast<uint32_t>(std::min<uint64_t>(dataBytes, 0xffffffffu - kHeaderBytes)));
+    out_.flush();
+    bool written = out_.good() && !writeFailed();
+    out_.close();
+    written = written && !out_.fail();
+    if (!written)
+    {
+        writeFailed_.store(true, std::memory_order_release);
+        error_ = "Take " + path_.string() + " is incomplete: writing failed after " +
+                 std::to_string(framesWritten()) + " frames (disk full or file removed?).";
+        std::cerr << error_ << std::endl;
+        return false;
+    }
+    std::cout << "Take saved: " << path_.string() << " (" << framesWritten() << " frames, "
+              << dropouts() << " dropouts)" << std::endl;
+    return true;
+}
+
+void TakeRecorder::push(const float *samples, unsigned int frames)
+{
+    pushing_.fetch_add(1);
+    if (!recording_.load() || samples == nullptr || frames == 0)
+    {
+        pushing_.fetch_sub(1, std::memory_order_release);
+        return;
+    }
+
+    // Only whole frames go in, so channels stay interleaved after an overflow.
+    std::size_t room = ring_.writeAvailable();
+    std::size_t fit = std::min<std::size_t>(frames, room / channels_);
+    ring_.write(samples, fit * channels_);
+    if (fit < frames)
+    {
+        droppedFrames_.fetch_add(frames - fit, std::memory_order_relaxed);
+        dropouts_.fetch_add(1, std::memory_order_relaxed);
+    }
+    pushing_.fetch_sub(1, std::memory_order_release);
+}
+
+std::filesystem::path TakeRecorder::path() const
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    return path_;
+}
+
+std::string TakeRecorder::status() const
+{
+    std::lock_guard<std::mutex> lock(controlMutex_);
+    if (!error_.empty())
+    {
+        return error_;
+    }
+    if (path_.empty())
+    {
+        return "Not recording.";
+    }
+    if (writeFailed())
+    {
+        return "Recording stopped: writing " + path_.filename().string() + " failed.";
+    }
+    double seconds = sampleRate_ > 0 ? static_cast<double>(framesWritten()) / sampleRate_ : 0.0;
+    std::string state = recording() ? "Recording " : "Last take ";
+    return state + path_.filename().string() + ": " + std::to_string(static_cast<int>(seconds)) + " s, " +
+           std::to_string(dropouts()) + " dropouts (" + std::to_string(droppedFrames()) + " frames lost)";
+}
+
+void TakeRecorder::writerLoop()
+{
+    std::vector<float> chunk(kWriteChunkSamples);
+    const std::size_t frameSamples = channels_;
+    for (;;)
+    {
+        // Snapshot before draining so the final pass catches everything pushed before stop().
+        bool running = writerRunning_.load(std::memory_order_acquire);
+        std::size_t available = ring_.readAvailable();
+        std::size_t wanted = std::min(chunk.size() - chunk.size() % frameSamples, available - available % frameSamples);
+        if (running && wanted < chunk.size() / 4)
+        {
+            // Let the ring fill so writes stay large and sequential.
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            continue;
+        }
+
+        std::size_t got = ring_.read(chunk.data(), wanted);
+        if (got > 0)
+        {
+            out_.write(reinterpret_cast<const char *>(chunk.data()), static_cast<std::streamsize>(got * sizeof(float)));
+            if (!out_.good())
+            {
+                // Stop taking input; framesWritten keeps counting only what reached the file.
+                recording_.store(false, std::memory_order_release);
+                writeFailed_.store(true, std::memory_order_release);
+                return;
+            }
+            framesWritten_.fetch_add(got / frameSamples, std::memory_order_relaxed);
+        }
+        if (!running && ring_.readAvailable() < frameSamples)
+        {
+            break;
+        }
+    }
+    out_.flush();
+    if (!out_.good())
+    {
+        writeFailed_.store(true, std::memory_order_release);
+    }
+}
+
+void TakeRecorder::writeHeader(uint32_t dataBytes)
+{
+    std::array<char, kHeaderBytes> header{};
+    const uint16_t bitsPerSample = 32;
+    const uint16_t blockAlign = static_cast<uint16_t>(channels_ * bitsPerSample / 8);
+    header[0] = 'R'; header[1] = 'I'; header[2] = 'F'; header[3] = 'F';
+    putLe32(header, 4, kHeaderBytes - 8 + dataBytes);
+    header[8] = 'W'; header[9] = 'A'; header[10] = 'V'; header[11] = 'E';
+    header[12] = 'f'; header[13] = 'm'; header[14] = 't'; header[15] = ' ';
+    putLe32(header, 16, 16);
+    putLe16(header, 20, 3); // WAVE_FORMAT_IEEE_FLOAT
+    putLe16(header, 22, static_cast<uint16_t>(channels_));
+    putLe32(header, 24, sampleRate_);
+    putLe32(header, 28, sampleRate_ * blockAlign);
+    putLe16(header, 32, blockAlign);
+    putLe16(header, 34, bitsPerSample);
+    header[36] = 'd'; header[37] = 'a'; header[38] = 't'; header[39] = 'a';
+    putLe32(header, 40, dataBytes);
+
+    out_.seekp(0);
+    out_.write(header.data(), header.size());
+    out_.seekp(0, std::ios::end);
+}
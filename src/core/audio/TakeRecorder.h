@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "audio/SpscRingBuffer.h"
+
+// Records the monitored input to a 32-bit float WAV file. The audio thread only
+// copies into a lock-free ring; a writer thread drains it in large sequential
+// writes. When the ring is full the block is dropped and counted, never waited on.
+class TakeRecorder
+{
+public:
+    // The ring holds ringSeconds of audio at the rate and channel count given to start().
+    explicit TakeRecorder(std::size_t ringSeconds = 4);
+    ~TakeRecorder();
+
+    TakeRecorder(const TakeRecorder &) = delete;
+    TakeRecorder &operator=(const TakeRecorder &) = delete;
+
+    bool start(const std::filesystem::path &path, unsigned int sampleRate, unsigned int channels);
+    // False when the take could not be written completely (disk full, file removed);
+    // status() then describes the failure.
+    bool stop();
+    bool recording() const { return recording_.load(std::memory_order_acquire); }
+    // Set when a write failed; the writer stops the take, which still needs stop().
+    bool writeFailed() const { return writeFailed_.load(std::memory_order_acquire); }
+
+    // Audio thread. Interleaved frames matching the channel count given to start().
+    void push(const float *samples, unsigned int frames);
+
+    uint64_t framesWritten() const { return framesWritten_.load(std::memory_order_relaxed); }
+    uint64_t droppedFrames() const { return droppedFrames_.load(std::memory_order_relaxed); }
+    uint64_t dropouts() const { return dropouts_.load(std::memory_order_relaxed); }
+    std::filesystem::path path() const;
+    std::string status() const;
+
+private:
+    bool finishTake(); // Caller holds controlMutex_
+    void writerLoop();
+    void writeHeader(uint32_t dataBytes);
+
+    std::size_t ringSeconds_;
+    SpscRingBuffer<float> ring_{0};
+    std::atomic<bool> recording_{false};
+    std::atomic<int> pushing_{0}; // push() calls in flight; the ring is only resized with none
+    std::atomic<bool> writerRunning_{false};
+    std::atomic<bool> writeFailed_{false};
+    std::atomic<uint64_t> framesWritten_{0};
+    std::atomic<uint64_t> droppedFrames_{0};
+    std::atomic<uint64_t> dropouts_{0};
+    std::thread writer_;
+    mutable std::mutex controlMutex_; // start/stop and path; never taken by the audio thread
+    std::filesystem::path path_;
+    std::ofstream out_; // Writer thread only while recording
+    unsigned int sampleRate_ = 0;
+    unsigned int channels_ = 1;
+    std::string error_;
+};
@@ -0,0 +1,145 @@
+#include "gameplay/HighwayLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    std::size_t slot(HighwayDrawType type)
+    {
+        return static_cast<std::size_t>(type);
+    }
+
+    HighwayInstance makeInstance(float x, float y, float z,
+                                 float sx, float sy, float sz,
+                                 const std::array<float, 3> &color, float state)
+    {
+        HighwayInstance instance;
+        instance.transform = {sx, 0.0f, 0.0f, 0.0f,
+                              0.0f, sy, 0.0f, 0.0f,
+                              0.0f, 0.0f, sz, 0.0f,
+                              x, y, z, 1.0f};
+        instance.colorState = {color[0], color[1], color[2], state};
+        return instance;
+    }
+}
+
+float HighwaySettings::unitsPerSecondForSpeed(int noteSpeed)
+{
+    return 4.0f + 1.5f * static_cast<float>(std::clamp(noteSpeed, 1, 10));
+}
+
+void HighwayLayout::setChart(std::shared_ptr<const ChartFile> chart, int partIndex)
+{
+    chart_ = std::move(chart);
+    part_ = {};
+    maxSustainSeconds_ = 0.0;
+    for (auto &list : instances_)
+    {
+        list.clear();
+    }
+    if (!chart_ || partIndex < 0 || static_cast<std::size_t>(partIndex) >= chart_->partCount())
+    {
+        chart_.reset();
+        return;
+    }
+
+    part_ = chart_->part(static_cast<std::size_t>(partIndex));
+    // Sustains can reach into the window from notes that started before it; the
+    // longest one bounds how far back the index lookup has to start.
+    const TempoMap &tempo = chart_->tempoMap();
+    TempoMap::Cursor cursor = tempo.cursor();
+    for (std::size_t i = 0; i < part_.size(); ++i)
+    {
+        if (part_.duration[i] == 0)
+        {
+            continue;
+        }
+        const double start = cursor.tickToSeconds(part_.startTick[i]);
+        const double end = tempo.tickToSeconds(static_cast<double>(part_.startTick[i]) + part_.duration[i]);
+        maxSustainSeconds_ = std::max(maxSustainSeconds_, end - start);
+    }
+}
+
+void HighwayLayout::build(double chartSeconds, const HighwaySettings &settings, std::span<const uint8_t> noteStates)
+{
+    for (auto &list : instances_)
+    {
+        list.clear();
+    }
+    if (!chart_)
+    {
+        return;
+    }
+    addGems(chartSeconds, settings, noteStates);
+    addBeatLines(chartSeconds, settings);
+}
+
+void HighwayLayout::addGems(double chartSeconds, const HighwaySettings &settings, std::span<const uint8_t> noteStates)
+{
+    const double windowStart = chartSeconds - settings.lookBehind;
+    const double windowEnd = chartSeconds + settings.lookAhead;
+    const float speed = settings.unitsPerSecond;
+    const float laneCenter = 0.5f * static_cast<float>(std::max(settings.stringCount, 1) - 1);
+    auto depth = [&](double seconds)
+    { return -static_cast<float>((seconds - chartSeconds) * speed); };
+
+    const TempoMap &tempo = chart_->tempoMap();
+    std::vector<HighwayInstance> &gems = instances_[slot(HighwayDrawType::Gem)];
+    std::vector<HighwayInstance> &sustains = instances_[slot(HighwayDrawType::Sustain)];
+    TempoMap::Cursor cursor = tempo.cursor();
+    for (std::size_t i = chart_->firstNoteAtOrAfter(part_, windowStart - maxSustainSeconds_); i < part_.size(); ++i)
+    {
+        const double start = cursor.tickToSeconds(part_.startTick[i]);
+        if (start > windowEnd)
+        {
+            break;
+        }
+        const uint8_t string = part_.string[i];
+        const auto &color = settings.stringColors[std::min<std::size_t>(string, settings.stringColors.size() - 1)];
+        const float state = i < noteStates.size() ? static_cast<float>(noteStates[i]) : 0.0f;
+        const float x = (static_cast<float>(string) - laneCenter) * settings.laneSpacing;
+
+        if (part_.duration[i] > 0)
+        {
+            const double end = tempo.tickToSeconds(static_cast<double>(part_.startTick[i]) + part_.duration[i]);
+            const double from = std::max(start, windowStart);
+            const double to = std::min(end, windowEnd);
+            if (to > from)
+            {
+                const float zFrom = depth(from);
+                const float zTo = depth(to);
+                sustains.push_back(makeInstance(x, 0.0f, 0.5f * (zFrom + zTo),
+                                                settings.sustainWidth, settings.lineThickness, zFrom - zTo,
+                                                color, state));
+            }
+        }
+        if (start >= windowStart)
+        {
+            gems.push_back(makeInstance(x, 0.5f * settings.gemScale[1], depth(start),
+                                        settings.gemScale[0], settings.gemScale[1], settings.gemScale[2],
+                                        color, state));
+        }
+    }
+}
+
+void HighwayLayout::addBeatLines(double chartSeconds, const HighwaySettings &settings)
+{
+    const TempoMap &tempo = chart_->tempoMap();
+    const double firstBeat = std::ceil(tempo.secondsToBeat(chartSeconds - settings.lookBehind));
+    const double lastBeat = tempo.secondsToBeat(chartSeconds + settings.lookAhead);
+    const float width = settings.laneSpacing * static_cast<float>(std::max(settings.stringCount, 1));
+    const int perMeasure = std::max(settings.beatsPerMeasure, 1);
+
+    std::vector<HighwayInstance> &lines = instances_[slot(HighwayDrawType::BeatLine)];
+    TempoMap::Cursor cursor = tempo.cursor();
+    for (double beat = std::max(firstBeat, 0.0); beat <= lastBeat; beat += 1.0)
+    {
+        const double seconds = cursor.tickToSeconds(beat * tempo.ticksPerQuarter());
+        const bool measure = static_cast<int64_t>(beat) % perMeasure == 0;
+        lines.push_back(makeInstance(0.0f, 0.0f, -static_cast<float>((seconds - chartSeconds) * settings.unitsPerSecond),
+                                     width, settings.lineThickness, settings.lineThickness * (measure ? 2.0f : 1.0f),
+                                     measure ? settings.measureColor : settings.beatColor, 0.0f));
+    }
+}
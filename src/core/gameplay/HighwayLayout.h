@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "track/ChartFile.h"
+#include "track/TempoMap.h"
+
+enum class HighwayDrawType
+{
+    Gem,
+    Sustain,
+    BeatLine,
+    Count
+};
+
+// Per-note state written by gameplay, indexed like the chart part's notes.
+enum class HighwayNoteState : uint8_t
+{
+    Upcoming = 0,
+    Hit = 1,
+    Missed = 2
+};
+
+struct HighwaySettings
+{
+    float lookAhead = 2.5f;  // Seconds of chart shown beyond the strike line
+    float lookBehind = 0.25f;
+    float unitsPerSecond = 10.0f;
+    int stringCount = 6;
+    float laneSpacing = 0.5f;
+    std::array<float, 3> gemScale{0.32f, 0.12f, 0.2f};
+    float sustainWidth = 0.08f;
+    float lineThickness = 0.02f;
+    int beatsPerMeasure = 4;
+    std::array<std::array<float, 3>, 7> stringColors{{{0.93f, 0.22f, 0.25f},
+                                                      {0.98f, 0.82f, 0.18f},
+                                                      {0.2f, 0.55f, 0.98f},
+                                                      {0.98f, 0.55f, 0.15f},
+                                                      {0.25f, 0.85f, 0.35f},
+                                                      {0.7f, 0.3f, 0.9f},
+                                                      {0.6f, 0.6f, 0.6f}}};
+    std::array<float, 3> beatColor{0.35f, 0.35f, 0.4f};
+    std::array<float, 3> measureColor{0.75f, 0.75f, 0.8f};
+    float hitGlow = 1.5f;
+    float missDim = 0.3f;
+
+    // Maps GameplaySettings::noteSpeed (1..10) to highway units per second.
+    static float unitsPerSecondForSpeed(int noteSpeed);
+};
+
+// One 80 byte instance: model matrix in bx column order, then rgb colour and state.
+struct HighwayInstance
+{
+    std::array<float, 16> transform{};
+    std::array<float, 4> colorState{};
+};
+static_assert(sizeof(HighwayInstance) == 80, "instance stride must match i_data0..i_data4");
+
+// CPU side of the note highway: picks the notes and beats inside the window
+// around the playhead through the chart's per-second index and packs them into
+// one instance list per draw type. The strike line sits at z = 0 and the chart
+// runs towards -z; lanes are spread along x, highest string first.
+class HighwayLayout
+{
+public:
+    void setChart(std::shared_ptr<const ChartFile> chart, int partIndex);
+    bool hasChart() const { return chart_ != nullptr; }
+    const ChartPartView &part() const { return part_; }
+
+    // Refills the per-type instance lists for the window around chartSeconds.
+    void build(double chartSeconds, const HighwaySettings &settings, std::span<const uint8_t> noteStates = {});
+
+    const std::vector<HighwayInstance> &instances(HighwayDrawType type) const
+    {
+        return instances_[static_cast<std::size_t>(type)];
+    }
+
+private:
+    void addGems(double chartSeconds, const HighwaySettings &settings, std::span<const uint8_t> noteStates);
+    void addBeatLines(double chartSeconds, const HighwaySettings &settings);
+
+    std::array<std::vector<HighwayInstance>, static_cast<std::size_t>(HighwayDrawType::Count)> instances_{};
+    std::shared_ptr<const ChartFile> chart_;
+    ChartPartView part_{};
+    double maxSustainSeconds_ = 0.0;
+};
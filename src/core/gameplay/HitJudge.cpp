@@ -0,0 +1,170 @@
+#include "gameplay/HitJudge.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace
+{
+    constexpr std::array<double, 5> kHitWindows{0.040, 0.060, 0.080, 0.110, 0.150};
+    constexpr int kPerfectPoints = 100;
+    constexpr int kGoodPoints = 50;
+    constexpr int kComboStep = 10; // Notes per multiplier step
+    constexpr int kMaxMultiplier = 4;
+}
+
+double hitWindowSeconds(int leniency)
+{
+    return kHitWindows[static_cast<std::size_t>(std::clamp(leniency, 0, static_cast<int>(kHitWindows.size()) - 1))];
+}
+
+double pitchInputLatency(unsigned int sampleRate, unsigned int bufferFrames, unsigned int analysisWindow)
+{
+    if (sampleRate == 0)
+    {
+        return 0.0;
+    }
+    return (bufferFrames + analysisWindow / 2.0) / sampleRate;
+}
+
+std::vector<JudgeNote> buildJudgeNotes(const ChartPartView &part, const TempoMap &tempo,
+                                       std::span<const uint8_t> tuning)
+{
+    std::vector<JudgeNote> notes;
+    notes.reserve(part.size());
+    TempoMap::Cursor cursor = tempo.cursor();
+    for (std::size_t i = 0; i < part.size(); ++i)
+    {
+        if ((part.flags[i] & ChartNoteDead) || part.string[i] >= tuning.size())
+        {
+            continue;
+        }
+        JudgeNote note;
+        note.seconds = cursor.tickToSeconds(part.startTick[i]);
+        note.endSeconds = tempo.tickToSeconds(static_cast<double>(part.startTick[i]) + part.duration[i]);
+        note.midiNote = tuning[part.string[i]] + part.fret[i];
+        note.flags = part.flags[i];
+        notes.push_back(note);
+    }
+    return notes;
+}
+
+HitJudge::HitJudge(std::vector<JudgeNote> notes, const JudgeOptions &options)
+    : notes_(std::move(notes)), options_(options)
+{
+    std::stable_sort(notes_.begin(), notes_.end(), [](const JudgeNote &a, const JudgeNote &b)
+                     { return a.seconds < b.seconds; });
+}
+
+double HitJudge::chartTime(double streamTime) const
+{
+    return streamTime - options_.chartStart - options_.inputLatency;
+}
+
+void HitJudge::onPitch(double streamTime, int midiNote)
+{
+    const double time = chartTime(streamTime);
+    admit(time);
+    expire(time);
+    if (midiNote >= 0 && midiNote != lastMidiNote_)
+    {
+        judgeOnset(time, midiNote);
+    }
+    lastMidiNote_ = midiNote;
+}
+
+void HitJudge::onOnset(double streamTime, int midiNote)
+{
+    const double time = chartTime(streamTime);
+    admit(time);
+    expire(time);
+    if (midiNote >= 0)
+    {
+        judgeOnset(time, midiNote);
+    }
+    lastMidiNote_ = midiNote;
+}
+
+void HitJudge::advance(double streamTime)
+{
+    const double time = chartTime(streamTime);
+    admit(time);
+    expire(time);
+}
+
+void HitJudge::reset()
+{
+    next_ = 0;
+    active_.clear();
+    lastMidiNote_ = -1;
+    stats_ = JudgeStats{};
+    judgements_.clear();
+}
+
+void HitJudge::admit(double time)
+{
+    while (next_ < notes_.size() && notes_[next_].seconds - options_.window <= time)
+    {
+        active_.push_back(next_++);
+    }
+}
+
+void HitJudge::expire(double time)
+{
+    // Notes are admitted in time order and share one window, so the expired ones
+    // are always a prefix of the active set.
+    std::size_t expired = 0;
+    while (expired < active_.size() && notes_[active_[expired]].seconds + options_.window < time)
+    {
+        record(active_[expired], JudgeGrade::Miss, 0.0);
+        ++expired;
+    }
+    active_.erase(active_.begin(), active_.begin() + static_cast<std::ptrdiff_t>(expired));
+}
+
+void HitJudge::judgeOnset(double time, int midiNote)
+{
+    auto match = std::find_if(active_.begin(), active_.end(), [&](std::size_t index)
+                              { return notes_[index].midiNote == midiNote; });
+    if (match == active_.end())
+    {
+        ++stats_.stray;
+        return;
+    }
+
+    const double chordTime = notes_[*match].seconds;
+    const double offset = time - chordTime;
+    const JudgeGrade grade =
+        std::abs(offset) <= options_.window * options_.perfectFraction ? JudgeGrade::Perfect : JudgeGrade::Good;
+
+    // The detector is monophonic, so one matching pitch judges the whole chord.
+    std::size_t kept = 0;
+    for (std::size_t index : active_)
+    {
+        if (notes_[index].seconds == chordTime)
+        {
+            record(index, grade, offset);
+        }
+        else
+        {
+            active_[kept++] = index;
+        }
+    }
+    active_.resize(kept);
+}
+
+void HitJudge::record(std::size_t note, JudgeGrade grade, double offset)
+{
+    judgements_.push_back(Judgement{note, grade, offset});
+    if (grade == JudgeGrade::Miss)
+    {
+        ++stats_.miss;
+        stats_.combo = 0;
+        return;
+    }
+
+    ++(grade == JudgeGrade::Perfect ? stats_.perfect : stats_.good);
+    const int multiplier = std::min(1 + stats_.combo / kComboStep, kMaxMultiplier);
+    stats_.score += static_cast<int64_t>(grade == JudgeGrade::Perfect ? kPerfectPoints : kGoodPoints) * multiplier;
+    stats_.maxCombo = std::max(stats_.maxCombo, ++stats_.combo);
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "track/ChartFile.h"
+#include "track/TempoMap.h"
+
+// A chart note resolved to chart seconds and the pitch the detector should report.
+struct JudgeNote
+{
+    double seconds = 0.0;
+    double endSeconds = 0.0;
+    int midiNote = -1;
+    uint16_t flags = ChartNoteNone;
+};
+
+enum class JudgeGrade
+{
+    Perfect,
+    Good,
+    Miss
+};
+
+struct Judgement
+{
+    std::size_t note = 0;
+    JudgeGrade grade = JudgeGrade::Miss;
+    double offset = 0.0; // Seconds late (positive) or early (negative); 0 for misses
+};
+
+struct JudgeStats
+{
+    std::size_t perfect = 0;
+    std::size_t good = 0;
+    std::size_t miss = 0;
+    std::size_t stray = 0; // Onsets that matched no note in the window
+    int combo = 0;
+    int maxCombo = 0;
+    int64_t score = 0;
+};
+
+struct JudgeOptions
+{
+    double window = 0.080;          // Half width of the hit window in seconds
+    double perfectFraction = 0.4;   // Share of the window that grades Perfect
+    double chartStart = 0.0;        // Stream time at which chart second zero plays
+    double inputLatency = 0.0;      // Capture plus analysis delay of the pitch input
+    std::array<uint8_t, 7> tuning{64, 59, 55, 50, 45, 40, 35}; // Open pitch, highest string first
+};
+
+// Maps GameplaySettings::hitWindow (0 strict .. 4 lenient) to a window half width.
+double hitWindowSeconds(int leniency);
+// Delay between a string being struck and the detector reporting it: one stream
+// buffer plus half the analysis window.
+double pitchInputLatency(unsigned int sampleRate, unsigned int bufferFrames, unsigned int analysisWindow);
+
+// Dead notes carry no pitch and are left out.
+std::vector<JudgeNote> buildJudgeNotes(const ChartPartView &part, const TempoMap &tempo,
+                                       std::span<const uint8_t> tuning);
+
+// Walks the notes with a forward cursor. Notes enter the active set when their
+// window opens and leave it when hit or when the window closes, so each call costs
+// O(active notes) regardless of chart length. Input times are stream times; they
+// are shifted by chartStart and inputLatency before anything is compared, and the
+// result depends only on the inputs, so a replayed pitch timeline scores the same.
+class HitJudge
+{
+public:
+    HitJudge(std::vector<JudgeNote> notes, const JudgeOptions &options);
+
+    // One detector sample per hop. A change to a valid note counts as an onset.
+    void onPitch(double streamTime, int midiNote);
+    // Explicit onset from a transient detector; re-attacks of the same pitch count.
+    void onOnset(double streamTime, int midiNote);
+    // Closes windows that ended by streamTime without any input.
+    void advance(double streamTime);
+    void reset();
+
+    double chartTime(double streamTime) const;
+    bool finished() const { return next_ == notes_.size() && active_.empty(); }
+    const JudgeStats &stats() const { return stats_; }
+    const std::vector<Judgement> &judgements() const { return judgements_; }
+    std::span<const JudgeNote> notes() const { return notes_; }
+    std::span<const std::size_t> active() const { return active_; }
+
+private:
+    void admit(double time);
+    void expire(double time);
+    void judgeOnset(double time, int midiNote);
+    void record(std::size_t note, JudgeGrade grade, double offset);
+
+    std::vector<JudgeNote> notes_;
+    JudgeOptions options_;
+    std::size_t next_ = 0;
+    std::vector<std::size_t> active_; // Unjudged notes whose window is open, in chart order
+    int lastMidiNote_ = -1;
+    JudgeStats stats_;
+    std::vector<Judgement> judgements_;
+};
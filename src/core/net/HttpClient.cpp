@@ -0,0 +1,269 @@
+#include "net/HttpClient.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <utility>
+
+#include "net/TcpSocket.h"
+
+namespace
+{
+    bool equalsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+                                                  { return std::tolower(static_cast<unsigned char>(x)) ==
+                                                           std::tolower(static_cast<unsigned char>(y)); });
+    }
+
+    enum class ChunkedBody
+    {
+        Incomplete,
+        Complete,
+        Malformed
+    };
+
+    // Decodes a chunked body. A size line that is not hex, optionally followed by
+    // a ';' extension, fails the request rather than reading as the last chunk.
+    ChunkedBody decodeChunked(std::string_view data, std::string &out)
+    {
+        out.clear();
+        std::size_t pos = 0;
+        while (true)
+        {
+            const std::size_t lineEnd = data.find("\r\n", pos);
+            if (lineEnd == std::string_view::npos)
+            {
+                return ChunkedBody::Incomplete;
+            }
+            const std::string line(data.substr(pos, lineEnd - pos));
+            if (line.empty() || !std::isxdigit(static_cast<unsigned char>(line.front())))
+            {
+                return ChunkedBody::Malformed;
+            }
+            char *sizeEnd = nullptr;
+            errno = 0;
+            const unsigned long long size = std::strtoull(line.c_str(), &sizeEnd, 16);
+            if (errno == ERANGE || (*sizeEnd != '\0' && *sizeEnd != ';'))
+            {
+                return ChunkedBody::Malformed;
+            }
+            pos = lineEnd + 2;
+            if (size == 0)
+            {
+                return ChunkedBody::Complete;
+            }
+            if (size > data.size() || data.size() - size < pos + 2)
+            {
+                return ChunkedBody::Incomplete;
+            }
+            if (data.substr(pos + size, 2) != "\r\n")
+            {
+                return ChunkedBody::Malformed;
+            }
+            out.append(data.substr(pos, size));
+            pos += size + 2;
+        }
+    }
+}
+
+bool parseHttpUrl(std::string_view url, HttpUrl &out)
+{
+    constexpr std::string_view scheme = "http://";
+    if (url.substr(0, scheme.size()) != scheme)
+    {
+        return false;
+    }
+    url.remove_prefix(scheme.size());
+    const std::size_t slash = url.find('/');
+    std::string_view authority = url.substr(0, slash);
+    out.target = slash == std::string_view::npos ? "/" : std::string(url.substr(slash));
+
+    const std::size_t colon = authority.rfind(':');
+    out.port = 80;
+    if (colon != std::string_view::npos)
+    {
+        const int port = std::atoi(std::string(authority.substr(colon + 1)).c_str());
+        if (port <= 0 || port > 65535)
+        {
+            return false;
+        }
+        out.port = static_cast<uint16_t>(port);
+        authority = authority.substr(0, colon);
+    }
+    out.host = std::string(authority);
+    return !out.host.empty();
+}
+
+std::string urlEncode(std::string_view text)
+{
+    static const char *kHex = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if (std::isalnum(byte) || c == '-' || c == '_' || c == '.' || c == '~')
+        {
+            out.push_back(c);
+        }
+        else
+        {
+            out.push_back('%');
+            out.push_back(kHex[byte >> 4]);
+            out.push_back(kHex[byte & 0x0F]);
+        }
+    }
+    return out;
+}
+
+HttpResponse httpRequest(const HttpRequest &request)
+{
+    HttpResponse response;
+    HttpUrl url;
+    if (!parseHttpUrl(request.url, url))
+    {
+        response.error = "unsupported URL " + request.url;
+        return response;
+    }
+
+    // request.timeout bounds the whole exchange, not each read, so a server that
+    // trickles bytes cannot hold the caller past it.
+    const auto deadline = std::chrono::steady_clock::now() + request.timeout;
+    auto remaining = [&]
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+    };
+    auto fail = [&](std::string error)
+    {
+        response.status = 0;
+        response.body.clear();
+        response.error = std::move(error);
+        return response;
+    };
+
+    TcpSocket socket = TcpSocket::connect(url.host, url.port, remaining(), response.error);
+    if (!socket.valid())
+    {
+        return response;
+    }
+
+    std::string message = request.method + " " + url.target + " HTTP/1.1\r\n";
+    message += "Host: " + url.host + "\r\n";
+    message += "Connection: close\r\n";
+    if (!request.body.empty() || request.method == "POST" || request.method == "PUT")
+    {
+        message += "Content-Type: " + (request.contentType.empty() ? std::string("text/plain") : request.contentType) + "\r\n";
+        message += "Content-Length: " + std::to_string(request.body.size()) + "\r\n";
+    }
+    message += "\r\n";
+    message += request.body;
+    if (!socket.sendAll(message, remaining()))
+    {
+        return fail("send failed");
+    }
+
+    std::string raw;
+    std::size_t headerEnd = std::string::npos;
+    long contentLength = -1;
+    bool chunked = false;
+    bool bodiless = false;
+    while (true)
+    {
+        const std::chrono::milliseconds left = remaining();
+        if (left.count() <= 0)
+        {
+            return fail("timed out");
+        }
+        const long received = socket.receive(raw, left);
+        if (headerEnd == std::string::npos)
+        {
+            headerEnd = raw.find("\r\n\r\n");
+            if (headerEnd != std::string::npos)
+            {
+                std::string_view headers(raw.data(), headerEnd);
+                if (headers.substr(0, 5) != "HTTP/" || headers.find(' ') == std::string_view::npos)
+                {
+                    return fail("malformed status line");
+                }
+                response.status = std::atoi(raw.c_str() + headers.find(' ') + 1);
+
+                std::size_t lineStart = headers.find("\r\n");
+                while (lineStart != std::string_view::npos && lineStart < headers.size())
+                {
+                    lineStart += 2;
+                    std::size_t lineEnd = std::min(headers.find("\r\n", lineStart), headers.size());
+                    std::string_view line = headers.substr(lineStart, lineEnd - lineStart);
+                    const std::size_t colon = line.find(':');
+                    if (colon != std::string_view::npos)
+                    {
+                        std::string_view name = line.substr(0, colon);
+                        std::string_view value = line.substr(colon + 1);
+                        while (!value.empty() && value.front() == ' ')
+                        {
+                            value.remove_prefix(1);
+                        }
+                        if (equalsIgnoreCase(name, "Content-Length"))
+                        {
+                            contentLength = std::atol(std::string(value).c_str());
+                        }
+                        else if (equalsIgnoreCase(name, "Transfer-Encoding") && equalsIgnoreCase(value, "chunked"))
+                        {
+                            chunked = true;
+                        }
+                    }
+                    lineStart = lineEnd;
+                }
+
+                bodiless = request.method == "HEAD" || response.status == 204 || response.status == 304;
+                if (!bodiless && !chunked && contentLength < 0)
+                {
+                    // Without a length a dropped connection looks like the end of
+                    // the body, so such responses are never trusted.
+                    return fail("response has neither Content-Length nor chunked encoding");
+                }
+            }
+        }
+
+        if (headerEnd != std::string::npos)
+        {
+            std::string_view body(raw.data() + headerEnd + 4, raw.size() - headerEnd - 4);
+            if (bodiless)
+            {
+                return response;
+            }
+            if (chunked)
+            {
+                const ChunkedBody decoded = decodeChunked(body, response.body);
+                if (decoded == ChunkedBody::Complete)
+                {
+                    return response;
+                }
+                if (decoded == ChunkedBody::Malformed)
+                {
+                    return fail("malformed chunked body");
+                }
+            }
+            if (!chunked && body.size() >= static_cast<std::size_t>(contentLength))
+            {
+                response.body.assign(body.substr(0, static_cast<std::size_t>(contentLength)));
+                return response;
+            }
+        }
+        if (received == TcpSocket::kReceiveTimedOut)
+        {
+            return fail("timed out");
+        }
+        if (received == TcpSocket::kReceiveError)
+        {
+            return fail("receive failed");
+        }
+        if (received == 0)
+        {
+            return fail(headerEnd == std::string::npos ? "connection closed before the response headers"
+                                                       : "response truncated");
+        }
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+struct HttpRequest
+{
+    std::string method = "GET";
+    std::string url; // http://host[:port]/path?query
+    std::string body;
+    std::string contentType;
+    std::chrono::milliseconds timeout{5000}; // Deadline for the whole exchange
+};
+
+struct HttpResponse
+{
+    int status = 0; // 0 when no response arrived
+    std::string body;
+    std::string error;
+
+    bool ok() const { return status >= 200 && status < 300; }
+};
+
+// Anything that can carry a request; tests and a future TLS backend plug in here.
+using HttpTransport = std::function<HttpResponse(const HttpRequest &)>;
+
+struct HttpUrl
+{
+    std::string host;
+    uint16_t port = 80;
+    std::string target = "/";
+};
+
+bool parseHttpUrl(std::string_view url, HttpUrl &out);
+std::string urlEncode(std::string_view text);
+
+// One blocking HTTP/1.1 exchange over plain TCP with Connection: close. Handles
+// Content-Length and chunked bodies; a response is only returned once its length
+// or the terminating chunk was reached, so a cut connection is an error rather
+// than a short body. https URLs are rejected.
+HttpResponse httpRequest(const HttpRequest &request);
@@ -0,0 +1,252 @@
+#include "net/TcpSocket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+#if defined(_WIN32)
+    using SocketLength = int;
+
+    // Winsock needs one WSAStartup per process before any socket call.
+    bool ensureWinsock()
+    {
+        static const bool started = []
+        {
+            WSADATA data{};
+            return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+        }();
+        return started;
+    }
+
+    int pollSockets(WSAPOLLFD *fds, unsigned long count, int timeoutMs) { return WSAPoll(fds, count, timeoutMs); }
+    void closeHandle(uintptr_t handle) { closesocket(static_cast<SOCKET>(handle)); }
+    bool setNonBlocking(uintptr_t handle, bool enabled)
+    {
+        u_long mode = enabled ? 1 : 0;
+        return ioctlsocket(static_cast<SOCKET>(handle), FIONBIO, &mode) == 0;
+    }
+    bool connectPending() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+    using PollFd = WSAPOLLFD;
+    constexpr int kSendFlags = 0;
+#else
+    using SocketLength = socklen_t;
+
+    bool ensureWinsock() { return true; }
+    int pollSockets(pollfd *fds, nfds_t count, int timeoutMs) { return ::poll(fds, count, timeoutMs); }
+    void closeHandle(int handle) { ::close(handle); }
+    bool setNonBlocking(int handle, bool enabled)
+    {
+        int flags = fcntl(handle, F_GETFL, 0);
+        if (flags < 0)
+        {
+            return false;
+        }
+        flags = enabled ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+        return fcntl(handle, F_SETFL, flags) == 0;
+    }
+    bool connectPending() { return errno == EINPROGRESS; }
+    using PollFd = pollfd;
+#if defined(MSG_NOSIGNAL)
+    constexpr int kSendFlags = MSG_NOSIGNAL;
+#else
+    constexpr int kSendFlags = 0;
+#endif
+#endif
+}
+
+TcpSocket::~TcpSocket()
+{
+    close();
+}
+
+TcpSocket::TcpSocket(TcpSocket &&other) noexcept : handle_(std::exchange(other.handle_, static_cast<Handle>(-1))) {}
+
+TcpSocket &TcpSocket::operator=(TcpSocket &&other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        handle_ = std::exchange(other.handle_, static_cast<Handle>(-1));
+    }
+    return *this;
+}
+
+bool TcpSocket::valid() const
+{
+    return handle_ != static_cast<Handle>(-1);
+}
+
+void TcpSocket::close()
+{
+    if (valid())
+    {
+        closeHandle(handle_);
+        handle_ = static_cast<Handle>(-1);
+    }
+}
+
+TcpSocket TcpSocket::connect(const std::string &host, uint16_t port, std::chrono::milliseconds timeout,
+                             std::string &error)
+{
+    if (!ensureWinsock())
+    {
+        error = "socket startup failed";
+        return {};
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *results = nullptr;
+    const std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &results) != 0 || !results)
+    {
+        error = "cannot resolve " + host;
+        return {};
+    }
+
+    TcpSocket connected;
+    for (addrinfo *addr = results; addr && !connected.valid(); addr = addr->ai_next)
+    {
+        TcpSocket candidate(static_cast<Handle>(::socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol)));
+        if (!candidate.valid() || !setNonBlocking(candidate.handle_, true))
+        {
+            continue;
+        }
+        // Non-blocking connect so an unreachable server costs at most the timeout.
+        if (::connect(candidate.handle_, addr->ai_addr, static_cast<SocketLength>(addr->ai_addrlen)) != 0)
+        {
+            if (!connectPending() || !candidate.waitReady(true, timeout))
+            {
+                continue;
+            }
+            int socketError = 0;
+            SocketLength length = sizeof(socketError);
+            getsockopt(candidate.handle_, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&socketError), &length);
+            if (socketError != 0)
+            {
+                continue;
+            }
+        }
+        setNonBlocking(candidate.handle_, false);
+        int noDelay = 1;
+        setsockopt(candidate.handle_, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char *>(&noDelay), sizeof(noDelay));
+        connected = std::move(candidate);
+    }
+    freeaddrinfo(results);
+    if (!connected.valid())
+    {
+        error = "cannot connect to " + host + ":" + service;
+    }
+    return connected;
+}
+
+TcpSocket TcpSocket::listenLoopback(uint16_t port, std::string &error)
+{
+    if (!ensureWinsock())
+    {
+        error = "socket startup failed";
+        return {};
+    }
+    TcpSocket listener(static_cast<Handle>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP)));
+    if (!listener.valid())
+    {
+        error = "cannot create socket";
+        return {};
+    }
+    int reuse = 1;
+    setsockopt(listener.handle_, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>(&reuse), sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::bind(listener.handle_, reinterpret_cast<const sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listener.handle_, 16) != 0)
+    {
+        error = "cannot listen on port " + std::to_string(port);
+        return {};
+    }
+    return listener;
+}
+
+uint16_t TcpSocket::localPort() const
+{
+    sockaddr_in addr{};
+    SocketLength length = sizeof(addr);
+    if (!valid() || getsockname(handle_, reinterpret_cast<sockaddr *>(&addr), &length) != 0)
+    {
+        return 0;
+    }
+    return ntohs(addr.sin_port);
+}
+
+TcpSocket TcpSocket::accept(std::chrono::milliseconds timeout)
+{
+    if (!valid() || !waitReady(false, timeout))
+    {
+        return {};
+    }
+    return TcpSocket(static_cast<Handle>(::accept(handle_, nullptr, nullptr)));
+}
+
+int TcpSocket::pollReady(bool forWrite, std::chrono::milliseconds timeout) const
+{
+    PollFd fd{};
+    fd.fd = handle_;
+    fd.events = forWrite ? POLLOUT : POLLIN;
+    return pollSockets(&fd, 1, static_cast<int>(std::max<std::chrono::milliseconds::rep>(timeout.count(), 0)));
+}
+
+bool TcpSocket::sendAll(const std::string &data, std::chrono::milliseconds timeout)
+{
+    std::size_t sent = 0;
+    while (sent < data.size())
+    {
+        if (!waitReady(true, timeout))
+        {
+            return false;
+        }
+        const auto chunk = ::send(handle_, data.data() + sent, static_cast<int>(data.size() - sent), kSendFlags);
+        if (chunk <= 0)
+        {
+            return false;
+        }
+        sent += static_cast<std::size_t>(chunk);
+    }
+    return true;
+}
+
+long TcpSocket::receive(std::string &out, std::chrono::milliseconds timeout)
+{
+    const int ready = pollReady(false, timeout);
+    if (ready == 0)
+    {
+        return kReceiveTimedOut;
+    }
+    char buffer[4096];
+    const auto received = ready < 0 ? -1 : ::recv(handle_, buffer, sizeof(buffer), 0);
+    if (received < 0)
+    {
+        return kReceiveError;
+    }
+    out.append(buffer, static_cast<std::size_t>(received));
+    return static_cast<long>(received);
+}
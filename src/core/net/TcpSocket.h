@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Blocking TCP socket with per-call timeouts. Thin wrapper over BSD sockets and
+// Winsock, enough for the HTTP client and the test stand-in server.
+class TcpSocket
+{
+public:
+    TcpSocket() = default;
+    ~TcpSocket();
+
+    TcpSocket(const TcpSocket &) = delete;
+    TcpSocket &operator=(const TcpSocket &) = delete;
+    TcpSocket(TcpSocket &&other) noexcept;
+    TcpSocket &operator=(TcpSocket &&other) noexcept;
+
+    static TcpSocket connect(const std::string &host, uint16_t port, std::chrono::milliseconds timeout,
+                             std::string &error);
+    // Listens on the loopback interface; port 0 picks a free one (see localPort).
+    static TcpSocket listenLoopback(uint16_t port, std::string &error);
+
+    bool valid() const;
+    uint16_t localPort() const;
+    // Waits up to timeout for a connection; returns an invalid socket on timeout.
+    TcpSocket accept(std::chrono::milliseconds timeout);
+
+    static constexpr long kReceiveError = -1;
+    static constexpr long kReceiveTimedOut = -2;
+
+    bool sendAll(const std::string &data, std::chrono::milliseconds timeout);
+    // Appends whatever arrives within timeout and returns its size: 0 on orderly
+    // close, kReceiveTimedOut when nothing arrived, kReceiveError on failure.
+    long receive(std::string &out, std::chrono::milliseconds timeout);
+    void close();
+
+private:
+#if defined(_WIN32)
+    using Handle = uintptr_t;
+#else
+    using Handle = int;
+#endif
+    explicit TcpSocket(Handle handle) : handle_(handle) {}
+    // poll() result: positive when ready, 0 on timeout, negative on error.
+    int pollReady(bool forWrite, std::chrono::milliseconds timeout) const;
+    bool waitReady(bool forWrite, std::chrono::milliseconds timeout) const { return pollReady(forWrite, timeout) > 0; }
+
+    Handle handle_ = static_cast<Handle>(-1);
+};
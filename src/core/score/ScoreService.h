@@ -1,11 +1,18 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
 #include "score/ScoreTypes.h"
 #include "track/TrackTypes.h"
 
+// Identifies one (track, part) leaderboard in score stores and caches.
+inline std::string scorePartKey(const TrackInfo &track, const std::string &partName)
+{
+    return track.title + '\x1f' + track.artist + '\x1f' + partName;
+}
+
 class TrackScoreService
 {
 public:
@@ -14,4 +21,19 @@ public:
     virtual std::vector<ScoreEntry> scoresFor(const TrackInfo &track,
                                               const std::string &partName,
                                               ScoreCategory category) const = 0;
+
+    // Stores a finished run. Read-only services return false.
+    virtual bool recordScore(const TrackInfo & /*track*/,
+                             const std::string & /*partName*/,
+                             const ScoreEntry & /*entry*/)
+    {
+        return false;
+    }
+
+    virtual std::optional<ScoreEntry> personalBest(const TrackInfo & /*track*/,
+                                                   const std::string & /*partName*/,
+                                                   const std::string & /*playerName*/) const
+    {
+        return std::nullopt;
+    }
 };
@@ -0,0 +1,432 @@
+#include "score/ScoreServiceFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+#include "BinaryLog.h"
+#include "FileSync.h"
+
+namespace
+{
+    constexpr char kLogMagic[8] = {'O', 'C', 'S', 'C', 'O', 'R', 'E', '1'};
+    constexpr std::size_t kFrameHeader = 8; // u32 payload length, u32 checksum
+    constexpr std::size_t kLeaderboardRows = 10;
+
+    // Payload: i32 score, i32 combo, u16 key length, key, u16 name length, name.
+    std::vector<char> encodeRecord(const std::string &key, const std::string &name, int score, int combo)
+    {
+        std::vector<char> payload;
+        payload.reserve(12 + key.size() + name.size());
+        binlog::putU32(payload, static_cast<uint32_t>(score));
+        binlog::putU32(payload, static_cast<uint32_t>(combo));
+        binlog::putString(payload, key);
+        binlog::putString(payload, name);
+
+        std::vector<char> record;
+        record.reserve(kFrameHeader + payload.size());
+        binlog::putU32(record, static_cast<uint32_t>(payload.size()));
+        binlog::putU32(record, binlog::fnv1a32(payload.data(), payload.size()));
+        record.insert(record.end(), payload.begin(), payload.end());
+        return record;
+    }
+
+    bool decodeRecord(const char *data, std::size_t size, std::string &key, std::string &name, int &score, int &combo)
+    {
+        binlog::Reader in{data, size};
+        score = static_cast<int>(in.bytes(4));
+        combo = static_cast<int>(in.bytes(4));
+        key = in.string();
+        name = in.string();
+        return in.ok && in.pos == size;
+    }
+}
+
+TrackScoreServiceFile::TrackScoreServiceFile(std::filesystem::path logPath,
+                                             std::unique_ptr<TrackScoreService> remote,
+                                             ScoreStoreOptions options)
+    : path_(std::move(logPath)), remote_(std::move(remote)), options_(options)
+{
+    options_.retainPerPart = std::max<std::size_t>(options_.retainPerPart, 1);
+    load();
+}
+
+TrackScoreServiceFile::~TrackScoreServiceFile()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+void TrackScoreServiceFile::load()
+{
+    std::error_code ec;
+    if (path_.has_parent_path())
+    {
+        std::filesystem::create_directories(path_.parent_path(), ec);
+    }
+    std::filesystem::remove(path_.string() + ".compact", ec); // Left behind by an interrupted compaction
+
+    bool writeHeader = true;
+    std::ifstream in(path_, std::ios::binary);
+    if (in.good())
+    {
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        if (bytes.size() >= sizeof(kLogMagic) && std::memcmp(bytes.data(), kLogMagic, sizeof(kLogMagic)) == 0)
+        {
+            writeHeader = false;
+            std::size_t pos = sizeof(kLogMagic);
+            std::string key;
+            StoredScore score;
+            while (pos + kFrameHeader <= bytes.size())
+            {
+                const uint32_t length = binlog::getU32(bytes.data() + pos);
+                const uint32_t checksum = binlog::getU32(bytes.data() + pos + 4);
+                const char *payload = bytes.data() + pos + kFrameHeader;
+                if (length > bytes.size() - pos - kFrameHeader || binlog::fnv1a32(payload, length) != checksum ||
+                    !decodeRecord(payload, length, key, score.name, score.score, score.combo))
+                {
+                    break;
+                }
+                score.sequence = nextSequence_++;
+                index(key, score);
+                ++logRecords_;
+                pos += kFrameHeader + length;
+            }
+            if (pos != bytes.size())
+            {
+                // A write cut short by a crash; everything before it is intact.
+                std::cerr << "TrackScoreServiceFile: Dropping " << bytes.size() - pos << " torn bytes from "
+                          << path_.string() << std::endl;
+                std::filesystem::resize_file(path_, pos, ec);
+                syncFile(path_);
+            }
+        }
+        else if (!bytes.empty())
+        {
+            std::filesystem::path aside = path_.string() + ".corrupt";
+            std::cerr << "TrackScoreServiceFile: " << path_.string() << " is not a score log; moved to "
+                      << aside.string() << std::endl;
+            std::filesystem::rename(path_, aside, ec);
+        }
+    }
+
+    log_.open(path_, writeHeader ? std::ios::binary | std::ios::trunc : std::ios::binary | std::ios::app);
+    if (!log_.is_open())
+    {
+        error_ = "Cannot open score log " + path_.string();
+        return;
+    }
+    if (writeHeader)
+    {
+        log_.write(kLogMagic, sizeof(kLogMagic));
+        log_.flush();
+        syncFile(path_);
+        syncDirectory(path_.parent_path());
+    }
+}
+
+void TrackScoreServiceFile::index(const std::string &key, StoredScore score)
+{
+    auto better = [](const StoredScore &a, const StoredScore &b)
+    { return a.score != b.score ? a.score > b.score : a.sequence < b.sequence; };
+
+    PartIndex &part = parts_[key];
+    auto pos = std::upper_bound(part.top.begin(), part.top.end(), score, better);
+    if (static_cast<std::size_t>(pos - part.top.begin()) < options_.retainPerPart)
+    {
+        part.top.insert(pos, score);
+        if (part.top.size() > options_.retainPerPart)
+        {
+            part.top.pop_back();
+        }
+        else
+        {
+            ++indexedRecords_;
+        }
+    }
+
+    auto best = part.best.find(score.name);
+    if (best == part.best.end())
+    {
+        part.best.emplace(score.name, std::move(score));
+        ++indexedRecords_;
+    }
+    else if (better(score, best->second))
+    {
+        best->second = std::move(score);
+    }
+}
+
+std::vector<ScoreEntry> TrackScoreServiceFile::scoresFor(const TrackInfo &track,
+                                                         const std::string &partName,
+                                                         ScoreCategory category) const
+{
+    if (category == ScoreCategory::Local)
+    {
+        return topScores(track, partName, kLeaderboardRows);
+    }
+    return remote_ ? remote_->scoresFor(track, partName, category) : std::vector<ScoreEntry>{};
+}
+
+std::vector<ScoreEntry> TrackScoreServiceFile::topScores(const TrackInfo &track,
+                                                         const std::string &partName,
+                                                         std::size_t count) const
+{
+    std::vector<ScoreEntry> entries;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = parts_.find(scorePartKey(track, partName));
+    if (it == parts_.end())
+    {
+        return entries;
+    }
+    const std::vector<StoredScore> &top = it->second.top;
+    entries.reserve(std::min(count, top.size()));
+    for (std::size_t i = 0; i < top.size() && i < count; ++i)
+    {
+        entries.push_back(ScoreEntry{static_cast<int>(i + 1), top[i].name, top[i].combo, top[i].score});
+    }
+    return entries;
+}
+
+std::optional<ScoreEntry> TrackScoreServiceFile::personalBest(const TrackInfo &track,
+                                                              const std::string &partName,
+                                                              const std::string &playerName) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = parts_.find(scorePartKey(track, partName));
+    if (it == parts_.end())
+    {
+        return std::nullopt;
+    }
+    auto best = it->second.best.find(playerName);
+    if (best == it->second.best.end())
+    {
+        return std::nullopt;
+    }
+
+    // Place within the retained leaderboard, or 0 when the run fell off it.
+    const StoredScore &score = best->second;
+    const std::vector<StoredScore> &top = it->second.top;
+    auto pos = std::find_if(top.begin(), top.end(), [&](const StoredScore &entry)
+                            { return entry.sequence == score.sequence; });
+    int place = pos == top.end() ? 0 : static_cast<int>(pos - top.begin()) + 1;
+    return ScoreEntry{place, score.name, score.combo, score.score};
+}
+
+bool TrackScoreServiceFile::recordScore(const TrackInfo &track, const std::string &partName, const ScoreEntry &entry)
+{
+    if (entry.name.empty())
+    {
+        return false;
+    }
+    const std::string key = scorePartKey(track, partName);
+    std::vector<char> record = encodeRecord(key, entry.name, entry.score, entry.combo);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!appendRecord(record))
+    {
+        return false;
+    }
+    if (compacting_)
+    {
+        tail_.insert(tail_.end(), record.begin(), record.end());
+        ++tailRecords_;
+    }
+    index(key, StoredScore{entry.name, entry.score, entry.combo, nextSequence_++});
+    ++logRecords_;
+
+    if (options_.backgroundCompaction && !compactRequested_ && !compacting_ && shouldCompact())
+    {
+        compactRequested_ = true;
+        ensureWorker();
+        wake_.notify_one();
+    }
+    lock.unlock();
+
+    if (remote_)
+    {
+        remote_->recordScore(track, partName, entry);
+    }
+    return true;
+}
+
+bool TrackScoreServiceFile::appendRecord(const std::vector<char> &record)
+{
+    if (!log_.is_open())
+    {
+        return false;
+    }
+    // One write per record keeps a torn write confined to the tail, where the
+    // length and checksum catch it on the next open. Runs are recorded once per
+    // song, so syncing each one costs nothing noticeable.
+    log_.write(record.data(), static_cast<std::streamsize>(record.size()));
+    log_.flush();
+    if (!log_.good())
+    {
+        return false;
+    }
+    if (!syncFile(path_))
+    {
+        std::cerr << "TrackScoreServiceFile: Cannot sync " << path_.string() << std::endl;
+    }
+    return true;
+}
+
+bool TrackScoreServiceFile::shouldCompact() const
+{
+    return logRecords_ >= options_.compactMinRecords &&
+           static_cast<double>(logRecords_) > options_.compactRatio * static_cast<double>(indexedRecords_);
+}
+
+bool TrackScoreServiceFile::compact()
+{
+    struct LiveRecord
+    {
+        uint64_t sequence;
+        std::vector<char> bytes;
+    };
+    std::vector<LiveRecord> live;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [&]
+                   { return !compacting_; });
+        if (!log_.is_open())
+        {
+            return false;
+        }
+        compacting_ = true;
+        tail_.clear();
+        tailRecords_ = 0;
+
+        std::unordered_set<uint64_t> seen;
+        for (const auto &[key, part] : parts_)
+        {
+            seen.clear();
+            auto keep = [&](const StoredScore &score)
+            {
+                if (seen.insert(score.sequence).second)
+                {
+                    live.push_back(LiveRecord{score.sequence, encodeRecord(key, score.name, score.score, score.combo)});
+                }
+            };
+            std::for_each(part.top.begin(), part.top.end(), keep);
+            for (const auto &[name, score] : part.best)
+            {
+                keep(score);
+            }
+        }
+    }
+    // Replaying in the original order keeps tie-breaks stable across reloads.
+    std::sort(live.begin(), live.end(), [](const LiveRecord &a, const LiveRecord &b)
+              { return a.sequence < b.sequence; });
+
+    const std::filesystem::path temp = path_.string() + ".compact";
+    bool written = false;
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out.write(kLogMagic, sizeof(kLogMagic));
+        for (const LiveRecord &record : live)
+        {
+            out.write(record.bytes.data(), static_cast<std::streamsize>(record.bytes.size()));
+        }
+        out.flush();
+        written = out.good();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    if (written)
+    {
+        // Runs recorded while the snapshot was written went to the old log; carry
+        // them over before the swap.
+        std::ofstream out(temp, std::ios::binary | std::ios::app);
+        out.write(tail_.data(), static_cast<std::streamsize>(tail_.size()));
+        out.close();
+        written = out.good();
+    }
+    if (written)
+    {
+        // The snapshot must be on the device before it replaces the log, or a crash
+        // could leave an empty log under the old name.
+        log_.close();
+        written = replaceFileDurably(temp, path_, ec);
+        log_.open(path_, std::ios::binary | std::ios::app);
+        if (written)
+        {
+            logRecords_ = live.size() + tailRecords_;
+        }
+        if (!log_.is_open())
+        {
+            error_ = "Cannot reopen score log " + path_.string();
+        }
+    }
+    if (!written)
+    {
+        std::cerr << "TrackScoreServiceFile: Compaction of " << path_.string() << " failed." << std::endl;
+        std::filesystem::remove(temp, ec);
+    }
+    compacting_ = false;
+    tail_.clear();
+    tailRecords_ = 0;
+    idle_.notify_all();
+    return written;
+}
+
+void TrackScoreServiceFile::waitForCompaction()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [&]
+               { return !compacting_ && !compactRequested_; });
+}
+
+std::size_t TrackScoreServiceFile::logRecords() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return logRecords_;
+}
+
+std::size_t TrackScoreServiceFile::indexedRecords() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return indexedRecords_;
+}
+
+void TrackScoreServiceFile::ensureWorker()
+{
+    if (!worker_.joinable())
+    {
+        worker_ = std::thread([this]
+                              { run(); });
+    }
+}
+
+void TrackScoreServiceFile::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        wake_.wait(lock, [&]
+                   { return stop_ || compactRequested_; });
+        if (stop_)
+        {
+            break;
+        }
+        lock.unlock();
+        compact();
+        lock.lock();
+        compactRequested_ = false;
+        idle_.notify_all();
+    }
+}
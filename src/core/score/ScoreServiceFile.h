@@ -0,0 +1,105 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "score/ScoreService.h"
+
+struct ScoreStoreOptions
+{
+    std::size_t retainPerPart = 100;     // Best runs per (track, part) that survive compaction
+    std::size_t compactMinRecords = 512; // No compaction below this many log records
+    double compactRatio = 2.0;           // Compact when the log holds this many times the live records
+    bool backgroundCompaction = true;
+};
+
+// Local scores on disk. Runs are appended to a checksummed record log and folded
+// into an in-memory index per (track, part): the top runs in order plus each
+// player's best, so leaderboard and personal-best queries never touch the log.
+// Opening replays the log once and truncates a torn tail left by a crash.
+// Compaction rewrites only the indexed runs to a temporary file on a worker thread
+// and swaps it in with a rename, so the log on disk is always complete.
+class TrackScoreServiceFile : public TrackScoreService
+{
+public:
+    // Non-local categories are read from remote when one is given, and recorded
+    // runs are passed on to it after they are stored locally.
+    explicit TrackScoreServiceFile(std::filesystem::path logPath,
+                                   std::unique_ptr<TrackScoreService> remote = nullptr,
+                                   ScoreStoreOptions options = {});
+    ~TrackScoreServiceFile() override;
+
+    TrackScoreServiceFile(const TrackScoreServiceFile &) = delete;
+    TrackScoreServiceFile &operator=(const TrackScoreServiceFile &) = delete;
+
+    bool ok() const { return error_.empty(); }
+    const std::string &error() const { return error_; }
+
+    std::vector<ScoreEntry> scoresFor(const TrackInfo &track,
+                                      const std::string &partName,
+                                      ScoreCategory category) const override;
+    bool recordScore(const TrackInfo &track, const std::string &partName, const ScoreEntry &entry) override;
+    std::optional<ScoreEntry> personalBest(const TrackInfo &track,
+                                           const std::string &partName,
+                                           const std::string &playerName) const override;
+
+    std::vector<ScoreEntry> topScores(const TrackInfo &track, const std::string &partName, std::size_t count) const;
+
+    // Rewrites the log synchronously; returns false if the rewrite failed.
+    bool compact();
+    void waitForCompaction();
+    std::size_t logRecords() const;
+    std::size_t indexedRecords() const;
+
+private:
+    struct StoredScore
+    {
+        std::string name;
+        int score = 0;
+        int combo = 0;
+        uint64_t sequence = 0; // Log order; earlier runs win ties
+    };
+
+    struct PartIndex
+    {
+        std::vector<StoredScore> top; // Best first, at most retainPerPart
+        std::unordered_map<std::string, StoredScore> best;
+    };
+
+    void load();
+    void index(const std::string &key, StoredScore score);
+    bool appendRecord(const std::vector<char> &record);
+    bool shouldCompact() const;
+    void ensureWorker();
+    void run();
+
+    std::filesystem::path path_;
+    std::unique_ptr<TrackScoreService> remote_;
+    ScoreStoreOptions options_;
+    std::string error_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::unordered_map<std::string, PartIndex> parts_;
+    std::ofstream log_;
+    std::size_t logRecords_ = 0;
+    std::size_t indexedRecords_ = 0; // Top entries plus personal bests; may count a run twice
+    uint64_t nextSequence_ = 0;
+    bool compacting_ = false;
+    std::vector<char> tail_; // Records appended while a compaction is writing
+    std::size_t tailRecords_ = 0;
+
+    std::thread worker_;
+    bool compactRequested_ = false;
+    bool stop_ = false;
+};
@@ -0,0 +1,320 @@
+#include "score/ScoreServiceOnline.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+    std::string sanitizeField(std::string value)
+    {
+        std::replace_if(value.begin(), value.end(), [](char c)
+                        { return c == '\t' || c == '\n' || c == '\r'; }, ' ');
+        return value;
+    }
+
+    std::vector<std::string> splitFields(const std::string &line)
+    {
+        std::vector<std::string> fields;
+        std::size_t start = 0;
+        while (true)
+        {
+            const std::size_t tab = line.find('\t', start);
+            fields.push_back(line.substr(start, tab - start));
+            if (tab == std::string::npos)
+            {
+                return fields;
+            }
+            start = tab + 1;
+        }
+    }
+
+    std::vector<ScoreEntry> parseLeaderboard(const std::string &body)
+    {
+        std::vector<ScoreEntry> entries;
+        std::istringstream in(body);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+            std::vector<std::string> fields = splitFields(line);
+            if (fields.size() != 4)
+            {
+                continue;
+            }
+            entries.push_back(ScoreEntry{std::atoi(fields[0].c_str()), fields[1], std::atoi(fields[2].c_str()),
+                                         std::atoi(fields[3].c_str())});
+        }
+        return entries;
+    }
+
+    const char *scopeName(ScoreCategory category)
+    {
+        return category == ScoreCategory::Country ? "country" : "online";
+    }
+}
+
+TrackScoreServiceOnline::TrackScoreServiceOnline(LeaderboardOptions options, HttpTransport transport)
+    : options_(std::move(options)), transport_(std::move(transport))
+{
+    options_.batchSize = std::max<std::size_t>(options_.batchSize, 1);
+    while (!options_.baseUrl.empty() && options_.baseUrl.back() == '/')
+    {
+        options_.baseUrl.pop_back();
+    }
+    loadQueue();
+    worker_ = std::thread([this]
+                          { run(); });
+}
+
+TrackScoreServiceOnline::~TrackScoreServiceOnline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    if (worker_.joinable())
+    {
+        worker_.join();
+    }
+}
+
+std::string TrackScoreServiceOnline::leaderboardUrl(const TrackInfo &track, const std::string &partName,
+                                                    ScoreCategory category) const
+{
+    std::string url = options_.baseUrl + "/leaderboard?title=" + urlEncode(track.title) +
+                      "&artist=" + urlEncode(track.artist) + "&part=" + urlEncode(partName) +
+                      "&scope=" + scopeName(category);
+    if (category == ScoreCategory::Country && !options_.country.empty())
+    {
+        url += "&country=" + urlEncode(options_.country);
+    }
+    return url;
+}
+
+std::vector<ScoreEntry> TrackScoreServiceOnline::scoresFor(const TrackInfo &track,
+                                                           const std::string &partName,
+                                                           ScoreCategory category) const
+{
+    if (category == ScoreCategory::Local || options_.baseUrl.empty())
+    {
+        return {};
+    }
+    const std::string key = std::string(scopeName(category)) + '\x1f' + scorePartKey(track, partName);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    CacheEntry &entry = cache_[key];
+    if (!entry.fetching && Clock::now() >= entry.expires)
+    {
+        entry.fetching = true;
+        fetches_.push_back(FetchJob{key, leaderboardUrl(track, partName, category)});
+        wake_.notify_one();
+    }
+    return entry.entries;
+}
+
+bool TrackScoreServiceOnline::recordScore(const TrackInfo &track, const std::string &partName, const ScoreEntry &entry)
+{
+    if (options_.baseUrl.empty() || entry.name.empty())
+    {
+        return false;
+    }
+    std::string row = sanitizeField(track.title) + '\t' + sanitizeField(track.artist) + '\t' +
+                      sanitizeField(partName) + '\t' + sanitizeField(entry.name) + '\t' +
+                      std::to_string(entry.combo) + '\t' + std::to_string(entry.score);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.push_back(std::move(row));
+    saveQueue();
+    wake_.notify_one();
+    return true;
+}
+
+std::size_t TrackScoreServiceOnline::pendingSubmissions() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
+
+uint64_t TrackScoreServiceOnline::cacheVersion() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cacheVersion_;
+}
+
+void TrackScoreServiceOnline::flush()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    backoff_ = std::chrono::milliseconds(0);
+    retryAt_ = Clock::now();
+    wake_.notify_one();
+}
+
+bool TrackScoreServiceOnline::submissionDue(Clock::time_point now) const
+{
+    return !pending_.empty() && now >= retryAt_;
+}
+
+bool TrackScoreServiceOnline::idle(Clock::time_point now) const
+{
+    return fetches_.empty() && inFlight_ == 0 && !submissionDue(now);
+}
+
+bool TrackScoreServiceOnline::waitIdle(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return idle_.wait_for(lock, timeout, [&]
+                          { return idle(Clock::now()); });
+}
+
+void TrackScoreServiceOnline::loadQueue()
+{
+    if (options_.queuePath.empty())
+    {
+        return;
+    }
+    std::ifstream in(options_.queuePath);
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (splitFields(line).size() == 6)
+        {
+            pending_.push_back(line);
+        }
+    }
+}
+
+void TrackScoreServiceOnline::saveQueue() const
+{
+    if (options_.queuePath.empty())
+    {
+        return;
+    }
+    // Rewritten whole through a rename so a crash leaves either queue, never half.
+    const std::filesystem::path temp = options_.queuePath.string() + ".tmp";
+    {
+        std::ofstream out(temp, std::ios::trunc);
+        for (const std::string &row : pending_)
+        {
+            out << row << '\n';
+        }
+        if (!out.good())
+        {
+            std::cerr << "TrackScoreServiceOnline: Cannot write " << temp.string() << std::endl;
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, options_.queuePath, ec);
+}
+
+void TrackScoreServiceOnline::run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_)
+    {
+        if (!fetches_.empty())
+        {
+            FetchJob job = std::move(fetches_.front());
+            fetches_.pop_front();
+            ++inFlight_;
+            lock.unlock();
+            fetch(job);
+            lock.lock();
+            --inFlight_;
+            idle_.notify_all();
+            continue;
+        }
+        if (submissionDue(Clock::now()))
+        {
+            const std::size_t count = std::min(options_.batchSize, pending_.size());
+            std::vector<std::string> batch(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+            ++inFlight_;
+            lock.unlock();
+            submitBatch(std::move(batch));
+            lock.lock();
+            --inFlight_;
+            idle_.notify_all();
+            continue;
+        }
+
+        idle_.notify_all();
+        if (pending_.empty())
+        {
+            wake_.wait(lock);
+        }
+        else
+        {
+            wake_.wait_until(lock, retryAt_);
+        }
+    }
+}
+
+void TrackScoreServiceOnline::fetch(const FetchJob &job)
+{
+    HttpRequest request;
+    request.url = job.url;
+    request.timeout = options_.timeout;
+    HttpResponse response = transport_(request);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    CacheEntry &entry = cache_[job.key];
+    entry.fetching = false;
+    if (response.ok())
+    {
+        entry.entries = parseLeaderboard(response.body);
+        entry.expires = Clock::now() + options_.ttl;
+        ++cacheVersion_;
+    }
+    else
+    {
+        // Keep serving the stale board and try again later.
+        entry.expires = Clock::now() + options_.failureTtl;
+    }
+}
+
+void TrackScoreServiceOnline::submitBatch(std::vector<std::string> batch)
+{
+    HttpRequest request;
+    request.method = "POST";
+    request.url = options_.baseUrl + "/scores";
+    request.contentType = "text/tab-separated-values";
+    request.timeout = options_.timeout;
+    for (const std::string &row : batch)
+    {
+        request.body += row;
+        request.body += '\n';
+    }
+    HttpResponse response = transport_(request);
+
+    // Client errors other than timeouts and throttling will never succeed, so the
+    // batch is dropped rather than retried forever.
+    const bool rejected = response.status >= 400 && response.status < 500 && response.status != 408 &&
+                          response.status != 429;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (response.ok() || rejected)
+    {
+        if (rejected)
+        {
+            std::cerr << "TrackScoreServiceOnline: Server rejected " << batch.size() << " scores (HTTP "
+                      << response.status << ")." << std::endl;
+        }
+        // Only the worker removes rows, so the batch is still at the front.
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(batch.size()));
+        backoff_ = std::chrono::milliseconds(0);
+        retryAt_ = Clock::now();
+        saveQueue();
+        return;
+    }
+    backoff_ = backoff_.count() == 0 ? options_.retryInitial : std::min(backoff_ * 2, options_.retryMax);
+    retryAt_ = Clock::now() + backoff_;
+}
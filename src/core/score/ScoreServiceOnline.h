@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "net/HttpClient.h"
+#include "score/ScoreService.h"
+
+struct LeaderboardOptions
+{
+    std::string baseUrl;  // Server root, e.g. http://localhost:8080/api
+    std::string country;  // Sent with Country queries; empty lets the server decide
+    std::chrono::milliseconds ttl{60000};
+    std::chrono::milliseconds failureTtl{10000}; // Wait before refetching after an error
+    std::size_t batchSize = 25;
+    std::chrono::milliseconds retryInitial{1000};
+    std::chrono::milliseconds retryMax{60000};
+    std::chrono::milliseconds timeout{4000};
+    std::filesystem::path queuePath; // Pending submissions survive restarts here; empty keeps them in memory
+};
+
+// Online and Country leaderboards over HTTP. All network work runs on one worker
+// thread: scoresFor returns whatever is cached (possibly stale or empty) and queues
+// a refresh when the entry has expired, so the UI never waits on the network.
+// Submissions go into an offline queue that is posted in batches and retried with
+// exponential backoff until the server accepts them.
+//
+// Wire format is tab separated text. GET {base}/leaderboard?title=&artist=&part=
+// &scope=online|country[&country=] answers "place name combo score" rows; POST
+// {base}/scores takes "title artist part name combo score" rows.
+class TrackScoreServiceOnline : public TrackScoreService
+{
+public:
+    explicit TrackScoreServiceOnline(LeaderboardOptions options, HttpTransport transport = httpRequest);
+    ~TrackScoreServiceOnline() override;
+
+    TrackScoreServiceOnline(const TrackScoreServiceOnline &) = delete;
+    TrackScoreServiceOnline &operator=(const TrackScoreServiceOnline &) = delete;
+
+    std::vector<ScoreEntry> scoresFor(const TrackInfo &track,
+                                      const std::string &partName,
+                                      ScoreCategory category) const override;
+    bool recordScore(const TrackInfo &track, const std::string &partName, const ScoreEntry &entry) override;
+
+    std::size_t pendingSubmissions() const;
+    // Bumped whenever a fetch lands, so callers can tell fresh data from a repeat.
+    uint64_t cacheVersion() const;
+    // Retries queued submissions now instead of waiting out the backoff.
+    void flush();
+    // Waits until no fetch is queued or running and no submission is due.
+    bool waitIdle(std::chrono::milliseconds timeout) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct CacheEntry
+    {
+        std::vector<ScoreEntry> entries;
+        Clock::time_point expires{};
+        bool fetching = false;
+    };
+
+    struct FetchJob
+    {
+        std::string key;
+        std::string url;
+    };
+
+    std::string leaderboardUrl(const TrackInfo &track, const std::string &partName, ScoreCategory category) const;
+    bool submissionDue(Clock::time_point now) const;
+    bool idle(Clock::time_point now) const;
+    void loadQueue();
+    void saveQueue() const;
+    void run();
+    void fetch(const FetchJob &job);
+    void submitBatch(std::vector<std::string> batch);
+
+    LeaderboardOptions options_;
+    HttpTransport transport_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable wake_;
+    mutable std::condition_variable idle_;
+    mutable std::unordered_map<std::string, CacheEntry> cache_;
+    mutable std::deque<FetchJob> fetches_;
+    std::deque<std::string> pending_; // Submission rows, oldest first
+    std::size_t inFlight_ = 0;        // Fetches or batches the worker is running
+    std::chrono::milliseconds backoff_{0};
+    Clock::time_point retryAt_{};
+    uint64_t cacheVersion_ = 0;
+    bool stop_ = false;
+    std::thread worker_;
+};
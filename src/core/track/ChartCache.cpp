@@ -0,0 +1,30 @@
+#include "track/ChartCache.h"
+
+#include <iostream>
+
+#include "track/ChartFile.h"
+
+std::shared_ptr<const ChartFile> ChartCache::open(const std::string &path) const
+{
+    if (path.empty())
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::weak_ptr<const ChartFile> &slot = charts_[path];
+    if (std::shared_ptr<const ChartFile> chart = slot.lock())
+    {
+        return chart;
+    }
+
+    std::string error;
+    std::shared_ptr<const ChartFile> chart = ChartFile::open(path, error);
+    if (!chart)
+    {
+        std::cerr << "Chart load failed: " << error << std::endl;
+        return nullptr;
+    }
+    slot = chart;
+    return chart;
+}
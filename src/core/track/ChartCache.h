@@ -0,0 +1,22 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+class ChartFile;
+
+// Charts mapped by path on demand and dropped once nobody holds them, so
+// browsing a catalog never touches chart files. Safe to call from any thread.
+class ChartCache
+{
+public:
+    // Maps the chart on first use; later calls share the same mapping. Null and
+    // logged when the file cannot be opened, null for an empty path.
+    std::shared_ptr<const ChartFile> open(const std::string &path) const;
+
+private:
+    mutable std::mutex mutex_;
+    mutable std::map<std::string, std::weak_ptr<const ChartFile>> charts_;
+};
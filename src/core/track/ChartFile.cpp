@@ -0,0 +1,182 @@
+#include "track/ChartFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace chartformat;
+
+namespace
+{
+    bool sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+    {
+        if (offset % kAlignment != 0 || offset > fileSize)
+        {
+            return false;
+        }
+        return count <= (fileSize - offset) / elementSize;
+    }
+}
+
+std::shared_ptr<const ChartFile> ChartFile::open(const std::filesystem::path &path, std::string &error)
+{
+    std::shared_ptr<ChartFile> chart(new ChartFile());
+    if (!chart->file_.open(path, error))
+    {
+        return nullptr;
+    }
+    if (!chart->validate(error))
+    {
+        error = path.string() + ": " + error;
+        return nullptr;
+    }
+    return chart;
+}
+
+bool ChartFile::validate(std::string &error)
+{
+    std::span<const std::byte> bytes = file_.bytes();
+    if (bytes.size() < sizeof(ChartFileHeader))
+    {
+        error = "file too small for a chart header";
+        return false;
+    }
+    header_ = reinterpret_cast<const ChartFileHeader *>(bytes.data());
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0)
+    {
+        error = "not a chart file";
+        return false;
+    }
+    if (header_->version != kVersion)
+    {
+        error = "unsupported chart version " + std::to_string(header_->version);
+        return false;
+    }
+    const uint64_t size = bytes.size();
+    if (header_->fileSize != size)
+    {
+        error = "chart is truncated";
+        return false;
+    }
+    if (header_->ticksPerQuarter == 0 || header_->tempoCount == 0 ||
+        !sectionFits(header_->tempoOffset, header_->tempoCount, sizeof(ChartFileTempo), size) ||
+        !sectionFits(header_->partOffset, header_->partCount, sizeof(ChartFilePart), size) ||
+        !sectionFits(header_->stringTableOffset, header_->stringTableSize, 1, size))
+    {
+        error = "corrupt chart header";
+        return false;
+    }
+
+    tempo_ = column<ChartFileTempo>(header_->tempoOffset, header_->tempoCount);
+    parts_ = column<ChartFilePart>(header_->partOffset, header_->partCount);
+    for (const ChartFilePart &entry : parts_)
+    {
+        const uint64_t n = entry.noteCount;
+        bool ok = sectionFits(entry.startTickOffset, n, sizeof(uint32_t), size) &&
+                  sectionFits(entry.durationOffset, n, sizeof(uint32_t), size) &&
+                  sectionFits(entry.stringOffset, n, sizeof(uint8_t), size) &&
+                  sectionFits(entry.fretOffset, n, sizeof(uint8_t), size) &&
+                  sectionFits(entry.flagsOffset, n, sizeof(uint16_t), size) &&
+                  sectionFits(entry.indexOffset, entry.indexCount, sizeof(uint32_t), size) &&
+                  entry.indexCount > 0 &&
+                  static_cast<uint64_t>(entry.nameOffset) + entry.nameLength <= header_->stringTableSize;
+        if (!ok)
+        {
+            error = "corrupt chart part table";
+            return false;
+        }
+    }
+
+    // Lookups binary-search the tempo map and index notes through secondIndex, so
+    // both must be ordered and the index must stay inside the note columns.
+    for (std::size_t i = 1; i < tempo_.size(); ++i)
+    {
+        if (tempo_[i].tick < tempo_[i - 1].tick)
+        {
+            error = "tempo changes are out of order";
+            return false;
+        }
+    }
+    tempoMap_ = TempoMap(header_->ticksPerQuarter, tempo_);
+
+    for (std::size_t p = 0; p < parts_.size(); ++p)
+    {
+        const ChartPartView view = part(p);
+        if (!std::is_sorted(view.startTick.begin(), view.startTick.end()))
+        {
+            error = "notes of part " + std::string(view.name) + " are out of order";
+            return false;
+        }
+        uint32_t previous = 0;
+        for (uint32_t first : view.secondIndex)
+        {
+            if (first < previous || first > view.size())
+            {
+                error = "corrupt seek index in part " + std::string(view.name);
+                return false;
+            }
+            previous = first;
+        }
+    }
+    return true;
+}
+
+ChartPartView ChartFile::part(std::size_t index) const
+{
+    const ChartFilePart &entry = parts_[index];
+    const char *strings = reinterpret_cast<const char *>(file_.bytes().data() + header_->stringTableOffset);
+
+    ChartPartView view;
+    view.name = std::string_view(strings + entry.nameOffset, entry.nameLength);
+    view.startTick = column<uint32_t>(entry.startTickOffset, entry.noteCount);
+    view.duration = column<uint32_t>(entry.durationOffset, entry.noteCount);
+    view.string = column<uint8_t>(entry.stringOffset, entry.noteCount);
+    view.fret = column<uint8_t>(entry.fretOffset, entry.noteCount);
+    view.flags = column<uint16_t>(entry.flagsOffset, entry.noteCount);
+    view.secondIndex = column<uint32_t>(entry.indexOffset, entry.indexCount);
+    return view;
+}
+
+int ChartFile::findPart(std::string_view name) const
+{
+    for (std::size_t i = 0; i < parts_.size(); ++i)
+    {
+        if (part(i).name == name)
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int ChartFile::findPart(const TrackPart &entry) const
+{
+    // The block index is only a hint: a re-exported chart may have reordered its parts.
+    if (entry.chartBlock >= 0 && static_cast<std::size_t>(entry.chartBlock) < parts_.size() &&
+        part(static_cast<std::size_t>(entry.chartBlock)).name == entry.name)
+    {
+        return entry.chartBlock;
+    }
+    return findPart(entry.name);
+}
+
+std::size_t ChartFile::firstNoteAtOrAfter(const ChartPartView &part, double seconds) const
+{
+    if (seconds <= 0.0 || part.secondIndex.empty())
+    {
+        return 0;
+    }
+    const std::size_t lastBucket = part.secondIndex.size() - 1;
+    const std::size_t bucket = std::min(static_cast<std::size_t>(std::floor(seconds)), lastBucket);
+
+    // Past the last bucket the remaining notes are scanned to the end of the part.
+    std::size_t note = std::min<std::size_t>(part.secondIndex[bucket], part.size());
+    const std::size_t end = bucket < lastBucket ? std::min<std::size_t>(part.secondIndex[bucket + 1], part.size())
+                                                : part.size();
+    TempoMap::Cursor cursor = tempoMap_.cursor();
+    while (note < end && cursor.tickToSeconds(part.startTick[note]) < seconds)
+    {
+        ++note;
+    }
+    return note;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "MappedFile.h"
+#include "track/ChartFormat.h"
+#include "track/TempoMap.h"
+#include "track/TrackTypes.h"
+
+// Column views of one part. All spans point straight into the mapping.
+struct ChartPartView
+{
+    std::string_view name;
+    std::span<const uint32_t> startTick;
+    std::span<const uint32_t> duration;
+    std::span<const uint8_t> string;
+    std::span<const uint8_t> fret;
+    std::span<const uint16_t> flags;
+    std::span<const uint32_t> secondIndex;
+
+    std::size_t size() const { return startTick.size(); }
+};
+
+// A mapped .occhart file. Opening validates the header, the section bounds and
+// the ordering the lookups rely on once; after that every accessor is a pointer
+// cast into the mapping.
+class ChartFile
+{
+public:
+    static std::shared_ptr<const ChartFile> open(const std::filesystem::path &path, std::string &error);
+
+    uint32_t ticksPerQuarter() const { return header_->ticksPerQuarter; }
+    std::span<const chartformat::ChartFileTempo> tempo() const { return tempo_; }
+    std::size_t partCount() const { return parts_.size(); }
+    ChartPartView part(std::size_t index) const;
+    int findPart(std::string_view name) const;
+    // Part a catalog entry refers to: its chartBlock when that still carries the
+    // entry's name, otherwise a lookup by name. -1 when the chart lacks the part.
+    int findPart(const TrackPart &entry) const;
+
+    double tickToSeconds(uint32_t tick) const { return tempoMap_.tickToSeconds(tick); }
+    // Built from the tempo table once on open.
+    const TempoMap &tempoMap() const { return tempoMap_; }
+    // Index of the first note starting at or after `seconds`, or part size if none.
+    // Jumps to the one-second bucket and scans only within it.
+    std::size_t firstNoteAtOrAfter(const ChartPartView &part, double seconds) const;
+
+private:
+    ChartFile() = default;
+    bool validate(std::string &error);
+
+    template <typename T>
+    std::span<const T> column(uint64_t offset, uint64_t count) const
+    {
+        return {reinterpret_cast<const T *>(file_.bytes().data() + offset), static_cast<std::size_t>(count)};
+    }
+
+    MappedFile file_;
+    const chartformat::ChartFileHeader *header_ = nullptr;
+    std::span<const chartformat::ChartFileTempo> tempo_;
+    std::span<const chartformat::ChartFilePart> parts_;
+    TempoMap tempoMap_;
+};
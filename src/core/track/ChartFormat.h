@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of .occhart files. Everything is little-endian and every section
+// starts on an 8-byte boundary, so a mapped file is used in place without parsing.
+//
+//   ChartFileHeader
+//   ChartFileTempo[tempoCount]
+//   ChartFilePart[partCount]
+//   per part: uint32 startTick[n] | uint32 duration[n] | uint8 string[n] |
+//             uint8 fret[n] | uint16 flags[n] | uint32 secondIndex[indexCount]
+//   string table (part names, not terminated)
+namespace chartformat
+{
+    inline constexpr char kMagic[8] = {'O', 'C', 'C', 'H', 'A', 'R', 'T', '\0'};
+    inline constexpr uint32_t kVersion = 1;
+    inline constexpr uint64_t kAlignment = 8;
+
+    struct ChartFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t ticksPerQuarter;
+        uint32_t tempoCount;
+        uint32_t partCount;
+        uint64_t tempoOffset;
+        uint64_t partOffset;
+        uint64_t stringTableOffset;
+        uint64_t stringTableSize;
+        uint64_t fileSize;
+    };
+
+    struct ChartFileTempo
+    {
+        uint32_t tick;
+        uint32_t microsPerQuarter;
+        double startSeconds; // Precomputed so lookups need no accumulation
+    };
+
+    struct ChartFilePart
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t noteCount;
+        uint32_t indexCount; // secondIndex[s] = first note starting at or after s seconds
+        uint64_t startTickOffset;
+        uint64_t durationOffset;
+        uint64_t stringOffset;
+        uint64_t fretOffset;
+        uint64_t flagsOffset;
+        uint64_t indexOffset;
+    };
+
+    static_assert(sizeof(ChartFileHeader) == 64);
+    static_assert(sizeof(ChartFileTempo) == 16);
+    static_assert(sizeof(ChartFilePart) == 64);
+}
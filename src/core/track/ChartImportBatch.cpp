@@ -0,0 +1,341 @@
+#include "track/ChartImportBatch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <span>
+#include <thread>
+
+#include "track/ChartWriter.h"
+#include "track/GuitarProImporter.h"
+#include "track/MidiImporter.h"
+
+namespace
+{
+    // Bump when the importer output changes for the same input.
+    constexpr uint64_t kImporterRevision = 1;
+    constexpr const char *kManifestName = "import-manifest.tsv";
+
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t fnv1a(std::span<const char> bytes, uint64_t hash = 14695981039346656037ull ^ kImporterRevision)
+    {
+        for (char c : bytes)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // The string mapping changes what a .mid file compiles to, so it is part of the key.
+    uint64_t mixMidiOptions(uint64_t hash, const MidiImportOptions &midi)
+    {
+        const int fields[] = {midi.firstChannel, midi.stringCount};
+        for (int field : fields)
+        {
+            for (int shift = 0; shift < 32; shift += 8)
+            {
+                char byte = static_cast<char>((static_cast<uint32_t>(field) >> shift) & 0xFF);
+                hash = fnv1a(std::span<const char>(&byte, 1), hash);
+            }
+        }
+        return fnv1a(std::span<const char>(reinterpret_cast<const char *>(midi.tuning.data()), midi.tuning.size()),
+                     hash);
+    }
+
+    bool readBytes(const std::filesystem::path &path, std::vector<char> &bytes)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in.good())
+        {
+            return false;
+        }
+        bytes.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        return !in.bad();
+    }
+
+    std::string lowerExtension(const std::filesystem::path &path)
+    {
+        std::string ext = path.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext;
+    }
+
+    bool isMidiFile(const std::filesystem::path &path)
+    {
+        std::string ext = lowerExtension(path);
+        return ext == ".mid" || ext == ".midi";
+    }
+
+    bool isImportable(const std::filesystem::path &path)
+    {
+        std::string ext = lowerExtension(path);
+        return ext == ".gp3" || ext == ".gp4" || ext == ".gp5" || isMidiFile(path);
+    }
+
+    bool parseSource(const std::filesystem::path &source, const MidiImportOptions &midi, std::span<const std::byte> bytes,
+                     ChartData &chart, std::string &title, std::string &error)
+    {
+        if (isMidiFile(source))
+        {
+            MidiSong song;
+            if (!parseMidi(bytes, midi, song, error))
+            {
+                return false;
+            }
+            title = song.title;
+            chart = std::move(song.chart);
+            return true;
+        }
+        GuitarProSong song;
+        if (!parseGuitarPro(bytes, song, error))
+        {
+            return false;
+        }
+        title = song.title;
+        chart = std::move(song.chart);
+        return true;
+    }
+
+    // Manifest rows are "<hash hex>\t<source path relative to the input root>".
+    std::map<std::string, uint64_t> readManifest(const std::filesystem::path &path)
+    {
+        std::map<std::string, uint64_t> manifest;
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            std::size_t tab = line.find('\t');
+            if (tab == std::string::npos)
+            {
+                continue;
+            }
+            try
+            {
+                manifest[line.substr(tab + 1)] = std::stoull(line.substr(0, tab), nullptr, 16);
+            }
+            catch (const std::exception &)
+            {
+            }
+        }
+        return manifest;
+    }
+
+    bool writeManifest(const std::filesystem::path &path, const std::map<std::string, uint64_t> &manifest)
+    {
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::trunc);
+            if (!out.good())
+            {
+                return false;
+            }
+            char hex[17];
+            for (const auto &[source, hash] : manifest)
+            {
+                std::snprintf(hex, sizeof(hex), "%016" PRIx64, hash);
+                out << hex << '\t' << source << '\n';
+            }
+            if (!out.good())
+            {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+
+    struct ImportJob
+    {
+        std::filesystem::path source;
+        std::string key; // Relative source path, generic format
+        std::filesystem::path chart;
+        bool known = false;
+        uint64_t previousHash = 0;
+        uint64_t hash = 0;
+        std::filesystem::path sharedWith; // Earlier source that converts to the same chart
+    };
+
+    void runJob(ImportJob &job, const ChartImportOptions &options, ChartImportResult &result)
+    {
+        const auto start = Clock::now();
+        result.source = job.source;
+        result.chart = job.chart;
+
+        std::vector<char> bytes;
+        if (!job.sharedWith.empty())
+        {
+            result.error = job.source.string() + " converts to the same chart as " + job.sharedWith.string();
+        }
+        else if (!readBytes(job.source, bytes))
+        {
+            result.error = "Cannot read " + job.source.string();
+        }
+        else
+        {
+            job.hash = fnv1a(bytes);
+            if (isMidiFile(job.source))
+            {
+                job.hash = mixMidiOptions(job.hash, options.midi);
+            }
+            std::error_code ec;
+            if (!options.force && job.known && job.hash == job.previousHash && std::filesystem::exists(job.chart, ec))
+            {
+                result.status = ChartImportStatus::Unchanged;
+            }
+            else
+            {
+                ChartData chart;
+                std::string title;
+                if (parseSource(job.source, options.midi, std::as_bytes(std::span<const char>(bytes)), chart, title,
+                                result.error))
+                {
+                    std::filesystem::create_directories(job.chart.parent_path(), ec);
+                    if (writeChart(job.chart, chart, result.error))
+                    {
+                        result.status = ChartImportStatus::Converted;
+                        result.title = title.empty() ? job.source.stem().string() : title;
+                        result.parts = chart.parts.size();
+                    }
+                }
+            }
+        }
+        result.millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+}
+
+ChartImportReport importCharts(const ChartImportOptions &options)
+{
+    ChartImportReport report;
+    const auto start = Clock::now();
+
+    std::error_code ec;
+    std::vector<std::filesystem::path> sources;
+    std::filesystem::path root = options.input;
+    if (std::filesystem::is_regular_file(options.input, ec))
+    {
+        sources.push_back(options.input);
+        root = options.input.parent_path();
+    }
+    else if (std::filesystem::is_directory(options.input, ec))
+    {
+        auto it = std::filesystem::recursive_directory_iterator(
+            options.input, std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (it->is_regular_file(ec) && isImportable(it->path()))
+            {
+                sources.push_back(it->path());
+            }
+        }
+        std::sort(sources.begin(), sources.end());
+    }
+    else
+    {
+        report.error = "Input not found: " + options.input.string();
+        return report;
+    }
+
+    std::filesystem::create_directories(options.output, ec);
+    if (!std::filesystem::is_directory(options.output, ec))
+    {
+        report.error = "Cannot create output directory " + options.output.string();
+        return report;
+    }
+
+    const std::filesystem::path manifestPath = options.output / kManifestName;
+    std::map<std::string, uint64_t> manifest = readManifest(manifestPath);
+
+    std::vector<ImportJob> jobs(sources.size());
+    std::map<std::filesystem::path, std::size_t> charts; // Target chart -> first job writing it
+    for (std::size_t i = 0; i < sources.size(); ++i)
+    {
+        ImportJob &job = jobs[i];
+        std::filesystem::path relative = sources[i].lexically_relative(root);
+        job.source = sources[i];
+        job.key = relative.generic_string();
+        job.chart = (options.output / relative).replace_extension(".occhart");
+        // song.gp5 and song.mid side by side would overwrite each other's chart.
+        auto [target, inserted] = charts.emplace(job.chart, i);
+        if (!inserted)
+        {
+            job.sharedWith = jobs[target->second].source;
+        }
+        auto known = manifest.find(job.key);
+        if (known != manifest.end())
+        {
+            job.known = true;
+            job.previousHash = known->second;
+        }
+    }
+
+    // Files are independent, so workers just pull the next index.
+    unsigned workers = options.jobs > 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(jobs.size(), 1)));
+    report.jobs = workers;
+    report.results.resize(jobs.size());
+    std::atomic<std::size_t> next{0};
+    auto work = [&]()
+    {
+        for (std::size_t i = next.fetch_add(1); i < jobs.size(); i = next.fetch_add(1))
+        {
+            // An exception escaping a worker would terminate the process, so one bad
+            // file only fails its own job.
+            try
+            {
+                runJob(jobs[i], options, report.results[i]);
+            }
+            catch (const std::exception &e)
+            {
+                report.results[i].status = ChartImportStatus::Failed;
+                report.results[i].error = jobs[i].source.string() + ": " + e.what();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t i = 0; i < jobs.size(); ++i)
+    {
+        switch (report.results[i].status)
+        {
+        case ChartImportStatus::Converted:
+            ++report.converted;
+            manifest[jobs[i].key] = jobs[i].hash;
+            break;
+        case ChartImportStatus::Unchanged:
+            ++report.unchanged;
+            break;
+        case ChartImportStatus::Failed:
+            ++report.failed;
+            manifest.erase(jobs[i].key);
+            break;
+        }
+    }
+    if (!writeManifest(manifestPath, manifest))
+    {
+        report.error = "Cannot write " + manifestPath.string();
+    }
+
+    report.totalMillis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    return report;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "track/MidiImporter.h"
+
+// Converts every Guitar Pro or MIDI file under a directory into .occhart files
+// that mirror the source tree. Sources whose content hash matches the manifest from
+// the previous run are skipped. When two sources differ only in extension, the
+// first in path order owns the chart and the other fails.
+struct ChartImportOptions
+{
+    std::filesystem::path input;  // Directory or single file
+    std::filesystem::path output; // Output directory; holds the manifest
+    unsigned jobs = 0;            // 0 = one per hardware thread
+    bool force = false;           // Ignore the manifest and convert everything
+    MidiImportOptions midi;       // String/channel mapping for .mid files; part of their manifest hash
+};
+
+enum class ChartImportStatus
+{
+    Converted,
+    Unchanged,
+    Failed
+};
+
+struct ChartImportResult
+{
+    std::filesystem::path source;
+    std::filesystem::path chart;
+    ChartImportStatus status = ChartImportStatus::Failed;
+    double millis = 0.0;
+    std::string title;
+    std::size_t parts = 0;
+    std::string error;
+};
+
+struct ChartImportReport
+{
+    std::vector<ChartImportResult> results; // In source path order
+    std::size_t converted = 0;
+    std::size_t unchanged = 0;
+    std::size_t failed = 0;
+    unsigned jobs = 0;
+    double totalMillis = 0.0;
+    std::string error; // Set when the batch could not run at all
+};
+
+ChartImportReport importCharts(const ChartImportOptions &options);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Technique bits carried per note.
+enum ChartNoteFlags : uint16_t
+{
+    ChartNoteNone = 0,
+    ChartNoteHammerOn = 1 << 0,
+    ChartNotePullOff = 1 << 1,
+    ChartNoteSlide = 1 << 2,
+    ChartNoteBend = 1 << 3,
+    ChartNotePalmMute = 1 << 4,
+    ChartNoteHarmonic = 1 << 5,
+    ChartNoteVibrato = 1 << 6,
+    ChartNoteAccent = 1 << 7,
+    ChartNoteTap = 1 << 8,
+    ChartNoteDead = 1 << 9,
+    ChartNoteTie = 1 << 10,
+};
+
+struct ChartNote
+{
+    uint32_t tick = 0;
+    uint32_t duration = 0;
+    uint8_t string = 0; // 0 = highest string
+    uint8_t fret = 0;
+    uint16_t flags = ChartNoteNone;
+};
+
+struct ChartTempoChange
+{
+    uint32_t tick = 0;
+    uint32_t microsPerQuarter = 500000; // 120 BPM
+};
+
+struct ChartPartData
+{
+    std::string name;
+    std::vector<ChartNote> notes;
+};
+
+// In-memory chart used by importers and tools before it is written to disk.
+struct ChartData
+{
+    uint32_t ticksPerQuarter = 480;
+    std::vector<ChartTempoChange> tempo;
+    std::vector<ChartPartData> parts;
+};
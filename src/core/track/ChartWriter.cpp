@@ -0,0 +1,176 @@
+#include "track/ChartWriter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+#include "track/ChartFormat.h"
+#include "track/TempoMap.h"
+
+using namespace chartformat;
+
+namespace
+{
+    uint64_t alignUp(uint64_t value)
+    {
+        return (value + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    template <typename T>
+    void put(std::vector<std::byte> &out, uint64_t offset, const T &value)
+    {
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    std::vector<ChartFileTempo> buildTempo(const TempoMap &map)
+    {
+        std::vector<ChartFileTempo> tempo;
+        tempo.reserve(map.segments().size());
+        for (const TempoSegment &segment : map.segments())
+        {
+            tempo.push_back(ChartFileTempo{segment.tick, segment.microsPerQuarter, segment.startSeconds});
+        }
+        return tempo;
+    }
+}
+
+std::vector<std::byte> serializeChart(const ChartData &chart)
+{
+    const TempoMap map(chart.ticksPerQuarter, chart.tempo);
+    const uint32_t ticksPerQuarter = map.ticksPerQuarter();
+    std::vector<ChartFileTempo> tempo = buildTempo(map);
+
+    struct PartLayout
+    {
+        std::vector<ChartNote> notes;
+        std::vector<uint32_t> index;
+        ChartFilePart entry{};
+    };
+    std::vector<PartLayout> layouts(chart.parts.size());
+
+    std::string strings;
+    uint64_t offset = alignUp(sizeof(ChartFileHeader));
+    const uint64_t tempoOffset = offset;
+    offset = alignUp(offset + tempo.size() * sizeof(ChartFileTempo));
+    const uint64_t partOffset = offset;
+    offset = alignUp(offset + chart.parts.size() * sizeof(ChartFilePart));
+
+    for (std::size_t p = 0; p < chart.parts.size(); ++p)
+    {
+        PartLayout &layout = layouts[p];
+        layout.notes = chart.parts[p].notes;
+        std::stable_sort(layout.notes.begin(), layout.notes.end(), [](const ChartNote &a, const ChartNote &b)
+                         { return a.tick < b.tick; });
+
+        // secondIndex[s] = first note whose start time is >= s seconds; one extra
+        // trailing entry lets readers take [index[s], index[s + 1]) as a bucket.
+        double lastSeconds = layout.notes.empty() ? 0.0 : map.tickToSeconds(layout.notes.back().tick);
+        std::size_t buckets = static_cast<std::size_t>(std::floor(lastSeconds)) + 2;
+        layout.index.resize(buckets);
+        TempoMap::Cursor cursor = map.cursor();
+        std::size_t note = 0;
+        for (std::size_t s = 0; s < buckets; ++s)
+        {
+            while (note < layout.notes.size() && cursor.tickToSeconds(layout.notes[note].tick) < static_cast<double>(s))
+            {
+                ++note;
+            }
+            layout.index[s] = static_cast<uint32_t>(note);
+        }
+
+        const uint64_t n = layout.notes.size();
+        ChartFilePart &entry = layout.entry;
+        entry.nameOffset = static_cast<uint32_t>(strings.size());
+        entry.nameLength = static_cast<uint32_t>(chart.parts[p].name.size());
+        strings += chart.parts[p].name;
+        entry.noteCount = static_cast<uint32_t>(n);
+        entry.indexCount = static_cast<uint32_t>(buckets);
+        entry.startTickOffset = offset;
+        offset = alignUp(offset + n * sizeof(uint32_t));
+        entry.durationOffset = offset;
+        offset = alignUp(offset + n * sizeof(uint32_t));
+        entry.stringOffset = offset;
+        offset = alignUp(offset + n * sizeof(uint8_t));
+        entry.fretOffset = offset;
+        offset = alignUp(offset + n * sizeof(uint8_t));
+        entry.flagsOffset = offset;
+        offset = alignUp(offset + n * sizeof(uint16_t));
+        entry.indexOffset = offset;
+        offset = alignUp(offset + buckets * sizeof(uint32_t));
+    }
+
+    const uint64_t stringOffset = offset;
+    offset = alignUp(offset + strings.size());
+
+    std::vector<std::byte> out(offset);
+    ChartFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.ticksPerQuarter = ticksPerQuarter;
+    header.tempoCount = static_cast<uint32_t>(tempo.size());
+    header.partCount = static_cast<uint32_t>(chart.parts.size());
+    header.tempoOffset = tempoOffset;
+    header.partOffset = partOffset;
+    header.stringTableOffset = stringOffset;
+    header.stringTableSize = strings.size();
+    header.fileSize = out.size();
+    put(out, 0, header);
+
+    for (std::size_t i = 0; i < tempo.size(); ++i)
+    {
+        put(out, tempoOffset + i * sizeof(ChartFileTempo), tempo[i]);
+    }
+
+    for (std::size_t p = 0; p < layouts.size(); ++p)
+    {
+        const PartLayout &layout = layouts[p];
+        const ChartFilePart &entry = layout.entry;
+        put(out, partOffset + p * sizeof(ChartFilePart), entry);
+        for (std::size_t i = 0; i < layout.notes.size(); ++i)
+        {
+            const ChartNote &noteData = layout.notes[i];
+            put(out, entry.startTickOffset + i * sizeof(uint32_t), noteData.tick);
+            put(out, entry.durationOffset + i * sizeof(uint32_t), noteData.duration);
+            put(out, entry.stringOffset + i, noteData.string);
+            put(out, entry.fretOffset + i, noteData.fret);
+            put(out, entry.flagsOffset + i * sizeof(uint16_t), noteData.flags);
+        }
+        std::memcpy(out.data() + entry.indexOffset, layout.index.data(), layout.index.size() * sizeof(uint32_t));
+    }
+    std::memcpy(out.data() + stringOffset, strings.data(), strings.size());
+    return out;
+}
+
+bool writeChart(const std::filesystem::path &path, const ChartData &chart, std::string &error)
+{
+    std::vector<std::byte> bytes = serializeChart(chart);
+
+    // Write beside the target and rename, so a mapped reader never sees a partial file.
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        if (!out.good())
+        {
+            error = "Cannot open " + temp.string() + " for writing.";
+            return false;
+        }
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!out.good())
+        {
+            error = "Failed writing " + temp.string();
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+    {
+        error = "Cannot replace " + path.string() + ": " + ec.message();
+        std::filesystem::remove(temp, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "track/ChartTypes.h"
+
+// Serialises a chart into the .occhart layout (see ChartFormat.h). Notes are sorted
+// by tick, the tempo map gets an entry at tick 0 if it lacks one, and the per-second
+// seek index is built here so readers never have to.
+std::vector<std::byte> serializeChart(const ChartData &chart);
+bool writeChart(const std::filesystem::path &path, const ChartData &chart, std::string &error);
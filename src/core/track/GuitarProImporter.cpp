@@ -0,0 +1,861 @@
+#include "track/GuitarProImporter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include "track/TempoMap.h"
+
+// Binary layout follows the GP3/GP4/GP5 files as written by Guitar Pro itself.
+// Only what the chart needs is kept (timing, string, fret, techniques, tempo);
+// everything else is read past so the stream stays in sync.
+namespace
+{
+    constexpr uint32_t kTicksPerQuarter = 960;
+    constexpr uint32_t kTicksPerWhole = kTicksPerQuarter * 4;
+    constexpr int kMaxStrings = 7;
+
+    class GpReader
+    {
+    public:
+        explicit GpReader(std::span<const std::byte> data) : data_(data) {}
+
+        bool ok() const { return ok_; }
+        void fail() { ok_ = false; }
+        std::size_t remaining() const { return data_.size() - pos_; }
+
+        void skip(std::size_t count)
+        {
+            if (count > remaining())
+            {
+                ok_ = false;
+                pos_ = data_.size();
+                return;
+            }
+            pos_ += count;
+        }
+
+        uint8_t u8()
+        {
+            if (remaining() < 1)
+            {
+                ok_ = false;
+                return 0;
+            }
+            return static_cast<uint8_t>(data_[pos_++]);
+        }
+
+        int8_t i8() { return static_cast<int8_t>(u8()); }
+        bool boolean() { return u8() != 0; }
+
+        int16_t i16()
+        {
+            uint16_t lo = u8();
+            uint16_t hi = u8();
+            return static_cast<int16_t>(lo | (hi << 8));
+        }
+
+        int32_t i32()
+        {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                value |= static_cast<uint32_t>(u8()) << (8 * i);
+            }
+            return static_cast<int32_t>(value);
+        }
+
+        // Length byte followed by a fixed-size field.
+        std::string byteSizeString(std::size_t size)
+        {
+            std::size_t length = std::min<std::size_t>(u8(), size);
+            std::string out = chars(length);
+            skip(size - length);
+            return out;
+        }
+
+        // Field size as int, then a length byte, then size - 1 bytes.
+        std::string intByteSizeString()
+        {
+            int32_t size = i32() - 1;
+            if (size < 0 || static_cast<std::size_t>(size) > remaining())
+            {
+                ok_ = false;
+                return {};
+            }
+            return byteSizeString(static_cast<std::size_t>(size));
+        }
+
+        std::string intSizeString()
+        {
+            int32_t size = i32();
+            if (size < 0 || static_cast<std::size_t>(size) > remaining())
+            {
+                ok_ = false;
+                return {};
+            }
+            return chars(static_cast<std::size_t>(size));
+        }
+
+    private:
+        std::string chars(std::size_t count)
+        {
+            if (count > remaining())
+            {
+                ok_ = false;
+                return {};
+            }
+            std::string out(reinterpret_cast<const char *>(data_.data() + pos_), count);
+            pos_ += count;
+            return out;
+        }
+
+        std::span<const std::byte> data_;
+        std::size_t pos_ = 0;
+        bool ok_ = true;
+    };
+
+    struct BeatEffects
+    {
+        bool vibrato = false;
+        bool harmonic = false;
+        bool tap = false;
+    };
+
+    struct TrackState
+    {
+        int part = -1; // -1 for percussion
+        int stringCount = 6;
+        std::array<int, kMaxStrings> lastNote{};
+        std::array<bool, kMaxStrings> hammerPending{};
+    };
+
+    class GpParser
+    {
+    public:
+        GpParser(std::span<const std::byte> data, GuitarProSong &song) : in_(data), song_(song) {}
+
+        bool parse(std::string &error)
+        {
+            if (!readVersion())
+            {
+                error = "not a Guitar Pro 3/4/5 file";
+                return false;
+            }
+            song_.version = version_;
+
+            readInfo();
+            if (version_ < 500)
+            {
+                in_.boolean(); // Triplet feel
+            }
+            if (version_ >= 400)
+            {
+                readLyrics();
+            }
+            if (version_ >= 510)
+            {
+                in_.skip(19); // RSE master volume and equalizer
+            }
+            if (version_ >= 500)
+            {
+                readPageSetup();
+                in_.intByteSizeString(); // Tempo name
+            }
+            song_.bpm = in_.i32();
+            if (version_ >= 510)
+            {
+                in_.boolean(); // Hide tempo
+            }
+            in_.skip(version_ >= 400 ? 5 : 4); // Key signature and octave
+            in_.skip(64 * 12);                 // MIDI channel table
+            if (version_ >= 500)
+            {
+                in_.skip(19 * 2 + 4); // Directions and master reverb
+            }
+
+            int32_t measureCount = in_.i32();
+            int32_t trackCount = in_.i32();
+            if (!in_.ok() || measureCount <= 0 || trackCount <= 0 ||
+                static_cast<std::size_t>(measureCount) > in_.remaining() || trackCount > 128)
+            {
+                error = "corrupt song header";
+                return false;
+            }
+            if (song_.bpm <= 0 || song_.bpm > 1000)
+            {
+                song_.bpm = 120;
+            }
+
+            if (!readMeasureHeaders(measureCount))
+            {
+                error = "corrupt measure header";
+                return false;
+            }
+            if (!readTracks(trackCount))
+            {
+                error = "corrupt track table";
+                return false;
+            }
+            if (!readMeasures(error))
+            {
+                return false;
+            }
+
+            song_.chart.ticksPerQuarter = kTicksPerQuarter;
+            song_.chart.tempo.clear();
+            song_.chart.tempo.push_back(ChartTempoChange{0, static_cast<uint32_t>(60000000 / song_.bpm)});
+            for (const auto &[tick, micros] : tempoChanges_)
+            {
+                song_.chart.tempo.push_back(ChartTempoChange{tick, micros});
+            }
+            return true;
+        }
+
+    private:
+        struct MeasureHeader
+        {
+            uint32_t start = 0;
+        };
+
+        bool readVersion()
+        {
+            std::string text = in_.byteSizeString(30);
+            std::size_t v = text.rfind('v');
+            if (v == std::string::npos || v + 5 > text.size() || text[v + 2] != '.')
+            {
+                return false;
+            }
+            auto digit = [&](std::size_t i)
+            { return text[i] >= '0' && text[i] <= '9' ? text[i] - '0' : -1; };
+            int major = digit(v + 1);
+            int minorHigh = digit(v + 3);
+            int minorLow = digit(v + 4);
+            if (major < 3 || major > 5 || minorHigh < 0 || minorLow < 0)
+            {
+                return false;
+            }
+            version_ = major * 100 + minorHigh * 10 + minorLow;
+            return in_.ok();
+        }
+
+        void readInfo()
+        {
+            song_.title = in_.intByteSizeString();
+            in_.intByteSizeString(); // Subtitle
+            song_.artist = in_.intByteSizeString();
+            song_.album = in_.intByteSizeString();
+            in_.intByteSizeString(); // Words
+            if (version_ >= 500)
+            {
+                in_.intByteSizeString(); // Music
+            }
+            in_.intByteSizeString(); // Copyright
+            in_.intByteSizeString(); // Tab author
+            in_.intByteSizeString(); // Instructions
+            int32_t notices = in_.i32();
+            for (int32_t i = 0; i < notices && in_.ok(); ++i)
+            {
+                in_.intByteSizeString();
+            }
+        }
+
+        void readLyrics()
+        {
+            in_.i32(); // Track
+            for (int i = 0; i < 5; ++i)
+            {
+                in_.i32(); // Starting measure
+                in_.intSizeString();
+            }
+        }
+
+        void readPageSetup()
+        {
+            in_.skip(30); // Page size, margins, proportion, header/footer flags
+            for (int i = 0; i < 10; ++i)
+            {
+                in_.intByteSizeString();
+            }
+        }
+
+        bool readMeasureHeaders(int32_t count)
+        {
+            uint32_t tick = 0;
+            int numerator = 4;
+            int denominator = 4;
+            headers_.reserve(static_cast<std::size_t>(count));
+            for (int32_t i = 0; i < count; ++i)
+            {
+                if (version_ >= 500 && i > 0)
+                {
+                    in_.skip(1);
+                }
+                uint8_t flags = in_.u8();
+                if (flags & 0x01)
+                {
+                    numerator = in_.i8();
+                }
+                if (flags & 0x02)
+                {
+                    denominator = in_.i8();
+                }
+                if (flags & 0x08)
+                {
+                    in_.i8(); // Repeat close
+                }
+                if (version_ < 500)
+                {
+                    if (flags & 0x10)
+                    {
+                        in_.u8(); // Alternate ending
+                    }
+                    if (flags & 0x20)
+                    {
+                        readMarker();
+                    }
+                    if (flags & 0x40)
+                    {
+                        in_.skip(2); // Key signature
+                    }
+                }
+                else
+                {
+                    if (flags & 0x20)
+                    {
+                        readMarker();
+                    }
+                    if (flags & 0x10)
+                    {
+                        in_.u8();
+                    }
+                    if (flags & 0x40)
+                    {
+                        in_.skip(2);
+                    }
+                    if (flags & 0x03)
+                    {
+                        in_.skip(4); // Beam grouping
+                    }
+                    if (!(flags & 0x10))
+                    {
+                        in_.skip(1);
+                    }
+                    in_.u8(); // Triplet feel
+                }
+
+                if (!in_.ok() || numerator <= 0 || numerator > 64 || denominator <= 0 || denominator > 64 ||
+                    (denominator & (denominator - 1)) != 0)
+                {
+                    return false;
+                }
+                headers_.push_back(MeasureHeader{tick});
+                tick += static_cast<uint32_t>(numerator) * (kTicksPerWhole / static_cast<uint32_t>(denominator));
+            }
+            return true;
+        }
+
+        void readMarker()
+        {
+            in_.intByteSizeString();
+            in_.skip(4); // Colour
+        }
+
+        bool readTracks(int32_t count)
+        {
+            for (int32_t t = 0; t < count; ++t)
+            {
+                if (version_ >= 500 && (t == 0 || version_ == 500))
+                {
+                    in_.skip(1);
+                }
+                uint8_t flags = in_.u8();
+                std::string name = in_.byteSizeString(40);
+                int32_t stringCount = in_.i32();
+                in_.skip(7 * 4);     // Tuning
+                in_.skip(3 * 4);     // Port, channel, effect channel
+                in_.skip(2 * 4 + 4); // Fret count, capo, colour
+                if (version_ >= 500)
+                {
+                    in_.skip(2 + 1 + 1);       // Display flags, auto accentuation, bank
+                    in_.skip(1 + 12 + 12);     // RSE humanize and reserved fields
+                    in_.skip(version_ == 500 ? 15 : 16); // RSE instrument
+                    if (version_ > 500)
+                    {
+                        in_.skip(4); // RSE equalizer
+                        in_.intByteSizeString();
+                        in_.intByteSizeString();
+                    }
+                }
+                if (!in_.ok() || stringCount < 1 || stringCount > kMaxStrings)
+                {
+                    return false;
+                }
+
+                TrackState state;
+                state.stringCount = stringCount;
+                state.lastNote.fill(-1);
+                if (!(flags & 0x01))
+                {
+                    state.part = static_cast<int>(song_.chart.parts.size());
+                    ChartPartData part;
+                    part.name = name.empty() ? "Track " + std::to_string(t + 1) : name;
+                    song_.chart.parts.push_back(std::move(part));
+                }
+                tracks_.push_back(state);
+            }
+            if (version_ >= 500)
+            {
+                in_.skip(version_ == 500 ? 2 : 1);
+            }
+            return in_.ok();
+        }
+
+        bool readMeasures(std::string &error)
+        {
+            const int voices = version_ >= 500 ? 2 : 1;
+            for (std::size_t m = 0; m < headers_.size(); ++m)
+            {
+                for (std::size_t t = 0; t < tracks_.size(); ++t)
+                {
+                    for (int voice = 0; voice < voices; ++voice)
+                    {
+                        uint32_t tick = headers_[m].start;
+                        int32_t beats = in_.i32();
+                        if (!in_.ok() || beats < 0 || static_cast<std::size_t>(beats) > in_.remaining())
+                        {
+                            error = "corrupt measure " + std::to_string(m + 1);
+                            return false;
+                        }
+                        for (int32_t b = 0; b < beats; ++b)
+                        {
+                            tick += readBeat(tracks_[t], tick);
+                        }
+                        if (!in_.ok())
+                        {
+                            error = "truncated in measure " + std::to_string(m + 1);
+                            return false;
+                        }
+                    }
+                    if (version_ >= 500)
+                    {
+                        in_.skip(1); // Line break
+                    }
+                }
+            }
+            return in_.ok();
+        }
+
+        uint32_t readBeat(TrackState &track, uint32_t tick)
+        {
+            uint8_t flags = in_.u8();
+            uint8_t status = 1;
+            if (flags & 0x40)
+            {
+                status = in_.u8(); // 0 = empty, 2 = rest
+            }
+            int8_t value = in_.i8();
+            if (value < -2 || value > 6)
+            {
+                value = 0;
+            }
+            uint32_t duration = kTicksPerWhole >> (value + 2);
+            if (flags & 0x01)
+            {
+                duration = duration * 3 / 2;
+            }
+            if (flags & 0x20)
+            {
+                duration = applyTuplet(duration, in_.i32());
+            }
+            if (flags & 0x02)
+            {
+                readChord();
+            }
+            if (flags & 0x04)
+            {
+                in_.intByteSizeString(); // Text
+            }
+            BeatEffects effects;
+            if (flags & 0x08)
+            {
+                readBeatEffects(effects);
+            }
+            if (flags & 0x10)
+            {
+                readMixTableChange(tick);
+            }
+
+            uint8_t strings = in_.u8();
+            for (int bit = 6; bit >= 0 && in_.ok(); --bit)
+            {
+                int string = 6 - bit;
+                if ((strings & (1 << bit)) && string < track.stringCount)
+                {
+                    readNote(track, string, tick, duration, effects);
+                }
+            }
+            if (version_ >= 500)
+            {
+                int16_t flags2 = in_.i16();
+                if (flags2 & 0x0800)
+                {
+                    in_.skip(1); // Secondary beam break
+                }
+            }
+            return status == 0 ? 0 : duration;
+        }
+
+        static uint32_t applyTuplet(uint32_t duration, int32_t enters)
+        {
+            if (enters <= 1 || enters > 64)
+            {
+                return duration;
+            }
+            uint32_t times = 1;
+            while (times * 2 < static_cast<uint32_t>(enters))
+            {
+                times *= 2;
+            }
+            return duration * times / static_cast<uint32_t>(enters);
+        }
+
+        void readChord()
+        {
+            if (version_ >= 500)
+            {
+                in_.skip(17);
+                in_.byteSizeString(21);
+                in_.skip(4 + 4 + 7 * 4 + 32);
+                return;
+            }
+            if (in_.boolean())
+            {
+                if (version_ >= 400)
+                {
+                    in_.skip(16);
+                    in_.byteSizeString(21);
+                    in_.skip(4 + 4 + 7 * 4 + 32);
+                }
+                else
+                {
+                    in_.skip(25);
+                    in_.byteSizeString(34);
+                    in_.skip(4 + 6 * 4 + 36);
+                }
+                return;
+            }
+            in_.intByteSizeString();
+            if (in_.i32() != 0)
+            {
+                in_.skip((version_ >= 406 ? 7 : 6) * 4);
+            }
+        }
+
+        void readBeatEffects(BeatEffects &effects)
+        {
+            uint8_t flags1 = in_.u8();
+            uint8_t flags2 = version_ >= 400 ? in_.u8() : 0;
+            effects.vibrato = (flags1 & 0x02) || (version_ < 400 && (flags1 & 0x01));
+            effects.harmonic = version_ < 400 && (flags1 & 0x0C);
+            if (flags1 & 0x20)
+            {
+                effects.tap = in_.i8() == 1;
+                if (version_ < 400)
+                {
+                    in_.skip(4); // Tremolo bar value
+                }
+            }
+            if (flags2 & 0x04)
+            {
+                readBend();
+            }
+            if (flags1 & 0x40)
+            {
+                in_.skip(2); // Stroke
+            }
+            if (flags2 & 0x02)
+            {
+                in_.skip(1); // Pick stroke
+            }
+        }
+
+        void readBend()
+        {
+            in_.skip(1 + 4); // Type, value
+            int32_t points = in_.i32();
+            if (points < 0 || static_cast<std::size_t>(points) * 9 > in_.remaining())
+            {
+                in_.fail();
+                return;
+            }
+            in_.skip(static_cast<std::size_t>(points) * 9);
+        }
+
+        void readMixTableChange(uint32_t tick)
+        {
+            in_.i8(); // Instrument
+            if (version_ >= 500)
+            {
+                in_.skip(16); // RSE instrument
+            }
+            int changes = 0;
+            for (int i = 0; i < 6; ++i)
+            {
+                changes += in_.i8() >= 0 ? 1 : 0; // Volume, balance, chorus, reverb, phaser, tremolo
+            }
+            if (version_ >= 500)
+            {
+                in_.intByteSizeString(); // Tempo name
+            }
+            int32_t tempo = in_.i32();
+            in_.skip(static_cast<std::size_t>(changes)); // Transition durations
+            if (tempo >= 0)
+            {
+                in_.skip(version_ >= 510 ? 2 : 1);
+            }
+            if (version_ >= 400)
+            {
+                in_.skip(1); // Apply-to-all-tracks flags
+            }
+            if (version_ >= 500)
+            {
+                in_.skip(1); // Wah
+            }
+            if (version_ >= 510)
+            {
+                in_.intByteSizeString();
+                in_.intByteSizeString();
+            }
+            if (tempo > 0 && tempo <= 1000 && in_.ok())
+            {
+                tempoChanges_[tick] = static_cast<uint32_t>(60000000 / tempo);
+            }
+        }
+
+        void readNote(TrackState &track, int string, uint32_t tick, uint32_t duration, const BeatEffects &beat)
+        {
+            uint8_t flags = in_.u8();
+            uint8_t type = 1;
+            if (flags & 0x20)
+            {
+                type = in_.u8(); // 1 = normal, 2 = tie, 3 = dead
+            }
+            if ((flags & 0x01) && version_ < 500)
+            {
+                in_.skip(2); // Independent duration and tuplet
+            }
+            if (flags & 0x10)
+            {
+                in_.skip(1); // Dynamic
+            }
+            int fret = 0;
+            if (flags & 0x20)
+            {
+                fret = in_.i8();
+            }
+            if (flags & 0x80)
+            {
+                in_.skip(2); // Fingering
+            }
+            if (version_ >= 500)
+            {
+                if (flags & 0x01)
+                {
+                    in_.skip(8); // Duration percent
+                }
+                in_.skip(1);
+            }
+
+            uint16_t techniques = ChartNoteNone;
+            bool hammer = false;
+            if (flags & 0x08)
+            {
+                techniques = readNoteEffects(hammer);
+            }
+            if (beat.vibrato)
+            {
+                techniques |= ChartNoteVibrato;
+            }
+            if (beat.harmonic)
+            {
+                techniques |= ChartNoteHarmonic;
+            }
+            if (beat.tap)
+            {
+                techniques |= ChartNoteTap;
+            }
+            if ((flags & 0x02) || (version_ >= 400 && (flags & 0x40)))
+            {
+                techniques |= ChartNoteAccent;
+            }
+
+            if (track.part < 0 || !in_.ok())
+            {
+                return;
+            }
+            std::vector<ChartNote> &notes = song_.chart.parts[static_cast<std::size_t>(track.part)].notes;
+            int &last = track.lastNote[static_cast<std::size_t>(string)];
+
+            // A tie extends the sounding note rather than adding a new one to play.
+            if (type == 2 && last >= 0)
+            {
+                ChartNote &held = notes[static_cast<std::size_t>(last)];
+                held.duration = std::max(held.duration, tick + duration - held.tick);
+                return;
+            }
+            if (type == 2)
+            {
+                techniques |= ChartNoteTie;
+            }
+            if (type == 3)
+            {
+                techniques |= ChartNoteDead;
+            }
+
+            ChartNote note;
+            note.tick = tick;
+            note.duration = duration;
+            note.string = static_cast<uint8_t>(string);
+            note.fret = static_cast<uint8_t>(std::clamp(fret, 0, 99));
+
+            // Guitar Pro flags the note a legato starts from; the chart marks the
+            // note that is actually sounded by the hammer-on or pull-off.
+            bool &pending = track.hammerPending[static_cast<std::size_t>(string)];
+            if (pending && last >= 0)
+            {
+                techniques |= note.fret > notes[static_cast<std::size_t>(last)].fret ? ChartNoteHammerOn
+                                                                                    : ChartNotePullOff;
+            }
+            pending = hammer;
+            note.flags = techniques;
+
+            last = static_cast<int>(notes.size());
+            notes.push_back(note);
+        }
+
+        uint16_t readNoteEffects(bool &hammer)
+        {
+            uint16_t techniques = ChartNoteNone;
+            uint8_t flags1 = in_.u8();
+            uint8_t flags2 = version_ >= 400 ? in_.u8() : 0;
+            hammer = flags1 & 0x02;
+            if (version_ < 400 && (flags1 & 0x04))
+            {
+                techniques |= ChartNoteSlide;
+            }
+            if (flags1 & 0x01)
+            {
+                readBend();
+                techniques |= ChartNoteBend;
+            }
+            if (flags1 & 0x10)
+            {
+                in_.skip(version_ >= 500 ? 5 : 4); // Grace note
+            }
+            if (flags2 & 0x04)
+            {
+                in_.skip(1); // Tremolo picking
+            }
+            if (flags2 & 0x08)
+            {
+                in_.skip(1);
+                techniques |= ChartNoteSlide;
+            }
+            if (flags2 & 0x10)
+            {
+                int8_t harmonic = in_.i8();
+                if (version_ >= 500 && harmonic == 2)
+                {
+                    in_.skip(3); // Artificial harmonic pitch
+                }
+                else if (version_ >= 500 && harmonic == 3)
+                {
+                    in_.skip(1); // Tapped harmonic fret
+                }
+                techniques |= ChartNoteHarmonic;
+            }
+            if (flags2 & 0x20)
+            {
+                in_.skip(2); // Trill
+            }
+            if (flags2 & 0x02)
+            {
+                techniques |= ChartNotePalmMute;
+            }
+            if (flags2 & 0x40)
+            {
+                techniques |= ChartNoteVibrato;
+            }
+            return techniques;
+        }
+
+        GpReader in_;
+        GuitarProSong &song_;
+        int version_ = 0;
+        std::vector<MeasureHeader> headers_;
+        std::vector<TrackState> tracks_;
+        std::map<uint32_t, uint32_t> tempoChanges_;
+    };
+}
+
+bool parseGuitarPro(std::span<const std::byte> data, GuitarProSong &song, std::string &error)
+{
+    song = GuitarProSong{};
+    GpParser parser(data, song);
+    return parser.parse(error);
+}
+
+bool loadGuitarPro(const std::filesystem::path &path, GuitarProSong &song, std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+    {
+        error = "Cannot open " + path.string();
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!parseGuitarPro(std::as_bytes(std::span<const char>(bytes)), song, error))
+    {
+        error = path.string() + ": " + error;
+        return false;
+    }
+    if (song.title.empty())
+    {
+        song.title = path.stem().string();
+    }
+    return true;
+}
+
+TrackInfo guitarProTrackInfo(const GuitarProSong &song, const std::string &chartPath)
+{
+    TrackInfo info;
+    info.title = song.title;
+    info.artist = song.artist;
+    info.source = song.album;
+    info.bpm = song.bpm;
+
+    uint32_t endTick = 0;
+    for (const ChartPartData &part : song.chart.parts)
+    {
+        for (const ChartNote &note : part.notes)
+        {
+            endTick = std::max(endTick, note.tick + note.duration);
+        }
+    }
+    int seconds = static_cast<int>(TempoMap(song.chart.ticksPerQuarter, song.chart.tempo).tickToSeconds(endTick) + 0.5);
+    char length[16];
+    std::snprintf(length, sizeof(length), "%d:%02d", seconds / 60, seconds % 60);
+    info.length = length;
+
+    for (std::size_t i = 0; i < song.chart.parts.size(); ++i)
+    {
+        info.parts.push_back(TrackPart{song.chart.parts[i].name, chartPath, static_cast<int>(i)});
+    }
+    return info;
+}
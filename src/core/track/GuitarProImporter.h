@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+#include <string>
+
+#include "track/ChartTypes.h"
+#include "track/TrackTypes.h"
+
+// Song-level data pulled from a Guitar Pro 3/4/5 file. Every fretted track becomes
+// one chart part in file order; percussion tracks are skipped.
+struct GuitarProSong
+{
+    int version = 0; // 300, 400, 406, 500, 510, ...
+    std::string title;
+    std::string artist;
+    std::string album;
+    int bpm = 120;
+    ChartData chart;
+};
+
+bool parseGuitarPro(std::span<const std::byte> data, GuitarProSong &song, std::string &error);
+bool loadGuitarPro(const std::filesystem::path &path, GuitarProSong &song, std::string &error);
+
+// Catalog entry for an imported song whose chart lives at chartPath; each chart
+// part maps to a TrackPart pointing at its block.
+TrackInfo guitarProTrackInfo(const GuitarProSong &song, const std::string &chartPath);
@@ -0,0 +1,360 @@
+#include "track/MidiImporter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    class MidiCursor
+    {
+    public:
+        explicit MidiCursor(std::span<const std::byte> data) : data_(data) {}
+
+        bool ok() const { return ok_; }
+        bool atEnd() const { return pos_ >= data_.size(); }
+        std::size_t remaining() const { return data_.size() - pos_; }
+        std::size_t position() const { return pos_; }
+
+        uint8_t peek() const { return atEnd() ? 0 : static_cast<uint8_t>(data_[pos_]); }
+
+        uint8_t u8()
+        {
+            if (atEnd())
+            {
+                ok_ = false;
+                return 0;
+            }
+            return static_cast<uint8_t>(data_[pos_++]);
+        }
+
+        uint32_t be16()
+        {
+            uint32_t hi = u8();
+            return (hi << 8) | u8();
+        }
+
+        uint32_t be32()
+        {
+            uint32_t value = be16() << 16;
+            return value | be16();
+        }
+
+        // Variable-length quantity, at most four bytes.
+        uint32_t vlq()
+        {
+            uint32_t value = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                uint8_t byte = u8();
+                value = (value << 7) | (byte & 0x7F);
+                if (!(byte & 0x80))
+                {
+                    return value;
+                }
+            }
+            ok_ = false;
+            return value;
+        }
+
+        std::span<const std::byte> take(std::size_t count)
+        {
+            if (count > remaining())
+            {
+                ok_ = false;
+                pos_ = data_.size();
+                return {};
+            }
+            std::span<const std::byte> out = data_.subspan(pos_, count);
+            pos_ += count;
+            return out;
+        }
+
+    private:
+        std::span<const std::byte> data_;
+        std::size_t pos_ = 0;
+        bool ok_ = true;
+    };
+
+    class MidiParser
+    {
+    public:
+        MidiParser(const MidiImportOptions &options, MidiSong &song) : options_(options), song_(song) {}
+
+        bool parse(std::span<const std::byte> data, std::string &error)
+        {
+            MidiCursor in(data);
+            std::span<const std::byte> id = in.take(4);
+            uint32_t headerLength = in.be32();
+            if (!in.ok() || std::memcmp(id.data(), "MThd", 4) != 0 || headerLength < 6)
+            {
+                error = "not a Standard MIDI File";
+                return false;
+            }
+            song_.format = static_cast<int>(in.be16());
+            uint32_t trackCount = in.be16();
+            uint32_t division = in.be16();
+            in.take(headerLength - 6);
+            if (!in.ok() || song_.format > 2)
+            {
+                error = "unsupported MIDI header";
+                return false;
+            }
+
+            if (division & 0x8000)
+            {
+                // SMPTE timing: ticks are frame subdivisions, so one "quarter" is one second.
+                int fps = -static_cast<int8_t>(division >> 8);
+                uint32_t ticksPerFrame = division & 0xFF;
+                smpte_ = true;
+                song_.chart.ticksPerQuarter = static_cast<uint32_t>(fps == 29 ? 30 : fps) * ticksPerFrame;
+            }
+            else
+            {
+                song_.chart.ticksPerQuarter = division;
+            }
+            if (song_.chart.ticksPerQuarter == 0)
+            {
+                error = "invalid MIDI time division";
+                return false;
+            }
+
+            uint32_t track = 0;
+            while (track < trackCount && in.remaining() >= 8)
+            {
+                id = in.take(4);
+                uint32_t length = in.be32();
+                std::span<const std::byte> body = in.take(std::min<std::size_t>(length, in.remaining()));
+                if (std::memcmp(id.data(), "MTrk", 4) != 0)
+                {
+                    continue; // Unknown chunks are skipped per the spec
+                }
+                if (!parseTrack(body, track, error))
+                {
+                    error = "track " + std::to_string(track + 1) + ": " + error;
+                    return false;
+                }
+                ++track;
+            }
+            if (track == 0)
+            {
+                error = "no track chunks";
+                return false;
+            }
+
+            compileTempo();
+            std::stable_sort(song_.timeSignatures.begin(), song_.timeSignatures.end(),
+                             [](const MidiTimeSignature &a, const MidiTimeSignature &b)
+                             { return a.tick < b.tick; });
+            return true;
+        }
+
+    private:
+        bool parseTrack(std::span<const std::byte> data, uint32_t trackIndex, std::string &error)
+        {
+            MidiCursor in(data);
+            ChartPartData part;
+            part.notes.reserve(data.size() / 8); // Note on + off is at least eight bytes
+            std::string name;
+            for (auto &channel : open_)
+            {
+                channel.fill(-1);
+            }
+
+            uint32_t tick = 0;
+            uint8_t running = 0;
+            while (!in.atEnd())
+            {
+                tick += in.vlq();
+                uint8_t status = in.peek();
+                if (status & 0x80)
+                {
+                    in.u8();
+                }
+                else if (running != 0)
+                {
+                    status = running;
+                }
+                else
+                {
+                    error = "data byte without a running status";
+                    return false;
+                }
+
+                if (status == 0xFF)
+                {
+                    running = 0;
+                    uint8_t type = in.u8();
+                    std::span<const std::byte> meta = in.take(in.vlq());
+                    if (type == 0x2F)
+                    {
+                        break;
+                    }
+                    handleMeta(type, meta, tick, name);
+                }
+                else if (status == 0xF0 || status == 0xF7)
+                {
+                    running = 0;
+                    in.take(in.vlq());
+                }
+                else if (status >= 0xF0)
+                {
+                    error = "unexpected system message";
+                    return false;
+                }
+                else
+                {
+                    running = status;
+                    const uint8_t kind = status & 0xF0;
+                    const uint8_t channel = status & 0x0F;
+                    const uint8_t key = in.u8() & 0x7F;
+                    const uint8_t velocity = (kind == 0xC0 || kind == 0xD0) ? 0 : (in.u8() & 0x7F);
+                    if (kind == 0x90 && velocity > 0)
+                    {
+                        noteOn(part, channel, key, tick);
+                    }
+                    else if (kind == 0x80 || kind == 0x90)
+                    {
+                        noteOff(part, channel, key, tick);
+                    }
+                }
+                if (!in.ok())
+                {
+                    error = "truncated event";
+                    return false;
+                }
+            }
+
+            // Notes still held at the end of the track run to its last event.
+            for (auto &channel : open_)
+            {
+                for (int32_t index : channel)
+                {
+                    if (index >= 0)
+                    {
+                        ChartNote &note = part.notes[static_cast<std::size_t>(index)];
+                        note.duration = tick - note.tick;
+                    }
+                }
+            }
+
+            if (!part.notes.empty())
+            {
+                part.name = name.empty() ? "Track " + std::to_string(trackIndex + 1) : name;
+                song_.chart.parts.push_back(std::move(part));
+            }
+            if (song_.title.empty() && !name.empty() && (song_.format != 1 || trackIndex == 0))
+            {
+                song_.title = name;
+            }
+            return true;
+        }
+
+        void handleMeta(uint8_t type, std::span<const std::byte> data, uint32_t tick, std::string &name)
+        {
+            auto byteAt = [&](std::size_t i)
+            { return static_cast<uint8_t>(data[i]); };
+            if (type == 0x03 && name.empty())
+            {
+                name.assign(reinterpret_cast<const char *>(data.data()), data.size());
+            }
+            else if (type == 0x51 && data.size() == 3 && !smpte_)
+            {
+                uint32_t micros = (uint32_t(byteAt(0)) << 16) | (uint32_t(byteAt(1)) << 8) | byteAt(2);
+                if (micros > 0)
+                {
+                    song_.chart.tempo.push_back(ChartTempoChange{tick, micros});
+                }
+            }
+            else if (type == 0x58 && data.size() >= 2 && byteAt(0) > 0 && byteAt(1) <= 6)
+            {
+                song_.timeSignatures.push_back(
+                    MidiTimeSignature{tick, byteAt(0), static_cast<uint8_t>(1u << byteAt(1))});
+            }
+        }
+
+        void noteOn(ChartPartData &part, uint8_t channel, uint8_t key, uint32_t tick)
+        {
+            const int string = channel - options_.firstChannel;
+            const int stringCount = std::clamp(options_.stringCount, 1, static_cast<int>(options_.tuning.size()));
+            if (string < 0 || string >= stringCount)
+            {
+                ++song_.skippedNotes;
+                return;
+            }
+            const int fret = static_cast<int>(key) - options_.tuning[static_cast<std::size_t>(string)];
+            if (fret < 0 || fret > 99)
+            {
+                ++song_.skippedNotes;
+                return;
+            }
+            noteOff(part, channel, key, tick); // Retrigger closes the sounding note
+
+            ChartNote note;
+            note.tick = tick;
+            note.string = static_cast<uint8_t>(string);
+            note.fret = static_cast<uint8_t>(fret);
+            open_[channel][key] = static_cast<int32_t>(part.notes.size());
+            part.notes.push_back(note);
+        }
+
+        void noteOff(ChartPartData &part, uint8_t channel, uint8_t key, uint32_t tick)
+        {
+            int32_t &index = open_[channel][key];
+            if (index >= 0)
+            {
+                ChartNote &note = part.notes[static_cast<std::size_t>(index)];
+                note.duration = tick - note.tick;
+                index = -1;
+            }
+        }
+
+        void compileTempo()
+        {
+            std::vector<ChartTempoChange> &tempo = song_.chart.tempo;
+            std::stable_sort(tempo.begin(), tempo.end(), [](const ChartTempoChange &a, const ChartTempoChange &b)
+                             { return a.tick < b.tick; });
+            if (tempo.empty() || tempo.front().tick != 0)
+            {
+                tempo.insert(tempo.begin(), ChartTempoChange{0, smpte_ ? 1000000u : 500000u});
+            }
+            song_.tempoMap = TempoMap(song_.chart.ticksPerQuarter, tempo);
+        }
+
+        const MidiImportOptions &options_;
+        MidiSong &song_;
+        bool smpte_ = false;
+        std::array<std::array<int32_t, 128>, 16> open_{};
+    };
+}
+
+bool parseMidi(std::span<const std::byte> data, const MidiImportOptions &options, MidiSong &song,
+               std::string &error)
+{
+    song = MidiSong{};
+    MidiParser parser(options, song);
+    return parser.parse(data, error);
+}
+
+bool loadMidi(const std::filesystem::path &path, const MidiImportOptions &options, MidiSong &song,
+              std::string &error)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in.good())
+    {
+        error = "Cannot open " + path.string();
+        return false;
+    }
+    std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (!parseMidi(std::as_bytes(std::span<const char>(bytes)), options, song, error))
+    {
+        error = path.string() + ": " + error;
+        return false;
+    }
+    if (song.title.empty())
+    {
+        song.title = path.stem().string();
+    }
+    return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "track/ChartTypes.h"
+#include "track/TempoMap.h"
+
+// Guitar-to-MIDI style files carry one string per channel: firstChannel is the
+// highest string, and the fret is the key minus that string's open pitch.
+struct MidiImportOptions
+{
+    int firstChannel = 0;
+    int stringCount = 6;
+    std::array<uint8_t, 7> tuning{64, 59, 55, 50, 45, 40, 35}; // Open pitch, highest string first
+};
+
+struct MidiTimeSignature
+{
+    uint32_t tick = 0;
+    uint8_t numerator = 4;
+    uint8_t denominator = 4;
+};
+
+struct MidiSong
+{
+    int format = 0;
+    std::string title;
+    ChartData chart; // One part per track that has playable notes
+    std::vector<MidiTimeSignature> timeSignatures;
+    TempoMap tempoMap; // Compiled from chart.tempo
+    std::size_t skippedNotes = 0; // Off the string channels or below the open string
+};
+
+// Single pass over the track chunks. Notes are written straight into the chart
+// part arrays; nothing is allocated per event.
+bool parseMidi(std::span<const std::byte> data, const MidiImportOptions &options, MidiSong &song,
+               std::string &error);
+bool loadMidi(const std::filesystem::path &path, const MidiImportOptions &options, MidiSong &song,
+              std::string &error);
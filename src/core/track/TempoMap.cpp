@@ -0,0 +1,177 @@
+#include "track/TempoMap.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr uint32_t kDefaultMicrosPerQuarter = 500000;
+    // Forward steps a cursor takes before it gives up and binary searches.
+    constexpr std::size_t kCursorMaxSteps = 8;
+
+    double tickInSegment(const TempoSegment &segment, double seconds)
+    {
+        return segment.tick + (seconds - segment.startSeconds) / segment.secondsPerTick;
+    }
+
+    double secondsInSegment(const TempoSegment &segment, double tick)
+    {
+        return segment.startSeconds + (tick - segment.tick) * segment.secondsPerTick;
+    }
+}
+
+TempoMap::TempoMap()
+{
+    segments_.push_back(TempoSegment{0, kDefaultMicrosPerQuarter});
+    finish();
+}
+
+TempoMap::TempoMap(uint32_t ticksPerQuarter, std::span<const ChartTempoChange> changes)
+    : ticksPerQuarter_(ticksPerQuarter > 0 ? ticksPerQuarter : 480)
+{
+    std::vector<ChartTempoChange> sorted(changes.begin(), changes.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [](const ChartTempoChange &a, const ChartTempoChange &b)
+                     { return a.tick < b.tick; });
+    segments_.reserve(sorted.size() + 1);
+    if (sorted.empty() || sorted.front().tick != 0)
+    {
+        segments_.push_back(TempoSegment{0, kDefaultMicrosPerQuarter});
+    }
+    for (const ChartTempoChange &change : sorted)
+    {
+        uint32_t micros = change.microsPerQuarter > 0 ? change.microsPerQuarter : kDefaultMicrosPerQuarter;
+        if (!segments_.empty() && segments_.back().tick == change.tick)
+        {
+            segments_.back().microsPerQuarter = micros;
+            continue;
+        }
+        segments_.push_back(TempoSegment{change.tick, micros});
+    }
+    finish();
+}
+
+TempoMap::TempoMap(uint32_t ticksPerQuarter, std::span<const chartformat::ChartFileTempo> table)
+    : ticksPerQuarter_(ticksPerQuarter > 0 ? ticksPerQuarter : 480)
+{
+    // Chart files are already normalised; recompute starts anyway so both
+    // constructors agree to the last bit.
+    segments_.reserve(table.size() + 1);
+    if (table.empty() || table.front().tick != 0)
+    {
+        segments_.push_back(TempoSegment{0, kDefaultMicrosPerQuarter});
+    }
+    for (const chartformat::ChartFileTempo &entry : table)
+    {
+        segments_.push_back(TempoSegment{entry.tick, entry.microsPerQuarter > 0 ? entry.microsPerQuarter
+                                                                               : kDefaultMicrosPerQuarter});
+    }
+    finish();
+}
+
+TempoMap TempoMap::constant(double bpm, uint32_t ticksPerQuarter)
+{
+    uint32_t micros = bpm > 0.0 ? static_cast<uint32_t>(60000000.0 / bpm + 0.5) : kDefaultMicrosPerQuarter;
+    ChartTempoChange change{0, micros};
+    return TempoMap(ticksPerQuarter, std::span<const ChartTempoChange>(&change, 1));
+}
+
+void TempoMap::finish()
+{
+    double start = 0.0;
+    for (std::size_t i = 0; i < segments_.size(); ++i)
+    {
+        TempoSegment &segment = segments_[i];
+        if (i > 0)
+        {
+            const TempoSegment &prev = segments_[i - 1];
+            start = prev.startSeconds + static_cast<double>(segment.tick - prev.tick) * prev.secondsPerTick;
+        }
+        segment.startSeconds = start;
+        segment.secondsPerTick = segment.microsPerQuarter / (1e6 * ticksPerQuarter_);
+    }
+}
+
+std::size_t TempoMap::segmentAtTick(double tick) const
+{
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), tick,
+                               [](double value, const TempoSegment &segment) { return value < segment.tick; });
+    return it == segments_.begin() ? 0 : static_cast<std::size_t>(it - segments_.begin()) - 1;
+}
+
+std::size_t TempoMap::segmentAtSeconds(double seconds) const
+{
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), seconds,
+                               [](double value, const TempoSegment &segment) { return value < segment.startSeconds; });
+    return it == segments_.begin() ? 0 : static_cast<std::size_t>(it - segments_.begin()) - 1;
+}
+
+double TempoMap::tickToSeconds(double tick) const
+{
+    return secondsInSegment(segments_[segmentAtTick(tick)], tick);
+}
+
+double TempoMap::secondsToTick(double seconds) const
+{
+    return tickInSegment(segments_[segmentAtSeconds(seconds)], seconds);
+}
+
+double TempoMap::bpmAtTick(double tick) const
+{
+    return 60000000.0 / segments_[segmentAtTick(tick)].microsPerQuarter;
+}
+
+double TempoMap::bpmAtSeconds(double seconds) const
+{
+    return 60000000.0 / segments_[segmentAtSeconds(seconds)].microsPerQuarter;
+}
+
+double TempoMap::Cursor::tickToSeconds(double tick)
+{
+    const std::vector<TempoSegment> &segments = map_->segments_;
+    if (tick < segments[tickSegment_].tick)
+    {
+        tickSegment_ = map_->segmentAtTick(tick); // Went backwards: seek
+    }
+    else
+    {
+        std::size_t steps = 0;
+        while (tickSegment_ + 1 < segments.size() && segments[tickSegment_ + 1].tick <= tick)
+        {
+            if (++steps > kCursorMaxSteps)
+            {
+                tickSegment_ = map_->segmentAtTick(tick);
+                break;
+            }
+            ++tickSegment_;
+        }
+    }
+    return secondsInSegment(segments[tickSegment_], tick);
+}
+
+double TempoMap::Cursor::secondsToTick(double seconds)
+{
+    const std::vector<TempoSegment> &segments = map_->segments_;
+    if (seconds < segments[secondsSegment_].startSeconds)
+    {
+        secondsSegment_ = map_->segmentAtSeconds(seconds);
+    }
+    else
+    {
+        std::size_t steps = 0;
+        while (secondsSegment_ + 1 < segments.size() && segments[secondsSegment_ + 1].startSeconds <= seconds)
+        {
+            if (++steps > kCursorMaxSteps)
+            {
+                secondsSegment_ = map_->segmentAtSeconds(seconds);
+                break;
+            }
+            ++secondsSegment_;
+        }
+    }
+    return tickInSegment(segments[secondsSegment_], seconds);
+}
+
+void TempoMap::Cursor::reset()
+{
+    tickSegment_ = 0;
+    secondsSegment_ = 0;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "track/ChartFormat.h"
+#include "track/ChartTypes.h"
+
+// Piecewise-constant tempo segment with its start precomputed in every domain.
+struct TempoSegment
+{
+    uint32_t tick = 0;
+    uint32_t microsPerQuarter = 500000;
+    double startSeconds = 0.0;
+    double secondsPerTick = 0.0;
+};
+
+// Converts between ticks, beats (quarter notes) and seconds. Lookups binary search
+// the segment starts; Cursor walks forward in amortised O(1) for playback, where
+// every query is at or after the previous one.
+class TempoMap
+{
+public:
+    TempoMap(); // 120 BPM at 480 ticks per quarter
+    // Changes may be unsorted; a 120 BPM segment is added at tick 0 if missing and
+    // the last change at a given tick wins.
+    TempoMap(uint32_t ticksPerQuarter, std::span<const ChartTempoChange> changes);
+    TempoMap(uint32_t ticksPerQuarter, std::span<const chartformat::ChartFileTempo> table);
+
+    static TempoMap constant(double bpm, uint32_t ticksPerQuarter = 480);
+
+    uint32_t ticksPerQuarter() const { return ticksPerQuarter_; }
+    std::span<const TempoSegment> segments() const { return segments_; }
+
+    // Times before zero extrapolate the first segment, so lead-ins work.
+    double tickToSeconds(double tick) const;
+    double secondsToTick(double seconds) const;
+    double beatToSeconds(double beat) const { return tickToSeconds(beat * ticksPerQuarter_); }
+    double secondsToBeat(double seconds) const { return secondsToTick(seconds) / ticksPerQuarter_; }
+    double bpmAtTick(double tick) const;
+    double bpmAtSeconds(double seconds) const;
+
+    std::size_t segmentAtTick(double tick) const;
+    std::size_t segmentAtSeconds(double seconds) const;
+
+    class Cursor
+    {
+    public:
+        explicit Cursor(const TempoMap &map) : map_(&map) {}
+
+        double tickToSeconds(double tick);
+        double secondsToTick(double seconds);
+        void reset();
+
+    private:
+        const TempoMap *map_;
+        std::size_t tickSegment_ = 0;
+        std::size_t secondsSegment_ = 0;
+    };
+
+    Cursor cursor() const { return Cursor(*this); }
+
+private:
+    void finish();
+
+    uint32_t ticksPerQuarter_ = 480;
+    std::vector<TempoSegment> segments_;
+};
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "track/TrackTypes.h"
 
+class ChartFile;
+
 class TrackCatalog
 {
 public:
@@ -12,4 +15,10 @@ public:
 
     virtual const std::vector<TrackInfo> &tracks() const = 0;
     virtual std::vector<int> filter(const std::string &query) const = 0;
+    // Maps the part's chart on first use; later calls share the same mapping.
+    virtual std::shared_ptr<const ChartFile> openChart(const TrackPart &part) const = 0;
+    // Takes in tracks found since the last call; true when tracks() grew. Indices of
+    // tracks already listed stay valid.
+    virtual bool poll() { return false; }
+    virtual bool scanning() const { return false; }
 };
@@ -0,0 +1,551 @@
+#include "track/TrackCatalogFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+
+#include "BinaryLog.h"
+#include "track/ChartFile.h"
+
+namespace
+{
+    constexpr char kCacheMagic[8] = {'O', 'C', 'L', 'I', 'B', 'R', 'Y', '1'};
+    // Bump when readTrackInfo derives different metadata from the same files.
+    constexpr uint32_t kCacheRevision = 1;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct FileStamp
+    {
+        int64_t mtime = 0;
+        uint64_t size = 0;
+
+        bool operator==(const FileStamp &) const = default;
+    };
+
+    struct CacheRecord
+    {
+        FileStamp chart;
+        std::string sidecar; // Empty when the chart has none
+        FileStamp sidecarStamp;
+        bool ok = false;     // Failed charts are cached too so they are not reopened
+        TrackInfo track;
+    };
+
+    struct ChartEntry
+    {
+        std::filesystem::path path;
+        std::string key; // Generic path string; the cache key
+        FileStamp stamp;
+        std::filesystem::path sidecar;
+        FileStamp sidecarStamp;
+    };
+
+    std::string lowerCopy(std::string value)
+    {
+        std::transform(value.begin(), value.end(), value.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return value;
+    }
+
+    std::string trim(const std::string &value)
+    {
+        const std::size_t first = value.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+        {
+            return {};
+        }
+        return value.substr(first, value.find_last_not_of(" \t\r") - first + 1);
+    }
+
+    bool stampOf(const std::filesystem::directory_entry &entry, FileStamp &stamp)
+    {
+        std::error_code ec;
+        stamp.size = entry.file_size(ec);
+        if (ec)
+        {
+            return false;
+        }
+        stamp.mtime = static_cast<int64_t>(entry.last_write_time(ec).time_since_epoch().count());
+        return !ec;
+    }
+
+    // song.ini style key=value pairs; [section] headers are ignored.
+    void readSidecar(const std::filesystem::path &path, TrackInfo &track)
+    {
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line))
+        {
+            const std::size_t eq = line.find('=');
+            if (eq == std::string::npos)
+            {
+                continue;
+            }
+            const std::string key = lowerCopy(trim(line.substr(0, eq)));
+            std::string value = trim(line.substr(eq + 1));
+            if (value.empty())
+            {
+                continue;
+            }
+            if (key == "name" || key == "title")
+            {
+                track.title = std::move(value);
+            }
+            else if (key == "artist")
+            {
+                track.artist = std::move(value);
+            }
+            else if (key == "genre")
+            {
+                track.source = std::move(value);
+            }
+            else if (key == "charter" || key == "frets")
+            {
+                track.mapper = std::move(value);
+            }
+        }
+    }
+
+    // Layout: magic, u32 revision, u32 record count, u32 fnv1a32 of the records,
+    // then per record: path, chart stamp, sidecar path and stamp, u8 ok and the
+    // track fields. Parts keep their name and chart block; the path is the chart.
+    void encodeRecord(std::vector<char> &out, const std::string &key, const CacheRecord &record)
+    {
+        binlog::putString(out, key);
+        binlog::putU64(out, static_cast<uint64_t>(record.chart.mtime));
+        binlog::putU64(out, record.chart.size);
+        binlog::putString(out, record.sidecar);
+        binlog::putU64(out, static_cast<uint64_t>(record.sidecarStamp.mtime));
+        binlog::putU64(out, record.sidecarStamp.size);
+        binlog::putU8(out, record.ok ? 1 : 0);
+        if (!record.ok)
+        {
+            return;
+        }
+        const TrackInfo &track = record.track;
+        binlog::putString(out, track.title);
+        binlog::putString(out, track.artist);
+        binlog::putString(out, track.source);
+        binlog::putString(out, track.mapper);
+        binlog::putU32(out, static_cast<uint32_t>(track.bpm));
+        binlog::putString(out, track.length);
+        binlog::putU32(out, static_cast<uint32_t>(track.parts.size()));
+        for (const TrackPart &part : track.parts)
+        {
+            binlog::putString(out, part.name);
+            binlog::putU32(out, static_cast<uint32_t>(part.chartBlock));
+        }
+    }
+
+    bool decodeRecord(binlog::Reader &in, std::string &key, CacheRecord &record)
+    {
+        key = in.string();
+        record.chart.mtime = static_cast<int64_t>(in.bytes(8));
+        record.chart.size = in.bytes(8);
+        record.sidecar = in.string();
+        record.sidecarStamp.mtime = static_cast<int64_t>(in.bytes(8));
+        record.sidecarStamp.size = in.bytes(8);
+        record.ok = in.bytes(1) != 0;
+        if (!record.ok)
+        {
+            return in.ok;
+        }
+        TrackInfo &track = record.track;
+        track.title = in.string();
+        track.artist = in.string();
+        track.source = in.string();
+        track.mapper = in.string();
+        track.bpm = static_cast<int>(in.bytes(4));
+        track.length = in.string();
+        const std::size_t partCount = static_cast<std::size_t>(in.bytes(4));
+        if (!in.ok || partCount > in.size - in.pos)
+        {
+            return false;
+        }
+        track.parts.resize(partCount);
+        for (TrackPart &part : track.parts)
+        {
+            part.name = in.string();
+            part.chartPath = key;
+            part.chartBlock = static_cast<int>(in.bytes(4));
+        }
+        return in.ok;
+    }
+
+    std::unordered_map<std::string, CacheRecord> readCache(const std::filesystem::path &path)
+    {
+        std::unordered_map<std::string, CacheRecord> records;
+        std::ifstream in(path, std::ios::binary);
+        if (!in.good())
+        {
+            return records;
+        }
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        binlog::Reader header{bytes.data(), bytes.size()};
+        const bool magic = bytes.size() >= 20 && std::equal(std::begin(kCacheMagic), std::end(kCacheMagic), bytes.begin());
+        header.pos = sizeof(kCacheMagic);
+        const uint32_t revision = static_cast<uint32_t>(header.bytes(4));
+        const std::size_t count = static_cast<std::size_t>(header.bytes(4));
+        const uint32_t checksum = static_cast<uint32_t>(header.bytes(4));
+        if (!magic || !header.ok || revision != kCacheRevision)
+        {
+            return records;
+        }
+        if (binlog::fnv1a32(bytes.data() + header.pos, bytes.size() - header.pos) != checksum)
+        {
+            std::cerr << "TrackCatalogFile: Ignoring damaged cache " << path.string() << std::endl;
+            return records;
+        }
+
+        binlog::Reader reader{bytes.data(), bytes.size(), header.pos};
+        records.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            std::string key;
+            CacheRecord record;
+            if (!decodeRecord(reader, key, record))
+            {
+                std::cerr << "TrackCatalogFile: Ignoring damaged cache " << path.string() << std::endl;
+                return {};
+            }
+            records.emplace(std::move(key), std::move(record));
+        }
+        return records;
+    }
+
+    bool writeCache(const std::filesystem::path &path, const std::vector<std::pair<std::string, CacheRecord>> &records)
+    {
+        std::vector<char> body;
+        for (const auto &[key, record] : records)
+        {
+            encodeRecord(body, key, record);
+        }
+        std::vector<char> header(std::begin(kCacheMagic), std::end(kCacheMagic));
+        binlog::putU32(header, kCacheRevision);
+        binlog::putU32(header, static_cast<uint32_t>(records.size()));
+        binlog::putU32(header, binlog::fnv1a32(body.data(), body.size()));
+
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(header.data(), static_cast<std::streamsize>(header.size()));
+            out.write(body.data(), static_cast<std::streamsize>(body.size()));
+            if (!out.good())
+            {
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        return !ec;
+    }
+}
+
+TrackCatalogFile::TrackCatalogFile(TrackLibraryOptions options)
+    : options_(std::move(options))
+{
+    options_.publishBatch = std::max<std::size_t>(options_.publishBatch, 1);
+    scanner_ = std::thread([this]
+                           { scan(); });
+}
+
+TrackCatalogFile::~TrackCatalogFile()
+{
+    cancelScan();
+    if (scanner_.joinable())
+    {
+        scanner_.join();
+    }
+}
+
+const std::vector<TrackInfo> &TrackCatalogFile::tracks() const
+{
+    return tracks_;
+}
+
+std::vector<int> TrackCatalogFile::filter(const std::string &query) const
+{
+    return index_.search(query);
+}
+
+std::shared_ptr<const ChartFile> TrackCatalogFile::openChart(const TrackPart &part) const
+{
+    return charts_.open(part.chartPath);
+}
+
+bool TrackCatalogFile::poll()
+{
+    std::vector<TrackInfo> arrived;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        arrived.swap(incoming_);
+    }
+    if (arrived.empty())
+    {
+        return false;
+    }
+    // Indexed outside the lock so the workers never wait on the UI thread.
+    for (TrackInfo &track : arrived)
+    {
+        index_.add(track);
+        tracks_.push_back(std::move(track));
+    }
+    return true;
+}
+
+void TrackCatalogFile::cancelScan()
+{
+    cancel_ = true;
+}
+
+bool TrackCatalogFile::scanning() const
+{
+    return scanning_;
+}
+
+bool TrackCatalogFile::waitForScan(std::chrono::milliseconds timeout) const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return done_.wait_for(lock, timeout, [this]
+                          { return !scanning_; });
+}
+
+TrackLibraryStats TrackCatalogFile::scanStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+bool TrackCatalogFile::readTrackInfo(const std::filesystem::path &chartPath, const std::filesystem::path &sidecar,
+                                     TrackInfo &track, std::string &error)
+{
+    std::shared_ptr<const ChartFile> chart = ChartFile::open(chartPath, error);
+    if (!chart)
+    {
+        return false;
+    }
+
+    track = TrackInfo{};
+    const std::string stem = chartPath.stem().string();
+    const std::size_t dash = stem.find(" - ");
+    if (dash != std::string::npos)
+    {
+        track.artist = stem.substr(0, dash);
+        track.title = stem.substr(dash + 3);
+    }
+    else
+    {
+        track.title = stem;
+    }
+    if (!sidecar.empty())
+    {
+        readSidecar(sidecar, track);
+    }
+
+    if (!chart->tempo().empty() && chart->tempo().front().microsPerQuarter > 0)
+    {
+        track.bpm = static_cast<int>(std::lround(60e6 / chart->tempo().front().microsPerQuarter));
+    }
+
+    // Notes are sorted by start, but a long sustain can outlast later notes.
+    uint32_t endTick = 0;
+    for (std::size_t i = 0; i < chart->partCount(); ++i)
+    {
+        const ChartPartView part = chart->part(i);
+        for (std::size_t n = 0; n < part.size(); ++n)
+        {
+            endTick = std::max(endTick, part.startTick[n] + part.duration[n]);
+        }
+        track.parts.push_back(TrackPart{std::string(part.name), chartPath.generic_string(), static_cast<int>(i)});
+    }
+    const long seconds = std::lround(chart->tickToSeconds(endTick));
+    char length[32];
+    std::snprintf(length, sizeof(length), "%ld:%02ld", seconds / 60, seconds % 60);
+    track.length = length;
+    return true;
+}
+
+void TrackCatalogFile::publish(std::vector<TrackInfo> &batch)
+{
+    if (batch.empty())
+    {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    incoming_.insert(incoming_.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    batch.clear();
+}
+
+void TrackCatalogFile::scan()
+{
+    const auto start = Clock::now();
+    TrackLibraryStats stats;
+
+    // Walk every root once. Sidecars are collected in the same pass so matching
+    // them to charts costs no extra filesystem calls.
+    std::vector<ChartEntry> charts;
+    std::unordered_map<std::string, FileStamp> sidecars;
+    for (const std::filesystem::path &root : options_.roots)
+    {
+        std::error_code ec;
+        auto it = std::filesystem::recursive_directory_iterator(
+            root, std::filesystem::directory_options::skip_permission_denied, ec);
+        for (; !ec && it != std::filesystem::recursive_directory_iterator() && !cancel_; it.increment(ec))
+        {
+            std::error_code typeEc;
+            if (!it->is_regular_file(typeEc))
+            {
+                continue;
+            }
+            const std::string ext = lowerCopy(it->path().extension().string());
+            FileStamp stamp;
+            if ((ext != ".occhart" && ext != ".ini") || !stampOf(*it, stamp))
+            {
+                continue;
+            }
+            if (ext == ".ini")
+            {
+                sidecars.emplace(it->path().generic_string(), stamp);
+            }
+            else
+            {
+                charts.push_back(ChartEntry{it->path(), it->path().generic_string(), stamp, {}, {}});
+            }
+        }
+    }
+    const bool walkCancelled = cancel_;
+    std::sort(charts.begin(), charts.end(), [](const ChartEntry &a, const ChartEntry &b)
+              { return a.key < b.key; });
+    for (ChartEntry &chart : charts)
+    {
+        std::filesystem::path own = chart.path;
+        own.replace_extension(".ini");
+        for (const std::filesystem::path &candidate : {own, chart.path.parent_path() / "song.ini"})
+        {
+            auto found = sidecars.find(candidate.generic_string());
+            if (found != sidecars.end())
+            {
+                chart.sidecar = candidate;
+                chart.sidecarStamp = found->second;
+                break;
+            }
+        }
+    }
+    stats.charts = charts.size();
+    stats.walkMillis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    // Unchanged charts go straight to the UI; the rest are opened by the workers.
+    std::unordered_map<std::string, CacheRecord> cache;
+    if (!options_.cachePath.empty())
+    {
+        cache = readCache(options_.cachePath);
+    }
+    std::vector<CacheRecord> records(charts.size());
+    std::vector<std::size_t> misses;
+    std::vector<TrackInfo> batch;
+    for (std::size_t i = 0; i < charts.size(); ++i)
+    {
+        const ChartEntry &chart = charts[i];
+        auto found = cache.find(chart.key);
+        if (found != cache.end() && found->second.chart == chart.stamp &&
+            found->second.sidecar == chart.sidecar.generic_string() && found->second.sidecarStamp == chart.sidecarStamp)
+        {
+            records[i] = std::move(found->second);
+            ++stats.cached;
+            if (records[i].ok)
+            {
+                batch.push_back(records[i].track);
+                if (batch.size() >= options_.publishBatch)
+                {
+                    publish(batch);
+                }
+            }
+        }
+        else
+        {
+            misses.push_back(i);
+        }
+    }
+    publish(batch);
+    const bool cacheStale = cache.size() != stats.cached;
+    cache.clear();
+
+    unsigned workers = options_.jobs > 0 ? options_.jobs : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(misses.size(), 1)));
+    stats.jobs = workers;
+    const std::size_t workerBatch = std::max<std::size_t>(options_.publishBatch / workers, 1);
+    std::atomic<std::size_t> next{0};
+    std::atomic<std::size_t> opened{0};
+    std::atomic<std::size_t> failed{0};
+    auto work = [&]()
+    {
+        std::vector<TrackInfo> parsed;
+        for (std::size_t m = next.fetch_add(1); m < misses.size() && !cancel_; m = next.fetch_add(1))
+        {
+            const ChartEntry &chart = charts[misses[m]];
+            CacheRecord &record = records[misses[m]];
+            record.chart = chart.stamp;
+            record.sidecar = chart.sidecar.generic_string();
+            record.sidecarStamp = chart.sidecarStamp;
+            std::string error;
+            record.ok = readTrackInfo(chart.path, chart.sidecar, record.track, error);
+            ++opened;
+            if (!record.ok)
+            {
+                ++failed;
+                std::cerr << "TrackCatalogFile: Skipping " << chart.key << ": " << error << std::endl;
+                continue;
+            }
+            parsed.push_back(record.track);
+            if (parsed.size() >= workerBatch)
+            {
+                publish(parsed);
+            }
+        }
+        publish(parsed);
+    };
+    std::vector<std::thread> threads;
+    for (unsigned i = 1; i < workers; ++i)
+    {
+        threads.emplace_back(work);
+    }
+    work();
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    stats.parsed = opened;
+    stats.failed = failed;
+    stats.cancelled = walkCancelled || stats.parsed < misses.size();
+    if (!stats.cancelled && !options_.cachePath.empty() && (!misses.empty() || cacheStale))
+    {
+        std::vector<std::pair<std::string, CacheRecord>> rows;
+        rows.reserve(charts.size());
+        for (std::size_t i = 0; i < charts.size(); ++i)
+        {
+            rows.emplace_back(charts[i].key, std::move(records[i]));
+        }
+        if (!writeCache(options_.cachePath, rows))
+        {
+            std::cerr << "TrackCatalogFile: Cannot write " << options_.cachePath.string() << std::endl;
+        }
+    }
+    stats.totalMillis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_ = stats;
+        scanning_ = false;
+    }
+    done_.notify_all();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#include "track/ChartCache.h"
+#include "track/TrackCatalog.h"
+#include "track/TrackSearchIndex.h"
+
+struct TrackLibraryOptions
+{
+    std::vector<std::filesystem::path> roots; // Directories searched for .occhart files
+    std::filesystem::path cachePath;          // Metadata cache; empty re-reads every chart
+    unsigned jobs = 0;                        // 0 = one per hardware thread
+    std::size_t publishBatch = 256;           // Tracks handed over per batch while scanning
+};
+
+struct TrackLibraryStats
+{
+    std::size_t charts = 0; // .occhart files found
+    std::size_t cached = 0; // Served from the metadata cache
+    std::size_t parsed = 0; // Opened because they were new or changed
+    std::size_t failed = 0;
+    bool cancelled = false; // Stopped early; the counts cover only what was reached
+    unsigned jobs = 0;
+    double walkMillis = 0.0;
+    double totalMillis = 0.0;
+};
+
+// Track catalog built from the song directories on disk. Every .occhart file is one
+// track: parts, BPM and length come from the chart, and title, artist, genre and
+// charter from an optional "<chart stem>.ini" or "song.ini" beside it (name=,
+// artist=, genre=, charter=). Without one, "Artist - Title" stems are split.
+//
+// The scan runs on a background thread and opens new or changed charts on a worker
+// pool. Results are keyed by path, modification time and size in a binary cache,
+// so a warm start only opens files that changed. Tracks arrive in batches that
+// poll() moves into tracks(); existing indices never change.
+class TrackCatalogFile : public TrackCatalog
+{
+public:
+    explicit TrackCatalogFile(TrackLibraryOptions options);
+    ~TrackCatalogFile() override;
+
+    TrackCatalogFile(const TrackCatalogFile &) = delete;
+    TrackCatalogFile &operator=(const TrackCatalogFile &) = delete;
+
+    // tracks(), filter() and poll() belong to the thread that polls.
+    const std::vector<TrackInfo> &tracks() const override;
+    std::vector<int> filter(const std::string &query) const override;
+    std::shared_ptr<const ChartFile> openChart(const TrackPart &part) const override;
+    bool poll() override;
+    bool scanning() const override;
+
+    bool waitForScan(std::chrono::milliseconds timeout) const;
+    // Stops the scan at the next chart. Tracks already published stay and the
+    // cache is left as it was.
+    void cancelScan();
+    // Final once the scan is done.
+    TrackLibraryStats scanStats() const;
+
+    // Builds the catalog entry for one chart; `sidecar` may be empty.
+    static bool readTrackInfo(const std::filesystem::path &chartPath, const std::filesystem::path &sidecar,
+                              TrackInfo &track, std::string &error);
+
+private:
+    void scan();
+    void publish(std::vector<TrackInfo> &batch);
+
+    TrackLibraryOptions options_;
+    std::vector<TrackInfo> tracks_;
+    TrackSearchIndex index_;
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable done_;
+    std::vector<TrackInfo> incoming_;
+    TrackLibraryStats stats_;
+    std::atomic<bool> scanning_{true};
+    std::atomic<bool> cancel_{false};
+    std::thread scanner_;
+
+    ChartCache charts_;
+};
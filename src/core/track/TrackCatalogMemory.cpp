@@ -1,7 +1,15 @@
 #include "track/TrackCatalogMemory.h"
 
-#include <algorithm>
-#include <cctype>
+#include "track/ChartFile.h"
+
+namespace
+{
+    // The built-in tracks ship without charts.
+    std::vector<TrackPart> builtInParts()
+    {
+        return {TrackPart{"Lead Guitar", {}, -1}, TrackPart{"Rhythm Guitar", {}, -1}, TrackPart{"Bass", {}, -1}};
+    }
+}
 
 TrackCatalogMemory::TrackCatalogMemory()
 {
@@ -12,7 +20,7 @@ TrackCatalogMemory::TrackCatalogMemory()
         "Raine",
         212,
         "8:36",
-        {{"Lead Guitar"}, {"Rhythm Guitar"}, {"Bass"}}});
+        builtInParts()});
 
     tracks_.push_back(TrackInfo{
         "Back in Black",
@@ -21,7 +29,7 @@ TrackCatalogMemory::TrackCatalogMemory()
         "Lux",
         94,
         "4:15",
-        {{"Lead Guitar"}, {"Rhythm Guitar"}, {"Bass"}}});
+        builtInParts()});
 
     tracks_.push_back(TrackInfo{
         "Painkiller",
@@ -30,7 +38,7 @@ TrackCatalogMemory::TrackCatalogMemory()
         "Harper",
         188,
         "6:06",
-        {{"Lead Guitar"}, {"Rhythm Guitar"}, {"Bass"}}});
+        builtInParts()});
 
     tracks_.push_back(TrackInfo{
         "Paranoid",
@@ -39,7 +47,7 @@ TrackCatalogMemory::TrackCatalogMemory()
         "Aster",
         163,
         "2:48",
-        {{"Lead Guitar"}, {"Rhythm Guitar"}, {"Bass"}}});
+        builtInParts()});
 
     tracks_.push_back(TrackInfo{
         "Holy Wars... The Punishment Due",
@@ -48,7 +56,13 @@ TrackCatalogMemory::TrackCatalogMemory()
         "Mara",
         178,
         "6:36",
-        {{"Lead Guitar"}, {"Rhythm Guitar"}, {"Bass"}}});
+        builtInParts()});
+
+    index_.reserve(tracks_.size());
+    for (const TrackInfo &track : tracks_)
+    {
+        index_.add(track);
+    }
 }
 
 const std::vector<TrackInfo> &TrackCatalogMemory::tracks() const
@@ -58,29 +72,10 @@ const std::vector<TrackInfo> &TrackCatalogMemory::tracks() const
 
 std::vector<int> TrackCatalogMemory::filter(const std::string &query) const
 {
-    std::vector<int> out;
-    std::string lowered = lowerCopy(query);
-    for (size_t i = 0; i < tracks_.size(); ++i)
-    {
-        if (lowered.empty() || matchesFilter(tracks_[i], lowered))
-        {
-            out.push_back(static_cast<int>(i));
-        }
-    }
-    return out;
-}
-
-bool TrackCatalogMemory::matchesFilter(const TrackInfo &track, const std::string &query) const
-{
-    std::string title = lowerCopy(track.title);
-    std::string artist = lowerCopy(track.artist);
-    return title.find(query) != std::string::npos || artist.find(query) != std::string::npos;
+    return index_.search(query);
 }
 
-std::string TrackCatalogMemory::lowerCopy(const std::string &value)
+std::shared_ptr<const ChartFile> TrackCatalogMemory::openChart(const TrackPart &part) const
 {
-    std::string out = value;
-    std::transform(out.begin(), out.end(), out.begin(),
-                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
-    return out;
+    return charts_.open(part.chartPath);
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "track/ChartCache.h"
 #include "track/TrackCatalog.h"
+#include "track/TrackSearchIndex.h"
 
 class TrackCatalogMemory : public TrackCatalog
 {
@@ -9,10 +11,10 @@ public:
 
     const std::vector<TrackInfo> &tracks() const override;
     std::vector<int> filter(const std::string &query) const override;
+    std::shared_ptr<const ChartFile> openChart(const TrackPart &part) const override;
 
 private:
-    static std::string lowerCopy(const std::string &value);
-    bool matchesFilter(const TrackInfo &track, const std::string &query) const;
-
     std::vector<TrackInfo> tracks_;
+    TrackSearchIndex index_;
+    ChartCache charts_;
 };
@@ -0,0 +1,270 @@
+#include "track/TrackSearchIndex.h"
+
+#include <algorithm>
+
+namespace
+{
+    constexpr char kFieldSeparator = '\n';
+
+    // Length in the top byte so "a", "ab" and "abc" never collide.
+    uint32_t gramKey(const char *p, std::size_t length)
+    {
+        uint32_t key = static_cast<uint32_t>(length) << 24;
+        for (std::size_t i = 0; i < length; ++i)
+        {
+            key |= static_cast<uint32_t>(static_cast<uint8_t>(p[i])) << (8 * (length - 1 - i));
+        }
+        return key;
+    }
+
+    uint32_t rankAt(std::string_view text, std::size_t pos)
+    {
+        const char before = pos == 0 ? kFieldSeparator : text[pos - 1];
+        return before == kFieldSeparator ? 3u : before == ' ' ? 2u : 1u;
+    }
+
+    // Unique trigrams of a folded query.
+    void queryTrigrams(std::string_view text, std::vector<uint32_t> &out)
+    {
+        out.clear();
+        for (std::size_t i = 0; i + 3 <= text.size(); ++i)
+        {
+            out.push_back(gramKey(text.data() + i, 3));
+        }
+        std::sort(out.begin(), out.end());
+        out.erase(std::unique(out.begin(), out.end()), out.end());
+    }
+}
+
+void TrackSearchIndex::clear()
+{
+    text_.clear();
+    offsets_.assign(1, 0);
+    postings_.clear();
+    lastQuery_.clear();
+    lastExact_.clear();
+    lastSize_ = 0;
+}
+
+void TrackSearchIndex::reserve(std::size_t tracks)
+{
+    offsets_.reserve(tracks + 1);
+    text_.reserve(tracks * 32);
+}
+
+void TrackSearchIndex::add(const TrackInfo &track)
+{
+    const auto id = static_cast<uint32_t>(size());
+    text_ += fold(track.title);
+    text_ += kFieldSeparator;
+    text_ += fold(track.artist);
+    offsets_.push_back(static_cast<uint32_t>(text_.size()));
+
+    // Every 1-, 2- and 3-gram that stays inside a field, with the best rank it
+    // reaches in this track.
+    const std::string_view folded = text(id);
+    std::vector<std::pair<uint32_t, uint32_t>> grams;
+    for (std::size_t pos = 0; pos < folded.size(); ++pos)
+    {
+        const uint32_t rank = rankAt(folded, pos);
+        for (std::size_t length = 1; length <= 3 && pos + length <= folded.size(); ++length)
+        {
+            if (folded[pos + length - 1] == kFieldSeparator)
+            {
+                break;
+            }
+            grams.emplace_back(gramKey(folded.data() + pos, length), rank);
+        }
+    }
+    std::sort(grams.begin(), grams.end());
+    for (std::size_t i = 0; i < grams.size(); ++i)
+    {
+        // Sorted by key then rank, so the last of each run has the best rank.
+        if (i + 1 == grams.size() || grams[i + 1].first != grams[i].first)
+        {
+            // Ids only grow, so appending keeps every posting list sorted.
+            postings_[grams[i].first].push_back(id << 2 | grams[i].second);
+        }
+    }
+}
+
+std::string TrackSearchIndex::fold(std::string_view text)
+{
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text)
+    {
+        const auto byte = static_cast<unsigned char>(c);
+        if ((byte >= '0' && byte <= '9') || (byte >= 'a' && byte <= 'z') || byte >= 0x80)
+        {
+            out.push_back(c);
+        }
+        else if (byte >= 'A' && byte <= 'Z')
+        {
+            out.push_back(static_cast<char>(byte - 'A' + 'a'));
+        }
+        else if (!out.empty() && out.back() != ' ')
+        {
+            out.push_back(' ');
+        }
+    }
+    if (!out.empty() && out.back() == ' ')
+    {
+        out.pop_back();
+    }
+    return out;
+}
+
+TrackSearchIndex::MatchRank TrackSearchIndex::exactRank(uint32_t id, std::string_view query) const
+{
+    const std::string_view haystack = text(id);
+    MatchRank best = Fuzzy;
+    for (std::size_t pos = haystack.find(query); pos != std::string_view::npos; pos = haystack.find(query, pos + 1))
+    {
+        best = std::max(best, static_cast<MatchRank>(rankAt(haystack, pos)));
+        if (best == FieldStart)
+        {
+            break;
+        }
+    }
+    return best;
+}
+
+std::vector<int> TrackSearchIndex::search(std::string_view query) const
+{
+    const std::string folded = fold(query);
+    const auto total = static_cast<uint32_t>(size());
+    std::vector<int> out;
+    if (folded.empty())
+    {
+        out.resize(total);
+        for (uint32_t id = 0; id < total; ++id)
+        {
+            out[id] = static_cast<int>(id);
+        }
+        lastQuery_.clear();
+        return out;
+    }
+
+    // Candidates are visited in id order, so `exact` comes out sorted and each rank
+    // bucket keeps ids ascending.
+    std::vector<uint32_t> exact;
+    std::vector<uint32_t> buckets[FieldStart + 1];
+    auto verify = [&](uint32_t id)
+    {
+        const MatchRank rank = exactRank(id, folded);
+        if (rank != Fuzzy)
+        {
+            exact.push_back(id);
+            buckets[rank].push_back(id);
+        }
+    };
+    auto postings = [&](std::size_t pos, std::size_t length) -> const std::vector<uint32_t> *
+    {
+        auto it = postings_.find(gramKey(folded.data() + pos, length));
+        return it == postings_.end() ? nullptr : &it->second;
+    };
+
+    if (folded.size() <= 3)
+    {
+        // The query is a single gram: its posting list is the answer, ranks included.
+        if (const std::vector<uint32_t> *list = postings(0, folded.size()))
+        {
+            exact.reserve(list->size());
+            for (uint32_t entry : *list)
+            {
+                exact.push_back(entry >> 2);
+                buckets[entry & 3].push_back(entry >> 2);
+            }
+        }
+    }
+    else
+    {
+        // Every trigram of the query must occur, so the rarest one bounds the work,
+        // unless the query grew from the last one and its matches are fewer still.
+        const std::vector<uint32_t> *shortest = nullptr;
+        for (std::size_t pos = 0; pos + 3 <= folded.size(); ++pos)
+        {
+            const std::vector<uint32_t> *list = postings(pos, 3);
+            if (!list)
+            {
+                shortest = nullptr;
+                break;
+            }
+            if (!shortest || list->size() < shortest->size())
+            {
+                shortest = list;
+            }
+        }
+        const bool narrowing = !lastQuery_.empty() && folded.find(lastQuery_) != std::string::npos;
+        if (shortest && narrowing && lastExact_.size() + (total - lastSize_) < shortest->size())
+        {
+            for (uint32_t id : lastExact_)
+            {
+                verify(id);
+            }
+            for (uint32_t id = static_cast<uint32_t>(lastSize_); id < total; ++id)
+            {
+                verify(id);
+            }
+        }
+        else if (shortest)
+        {
+            for (uint32_t entry : *shortest)
+            {
+                verify(entry >> 2);
+            }
+        }
+    }
+
+    out.reserve(exact.size());
+    for (int rank = FieldStart; rank > Fuzzy; --rank)
+    {
+        out.insert(out.end(), buckets[rank].begin(), buckets[rank].end());
+    }
+
+    // Typo tolerance: count shared trigrams per track. One wrong letter breaks at
+    // most three trigrams, so half the query's trigrams is a forgiving bar.
+    std::vector<uint32_t> trigrams;
+    queryTrigrams(folded, trigrams);
+    if (exact.size() < kFuzzyFill && trigrams.size() >= 2)
+    {
+        counts_.assign(total, 0);
+        std::vector<uint32_t> touched;
+        for (uint32_t key : trigrams)
+        {
+            auto it = postings_.find(key);
+            if (it == postings_.end())
+            {
+                continue;
+            }
+            for (uint32_t entry : it->second)
+            {
+                if (counts_[entry >> 2]++ == 0)
+                {
+                    touched.push_back(entry >> 2);
+                }
+            }
+        }
+        const std::size_t needed = (trigrams.size() + 1) / 2;
+        std::vector<std::pair<uint32_t, uint16_t>> fuzzy;
+        for (uint32_t id : touched)
+        {
+            if (counts_[id] >= needed && !std::binary_search(exact.begin(), exact.end(), id))
+            {
+                fuzzy.emplace_back(id, counts_[id]);
+            }
+        }
+        std::sort(fuzzy.begin(), fuzzy.end(), [](const auto &a, const auto &b)
+                  { return a.second != b.second ? a.second > b.second : a.first < b.first; });
+        for (const auto &[id, count] : fuzzy)
+        {
+            out.push_back(static_cast<int>(id));
+        }
+    }
+
+    lastQuery_ = folded;
+    lastExact_ = std::move(exact);
+    lastSize_ = total;
+    return out;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "track/TrackTypes.h"
+
+// Title/artist search over a catalog. Each track's text is folded once (ASCII
+// lowercase, punctuation runs collapsed to one space) into a shared buffer, and
+// every 1-, 2- and 3-gram maps to the ascending ids of the tracks containing it,
+// tagged with how well it matched there.
+//
+// Results come in two tiers. Substring matches come first, ranked field start >
+// word start > anywhere. Queries of up to three characters are read straight off
+// their posting list; longer ones verify the rarest trigram's tracks, or the
+// previous result when the query only grew, as it does while typing. When exact
+// hits are scarce, tracks sharing at least half of the query's trigrams follow as
+// typo-tolerant matches, most shared first.
+class TrackSearchIndex
+{
+public:
+    // Fewer exact hits than this and fuzzy matches are appended.
+    static constexpr std::size_t kFuzzyFill = 32;
+
+    void clear();
+    void reserve(std::size_t tracks);
+    // Ids are assigned in insertion order, matching the catalog's track indices.
+    void add(const TrackInfo &track);
+    std::size_t size() const { return offsets_.size() - 1; }
+
+    // Not thread safe: the narrowing state is updated even though this is const.
+    std::vector<int> search(std::string_view query) const;
+
+    static std::string fold(std::string_view text);
+
+private:
+    enum MatchRank : uint8_t
+    {
+        Fuzzy,
+        Inside,
+        WordStart,
+        FieldStart
+    };
+
+    std::string_view text(uint32_t id) const
+    {
+        return std::string_view(text_).substr(offsets_[id], offsets_[id + 1] - offsets_[id]);
+    }
+    MatchRank exactRank(uint32_t id, std::string_view query) const;
+
+    std::string text_;                   // Folded "title\nartist" of every track, back to back
+    std::vector<uint32_t> offsets_{0};   // Track i spans [offsets_[i], offsets_[i + 1])
+    std::unordered_map<uint32_t, std::vector<uint32_t>> postings_; // Entries are id << 2 | MatchRank
+
+    mutable std::string lastQuery_;      // Folded query of the previous search
+    mutable std::vector<uint32_t> lastExact_; // Its substring matches, ascending
+    mutable std::size_t lastSize_ = 0;   // Tracks indexed when it ran
+    mutable std::vector<uint16_t> counts_;
+};
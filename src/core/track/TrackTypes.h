@@ -6,6 +6,8 @@
 struct TrackPart
 {
     std::string name;
+    std::string chartPath; // .occhart file holding this part's notes; empty if none
+    int chartBlock = -1;   // Part index inside the chart; -1 looks it up by name
 };
 
 struct TrackInfo
@@ -0,0 +1,110 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "devtools/CommandRegistry.h"
+#include "devtools/DevConsole.h"
+#include "devtools/IDevCommand.h"
+#include "devtools/commands/CommandArgs.h"
+
+namespace openchordix::devtools
+{
+    namespace
+    {
+        class CaptureCommand final : public IDevCommand
+        {
+        public:
+            CaptureCommand(std::function<bool(std::string_view)> startHandler,
+                           std::function<void()> stopHandler,
+                           std::function<std::string()> statusProvider,
+                           std::function<std::string(std::string_view, std::string_view)> replayHandler)
+                : startHandler_(std::move(startHandler)),
+                  stopHandler_(std::move(stopHandler)),
+                  statusProvider_(std::move(statusProvider)),
+                  replayHandler_(std::move(replayHandler))
+            {
+            }
+
+            std::string_view name() const override { return "capture"; }
+            std::string_view help() const override
+            {
+                return "Session capture: capture status | capture start [path] | capture stop | capture replay <file> [golden]";
+            }
+
+            void execute(DevConsole &console, std::span<const std::string_view> args) const override
+            {
+                if (args.empty() || args.front() == "status")
+                {
+                    console.addLog(statusProvider_ ? statusProvider_() : "Capture status unavailable.");
+                    return;
+                }
+
+                if (args.front() == "start")
+                {
+                    std::string path = joinTokens(args, 1);
+                    if (!startHandler_ || !startHandler_(path))
+                    {
+                        console.addLog("Failed to start capture.");
+                    }
+                    if (statusProvider_)
+                    {
+                        console.addLog(statusProvider_());
+                    }
+                    return;
+                }
+
+                if (args.front() == "stop")
+                {
+                    if (stopHandler_)
+                    {
+                        stopHandler_();
+                    }
+                    if (statusProvider_)
+                    {
+                        console.addLog(statusProvider_());
+                    }
+                    return;
+                }
+
+                if (args.front() == "replay")
+                {
+                    if (args.size() < 2)
+                    {
+                        console.addLog("Usage: capture replay <file.occap> [golden.txt]");
+                        return;
+                    }
+                    if (!replayHandler_)
+                    {
+                        console.addLog("Replay unavailable.");
+                        return;
+                    }
+                    std::string_view golden = args.size() > 2 ? args[2] : std::string_view{};
+                    console.addLog(replayHandler_(args[1], golden));
+                    return;
+                }
+
+                console.addLog("Unknown capture command. Try: capture status | capture start [path] | capture stop | capture replay <file> [golden]");
+            }
+
+        private:
+            std::function<bool(std::string_view)> startHandler_;
+            std::function<void()> stopHandler_;
+            std::function<std::string()> statusProvider_;
+            std::function<std::string(std::string_view, std::string_view)> replayHandler_;
+        };
+    }
+
+    void registerCaptureCommands(CommandRegistry &registry,
+                                 std::function<bool(std::string_view)> startHandler,
+                                 std::function<void()> stopHandler,
+                                 std::function<std::string()> statusProvider,
+                                 std::function<std::string(std::string_view, std::string_view)> replayHandler)
+    {
+        registry.registerCommand(std::make_unique<CaptureCommand>(std::move(startHandler),
+                                                                  std::move(stopHandler),
+                                                                  std::move(statusProvider),
+                                                                  std::move(replayHandler)));
+    }
+}
@@ -0,0 +1,18 @@
+#include "devtools/commands/CommandArgs.h"
+
+namespace openchordix::devtools
+{
+    std::string joinTokens(std::span<const std::string_view> tokens, std::size_t start)
+    {
+        std::string result;
+        for (std::size_t i = start; i < tokens.size(); ++i)
+        {
+            if (!result.empty())
+            {
+                result.push_back(' ');
+            }
+            result.append(tokens[i]);
+        }
+        return result;
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace openchordix::devtools
+{
+    // Rejoins the arguments from start onwards with single spaces, for trailing
+    // arguments such as paths that may contain spaces.
+    std::string joinTokens(std::span<const std::string_view> tokens, std::size_t start);
+}
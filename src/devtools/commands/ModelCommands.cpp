@@ -7,25 +7,12 @@
 #include "devtools/CommandRegistry.h"
 #include "devtools/DevConsole.h"
 #include "devtools/IDevCommand.h"
+#include "devtools/commands/CommandArgs.h"
 
 namespace openchordix::devtools
 {
     namespace
     {
-        std::string joinTokens(std::span<const std::string_view> tokens, std::size_t start)
-        {
-            std::string result;
-            for (std::size_t i = start; i < tokens.size(); ++i)
-            {
-                if (!result.empty())
-                {
-                    result.push_back(' ');
-                }
-                result.append(tokens[i]);
-            }
-            return result;
-        }
-
         class ModelCommand final : public IDevCommand
         {
         public:
@@ -83,7 +70,7 @@ namespace openchordix::devtools
                     std::string path = joinTokens(args, 1);
                     if (loadHandler_(path))
                     {
-                        console.addLog("Model loaded: " + path);
+                        console.addLog("Loading model: " + path + " (see model status)");
                     }
                     else
                     {
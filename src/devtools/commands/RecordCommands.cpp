@@ -0,0 +1,90 @@
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "devtools/CommandRegistry.h"
+#include "devtools/DevConsole.h"
+#include "devtools/IDevCommand.h"
+#include "devtools/commands/CommandArgs.h"
+
+namespace openchordix::devtools
+{
+    namespace
+    {
+        class RecordCommand final : public IDevCommand
+        {
+        public:
+            RecordCommand(std::function<bool(std::string_view)> startHandler,
+                          std::function<bool()> stopHandler,
+                          std::function<std::string()> statusProvider)
+                : startHandler_(std::move(startHandler)),
+                  stopHandler_(std::move(stopHandler)),
+                  statusProvider_(std::move(statusProvider))
+            {
+            }
+
+            std::string_view name() const override { return "record"; }
+            std::string_view help() const override { return "Take recorder: record status | record start [path.wav] | record stop"; }
+
+            void execute(DevConsole &console, std::span<const std::string_view> args) const override
+            {
+                if (args.empty() || args.front() == "status")
+                {
+                    console.addLog(statusProvider_ ? statusProvider_() : "Recorder status unavailable.");
+                    return;
+                }
+
+                if (args.front() == "start")
+                {
+                    if (!startHandler_)
+                    {
+                        console.addLog("Recording unavailable.");
+                        return;
+                    }
+                    std::string path = joinTokens(args, 1);
+                    if (!startHandler_(path))
+                    {
+                        console.addLog("Failed to start recording.");
+                    }
+                    if (statusProvider_)
+                    {
+                        console.addLog(statusProvider_());
+                    }
+                    return;
+                }
+
+                if (args.front() == "stop")
+                {
+                    if (stopHandler_ && !stopHandler_())
+                    {
+                        console.addLog("Take was not saved completely.");
+                    }
+                    if (statusProvider_)
+                    {
+                        console.addLog(statusProvider_());
+                    }
+                    return;
+                }
+
+                console.addLog("Unknown record command. Try: record status | record start [path.wav] | record stop");
+            }
+
+        private:
+            std::function<bool(std::string_view)> startHandler_;
+            std::function<bool()> stopHandler_;
+            std::function<std::string()> statusProvider_;
+        };
+    }
+
+    void registerRecordCommands(CommandRegistry &registry,
+                                std::function<bool(std::string_view)> startHandler,
+                                std::function<bool()> stopHandler,
+                                std::function<std::string()> statusProvider)
+    {
+        registry.registerCommand(std::make_unique<RecordCommand>(std::move(startHandler),
+                                                                 std::move(stopHandler),
+                                                                 std::move(statusProvider)));
+    }
+}
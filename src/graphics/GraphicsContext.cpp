@@ -486,9 +486,16 @@ bool GraphicsContext::initializeRenderer()
     {
         std::cerr << "Renderer: Failed to initialize model renderer." << std::endl;
     }
+    else if (!highwayRenderer_.initialize(modelRenderer_))
+    {
+        std::cerr << "Renderer: Failed to initialize highway renderer." << std::endl;
+    }
 
     uint16_t viewOrder[] = {openchordix::render::kViewIdScene, openchordix::render::kViewIdUi};
     bgfx::setViewOrder(0, 2, viewOrder);
+    // ModelRenderer::submit sorts its draws itself and skips binds the previous
+    // draw already made, so bgfx has to keep the submission order.
+    bgfx::setViewMode(openchordix::render::kViewIdScene, bgfx::ViewMode::Sequential);
     return true;
 }
 
@@ -536,6 +543,7 @@ bool GraphicsContext::shouldClose() const
 
 void GraphicsContext::shutdown()
 {
+    highwayRenderer_.shutdown();
     modelRenderer_.shutdown();
     if (renderer_.isInitialized())
     {
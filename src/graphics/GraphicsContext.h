@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "Renderer.h"
+#include "render/HighwayRenderer.h"
 #include "render/ModelRenderer.h"
 
 struct FrameInput
@@ -43,6 +44,7 @@ public:
     openchordix::Renderer &renderer() { return renderer_; }
     openchordix::render::ModelRenderer &modelRenderer() { return modelRenderer_; }
     const openchordix::render::ModelRenderer &modelRenderer() const { return modelRenderer_; }
+    openchordix::render::HighwayRenderer &highwayRenderer() { return highwayRenderer_; }
 
 private:
     void updateNativeHandles();
@@ -55,6 +57,7 @@ private:
     openchordix::Renderer renderer_{};
     openchordix::RendererConfig rendererConfig_{};
     openchordix::render::ModelRenderer modelRenderer_{};
+    openchordix::render::HighwayRenderer highwayRenderer_{};
     bool startedWithWindow_{false};
     float scrollDelta_{0.0f};
     std::vector<uint32_t> inputChars_{};
@@ -2,7 +2,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <functional>
+#include <iostream>
 #include <optional>
 #include <string>
 #include <thread>
@@ -12,14 +15,20 @@
 #include <imgui/imgui.h>
 
 #include "AudioSetupScene.h"
+#include "audio/SessionReplay.h"
 #include "platform/ImGuiPlatformBridge.h"
 #include "IntroScene.h"
 #include "MainMenuScene.h"
 #include "scenes/SceneCatalog.h"
 #include "render/RenderViewIds.h"
+#include "score/ScoreServiceFile.h"
+#include "score/ScoreServiceMemory.h"
+#include "score/ScoreServiceOnline.h"
 #include "SettingsScene.h"
 #include "TestScene.h"
 #include "TrackSelectScene.h"
+#include "track/TrackCatalogFile.h"
+#include "track/TrackCatalogMemory.h"
 #include "TunerScene.h"
 #include "devtools/commands/CommandList.h"
 
@@ -33,6 +42,17 @@ namespace openchordix::devtools
                                std::function<bool(std::string_view)> loadHandler,
                                std::function<void()> clearHandler,
                                std::function<std::string()> statusProvider);
+
+    void registerRecordCommands(CommandRegistry &registry,
+                                std::function<bool(std::string_view)> startHandler,
+                                std::function<bool()> stopHandler,
+                                std::function<std::string()> statusProvider);
+
+    void registerCaptureCommands(CommandRegistry &registry,
+                                 std::function<bool(std::string_view)> startHandler,
+                                 std::function<void()> stopHandler,
+                                 std::function<std::string()> statusProvider,
+                                 std::function<std::string(std::string_view, std::string_view)> replayHandler);
 }
 
 
@@ -43,14 +63,17 @@ GraphicsFlow::GraphicsFlow(GraphicsContext &gfx,
                            NoteConverter &noteConverter,
                            AnimatedUI &ui,
                            const std::vector<RtAudio::Api> &apis,
-                           bool enableDevTools)
+                           bool enableDevTools,
+                           StartupOptions startup)
     : gfx_(gfx),
       audio_(audio),
       configStore_(configStore),
       noteConverter_(noteConverter),
       ui_(ui),
       apis_(apis),
-      devConsole_(enableDevTools)
+      startup_(startup),
+      devConsole_(enableDevTools),
+      testSceneModel_(configStore.modelCachePath())
 {
     if (enableDevTools)
     {
@@ -80,6 +103,45 @@ void GraphicsFlow::configureImGuiStyle()
     colors[ImGuiCol_FrameBgActive] = ImVec4(0.18f, 0.26f, 0.35f, 1.0f);
 }
 
+void GraphicsFlow::ensureTrackServices()
+{
+    if (trackCatalog_ && scoreService_)
+    {
+        return;
+    }
+
+    // The song library next to the executable, scanned in the background; the built-in
+    // samples stand in when there is none.
+    std::error_code ec;
+    if (std::filesystem::is_directory(configStore_.songLibraryPath(), ec))
+    {
+        TrackLibraryOptions library;
+        library.roots = {configStore_.songLibraryPath()};
+        library.cachePath = configStore_.libraryCachePath();
+        trackCatalog_ = std::make_unique<TrackCatalogFile>(std::move(library));
+    }
+    else
+    {
+        trackCatalog_ = std::make_unique<TrackCatalogMemory>();
+    }
+
+    // Local runs come from the on-disk store. The other tabs come from the leaderboard
+    // server when one is configured and fall back to the sample boards otherwise.
+    std::unique_ptr<TrackScoreService> remote;
+    if (const char *url = std::getenv("OPENCHORDIX_LEADERBOARD_URL"); url && *url)
+    {
+        LeaderboardOptions options;
+        options.baseUrl = url;
+        options.queuePath = configStore_.scoreLogPath().parent_path() / "score-queue.tsv";
+        remote = std::make_unique<TrackScoreServiceOnline>(std::move(options));
+    }
+    else
+    {
+        remote = std::make_unique<TrackScoreServiceMemory>();
+    }
+    scoreService_ = std::make_unique<TrackScoreServiceFile>(configStore_.scoreLogPath(), std::move(remote));
+}
+
 std::unique_ptr<Scene> GraphicsFlow::makeScene(SceneId id)
 {
     switch (id)
@@ -91,7 +153,8 @@ std::unique_ptr<Scene> GraphicsFlow::makeScene(SceneId id)
     case SceneId::MainMenu:
         return std::make_unique<MainMenuScene>(ui_);
     case SceneId::TrackSelect:
-        return std::make_unique<TrackSelectScene>(ui_);
+        ensureTrackServices();
+        return std::make_unique<TrackSelectScene>(ui_, *trackCatalog_, *scoreService_);
     case SceneId::Tuner:
         return std::make_unique<TunerScene>(audio_, ui_);
     case SceneId::Settings:
@@ -125,11 +188,17 @@ int GraphicsFlow::run(std::atomic<bool> &quitFlag)
     }
 
     audio_.setApi(initialApi);
-    audio_.refreshDevices(initialApi);
 
+    // Fast path: reopen the saved devices straight away and enumerate the rest on
+    // the device monitor thread. Falls back to the full probe when they are gone.
     bool useSetupScene = true;
-    if (savedConfig)
+    if (savedConfig && startup_.fastAudioRestore && audio_.restoreMonitoring(*savedConfig))
+    {
+        useSetupScene = false;
+    }
+    else if (savedConfig)
     {
+        audio_.refreshDevices(initialApi);
         bool configApplied = audio_.applyConfig(*savedConfig);
         if (configApplied && savedConfig->isUsable())
         {
@@ -148,6 +217,10 @@ int GraphicsFlow::run(std::atomic<bool> &quitFlag)
             audio_.setStatus("Saved audio config does not match available devices.");
         }
     }
+    else
+    {
+        audio_.refreshDevices(initialApi);
+    }
 
     imguiCreate(20.0f);
     configureImGuiStyle();
@@ -192,10 +265,45 @@ int GraphicsFlow::run(std::atomic<bool> &quitFlag)
             return testSceneModel_.status();
         });
 
+    openchordix::devtools::registerRecordCommands(
+        devConsole_.registry(),
+        [&](std::string_view path)
+        {
+            return audio_.startRecording(std::filesystem::path(path));
+        },
+        [&]()
+        {
+            return audio_.stopRecording();
+        },
+        [&]()
+        {
+            return audio_.recorder().status();
+        });
+
+    openchordix::devtools::registerCaptureCommands(
+        devConsole_.registry(),
+        [&](std::string_view path)
+        {
+            return audio_.startCapture(std::filesystem::path(path), noteConverter_.referenceA4());
+        },
+        [&]()
+        {
+            audio_.stopCapture();
+        },
+        [&]()
+        {
+            return audio_.capture().status();
+        },
+        [](std::string_view capturePath, std::string_view goldenPath)
+        {
+            return replayCaptureFile(std::filesystem::path(capturePath), std::filesystem::path(goldenPath)).message;
+        });
+
     SceneId afterIntro = useSetupScene ? SceneId::AudioSetup : SceneId::MainMenu;
     SceneId afterAudio = SceneId::MainMenu;
 
     auto lastClock = std::chrono::steady_clock::now();
+    bool startupReported = false;
 
     while (!quitFlag.load() && !gfx_.shouldClose())
     {
@@ -209,7 +317,20 @@ int GraphicsFlow::run(std::atomic<bool> &quitFlag)
         lastClock = now;
         dt = std::clamp(dt, 0.0f, 0.1f);
 
+        audio_.pollDevices();
         audio_.updatePitch(noteConverter_);
+        // --startup-benchmark: report launch to first audio callback, then quit.
+        if (startup_.benchmark && !startupReported)
+        {
+            if (auto firstCallback = audio_.firstCallbackTime())
+            {
+                startupReported = true;
+                double ms = std::chrono::duration<double, std::milli>(*firstCallback - startup_.launchTime).count();
+                std::cout << "Startup: first audio callback " << ms << " ms after launch ("
+                          << (startup_.fastAudioRestore ? "fast restore" : "full probe") << ")" << std::endl;
+                quitFlag.store(true);
+            }
+        }
         ui_.beginFrame(dt);
         FrameInput input = gfx_.pollFrame();
         imguiBridge.updateKeyboard(input);
@@ -226,6 +347,7 @@ int GraphicsFlow::run(std::atomic<bool> &quitFlag)
             -1,
             openchordix::render::kViewIdUi);
 
+        testSceneModel_.update(gfx_.modelRenderer());
         currentScene->render(dt, input, gfx_, quitFlag);
 
         devConsole_.render();
@@ -13,7 +13,10 @@
 #include "NoteConverter.h"
 #include "scenes/TestSceneModelController.h"
 #include "Scene.h"
+#include "score/ScoreService.h"
+#include "StartupOptions.h"
 #include "devtools/DevConsole.h"
+#include "track/TrackCatalog.h"
 
 class GraphicsFlow
 {
@@ -24,7 +27,8 @@ public:
                  NoteConverter &noteConverter,
                  AnimatedUI &ui,
                  const std::vector<RtAudio::Api> &apis,
-                 bool enableDevTools);
+                 bool enableDevTools,
+                 StartupOptions startup = {});
 
     int run(std::atomic<bool> &quitFlag);
 
@@ -42,6 +46,8 @@ public:
 private:
     void configureImGuiStyle();
     std::unique_ptr<Scene> makeScene(SceneId id);
+    // Creates the song library and score store the first time track select opens.
+    void ensureTrackServices();
 
     GraphicsContext &gfx_;
     AudioSession &audio_;
@@ -49,6 +55,11 @@ private:
     NoteConverter &noteConverter_;
     AnimatedUI &ui_;
     std::vector<RtAudio::Api> apis_;
+    StartupOptions startup_;
     openchordix::devtools::DevConsole devConsole_;
-    TestSceneModelController testSceneModel_{};
+    TestSceneModelController testSceneModel_;
+    // Shared by every visit to track select; the library scan and the score log
+    // replay happen once per run.
+    std::unique_ptr<TrackCatalog> trackCatalog_;
+    std::unique_ptr<TrackScoreService> scoreService_;
 };
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <chrono>
+
+struct StartupOptions
+{
+    std::chrono::steady_clock::time_point launchTime = std::chrono::steady_clock::now();
+    bool fastAudioRestore = true; // Open the saved devices before enumerating
+    bool benchmark = false;       // Quit once the first audio callback has been timed
+};
@@ -65,21 +65,51 @@ namespace openchordix::assets
         std::vector<MeshPrimitive> primitives;
     };
 
+    struct NodeData
+    {
+        std::string name;
+        int32_t parent = -1; // Index into GltfAsset::nodes, always earlier; -1 for a root
+        std::array<float, 3> translation{0.0f, 0.0f, 0.0f};
+        std::array<float, 4> rotation{0.0f, 0.0f, 0.0f, 1.0f}; // Quaternion, xyzw
+        std::array<float, 3> scale{1.0f, 1.0f, 1.0f};
+        std::optional<std::size_t> meshIndex;
+    };
+
     struct GltfAsset
     {
         std::vector<ImageData> images;
         std::vector<MaterialData> materials;
         std::vector<MeshData> meshes;
+        // The default scene's nodes, depth first so each subtree is a contiguous
+        // run. Empty when the file has no nodes.
+        std::vector<NodeData> nodes;
+    };
+
+    struct GltfLoadOptions
+    {
+        unsigned jobs = 0; // Image decode threads including the caller; 0 = one per hardware thread
+    };
+
+    struct GltfLoadStats
+    {
+        unsigned jobs = 0;
+        double parseMillis = 0.0;
+        double meshMillis = 0.0;   // Materials and mesh attributes, overlapped with decoding
+        double decodeMillis = 0.0; // Until the last image finished, from the end of parsing
+        double totalMillis = 0.0;
     };
 
     struct GltfLoadResult
     {
         std::optional<GltfAsset> asset;
         std::string error;
+        GltfLoadStats stats;
 
         bool ok() const { return asset.has_value(); }
     };
 
-    GltfLoadResult loadGltfAsset(const std::filesystem::path &path);
+    // Images are decoded on a worker pool while the calling thread extracts meshes;
+    // GltfAsset::images keeps the glTF image order.
+    GltfLoadResult loadGltfAsset(const std::filesystem::path &path, const GltfLoadOptions &options = {});
 
 }
@@ -5,10 +5,19 @@
 #include <fastgltf/types.hpp>
 #include <fastgltf/util.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
+#include <exception>
+#include <optional>
 #include <span>
 #include <cmath>
+#include <thread>
+#include <utility>
+#include <variant>
 #include <vector>
 
 #define STB_IMAGE_IMPLEMENTATION
@@ -30,12 +39,20 @@ namespace openchordix::assets
             fastgltf::Extensions::KHR_texture_transform |
             fastgltf::Extensions::KHR_materials_emissive_strength;
 
+        using Clock = std::chrono::steady_clock;
+
+        double millisSince(Clock::time_point start)
+        {
+            return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        }
+
         constexpr auto kLoadOptions =
             fastgltf::Options::DontRequireValidAssetMember |
             fastgltf::Options::AllowDouble |
             fastgltf::Options::LoadExternalBuffers |
             fastgltf::Options::LoadExternalImages |
-            fastgltf::Options::GenerateMeshIndices;
+            fastgltf::Options::GenerateMeshIndices |
+            fastgltf::Options::DecomposeNodeMatrices;
 
         std::optional<ImageData> decodeImageBytes(std::span<const std::byte> bytes)
         {
@@ -533,46 +550,195 @@ namespace openchordix::assets
                 out.meshes.emplace_back(std::move(meshData));
             }
         }
+
+        // Flattens the default scene (or every root, without scenes) depth first.
+        // A node reached twice keeps its first parent, which also stops cycles.
+        void loadNodes(const fastgltf::Asset &asset, GltfAsset &out)
+        {
+            std::vector<std::size_t> roots;
+            if (!asset.scenes.empty())
+            {
+                std::size_t scene = asset.defaultScene.has_value() ? *asset.defaultScene : 0;
+                scene = scene < asset.scenes.size() ? scene : 0;
+                roots.assign(asset.scenes[scene].nodeIndices.begin(), asset.scenes[scene].nodeIndices.end());
+            }
+            else
+            {
+                std::vector<bool> isChild(asset.nodes.size(), false);
+                for (const auto &node : asset.nodes)
+                {
+                    for (std::size_t child : node.children)
+                    {
+                        if (child < isChild.size())
+                        {
+                            isChild[child] = true;
+                        }
+                    }
+                }
+                for (std::size_t i = 0; i < asset.nodes.size(); ++i)
+                {
+                    if (!isChild[i])
+                    {
+                        roots.push_back(i);
+                    }
+                }
+            }
+
+            std::vector<bool> visited(asset.nodes.size(), false);
+            std::vector<std::pair<std::size_t, int32_t>> stack; // Source node, parent in out.nodes
+            for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+            {
+                stack.emplace_back(*it, -1);
+            }
+            while (!stack.empty())
+            {
+                const auto [index, parent] = stack.back();
+                stack.pop_back();
+                if (index >= asset.nodes.size() || visited[index])
+                {
+                    continue;
+                }
+                visited[index] = true;
+
+                const auto &node = asset.nodes[index];
+                NodeData data{};
+                data.name = node.name;
+                data.parent = parent;
+                if (node.meshIndex.has_value())
+                {
+                    data.meshIndex = *node.meshIndex;
+                }
+                if (const auto *trs = std::get_if<fastgltf::TRS>(&node.transform))
+                {
+                    data.translation = {trs->translation.x(), trs->translation.y(), trs->translation.z()};
+                    data.rotation = {trs->rotation.x(), trs->rotation.y(), trs->rotation.z(), trs->rotation.w()};
+                    data.scale = {trs->scale.x(), trs->scale.y(), trs->scale.z()};
+                }
+
+                const auto self = static_cast<int32_t>(out.nodes.size());
+                out.nodes.emplace_back(std::move(data));
+                // Reversed, so the first child is popped next and its subtree finishes
+                // before the second child starts.
+                for (std::size_t child = node.children.size(); child-- > 0;)
+                {
+                    stack.emplace_back(node.children[child], self);
+                }
+            }
+        }
     }
 
-    GltfLoadResult loadGltfAsset(const std::filesystem::path &path)
+    GltfLoadResult loadGltfAsset(const std::filesystem::path &path, const GltfLoadOptions &options)
     {
+        const auto start = Clock::now();
         if (!std::filesystem::exists(path))
         {
-            return {std::nullopt, "File not found."};
+            return {std::nullopt, "File not found.", {}};
         }
 
         fastgltf::Parser parser(kSupportedExtensions);
         auto gltfFile = fastgltf::MappedGltfFile::FromPath(path);
         if (!gltfFile)
         {
-            return {std::nullopt, enrichFastgltfError(std::string(fastgltf::getErrorMessage(gltfFile.error())))};
+            return {std::nullopt, enrichFastgltfError(std::string(fastgltf::getErrorMessage(gltfFile.error()))), {}};
         }
 
         auto assetResult = parser.loadGltf(gltfFile.get(), path.parent_path(), kLoadOptions);
         if (assetResult.error() != fastgltf::Error::None)
         {
-            return {std::nullopt, enrichFastgltfError(std::string(fastgltf::getErrorMessage(assetResult.error())))};
+            return {std::nullopt, enrichFastgltfError(std::string(fastgltf::getErrorMessage(assetResult.error()))), {}};
         }
 
         GltfAsset asset{};
+        GltfLoadStats stats{};
         const auto &parsedAsset = assetResult.get();
+        stats.parseMillis = millisSince(start);
+
+        // Images are independent, so workers just pull the next index. stb_image
+        // keeps its error state thread-local, and each slot is written by one thread.
+        const std::size_t imageCount = parsedAsset.images.size();
+        std::vector<std::optional<ImageData>> decoded(imageCount);
+        std::atomic<std::size_t> next{0};
+        const auto decodeStart = Clock::now();
+        std::atomic<int64_t> decodeEnd{0};
+        auto decode = [&]()
+        {
+            for (std::size_t i = next.fetch_add(1); i < imageCount; i = next.fetch_add(1))
+            {
+                try
+                {
+                    decoded[i] = loadImageData(parsedAsset, parsedAsset.images[i], path.parent_path());
+                }
+                catch (const std::exception &)
+                {
+                    decoded[i].reset();
+                }
+            }
+            const int64_t finished = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - decodeStart).count();
+            int64_t latest = decodeEnd.load();
+            while (finished > latest && !decodeEnd.compare_exchange_weak(latest, finished))
+            {
+            }
+        };
 
-        asset.images.reserve(parsedAsset.images.size());
-        for (const auto &image : parsedAsset.images)
+        // Joins the workers on every way out. If mesh extraction throws, the
+        // remaining images are skipped and the workers only finish the one they
+        // hold; a joinable std::thread going out of scope would call std::terminate.
+        struct DecodeWorkers
         {
-            auto decoded = loadImageData(parsedAsset, image, path.parent_path());
-            if (!decoded)
+            std::atomic<std::size_t> &next;
+            std::size_t imageCount;
+            std::vector<std::thread> threads;
+
+            ~DecodeWorkers()
+            {
+                next.store(imageCount);
+                join();
+            }
+
+            void join()
             {
-                return {std::nullopt, "Failed to decode image."};
+                for (std::thread &thread : threads)
+                {
+                    if (thread.joinable())
+                    {
+                        thread.join();
+                    }
+                }
             }
-            asset.images.emplace_back(std::move(*decoded));
+        };
+
+        unsigned workers = options.jobs > 0 ? options.jobs : std::max(1u, std::thread::hardware_concurrency());
+        workers = static_cast<unsigned>(std::min<std::size_t>(workers, std::max<std::size_t>(imageCount, 1)));
+        stats.jobs = workers;
+        DecodeWorkers pool{next, imageCount, {}};
+        for (unsigned i = 1; i < workers; ++i)
+        {
+            pool.threads.emplace_back(decode);
         }
 
+        // Mesh extraction only reads accessors, so it overlaps the decode; the
+        // calling thread then helps with whatever images are left.
+        const auto meshStart = Clock::now();
         loadMaterials(parsedAsset, asset);
         loadMeshes(parsedAsset, asset);
+        loadNodes(parsedAsset, asset);
+        stats.meshMillis = millisSince(meshStart);
+        decode();
+        pool.join();
+        stats.decodeMillis = static_cast<double>(decodeEnd.load()) / 1000.0;
+
+        asset.images.reserve(imageCount);
+        for (std::size_t i = 0; i < imageCount; ++i)
+        {
+            if (!decoded[i])
+            {
+                return {std::nullopt, "Failed to decode image " + std::to_string(i) + ".", stats};
+            }
+            asset.images.emplace_back(std::move(*decoded[i]));
+        }
 
-        return {std::move(asset), {}};
+        stats.totalMillis = millisSince(start);
+        return {std::move(asset), {}, stats};
     }
 
 }
@@ -0,0 +1,232 @@
+#include "render/FrustumCull.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "render/Matrix4.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define OPENCHORDIX_CULL_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENCHORDIX_CULL_SSE 1
+#endif
+
+namespace openchordix::render
+{
+    namespace
+    {
+        // Row `row` of a bx matrix, i.e. the coefficients of clip component `row`.
+        std::array<float, 4> matrixRow(const float *m, int row)
+        {
+            return {m[row], m[4 + row], m[8 + row], m[12 + row]};
+        }
+
+        std::array<float, 4> add(const std::array<float, 4> &a, const std::array<float, 4> &b, float sign)
+        {
+            return {a[0] + sign * b[0], a[1] + sign * b[1], a[2] + sign * b[2], a[3] + sign * b[3]};
+        }
+
+        // A world-space plane as seen from the model's space: p applied to M x.
+        std::array<float, 4> planeToModel(const std::array<float, 4> &p, const float *m)
+        {
+            std::array<float, 4> out{};
+            for (int column = 0; column < 4; ++column)
+            {
+                const float *c = m + column * 4;
+                out[column] = p[0] * c[0] + p[1] * c[1] + p[2] * c[2] + p[3] * c[3];
+            }
+            return out;
+        }
+
+#if defined(OPENCHORDIX_CULL_AVX)
+        uint32_t cullBatches(const std::array<std::array<float, 4>, 6> &planes, const CullBoxes &boxes,
+                             std::span<uint8_t> visible)
+        {
+            uint32_t count = 0;
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            for (std::size_t base = 0; base < boxes.count; base += 8)
+            {
+                const __m256 cx = _mm256_loadu_ps(boxes.centerX.data() + base);
+                const __m256 cy = _mm256_loadu_ps(boxes.centerY.data() + base);
+                const __m256 cz = _mm256_loadu_ps(boxes.centerZ.data() + base);
+                const __m256 ex = _mm256_loadu_ps(boxes.extentX.data() + base);
+                const __m256 ey = _mm256_loadu_ps(boxes.extentY.data() + base);
+                const __m256 ez = _mm256_loadu_ps(boxes.extentZ.data() + base);
+
+                __m256 outside = _mm256_setzero_ps();
+                for (const auto &plane : planes)
+                {
+                    const __m256 a = _mm256_set1_ps(plane[0]);
+                    const __m256 b = _mm256_set1_ps(plane[1]);
+                    const __m256 c = _mm256_set1_ps(plane[2]);
+                    const __m256 distance = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(a, cx), _mm256_mul_ps(b, cy)),
+                        _mm256_add_ps(_mm256_mul_ps(c, cz), _mm256_set1_ps(plane[3])));
+                    const __m256 radius = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_andnot_ps(signMask, a), ex),
+                                      _mm256_mul_ps(_mm256_andnot_ps(signMask, b), ey)),
+                        _mm256_mul_ps(_mm256_andnot_ps(signMask, c), ez));
+                    outside = _mm256_or_ps(outside,
+                                           _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_LT_OQ));
+                }
+
+                const int mask = ~_mm256_movemask_ps(outside);
+                const std::size_t lanes = std::min<std::size_t>(8, boxes.count - base);
+                for (std::size_t lane = 0; lane < lanes; ++lane)
+                {
+                    visible[base + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+                    count += visible[base + lane];
+                }
+            }
+            return count;
+        }
+#elif defined(OPENCHORDIX_CULL_SSE)
+        uint32_t cullBatches(const std::array<std::array<float, 4>, 6> &planes, const CullBoxes &boxes,
+                             std::span<uint8_t> visible)
+        {
+            uint32_t count = 0;
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            for (std::size_t base = 0; base < boxes.count; base += 4)
+            {
+                const __m128 cx = _mm_loadu_ps(boxes.centerX.data() + base);
+                const __m128 cy = _mm_loadu_ps(boxes.centerY.data() + base);
+                const __m128 cz = _mm_loadu_ps(boxes.centerZ.data() + base);
+                const __m128 ex = _mm_loadu_ps(boxes.extentX.data() + base);
+                const __m128 ey = _mm_loadu_ps(boxes.extentY.data() + base);
+                const __m128 ez = _mm_loadu_ps(boxes.extentZ.data() + base);
+
+                __m128 outside = _mm_setzero_ps();
+                for (const auto &plane : planes)
+                {
+                    const __m128 a = _mm_set1_ps(plane[0]);
+                    const __m128 b = _mm_set1_ps(plane[1]);
+                    const __m128 c = _mm_set1_ps(plane[2]);
+                    const __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(a, cx), _mm_mul_ps(b, cy)),
+                                                       _mm_add_ps(_mm_mul_ps(c, cz), _mm_set1_ps(plane[3])));
+                    const __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_andnot_ps(signMask, a), ex),
+                                                                _mm_mul_ps(_mm_andnot_ps(signMask, b), ey)),
+                                                     _mm_mul_ps(_mm_andnot_ps(signMask, c), ez));
+                    outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+                }
+
+                const int mask = ~_mm_movemask_ps(outside);
+                const std::size_t lanes = std::min<std::size_t>(4, boxes.count - base);
+                for (std::size_t lane = 0; lane < lanes; ++lane)
+                {
+                    visible[base + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+                    count += visible[base + lane];
+                }
+            }
+            return count;
+        }
+#else
+        uint32_t cullBatches(const std::array<std::array<float, 4>, 6> &planes, const CullBoxes &boxes,
+                             std::span<uint8_t> visible)
+        {
+            uint32_t count = 0;
+            for (std::size_t i = 0; i < boxes.count; ++i)
+            {
+                bool inside = true;
+                for (const auto &plane : planes)
+                {
+                    const float distance = plane[0] * boxes.centerX[i] + plane[1] * boxes.centerY[i] +
+                                           plane[2] * boxes.centerZ[i] + plane[3];
+                    const float radius = std::fabs(plane[0]) * boxes.extentX[i] + std::fabs(plane[1]) * boxes.extentY[i] +
+                                         std::fabs(plane[2]) * boxes.extentZ[i];
+                    inside = inside && distance + radius >= 0.0f;
+                }
+                visible[i] = inside ? 1 : 0;
+                count += visible[i];
+            }
+            return count;
+        }
+#endif
+    }
+
+    Frustum extractFrustum(const float *view, const float *proj, bool homogeneousDepth)
+    {
+        float viewProj[16];
+        multiplyMatrices(viewProj, view, proj);
+
+        const auto x = matrixRow(viewProj, 0);
+        const auto y = matrixRow(viewProj, 1);
+        const auto z = matrixRow(viewProj, 2);
+        const auto w = matrixRow(viewProj, 3);
+
+        Frustum frustum;
+        frustum.planes[0] = add(w, x, 1.0f);
+        frustum.planes[1] = add(w, x, -1.0f);
+        frustum.planes[2] = add(w, y, 1.0f);
+        frustum.planes[3] = add(w, y, -1.0f);
+        frustum.planes[4] = homogeneousDepth ? add(w, z, 1.0f) : z;
+        frustum.planes[5] = add(w, z, -1.0f);
+        return frustum;
+    }
+
+    void CullBoxes::resize(std::size_t boxes)
+    {
+        count = boxes;
+        // Padding lanes are zero-sized boxes at the origin; their results are never read.
+        const std::size_t padded = (count + kCullBatch - 1) / kCullBatch * kCullBatch;
+        for (auto *component : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ})
+        {
+            component->resize(padded, 0.0f);
+        }
+    }
+
+    void CullBoxes::set(std::size_t index, const std::array<float, 3> &min, const std::array<float, 3> &max)
+    {
+        centerX[index] = (min[0] + max[0]) * 0.5f;
+        centerY[index] = (min[1] + max[1]) * 0.5f;
+        centerZ[index] = (min[2] + max[2]) * 0.5f;
+        extentX[index] = std::max(max[0] - min[0], 0.0f) * 0.5f;
+        extentY[index] = std::max(max[1] - min[1], 0.0f) * 0.5f;
+        extentZ[index] = std::max(max[2] - min[2], 0.0f) * 0.5f;
+    }
+
+    void CullBoxes::clear()
+    {
+        for (auto *component : {&centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ})
+        {
+            component->clear();
+        }
+        count = 0;
+    }
+
+    bool CullBoxes::bounds(std::array<float, 3> &min, std::array<float, 3> &max) const
+    {
+        if (count == 0)
+        {
+            return false;
+        }
+        min = {INFINITY, INFINITY, INFINITY};
+        max = {-INFINITY, -INFINITY, -INFINITY};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            min[0] = std::min(min[0], centerX[i] - extentX[i]);
+            min[1] = std::min(min[1], centerY[i] - extentY[i]);
+            min[2] = std::min(min[2], centerZ[i] - extentZ[i]);
+            max[0] = std::max(max[0], centerX[i] + extentX[i]);
+            max[1] = std::max(max[1], centerY[i] + extentY[i]);
+            max[2] = std::max(max[2], centerZ[i] + extentZ[i]);
+        }
+        return true;
+    }
+
+    uint32_t cullBoxes(const Frustum &frustum, const float *modelMtx, const CullBoxes &boxes, std::span<uint8_t> visible)
+    {
+        if (boxes.count == 0 || visible.size() < boxes.count)
+        {
+            return 0;
+        }
+
+        std::array<std::array<float, 4>, 6> planes;
+        for (std::size_t i = 0; i < planes.size(); ++i)
+        {
+            planes[i] = planeToModel(frustum.planes[i], modelMtx);
+        }
+        return cullBatches(planes, boxes, visible);
+    }
+}
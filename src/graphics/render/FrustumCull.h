@@ -0,0 +1,52 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// View-frustum tests for batches of axis-aligned boxes, four or eight at a time
+// depending on the SIMD width the build targets.
+namespace openchordix::render
+{
+    // Lanes per batch; box arrays are padded to a multiple of this.
+    inline constexpr std::size_t kCullBatch = 8;
+
+    // Planes (a, b, c, d) with ax + by + cz + d >= 0 on the inside, in the order
+    // left, right, bottom, top, near, far. Not normalized; only signs are used.
+    struct Frustum
+    {
+        std::array<std::array<float, 4>, 6> planes{};
+    };
+
+    // World-space frustum of a camera; matrices are column-major, bx style.
+    // `homogeneousDepth` is bgfx's caps flag: clip z runs -w..w when set and
+    // 0..w otherwise.
+    Frustum extractFrustum(const float *view, const float *proj, bool homogeneousDepth);
+
+    // Boxes as centre and half extent, one array per component.
+    struct CullBoxes
+    {
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> extentX;
+        std::vector<float> extentY;
+        std::vector<float> extentZ;
+        std::size_t count = 0; // Real boxes; the rest up to a kCullBatch multiple are padding
+
+        // Makes room for `boxes` boxes; new ones, and the padding, are empty.
+        void resize(std::size_t boxes);
+        void set(std::size_t index, const std::array<float, 3> &min, const std::array<float, 3> &max);
+        void clear();
+        // Smallest box holding every real box; false when there are none.
+        bool bounds(std::array<float, 3> &min, std::array<float, 3> &max) const;
+    };
+
+    // Sets visible[i] to 1 for every box that may be inside the frustum once
+    // transformed by `modelMtx`, 0 otherwise, and returns how many are visible.
+    // `visible` must hold boxes.count entries. The planes are taken into the
+    // model's space once, so the boxes are tested as stored.
+    uint32_t cullBoxes(const Frustum &frustum, const float *modelMtx, const CullBoxes &boxes, std::span<uint8_t> visible);
+}
@@ -0,0 +1,175 @@
+#include "render/HighwayRenderer.h"
+
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+#include "render/ShaderLoader.h"
+
+namespace openchordix::render
+{
+    namespace
+    {
+        constexpr uint16_t kInstanceStride = sizeof(HighwayInstance);
+
+        // Unit cube centred on the origin, in ModelRenderer's vertex layout.
+        Model buildBox(const bgfx::VertexLayout &layout)
+        {
+            struct Face
+            {
+                std::array<float, 3> normal;
+                std::array<float, 3> u;
+                std::array<float, 3> v;
+            };
+            constexpr std::array<Face, 6> faces{{{{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},
+                                                 {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},
+                                                 {{0, 1, 0}, {1, 0, 0}, {0, 0, -1}},
+                                                 {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}},
+                                                 {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},
+                                                 {{0, 0, -1}, {-1, 0, 0}, {0, 1, 0}}}};
+
+            std::vector<float> vertices;
+            std::vector<uint16_t> indices;
+            vertices.reserve(24 * 12);
+            indices.reserve(36);
+            for (const Face &face : faces)
+            {
+                const uint16_t base = static_cast<uint16_t>(vertices.size() / 12);
+                for (int corner = 0; corner < 4; ++corner)
+                {
+                    const float su = (corner == 1 || corner == 2) ? 0.5f : -0.5f;
+                    const float sv = corner >= 2 ? 0.5f : -0.5f;
+                    for (int axis = 0; axis < 3; ++axis)
+                    {
+                        vertices.push_back(face.normal[axis] * 0.5f + face.u[axis] * su + face.v[axis] * sv);
+                    }
+                    vertices.insert(vertices.end(), face.normal.begin(), face.normal.end());
+                    vertices.insert(vertices.end(), face.u.begin(), face.u.end());
+                    vertices.push_back(1.0f);
+                    vertices.push_back(su + 0.5f);
+                    vertices.push_back(0.5f - sv);
+                }
+                for (uint16_t index : {0, 1, 2, 0, 2, 3})
+                {
+                    indices.push_back(static_cast<uint16_t>(base + index));
+                }
+            }
+
+            Model model;
+            ModelMesh mesh;
+            mesh.vertexBuffer.reset(bgfx::createVertexBuffer(
+                bgfx::copy(vertices.data(), static_cast<uint32_t>(vertices.size() * sizeof(float))), layout));
+            mesh.indexBuffer.reset(bgfx::createIndexBuffer(
+                bgfx::copy(indices.data(), static_cast<uint32_t>(indices.size() * sizeof(uint16_t)))));
+            mesh.indexCount = static_cast<uint32_t>(indices.size());
+            mesh.boundsMin = {-0.5f, -0.5f, -0.5f};
+            mesh.boundsMax = {0.5f, 0.5f, 0.5f};
+            model.meshes.push_back(std::move(mesh));
+            model.materials.emplace_back();
+            model.setSingleNode();
+            return model;
+        }
+    }
+
+    bool HighwayRenderer::initialize(const ModelRenderer &models)
+    {
+        if (initialized_)
+        {
+            return true;
+        }
+        if (!(bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING))
+        {
+            std::cerr << "HighwayRenderer: Instancing is not supported by this renderer." << std::endl;
+            return false;
+        }
+
+        BgfxHandle<bgfx::ProgramHandle> program(loadEmbeddedProgram("vs_highway.bin", "fs_highway.bin"));
+        if (!program.isValid())
+        {
+            std::cerr << "HighwayRenderer: Failed to load highway shader program." << std::endl;
+            return false;
+        }
+
+        BgfxHandle<bgfx::UniformHandle> lightDir(bgfx::createUniform("u_lightDir", bgfx::UniformType::Vec4));
+        BgfxHandle<bgfx::UniformHandle> params(bgfx::createUniform("u_highwayParams", bgfx::UniformType::Vec4));
+        Model box = buildBox(models.vertexLayout());
+        if (!lightDir.isValid() || !params.isValid() || !box.meshes.front().vertexBuffer.isValid())
+        {
+            return false;
+        }
+
+        program_ = std::move(program);
+        lightDir_ = std::move(lightDir);
+        params_ = std::move(params);
+        box_ = std::move(box);
+        initialized_ = true;
+        return true;
+    }
+
+    void HighwayRenderer::shutdown()
+    {
+        box_.clear();
+        params_.reset();
+        lightDir_.reset();
+        program_.reset();
+        layout_.setChart(nullptr, -1);
+        initialized_ = false;
+    }
+
+    HighwayStats HighwayRenderer::render(uint16_t viewId,
+                                         double chartSeconds,
+                                         const ModelFrame &frame,
+                                         const HighwaySettings &settings,
+                                         std::span<const uint8_t> noteStates)
+    {
+        HighwayStats stats;
+        if (!initialized_)
+        {
+            return stats;
+        }
+        buildInstances(chartSeconds, settings, noteStates);
+
+        bgfx::setViewTransform(viewId, frame.view.data(), frame.proj.data());
+        const float lightDir[4] = {frame.lightDir[0], frame.lightDir[1], frame.lightDir[2], 0.0f};
+        const float params[4] = {settings.hitGlow, settings.missDim, 0.0f, 0.0f};
+        const uint64_t state = BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_WRITE_Z |
+                               BGFX_STATE_DEPTH_TEST_LESS | BGFX_STATE_CULL_CW | BGFX_STATE_MSAA;
+
+        for (std::size_t type = 0; type < stats.instances.size(); ++type)
+        {
+            const std::vector<HighwayInstance> &list = layout_.instances(static_cast<HighwayDrawType>(type));
+            stats.instances[type] = static_cast<uint32_t>(list.size());
+            if (list.empty())
+            {
+                continue;
+            }
+
+            const uint32_t count = bgfx::getAvailInstanceDataBuffer(static_cast<uint32_t>(list.size()), kInstanceStride);
+            stats.dropped += static_cast<uint32_t>(list.size()) - count;
+            if (count == 0)
+            {
+                continue;
+            }
+            bgfx::InstanceDataBuffer buffer;
+            bgfx::allocInstanceDataBuffer(&buffer, count, kInstanceStride);
+            std::memcpy(buffer.data, list.data(), static_cast<std::size_t>(count) * kInstanceStride);
+
+            for (const ModelMesh &mesh : box_.meshes)
+            {
+                if (!mesh.vertexBuffer.isValid() || !mesh.indexBuffer.isValid() || mesh.indexCount == 0)
+                {
+                    continue;
+                }
+                bgfx::setVertexBuffer(0, mesh.vertexBuffer.get());
+                bgfx::setIndexBuffer(mesh.indexBuffer.get(), 0, mesh.indexCount);
+                bgfx::setInstanceDataBuffer(&buffer);
+                bgfx::setUniform(lightDir_.get(), lightDir);
+                bgfx::setUniform(params_.get(), params);
+                bgfx::setState(state);
+                bgfx::submit(viewId, program_.get());
+                ++stats.drawCalls;
+            }
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+#include "gameplay/HighwayLayout.h"
+#include "render/BgfxHandle.h"
+#include "render/Model.h"
+#include "render/ModelRenderer.h"
+#include "track/ChartFile.h"
+
+namespace openchordix::render
+{
+    struct HighwayStats
+    {
+        std::array<uint32_t, static_cast<std::size_t>(HighwayDrawType::Count)> instances{};
+        uint32_t drawCalls = 0;
+        uint32_t dropped = 0; // Instances that did not fit the frame's instance data buffer
+    };
+
+    // Draws the note highway of one chart part. HighwayLayout packs the visible
+    // notes into one instance list per draw type, and each type is submitted as
+    // one instanced draw of a unit box, so a frame costs a handful of draw calls no
+    // matter how dense the chart is.
+    class HighwayRenderer
+    {
+    public:
+        bool initialize(const ModelRenderer &models);
+        void shutdown();
+        bool isInitialized() const { return initialized_; }
+
+        void setChart(std::shared_ptr<const ChartFile> chart, int partIndex) { layout_.setChart(std::move(chart), partIndex); }
+        bool hasChart() const { return layout_.hasChart(); }
+
+        // Fills the per-type instance lists for the window around chartSeconds.
+        void buildInstances(double chartSeconds, const HighwaySettings &settings,
+                            std::span<const uint8_t> noteStates = {})
+        {
+            layout_.build(chartSeconds, settings, noteStates);
+        }
+        HighwayStats render(uint16_t viewId,
+                            double chartSeconds,
+                            const ModelFrame &frame,
+                            const HighwaySettings &settings,
+                            std::span<const uint8_t> noteStates = {});
+
+        const std::vector<HighwayInstance> &instances(HighwayDrawType type) const
+        {
+            return layout_.instances(type);
+        }
+
+    private:
+        BgfxHandle<bgfx::ProgramHandle> program_{};
+        BgfxHandle<bgfx::UniformHandle> lightDir_{};
+        BgfxHandle<bgfx::UniformHandle> params_{};
+        Model box_{};
+        HighwayLayout layout_{};
+        bool initialized_ = false;
+    };
+}
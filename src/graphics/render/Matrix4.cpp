@@ -0,0 +1,80 @@
+#include "render/Matrix4.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENCHORDIX_MATRIX_SSE 1
+#endif
+
+namespace openchordix::render
+{
+    void multiplyMatrices(float *out, const float *a, const float *b)
+    {
+#if defined(OPENCHORDIX_MATRIX_SSE)
+        // Each output row is a's row weighting b's four rows.
+        const __m128 b0 = _mm_loadu_ps(b);
+        const __m128 b1 = _mm_loadu_ps(b + 4);
+        const __m128 b2 = _mm_loadu_ps(b + 8);
+        const __m128 b3 = _mm_loadu_ps(b + 12);
+        for (int row = 0; row < 4; ++row)
+        {
+            const float *r = a + row * 4;
+            const __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[0]), b0), _mm_mul_ps(_mm_set1_ps(r[1]), b1)),
+                                          _mm_add_ps(_mm_mul_ps(_mm_set1_ps(r[2]), b2), _mm_mul_ps(_mm_set1_ps(r[3]), b3)));
+            _mm_storeu_ps(out + row * 4, sum);
+        }
+#else
+        for (int row = 0; row < 4; ++row)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                out[row * 4 + column] = a[row * 4 + 0] * b[0 * 4 + column] + a[row * 4 + 1] * b[1 * 4 + column] +
+                                        a[row * 4 + 2] * b[2 * 4 + column] + a[row * 4 + 3] * b[3 * 4 + column];
+            }
+        }
+#endif
+    }
+
+    Matrix4 composeTransform(const std::array<float, 3> &translation,
+                             const std::array<float, 4> &rotation,
+                             const std::array<float, 3> &scale)
+    {
+        const float x = rotation[0];
+        const float y = rotation[1];
+        const float z = rotation[2];
+        const float w = rotation[3];
+
+        // Rows are the rotated, scaled basis vectors.
+        return {(1.0f - 2.0f * (y * y + z * z)) * scale[0], 2.0f * (x * y + w * z) * scale[0], 2.0f * (x * z - w * y) * scale[0], 0.0f,
+                2.0f * (x * y - w * z) * scale[1], (1.0f - 2.0f * (x * x + z * z)) * scale[1], 2.0f * (y * z + w * x) * scale[1], 0.0f,
+                2.0f * (x * z + w * y) * scale[2], 2.0f * (y * z - w * x) * scale[2], (1.0f - 2.0f * (x * x + y * y)) * scale[2], 0.0f,
+                translation[0], translation[1], translation[2], 1.0f};
+    }
+
+    void transformBounds(const float *m,
+                         const std::array<float, 3> &min,
+                         const std::array<float, 3> &max,
+                         std::array<float, 3> &outMin,
+                         std::array<float, 3> &outMax)
+    {
+        const float center[3] = {(min[0] + max[0]) * 0.5f, (min[1] + max[1]) * 0.5f, (min[2] + max[2]) * 0.5f};
+        const float extent[3] = {(max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f};
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float c = center[0] * m[axis] + center[1] * m[4 + axis] + center[2] * m[8 + axis] + m[12 + axis];
+            const float e = extent[0] * std::fabs(m[axis]) + extent[1] * std::fabs(m[4 + axis]) +
+                            extent[2] * std::fabs(m[8 + axis]);
+            outMin[axis] = c - e;
+            outMax[axis] = c + e;
+        }
+    }
+
+    float maxAxisScale(const float *m)
+    {
+        return std::sqrt(std::max({m[0] * m[0] + m[1] * m[1] + m[2] * m[2],
+                                   m[4] * m[4] + m[5] * m[5] + m[6] * m[6],
+                                   m[8] * m[8] + m[9] * m[9] + m[10] * m[10]}));
+    }
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <array>
+
+// 4x4 float matrices in bx's layout: column-major storage of row-vector maths,
+// so translation sits in elements 12..14 and a point p maps to p * M.
+namespace openchordix::render
+{
+    using Matrix4 = std::array<float, 16>;
+
+    inline constexpr Matrix4 kIdentityMatrix{1.0f, 0.0f, 0.0f, 0.0f,
+                                             0.0f, 1.0f, 0.0f, 0.0f,
+                                             0.0f, 0.0f, 1.0f, 0.0f,
+                                             0.0f, 0.0f, 0.0f, 1.0f};
+
+    // out = a then b, like bx::mtxMul; `out` may alias neither input.
+    void multiplyMatrices(float *out, const float *a, const float *b);
+
+    // Scale, then rotate by the xyzw quaternion, then translate: glTF's TRS order.
+    Matrix4 composeTransform(const std::array<float, 3> &translation,
+                             const std::array<float, 4> &rotation,
+                             const std::array<float, 3> &scale);
+
+    // Axis-aligned box around the box [min, max] once transformed by `m`.
+    void transformBounds(const float *m,
+                         const std::array<float, 3> &min,
+                         const std::array<float, 3> &max,
+                         std::array<float, 3> &outMin,
+                         std::array<float, 3> &outMax);
+
+    // Largest scale the upper 3x3 applies to any axis.
+    float maxAxisScale(const float *m);
+}
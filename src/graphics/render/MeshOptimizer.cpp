@@ -0,0 +1,839 @@
+#include "render/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace openchordix::render
+{
+    namespace
+    {
+        using openchordix::assets::Vertex;
+
+        constexpr uint32_t kUnused = std::numeric_limits<uint32_t>::max();
+
+        // Forsyth's scoring, tuned for a 32-entry LRU.
+        constexpr uint32_t kScoreCacheSize = 32;
+        constexpr float kLastTriangleScore = 0.75f;
+        constexpr float kCacheDecayPower = 1.5f;
+        constexpr float kValenceBoostScale = 2.0f;
+        constexpr uint32_t kValenceTableSize = 32;
+
+        constexpr uint32_t kBoundaryCacheSize = 16;
+        constexpr std::size_t kFetchLine = 64;
+        constexpr std::size_t kFetchLines = 16 * 1024 / kFetchLine;
+
+        struct ScoreTables
+        {
+            std::array<float, kScoreCacheSize> cache{};
+            std::array<float, kValenceTableSize> valence{};
+        };
+
+        const ScoreTables &scoreTables()
+        {
+            static const ScoreTables tables = []
+            {
+                ScoreTables out;
+                for (uint32_t position = 0; position < kScoreCacheSize; ++position)
+                {
+                    out.cache[position] = position < 3
+                                              ? kLastTriangleScore
+                                              : std::pow(1.0f - static_cast<float>(position - 3) / (kScoreCacheSize - 3),
+                                                         kCacheDecayPower);
+                }
+                for (uint32_t valence = 1; valence < kValenceTableSize; ++valence)
+                {
+                    out.valence[valence] = kValenceBoostScale / std::sqrt(static_cast<float>(valence));
+                }
+                return out;
+            }();
+            return tables;
+        }
+
+        // Vertices with fewer remaining triangles score higher, so stragglers get
+        // finished before they leave the cache.
+        float vertexScore(uint32_t cachePosition, uint32_t liveTriangles)
+        {
+            if (liveTriangles == 0)
+            {
+                return -1.0f;
+            }
+            const ScoreTables &tables = scoreTables();
+            const float cache = cachePosition < kScoreCacheSize ? tables.cache[cachePosition] : 0.0f;
+            const float valence = liveTriangles < kValenceTableSize
+                                      ? tables.valence[liveTriangles]
+                                      : kValenceBoostScale / std::sqrt(static_cast<float>(liveTriangles));
+            return cache + valence;
+        }
+
+        // FIFO post-transform cache keyed by insertion time; returns the misses of
+        // one triangle.
+        uint32_t updateCache(const uint32_t *triangle, std::vector<uint32_t> &timestamps, uint32_t &time,
+                             uint32_t cacheSize)
+        {
+            uint32_t misses = 0;
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t vertex = triangle[corner];
+                if (time - timestamps[vertex] > cacheSize)
+                {
+                    timestamps[vertex] = time++;
+                    ++misses;
+                }
+            }
+            return misses;
+        }
+
+        uint64_t countReferenced(std::span<const uint32_t> indices, std::size_t vertexCount)
+        {
+            std::vector<bool> seen(vertexCount, false);
+            uint64_t count = 0;
+            for (uint32_t index : indices)
+            {
+                if (!seen[index])
+                {
+                    seen[index] = true;
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        std::array<float, 3> sub(const float *a, const float *b)
+        {
+            return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+        }
+
+        // Sum of squared distances to a set of planes, each weighted by triangle area.
+        struct Quadric
+        {
+            float a2 = 0, b2 = 0, c2 = 0, d2 = 0;
+            float ab = 0, ac = 0, ad = 0, bc = 0, bd = 0, cd = 0;
+            float weight = 0;
+
+            void addPlane(float a, float b, float c, float d, float w)
+            {
+                a2 += a * a * w;
+                b2 += b * b * w;
+                c2 += c * c * w;
+                d2 += d * d * w;
+                ab += a * b * w;
+                ac += a * c * w;
+                ad += a * d * w;
+                bc += b * c * w;
+                bd += b * d * w;
+                cd += c * d * w;
+                weight += w;
+            }
+
+            Quadric &operator+=(const Quadric &o)
+            {
+                a2 += o.a2;
+                b2 += o.b2;
+                c2 += o.c2;
+                d2 += o.d2;
+                ab += o.ab;
+                ac += o.ac;
+                ad += o.ad;
+                bc += o.bc;
+                bd += o.bd;
+                cd += o.cd;
+                weight += o.weight;
+                return *this;
+            }
+
+            // Mean squared distance of p from the planes.
+            float error(const std::array<float, 3> &p) const
+            {
+                const float x = p[0], y = p[1], z = p[2];
+                const float sum = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                                  2.0f * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+                return weight > 0.0f ? std::max(sum / weight, 0.0f) : 0.0f;
+            }
+        };
+
+        std::array<float, 3> cross(const std::array<float, 3> &a, const std::array<float, 3> &b)
+        {
+            return {a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0]};
+        }
+
+        float dot(const std::array<float, 3> &a, const std::array<float, 3> &b)
+        {
+            return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+        }
+
+        struct Collapse
+        {
+            uint32_t from;
+            uint32_t to;
+            float cost;
+        };
+    }
+
+    VertexCacheStats &VertexCacheStats::operator+=(const VertexCacheStats &other)
+    {
+        triangles += other.triangles;
+        vertices += other.vertices;
+        transforms += other.transforms;
+        return *this;
+    }
+
+    VertexFetchStats &VertexFetchStats::operator+=(const VertexFetchStats &other)
+    {
+        fetchedBytes += other.fetchedBytes;
+        referencedBytes += other.referencedBytes;
+        return *this;
+    }
+
+    MeshOptimizationStats &MeshOptimizationStats::operator+=(const MeshOptimizationStats &other)
+    {
+        cacheBefore += other.cacheBefore;
+        cacheAfter += other.cacheAfter;
+        fetchBefore += other.fetchBefore;
+        fetchAfter += other.fetchAfter;
+        millis += other.millis;
+        return *this;
+    }
+
+    VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount, uint32_t cacheSize)
+    {
+        VertexCacheStats stats;
+        stats.triangles = indices.size() / 3;
+        stats.vertices = countReferenced(indices, vertexCount);
+
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = cacheSize + 1;
+        for (std::size_t i = 0; i + 3 <= indices.size(); i += 3)
+        {
+            stats.transforms += updateCache(indices.data() + i, timestamps, time, cacheSize);
+        }
+        return stats;
+    }
+
+    VertexFetchStats analyzeVertexFetch(std::span<const uint32_t> indices, std::size_t vertexCount, std::size_t vertexStride)
+    {
+        VertexFetchStats stats;
+        stats.referencedBytes = countReferenced(indices, vertexCount) * vertexStride;
+
+        // Only vertices that miss the post-transform cache are fetched. Tags are
+        // line + 1 so an empty slot never matches.
+        std::vector<uint32_t> timestamps(vertexCount, 0);
+        uint32_t time = kBoundaryCacheSize + 1;
+        std::vector<uint64_t> lines(kFetchLines, 0);
+        for (uint32_t index : indices)
+        {
+            if (time - timestamps[index] <= kBoundaryCacheSize)
+            {
+                continue;
+            }
+            timestamps[index] = time++;
+            const uint64_t start = static_cast<uint64_t>(index) * vertexStride;
+            const uint64_t end = start + vertexStride;
+            for (uint64_t line = start / kFetchLine; line * kFetchLine < end; ++line)
+            {
+                uint64_t &slot = lines[line % kFetchLines];
+                if (slot != line + 1)
+                {
+                    slot = line + 1;
+                    stats.fetchedBytes += kFetchLine;
+                }
+            }
+        }
+        return stats;
+    }
+
+    void weldVertices(std::vector<Vertex> &vertices, std::span<uint32_t> indices)
+    {
+        // Vertex is all floats, so byte equality is the exact comparison and there
+        // is no padding to trip over.
+        auto hash = [&](uint32_t index)
+        {
+            uint64_t h = 0xCBF29CE484222325ull;
+            const auto *bytes = reinterpret_cast<const uint32_t *>(&vertices[index]);
+            for (std::size_t i = 0; i < sizeof(Vertex) / sizeof(uint32_t); ++i)
+            {
+                h = (h ^ bytes[i]) * 0x100000001B3ull;
+            }
+            return static_cast<std::size_t>(h ^ (h >> 32));
+        };
+        auto equal = [&](uint32_t a, uint32_t b)
+        {
+            return std::memcmp(&vertices[a], &vertices[b], sizeof(Vertex)) == 0;
+        };
+        std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(equal)> unique(vertices.size(), hash, equal);
+
+        std::vector<uint32_t> remap(vertices.size());
+        uint32_t next = 0;
+        for (uint32_t i = 0; i < vertices.size(); ++i)
+        {
+            auto [it, inserted] = unique.try_emplace(i, next);
+            remap[i] = it->second;
+            if (inserted)
+            {
+                ++next;
+            }
+        }
+        if (next == vertices.size())
+        {
+            return;
+        }
+
+        // Every vertex moves to a slot at or below its own, so compacting in place is safe.
+        for (uint32_t i = 0; i < vertices.size(); ++i)
+        {
+            vertices[remap[i]] = vertices[i];
+        }
+        vertices.resize(next);
+        for (uint32_t &index : indices)
+        {
+            index = remap[index];
+        }
+    }
+
+    void optimizeVertexCache(std::span<uint32_t> indices, std::size_t vertexCount)
+    {
+        const std::size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // Triangles of each vertex; the first live[v] entries are the ones not yet emitted.
+        std::vector<uint32_t> live(vertexCount, 0);
+        for (uint32_t index : indices)
+        {
+            ++live[index];
+        }
+        std::vector<uint32_t> offsets(vertexCount + 1, 0);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            offsets[v + 1] = offsets[v] + live[v];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+            {
+                adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+
+        std::vector<uint32_t> cachePosition(vertexCount, kUnused);
+        std::vector<float> vertexScores(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            vertexScores[v] = vertexScore(kUnused, live[v]);
+        }
+        std::vector<float> triangleScores(triangleCount);
+        for (std::size_t t = 0; t < triangleCount; ++t)
+        {
+            triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> out;
+        out.reserve(indices.size());
+        std::array<uint32_t, kScoreCacheSize + 3> cache{};
+        std::size_t cacheCount = 0;
+        std::size_t cursor = 0;
+        std::size_t best = kUnused;
+
+        for (std::size_t step = 0; step < triangleCount; ++step)
+        {
+            if (best == kUnused)
+            {
+                // Dead end: nothing in the cache has triangles left. Restart from the
+                // first triangle not yet emitted.
+                while (emitted[cursor])
+                {
+                    ++cursor;
+                }
+                best = cursor;
+            }
+
+            const uint32_t *triangle = indices.data() + best * 3;
+            out.insert(out.end(), triangle, triangle + 3);
+            emitted[best] = true;
+
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                const uint32_t v = triangle[corner];
+                uint32_t *first = adjacency.data() + offsets[v];
+                uint32_t *last = first + live[v];
+                uint32_t *it = std::find(first, last, static_cast<uint32_t>(best));
+                std::swap(*it, *(last - 1));
+                --live[v];
+            }
+
+            // The triangle's vertices move to the front; whatever falls past the
+            // cache size is evicted.
+            std::array<uint32_t, kScoreCacheSize + 3> next{};
+            std::size_t nextCount = 0;
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                if (std::find(next.begin(), next.begin() + nextCount, triangle[corner]) == next.begin() + nextCount)
+                {
+                    next[nextCount++] = triangle[corner];
+                }
+            }
+            for (std::size_t i = 0; i < cacheCount; ++i)
+            {
+                if (std::find(next.begin(), next.begin() + 3, cache[i]) == next.begin() + 3)
+                {
+                    next[nextCount++] = cache[i];
+                }
+            }
+
+            for (std::size_t i = 0; i < nextCount; ++i)
+            {
+                const uint32_t v = next[i];
+                cachePosition[v] = i < kScoreCacheSize ? static_cast<uint32_t>(i) : kUnused;
+                const float score = vertexScore(cachePosition[v], live[v]);
+                const float delta = score - vertexScores[v];
+                vertexScores[v] = score;
+                for (uint32_t k = offsets[v]; k < offsets[v] + live[v]; ++k)
+                {
+                    triangleScores[adjacency[k]] += delta;
+                }
+            }
+            cacheCount = std::min<std::size_t>(nextCount, kScoreCacheSize);
+            std::copy(next.begin(), next.begin() + cacheCount, cache.begin());
+
+            best = kUnused;
+            float bestScore = -std::numeric_limits<float>::max();
+            for (std::size_t i = 0; i < cacheCount; ++i)
+            {
+                const uint32_t v = cache[i];
+                for (uint32_t k = offsets[v]; k < offsets[v] + live[v]; ++k)
+                {
+                    if (triangleScores[adjacency[k]] > bestScore)
+                    {
+                        bestScore = triangleScores[adjacency[k]];
+                        best = adjacency[k];
+                    }
+                }
+            }
+        }
+
+        std::copy(out.begin(), out.end(), indices.begin());
+    }
+
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold)
+    {
+        const std::size_t triangleCount = indices.size() / 3;
+        if (triangleCount < 2)
+        {
+            return;
+        }
+
+        // Hard boundaries: triangles that miss on all three vertices, where the
+        // cache order starts over anyway.
+        std::vector<uint32_t> timestamps(vertices.size(), 0);
+        uint32_t time = kBoundaryCacheSize + 1;
+        std::vector<std::size_t> hard;
+        for (std::size_t t = 0; t < triangleCount; ++t)
+        {
+            if (updateCache(indices.data() + t * 3, timestamps, time, kBoundaryCacheSize) == 3 || t == 0)
+            {
+                hard.push_back(t);
+            }
+        }
+        hard.push_back(triangleCount);
+
+        // Soft boundaries: split a cluster further wherever the part so far, on a
+        // cold cache, is already within `threshold` of the cluster's own ACMR.
+        std::vector<std::size_t> clusters;
+        for (std::size_t c = 0; c + 1 < hard.size(); ++c)
+        {
+            const std::size_t start = hard[c];
+            const std::size_t end = hard[c + 1];
+
+            time += kBoundaryCacheSize + 1;
+            uint32_t misses = 0;
+            for (std::size_t t = start; t < end; ++t)
+            {
+                misses += updateCache(indices.data() + t * 3, timestamps, time, kBoundaryCacheSize);
+            }
+            const float limit = threshold * static_cast<float>(misses) / static_cast<float>(end - start);
+
+            clusters.push_back(start);
+            time += kBoundaryCacheSize + 1;
+            std::size_t softStart = start;
+            misses = 0;
+            for (std::size_t t = start; t < end; ++t)
+            {
+                misses += updateCache(indices.data() + t * 3, timestamps, time, kBoundaryCacheSize);
+                if (t + 1 < end && static_cast<float>(misses) <= limit * static_cast<float>(t + 1 - softStart))
+                {
+                    clusters.push_back(t + 1);
+                    softStart = t + 1;
+                    misses = 0;
+                    time += kBoundaryCacheSize + 1;
+                }
+            }
+        }
+        clusters.push_back(triangleCount);
+
+        std::array<double, 3> meshCentroid{0.0, 0.0, 0.0};
+        for (uint32_t index : indices)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                meshCentroid[k] += vertices[index].position[k];
+            }
+        }
+        for (double &value : meshCentroid)
+        {
+            value /= static_cast<double>(indices.size());
+        }
+
+        // Sort key: how far the cluster's area-weighted centroid lies out along its
+        // average normal. Clusters on the outside of the mesh come first.
+        const std::size_t clusterCount = clusters.size() - 1;
+        std::vector<float> keys(clusterCount);
+        for (std::size_t c = 0; c < clusterCount; ++c)
+        {
+            std::array<float, 3> centroid{0.0f, 0.0f, 0.0f};
+            std::array<float, 3> normal{0.0f, 0.0f, 0.0f};
+            float area = 0.0f;
+            for (std::size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+            {
+                const float *p0 = vertices[indices[t * 3]].position;
+                const float *p1 = vertices[indices[t * 3 + 1]].position;
+                const float *p2 = vertices[indices[t * 3 + 2]].position;
+                const std::array<float, 3> e1 = sub(p1, p0);
+                const std::array<float, 3> e2 = sub(p2, p0);
+                const std::array<float, 3> cross{e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2],
+                                                 e1[0] * e2[1] - e1[1] * e2[0]};
+                const float doubleArea = std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]);
+                for (int k = 0; k < 3; ++k)
+                {
+                    centroid[k] += (p0[k] + p1[k] + p2[k]) / 3.0f * doubleArea;
+                    normal[k] += cross[k];
+                }
+                area += doubleArea;
+            }
+            const float inverseArea = area > 0.0f ? 1.0f / area : 0.0f;
+            const float normalLength = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+            const float inverseNormal = normalLength > 0.0f ? 1.0f / normalLength : 0.0f;
+            float key = 0.0f;
+            for (int k = 0; k < 3; ++k)
+            {
+                key += (centroid[k] * inverseArea - static_cast<float>(meshCentroid[k])) * normal[k] * inverseNormal;
+            }
+            keys[c] = key;
+        }
+
+        std::vector<uint32_t> order(clusterCount);
+        for (uint32_t c = 0; c < clusterCount; ++c)
+        {
+            order[c] = c;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+                         { return keys[a] > keys[b]; });
+
+        std::vector<uint32_t> out;
+        out.reserve(indices.size());
+        for (uint32_t c : order)
+        {
+            out.insert(out.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+        }
+        std::copy(out.begin(), out.end(), indices.begin());
+    }
+
+    void optimizeVertexFetch(std::vector<Vertex> &vertices, std::span<uint32_t> indices)
+    {
+        std::vector<uint32_t> remap(vertices.size(), kUnused);
+        uint32_t next = 0;
+        for (uint32_t &index : indices)
+        {
+            if (remap[index] == kUnused)
+            {
+                remap[index] = next++;
+            }
+            index = remap[index];
+        }
+
+        std::vector<Vertex> out(next);
+        for (std::size_t v = 0; v < vertices.size(); ++v)
+        {
+            if (remap[v] != kUnused)
+            {
+                out[remap[v]] = vertices[v];
+            }
+        }
+        vertices = std::move(out);
+    }
+
+    float simplifyMesh(std::span<const uint32_t> indices, std::span<const Vertex> vertices,
+                       std::size_t targetIndexCount, float maxError, std::vector<uint32_t> &out)
+    {
+        out.assign(indices.begin(), indices.end());
+        const std::size_t vertexCount = vertices.size();
+        if (out.size() <= targetIndexCount || out.size() % 3 != 0 || vertexCount == 0)
+        {
+            return 0.0f;
+        }
+
+        // Positions scaled to a unit extent, so errors come out relative to it.
+        std::array<float, 3> min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                                 std::numeric_limits<float>::max()};
+        std::array<float, 3> max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                                 std::numeric_limits<float>::lowest()};
+        for (uint32_t index : out)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                min[k] = std::min(min[k], vertices[index].position[k]);
+                max[k] = std::max(max[k], vertices[index].position[k]);
+            }
+        }
+        const float extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2]});
+        const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+        std::vector<std::array<float, 3>> positions(vertexCount);
+        for (std::size_t v = 0; v < vertexCount; ++v)
+        {
+            for (int k = 0; k < 3; ++k)
+            {
+                positions[v][k] = (vertices[v].position[k] - min[k]) * scale;
+            }
+        }
+
+        // Vertices sharing a position are one point of the surface split by an
+        // attribute seam; `canonical` names the first of them.
+        std::vector<uint32_t> canonical(vertexCount);
+        {
+            auto hash = [&](uint32_t v)
+            {
+                uint32_t bits[3];
+                std::memcpy(bits, vertices[v].position, sizeof(bits));
+                return static_cast<std::size_t>((bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u));
+            };
+            auto equal = [&](uint32_t a, uint32_t b)
+            {
+                return std::memcmp(vertices[a].position, vertices[b].position, sizeof(vertices[a].position)) == 0;
+            };
+            std::unordered_map<uint32_t, uint32_t, decltype(hash), decltype(equal)> first(vertexCount, hash, equal);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                canonical[v] = first.try_emplace(v, v).first->second;
+            }
+        }
+
+        // Seams and open borders stay put: moving them would tear or shrink the mesh.
+        std::vector<bool> locked(vertexCount, false);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            if (canonical[v] != v)
+            {
+                locked[v] = true;
+                locked[canonical[v]] = true;
+            }
+        }
+        {
+            std::vector<uint64_t> edges;
+            edges.reserve(out.size());
+            for (std::size_t i = 0; i < out.size(); i += 3)
+            {
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = canonical[out[i + corner]];
+                    const uint32_t b = canonical[out[i + (corner + 1) % 3]];
+                    edges.push_back(static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+            for (std::size_t i = 0; i < edges.size();)
+            {
+                std::size_t j = i + 1;
+                while (j < edges.size() && edges[j] == edges[i])
+                {
+                    ++j;
+                }
+                if (j - i == 1)
+                {
+                    locked[static_cast<uint32_t>(edges[i] >> 32)] = true;
+                    locked[static_cast<uint32_t>(edges[i])] = true;
+                }
+                i = j;
+            }
+        }
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            locked[v] = locked[v] || locked[canonical[v]];
+        }
+
+        std::vector<Quadric> quadrics(vertexCount);
+        for (std::size_t i = 0; i < out.size(); i += 3)
+        {
+            const std::array<float, 3> &p0 = positions[out[i]];
+            const std::array<float, 3> e1 = sub(positions[out[i + 1]].data(), p0.data());
+            const std::array<float, 3> e2 = sub(positions[out[i + 2]].data(), p0.data());
+            std::array<float, 3> normal = cross(e1, e2);
+            const float length = std::sqrt(dot(normal, normal));
+            if (length <= 0.0f)
+            {
+                continue;
+            }
+            for (float &value : normal)
+            {
+                value /= length;
+            }
+            const float d = -dot(normal, p0);
+            for (int corner = 0; corner < 3; ++corner)
+            {
+                quadrics[out[i + corner]].addPlane(normal[0], normal[1], normal[2], d, length * 0.5f);
+            }
+        }
+
+        std::vector<uint32_t> remap(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; ++v)
+        {
+            remap[v] = v;
+        }
+        const float maxCost = maxError * maxError;
+        float worst = 0.0f;
+        std::vector<uint32_t> offsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency;
+        std::vector<Collapse> collapses;
+        std::vector<bool> touched(vertexCount);
+
+        // Each pass collapses the cheapest edges whose endpoints no earlier collapse
+        // in the pass has touched, then rebuilds the triangle list.
+        while (out.size() > targetIndexCount)
+        {
+            std::fill(offsets.begin(), offsets.end(), 0);
+            for (uint32_t index : out)
+            {
+                ++offsets[index + 1];
+            }
+            for (std::size_t v = 0; v < vertexCount; ++v)
+            {
+                offsets[v + 1] += offsets[v];
+            }
+            adjacency.resize(out.size());
+            {
+                std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+                for (std::size_t i = 0; i < out.size(); ++i)
+                {
+                    adjacency[fill[out[i]]++] = static_cast<uint32_t>(i / 3);
+                }
+            }
+
+            // Every interior edge shows up once in each direction across its two
+            // triangles, and border edges have both ends locked, so one direction
+            // per triangle edge covers every candidate.
+            collapses.clear();
+            for (std::size_t i = 0; i < out.size(); i += 3)
+            {
+                for (int corner = 0; corner < 3; ++corner)
+                {
+                    const uint32_t a = out[i + corner];
+                    const uint32_t b = out[i + (corner + 1) % 3];
+                    if (!locked[a])
+                    {
+                        collapses.push_back({a, b, quadrics[a].error(positions[b])});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse &x, const Collapse &y)
+                      { return x.cost < y.cost; });
+
+            // A collapse removes about two triangles; stop once the target is in reach.
+            const std::size_t wanted = (out.size() - targetIndexCount) / 6 + 1;
+            std::size_t done = 0;
+            std::fill(touched.begin(), touched.end(), false);
+            for (const Collapse &collapse : collapses)
+            {
+                if (collapse.cost > maxCost || done >= wanted)
+                {
+                    break;
+                }
+                if (touched[collapse.from] || touched[collapse.to])
+                {
+                    continue;
+                }
+
+                // Reject the collapse if any surviving triangle around `from` turns
+                // over. Corners go through `remap`, so this pass's earlier collapses
+                // are already accounted for.
+                bool flips = false;
+                for (uint32_t k = offsets[collapse.from]; k < offsets[collapse.from + 1] && !flips; ++k)
+                {
+                    const uint32_t *triangle = out.data() + adjacency[k] * 3;
+                    std::array<uint32_t, 3> corners{remap[triangle[0]], remap[triangle[1]], remap[triangle[2]]};
+                    if (corners[0] == collapse.to || corners[1] == collapse.to || corners[2] == collapse.to)
+                    {
+                        continue;
+                    }
+                    const std::array<float, 3> before = cross(sub(positions[corners[1]].data(), positions[corners[0]].data()),
+                                                              sub(positions[corners[2]].data(), positions[corners[0]].data()));
+                    for (uint32_t &corner : corners)
+                    {
+                        corner = corner == collapse.from ? collapse.to : corner;
+                    }
+                    const std::array<float, 3> after = cross(sub(positions[corners[1]].data(), positions[corners[0]].data()),
+                                                             sub(positions[corners[2]].data(), positions[corners[0]].data()));
+                    flips = dot(before, after) <= 0.25f * std::sqrt(dot(before, before) * dot(after, after));
+                }
+                if (flips)
+                {
+                    continue;
+                }
+
+                remap[collapse.from] = collapse.to;
+                quadrics[collapse.to] += quadrics[collapse.from];
+                touched[collapse.from] = true;
+                touched[collapse.to] = true;
+                worst = std::max(worst, collapse.cost);
+                ++done;
+            }
+            if (done == 0)
+            {
+                break;
+            }
+
+            std::size_t write = 0;
+            for (std::size_t i = 0; i < out.size(); i += 3)
+            {
+                const uint32_t a = remap[out[i]];
+                const uint32_t b = remap[out[i + 1]];
+                const uint32_t c = remap[out[i + 2]];
+                if (a != b && b != c && a != c)
+                {
+                    out[write++] = a;
+                    out[write++] = b;
+                    out[write++] = c;
+                }
+            }
+            out.resize(write);
+            for (uint32_t v = 0; v < vertexCount; ++v)
+            {
+                remap[v] = v;
+            }
+        }
+        return std::sqrt(worst) * (extent > 0.0f ? extent : 0.0f);
+    }
+
+    MeshOptimizationStats optimizeMesh(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        MeshOptimizationStats stats;
+        stats.cacheBefore = analyzeVertexCache(indices, vertices.size());
+        stats.fetchBefore = analyzeVertexFetch(indices, vertices.size(), sizeof(Vertex));
+
+        weldVertices(vertices, indices);
+        optimizeVertexCache(indices, vertices.size());
+        optimizeOverdraw(indices, vertices);
+        optimizeVertexFetch(vertices, indices);
+
+        stats.cacheAfter = analyzeVertexCache(indices, vertices.size());
+        stats.fetchAfter = analyzeVertexFetch(indices, vertices.size(), sizeof(Vertex));
+        stats.millis = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "gltf/GltfAsset.h"
+
+// Index and vertex reordering for indexed triangle lists, run once at import.
+// None of it changes what is drawn, only the order it is drawn in.
+namespace openchordix::render
+{
+    // Post-transform cache simulation: a FIFO of the last few transformed vertices.
+    struct VertexCacheStats
+    {
+        uint64_t triangles = 0;
+        uint64_t vertices = 0;   // Distinct vertices referenced
+        uint64_t transforms = 0; // Cache misses, i.e. vertex shader invocations
+
+        float acmr() const { return triangles ? static_cast<float>(transforms) / static_cast<float>(triangles) : 0.0f; }
+        float atvr() const { return vertices ? static_cast<float>(transforms) / static_cast<float>(vertices) : 0.0f; }
+        VertexCacheStats &operator+=(const VertexCacheStats &other);
+    };
+
+    // Pre-transform fetch simulation: 64-byte lines through a small direct-mapped cache.
+    struct VertexFetchStats
+    {
+        uint64_t fetchedBytes = 0;
+        uint64_t referencedBytes = 0; // Distinct vertices referenced times the stride
+
+        // 1.0 means every referenced vertex byte was read exactly once.
+        float overfetch() const
+        {
+            return referencedBytes ? static_cast<float>(fetchedBytes) / static_cast<float>(referencedBytes) : 0.0f;
+        }
+        VertexFetchStats &operator+=(const VertexFetchStats &other);
+    };
+
+    struct MeshOptimizationStats
+    {
+        VertexCacheStats cacheBefore;
+        VertexCacheStats cacheAfter;
+        VertexFetchStats fetchBefore; // Measured with the assets::Vertex stride
+        VertexFetchStats fetchAfter;
+        double millis = 0.0;
+
+        MeshOptimizationStats &operator+=(const MeshOptimizationStats &other);
+    };
+
+    VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, std::size_t vertexCount, uint32_t cacheSize = 16);
+    VertexFetchStats analyzeVertexFetch(std::span<const uint32_t> indices, std::size_t vertexCount, std::size_t vertexStride);
+
+    // Merges bitwise identical vertices and rewrites the indices to match.
+    void weldVertices(std::vector<openchordix::assets::Vertex> &vertices, std::span<uint32_t> indices);
+    // Greedy triangle order for the post-transform cache (Forsyth's vertex scores).
+    void optimizeVertexCache(std::span<uint32_t> indices, std::size_t vertexCount);
+    // Splits the cache-optimized order into clusters wherever the cache would have
+    // restarted anyway, or where splitting keeps ACMR within `threshold` of the
+    // cluster's, then draws outward-facing clusters first so they occlude the rest.
+    void optimizeOverdraw(std::span<uint32_t> indices, std::span<const openchordix::assets::Vertex> vertices,
+                          float threshold = 1.05f);
+    // Renumbers vertices in first-use order and drops unreferenced ones.
+    void optimizeVertexFetch(std::vector<openchordix::assets::Vertex> &vertices, std::span<uint32_t> indices);
+
+    // Quadric edge-collapse simplification toward `targetIndexCount` indices. Each
+    // collapse moves a vertex onto a neighbour, so the result indexes the same
+    // vertices; border and attribute seam vertices never move, and collapses that
+    // would flip a triangle are skipped. Stops early rather than exceed `maxError`,
+    // given as a fraction of the mesh extent. Returns the largest error made, in
+    // position units.
+    float simplifyMesh(std::span<const uint32_t> indices, std::span<const openchordix::assets::Vertex> vertices,
+                       std::size_t targetIndexCount, float maxError, std::vector<uint32_t> &out);
+
+    // All but simplifyMesh, in order, with before and after figures. `indices` must be
+    // a triangle list.
+    MeshOptimizationStats optimizeMesh(std::vector<openchordix::assets::Vertex> &vertices, std::vector<uint32_t> &indices);
+}
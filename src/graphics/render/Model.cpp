@@ -1,12 +1,46 @@
 #include "render/Model.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace openchordix::render
 {
+    uint32_t selectMeshLod(std::span<const MeshLod> lods, float pixelsPerUnit, float maxErrorPixels)
+    {
+        for (std::size_t level = lods.size(); level > 1; --level)
+        {
+            if (lods[level - 1].error * pixelsPerUnit <= maxErrorPixels)
+            {
+                return static_cast<uint32_t>(level - 1);
+            }
+        }
+        return 0;
+    }
+
+    ModelBounds makeModelBounds(const std::array<float, 3> &min, const std::array<float, 3> &max)
+    {
+        ModelBounds bounds;
+        bounds.min = min;
+        bounds.max = max;
+        bounds.center = {
+            0.5f * (min[0] + max[0]),
+            0.5f * (min[1] + max[1]),
+            0.5f * (min[2] + max[2])};
+
+        float dx = max[0] - min[0];
+        float dy = max[1] - min[1];
+        float dz = max[2] - min[2];
+        bounds.maxExtent = std::max(dx, std::max(dy, dz));
+        bounds.radius = 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz);
+        return bounds;
+    }
+
     void ModelMesh::destroy()
     {
         vertexBuffer.reset();
         indexBuffer.reset();
         indexCount = 0;
+        lodCount = 0;
     }
 
     Model::~Model()
@@ -28,6 +62,14 @@ namespace openchordix::render
             materials = std::move(other.materials);
             textures = std::move(other.textures);
             bounds = other.bounds;
+            nodes = std::move(other.nodes);
+            instances = std::move(other.instances);
+            instanceBoxes = std::move(other.instanceBoxes);
+            nodeInstances_ = std::move(other.nodeInstances_);
+            other.nodes.clear();
+            other.instances.clear();
+            other.instanceBoxes.clear();
+            other.nodeInstances_.clear();
         }
         return *this;
     }
@@ -38,5 +80,63 @@ namespace openchordix::render
         materials.clear();
         textures.clear();
         bounds = {};
+        nodes.clear();
+        instances.clear();
+        instanceBoxes.clear();
+        nodeInstances_.clear();
+    }
+
+    void Model::setNodes(std::span<const NodeTransform> newNodes, std::vector<MeshInstance> newInstances)
+    {
+        nodes.assign(newNodes);
+        instances = std::move(newInstances);
+        nodeInstances_.assign(nodes.size() + 1, 0);
+        for (const MeshInstance &instance : instances)
+        {
+            ++nodeInstances_[instance.node + 1];
+        }
+        for (std::size_t node = 0; node < nodes.size(); ++node)
+        {
+            nodeInstances_[node + 1] += nodeInstances_[node];
+        }
+        instanceBoxes.resize(instances.size());
+        updateTransforms();
+    }
+
+    void Model::setSingleNode()
+    {
+        std::vector<MeshInstance> all(meshes.size());
+        for (std::size_t i = 0; i < all.size(); ++i)
+        {
+            all[i].mesh = static_cast<uint32_t>(i);
+        }
+        const NodeTransform root{};
+        setNodes(std::span<const NodeTransform>(&root, 1), std::move(all));
+    }
+
+    void Model::updateTransforms()
+    {
+        bool moved = false;
+        for (const NodeRange &range : nodes.update())
+        {
+            moved = true;
+            for (uint32_t index = nodeInstances_[range.first]; index < nodeInstances_[range.end]; ++index)
+            {
+                const MeshInstance &instance = instances[index];
+                const ModelMesh &mesh = meshes[instance.mesh];
+                std::array<float, 3> min;
+                std::array<float, 3> max;
+                transformBounds(nodes.world(instance.node).data(), mesh.boundsMin, mesh.boundsMax, min, max);
+                instanceBoxes.set(index, min, max);
+            }
+        }
+
+        // Instanced copies are culled and LODs picked by the whole model's box, so it follows the nodes.
+        std::array<float, 3> min;
+        std::array<float, 3> max;
+        if (moved)
+        {
+            bounds = instanceBoxes.bounds(min, max) ? makeModelBounds(min, max) : ModelBounds{};
+        }
     }
 }
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
+#include <span>
 #include <vector>
 
 #include <bgfx/bgfx.h>
 
 #include "render/BgfxHandle.h"
+#include "render/FrustumCull.h"
+#include "render/TransformHierarchy.h"
 
 namespace openchordix::render
 {
@@ -18,6 +22,12 @@ namespace openchordix::render
         Blend
     };
 
+    enum class VertexFormat : uint8_t
+    {
+        Full,  // assets::Vertex: float position, normal, tangent and uv, 48 bytes
+        Packed // PackedVertex: half position and uv, octahedral normal frame, 20 bytes
+    };
+
     struct ModelMaterial
     {
         std::array<float, 4> baseColorFactor{1.0f, 1.0f, 1.0f, 1.0f};
@@ -38,19 +48,43 @@ namespace openchordix::render
         uint32_t emissiveTexture = std::numeric_limits<uint32_t>::max();
     };
 
+    // One detail level: a range of the mesh's index buffer over the same vertices.
+    struct MeshLod
+    {
+        uint32_t firstIndex = 0;
+        uint32_t indexCount = 0;
+        float error = 0.0f; // Largest object-space deviation from level 0
+    };
+
+    inline constexpr std::size_t kMaxMeshLods = 4;
+
+    // Coarsest level whose error stays within `maxErrorPixels` on screen, where
+    // `pixelsPerUnit` is the projected size of one object-space unit.
+    uint32_t selectMeshLod(std::span<const MeshLod> lods, float pixelsPerUnit, float maxErrorPixels);
+
     struct ModelMesh
     {
         BgfxHandle<bgfx::VertexBufferHandle> vertexBuffer{};
         BgfxHandle<bgfx::IndexBufferHandle> indexBuffer{};
-        uint32_t indexCount = 0;
+        uint32_t indexCount = 0; // Level 0, from the start of the buffer
         uint16_t materialIndex = 0;
         bool index32 = false;
+        VertexFormat vertexFormat = VertexFormat::Full;
+        std::array<MeshLod, kMaxMeshLods> lods{};
+        uint8_t lodCount = 0; // 0 when the mesh has no LOD chain
         std::array<float, 3> boundsMin{0.0f, 0.0f, 0.0f};
         std::array<float, 3> boundsMax{0.0f, 0.0f, 0.0f};
 
         void destroy();
     };
 
+    // One placement of a mesh: drawn with its node's world matrix.
+    struct MeshInstance
+    {
+        uint32_t mesh = 0;
+        uint32_t node = 0;
+    };
+
     struct ModelBounds
     {
         std::array<float, 3> min{0.0f, 0.0f, 0.0f};
@@ -60,6 +94,9 @@ namespace openchordix::render
         float maxExtent = 0.0f;
     };
 
+    // Centre, radius and largest extent of the box [min, max].
+    ModelBounds makeModelBounds(const std::array<float, 3> &min, const std::array<float, 3> &max);
+
     class Model
     {
     public:
@@ -75,10 +112,23 @@ namespace openchordix::render
         Model &operator=(const Model &) = delete;
 
         void clear();
+        // Takes new nodes and instances; `instances` must be sorted by node.
+        void setNodes(std::span<const NodeTransform> nodes, std::vector<MeshInstance> instances);
+        // One identity node drawing every mesh once, for models built by hand.
+        void setSingleNode();
+        // Brings world matrices, instanceBoxes and bounds up to date after
+        // nodes.setLocal(); only the subtrees that changed are visited.
+        void updateTransforms();
 
         std::vector<ModelMesh> meshes;
         std::vector<ModelMaterial> materials;
         std::vector<BgfxHandle<bgfx::TextureHandle>> textures;
-        ModelBounds bounds{};
+        ModelBounds bounds{}; // Of every instance at its node's current world matrix
+        TransformHierarchy nodes;
+        std::vector<MeshInstance> instances; // Sorted by node
+        CullBoxes instanceBoxes;             // instances[i]'s mesh bounds in model space, in lane i
+
+    private:
+        std::vector<uint32_t> nodeInstances_; // instances of node n are [nodeInstances_[n], nodeInstances_[n + 1])
     };
 }
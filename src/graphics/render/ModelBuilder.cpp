@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstring>
 #include <iterator>
 #include <limits>
 #include <numeric>
@@ -36,6 +37,464 @@ namespace openchordix::render
             uint32_t srgb = Model::kInvalidTextureIndex;
             uint32_t linear = Model::kInvalidTextureIndex;
         };
+
+        constexpr uint64_t kStreamAlignment = 8;
+
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + kStreamAlignment - 1) & ~(kStreamAlignment - 1);
+        }
+
+        // Appends `size` bytes at the next aligned offset and returns that offset.
+        uint64_t appendStream(std::vector<std::byte> &blob, const void *data, std::size_t size)
+        {
+            const uint64_t offset = alignUp(blob.size());
+            blob.resize(offset + size);
+            std::memcpy(blob.data() + offset, data, size);
+            return offset;
+        }
+
+        // IEEE binary16, round to nearest even. Out of range values become infinity,
+        // which the packing tolerance check rejects.
+        uint16_t floatToHalf(float value)
+        {
+            uint32_t bits = 0;
+            std::memcpy(&bits, &value, sizeof(bits));
+            const auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+            const uint32_t magnitude = bits & 0x7FFFFFFFu;
+
+            if (magnitude >= 0x7F800000u)
+            {
+                return sign | (magnitude > 0x7F800000u ? 0x7E00u : 0x7C00u);
+            }
+            if (magnitude >= 0x477FF000u) // 65520 and up round past the largest half
+            {
+                return sign | 0x7C00u;
+            }
+            if (magnitude < 0x38800000u) // Below the smallest normal half
+            {
+                if (magnitude < 0x33000000u)
+                {
+                    return sign;
+                }
+                const uint32_t exponent = magnitude >> 23;
+                const uint32_t mantissa = (magnitude & 0x7FFFFFu) | 0x800000u;
+                const uint32_t shift = 126 - exponent;
+                uint32_t half = mantissa >> shift;
+                const uint32_t rest = mantissa & ((1u << shift) - 1);
+                const uint32_t halfway = 1u << (shift - 1);
+                if (rest > halfway || (rest == halfway && (half & 1u)))
+                {
+                    ++half;
+                }
+                return static_cast<uint16_t>(sign | half);
+            }
+
+            uint32_t half = (magnitude - 0x38000000u) >> 13;
+            const uint32_t rest = magnitude & 0x1FFFu;
+            if (rest > 0x1000u || (rest == 0x1000u && (half & 1u)))
+            {
+                ++half;
+            }
+            return static_cast<uint16_t>(sign | half);
+        }
+
+        float halfToFloat(uint16_t half)
+        {
+            const uint32_t exponent = (half >> 10) & 0x1Fu;
+            const uint32_t mantissa = half & 0x3FFu;
+            float value = 0.0f;
+            if (exponent == 0)
+            {
+                value = std::ldexp(static_cast<float>(mantissa), -24);
+            }
+            else if (exponent == 31)
+            {
+                value = mantissa ? std::numeric_limits<float>::quiet_NaN() : std::numeric_limits<float>::infinity();
+            }
+            else
+            {
+                const uint32_t bits = ((exponent + 112) << 23) | (mantissa << 13);
+                std::memcpy(&value, &bits, sizeof(value));
+            }
+            return (half & 0x8000u) ? -value : value;
+        }
+
+        int16_t toSnorm16(float value)
+        {
+            return static_cast<int16_t>(std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+        }
+
+        // Octahedral mapping of a unit vector onto [-1, 1]^2; vs_standard_packed has
+        // the inverse.
+        std::array<float, 2> octEncode(const float *v)
+        {
+            const float l1 = std::abs(v[0]) + std::abs(v[1]) + std::abs(v[2]);
+            if (!(l1 > 0.0f))
+            {
+                return {0.0f, 0.0f};
+            }
+            float x = v[0] / l1;
+            float y = v[1] / l1;
+            if (v[2] < 0.0f)
+            {
+                const float foldedX = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                const float foldedY = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x = foldedX;
+                y = foldedY;
+            }
+            return {x, y};
+        }
+
+        PackedVertex packVertex(const openchordix::assets::Vertex &vertex)
+        {
+            PackedVertex out{};
+            for (int i = 0; i < 3; ++i)
+            {
+                out.position[i] = floatToHalf(vertex.position[i]);
+            }
+            out.position[3] = floatToHalf(1.0f);
+
+            const std::array<float, 2> normal = octEncode(vertex.normal);
+            const std::array<float, 2> tangent = octEncode(vertex.tangent);
+            out.frame[0] = toSnorm16(normal[0]);
+            out.frame[1] = toSnorm16(normal[1]);
+            out.frame[2] = toSnorm16(tangent[0]);
+            // Remapped into [0.5, 1], tangent y leaves its sign free for the bitangent sign.
+            const float handedness = vertex.tangent[3] < 0.0f ? -1.0f : 1.0f;
+            out.frame[3] = toSnorm16(handedness * (tangent[1] * 0.25f + 0.75f));
+
+            out.uv[0] = floatToHalf(vertex.uv[0]);
+            out.uv[1] = floatToHalf(vertex.uv[1]);
+            return out;
+        }
+
+        bool withinHalfTolerance(float value, float tolerance)
+        {
+            const float error = std::abs(halfToFloat(floatToHalf(value)) - value);
+            return std::isfinite(value) && error <= tolerance;
+        }
+
+        // Packing is all or nothing, so one pipeline serves the whole model.
+        bool canPackVertices(const openchordix::assets::GltfAsset &asset, const ModelPrepareOptions &options)
+        {
+            std::array<float, 3> min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                                     std::numeric_limits<float>::max()};
+            std::array<float, 3> max{std::numeric_limits<float>::lowest(), std::numeric_limits<float>::lowest(),
+                                     std::numeric_limits<float>::lowest()};
+            for (const auto &mesh : asset.meshes)
+            {
+                for (const auto &prim : mesh.primitives)
+                {
+                    for (const auto &vertex : prim.vertices)
+                    {
+                        for (int i = 0; i < 3; ++i)
+                        {
+                            min[i] = std::min(min[i], vertex.position[i]);
+                            max[i] = std::max(max[i], vertex.position[i]);
+                        }
+                    }
+                }
+            }
+            const float extent = std::max({max[0] - min[0], max[1] - min[1], max[2] - min[2], 0.0f});
+            const float positionTolerance = options.positionTolerance * extent;
+
+            for (const auto &mesh : asset.meshes)
+            {
+                for (const auto &prim : mesh.primitives)
+                {
+                    for (const auto &vertex : prim.vertices)
+                    {
+                        if (!withinHalfTolerance(vertex.position[0], positionTolerance) ||
+                            !withinHalfTolerance(vertex.position[1], positionTolerance) ||
+                            !withinHalfTolerance(vertex.position[2], positionTolerance) ||
+                            !withinHalfTolerance(vertex.uv[0], options.uvTolerance) ||
+                            !withinHalfTolerance(vertex.uv[1], options.uvTolerance))
+                        {
+                            return false;
+                        }
+                    }
+                }
+            }
+            return true;
+        }
+
+        // Appends coarser copies of the level 0 indices already in `stream` and
+        // records every level in mesh.lods. Each level's error adds to the ones
+        // before it, since it was simplified from them.
+        void appendLods(std::vector<uint32_t> &stream,
+                        std::span<const openchordix::assets::Vertex> vertices,
+                        const ModelPrepareOptions &options,
+                        PreparedMesh &mesh)
+        {
+            constexpr std::size_t kMinLodIndices = 3 * 64;
+
+            mesh.lods[0] = {0, static_cast<uint32_t>(stream.size()), 0.0f};
+            mesh.lodCount = 1;
+            const std::size_t levels = std::min<std::size_t>(options.lodLevels, kMaxMeshLods - 1);
+            std::vector<uint32_t> previous = stream;
+            std::vector<uint32_t> simplified;
+            float error = 0.0f;
+            for (std::size_t level = 1; level <= levels && previous.size() >= kMinLodIndices; ++level)
+            {
+                error += simplifyMesh(previous, vertices, previous.size() / 6 * 3, options.lodMaxError, simplified);
+                // Not worth a level unless it drops at least a fifth of the triangles.
+                if (simplified.size() > previous.size() / 5 * 4)
+                {
+                    break;
+                }
+                optimizeVertexCache(simplified, vertices.size());
+                mesh.lods[level] = {static_cast<uint32_t>(stream.size()), static_cast<uint32_t>(simplified.size()), error};
+                ++mesh.lodCount;
+                stream.insert(stream.end(), simplified.begin(), simplified.end());
+                std::swap(previous, simplified);
+            }
+        }
+
+        float srgbToLinear(uint8_t value)
+        {
+            const float c = static_cast<float>(value) / 255.0f;
+            return c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+
+        // Box-filtered mip chain down to 1x1, appended after the base level. Colour
+        // channels of sRGB textures are averaged in linear space so mips do not darken.
+        std::vector<std::byte> buildMipChain(const openchordix::assets::ImageData &image, bool srgb, uint8_t &mipCount)
+        {
+            static const std::array<float, 256> kToLinear = []
+            {
+                std::array<float, 256> table{};
+                for (int i = 0; i < 256; ++i)
+                {
+                    table[i] = srgbToLinear(static_cast<uint8_t>(i));
+                }
+                return table;
+            }();
+            static const std::array<uint8_t, 4096> kToSrgb = []
+            {
+                std::array<uint8_t, 4096> table{};
+                for (int i = 0; i < 4096; ++i)
+                {
+                    const float c = static_cast<float>(i) / 4095.0f;
+                    const float s = c <= 0.0031308f ? c * 12.92f : 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
+                    table[i] = static_cast<uint8_t>(std::lround(std::clamp(s, 0.0f, 1.0f) * 255.0f));
+                }
+                return table;
+            }();
+
+            std::vector<std::byte> out(image.rgba.begin(), image.rgba.end());
+            uint32_t width = static_cast<uint32_t>(image.width);
+            uint32_t height = static_cast<uint32_t>(image.height);
+            std::size_t source = 0;
+            mipCount = 1;
+            while (width > 1 || height > 1)
+            {
+                const uint32_t mipWidth = std::max(width / 2, 1u);
+                const uint32_t mipHeight = std::max(height / 2, 1u);
+                const std::size_t dest = out.size();
+                out.resize(dest + static_cast<std::size_t>(mipWidth) * mipHeight * 4);
+                const auto *src = reinterpret_cast<const uint8_t *>(out.data() + source);
+                auto *dst = reinterpret_cast<uint8_t *>(out.data() + dest);
+
+                for (uint32_t y = 0; y < mipHeight; ++y)
+                {
+                    const uint32_t y0 = std::min(y * 2, height - 1);
+                    const uint32_t y1 = std::min(y * 2 + 1, height - 1);
+                    for (uint32_t x = 0; x < mipWidth; ++x)
+                    {
+                        const uint32_t x0 = std::min(x * 2, width - 1);
+                        const uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                        const uint8_t *taps[4] = {src + (y0 * width + x0) * 4, src + (y0 * width + x1) * 4,
+                                                  src + (y1 * width + x0) * 4, src + (y1 * width + x1) * 4};
+                        uint8_t *texel = dst + (static_cast<std::size_t>(y) * mipWidth + x) * 4;
+                        for (int c = 0; c < 4; ++c)
+                        {
+                            if (srgb && c < 3)
+                            {
+                                const float sum = kToLinear[taps[0][c]] + kToLinear[taps[1][c]] +
+                                                  kToLinear[taps[2][c]] + kToLinear[taps[3][c]];
+                                texel[c] = kToSrgb[static_cast<std::size_t>(std::lround(sum * 0.25f * 4095.0f))];
+                            }
+                            else
+                            {
+                                texel[c] = static_cast<uint8_t>((taps[0][c] + taps[1][c] + taps[2][c] + taps[3][c] + 2) / 4);
+                            }
+                        }
+                    }
+                }
+
+                source = dest;
+                width = mipWidth;
+                height = mipHeight;
+                ++mipCount;
+            }
+            return out;
+        }
+
+        void mergeBounds(ModelBounds &bounds,
+                         const std::array<float, 3> &min,
+                         const std::array<float, 3> &max,
+                         bool &boundsInit)
+        {
+            if (!boundsInit)
+            {
+                bounds.min = min;
+                bounds.max = max;
+                boundsInit = true;
+                return;
+            }
+
+            bounds.min[0] = std::min(bounds.min[0], min[0]);
+            bounds.min[1] = std::min(bounds.min[1], min[1]);
+            bounds.min[2] = std::min(bounds.min[2], min[2]);
+            bounds.max[0] = std::max(bounds.max[0], max[0]);
+            bounds.max[1] = std::max(bounds.max[1], max[1]);
+            bounds.max[2] = std::max(bounds.max[2], max[2]);
+        }
+
+        // Bounds of every instance placed by its node's world matrix.
+        template <typename Mesh>
+        ModelBounds instanceBounds(const std::vector<Mesh> &meshes,
+                                   const TransformHierarchy &nodes,
+                                   std::span<const MeshInstance> instances)
+        {
+            ModelBounds bounds{};
+            bool boundsInit = false;
+            for (const MeshInstance &instance : instances)
+            {
+                const Mesh &mesh = meshes[instance.mesh];
+                std::array<float, 3> min;
+                std::array<float, 3> max;
+                transformBounds(nodes.world(instance.node).data(), mesh.boundsMin, mesh.boundsMax, min, max);
+                mergeBounds(bounds, min, max, boundsInit);
+            }
+
+            return boundsInit ? makeModelBounds(bounds.min, bounds.max) : bounds;
+        }
+    }
+
+    ModelBounds PreparedModel::bounds() const
+    {
+        TransformHierarchy hierarchy;
+        hierarchy.assign(nodes);
+        hierarchy.update();
+        return instanceBounds(meshes, hierarchy, instances);
+    }
+
+    std::size_t PreparedModel::uploadBytes() const
+    {
+        std::size_t total = 0;
+        for (const PreparedTexture &texture : textures)
+        {
+            total += texture.size;
+        }
+        for (const PreparedMesh &mesh : meshes)
+        {
+            total += mesh.vertexSize() + mesh.indexSize();
+        }
+        return total;
+    }
+
+    ModelUpload::ModelUpload(PreparedModel prepared)
+        : prepared_(std::move(prepared)),
+          totalBytes_(prepared_.uploadBytes())
+    {
+        model_.materials = std::move(prepared_.materials);
+        if (model_.materials.empty())
+        {
+            model_.materials.push_back(ModelMaterial{});
+        }
+        model_.textures.reserve(prepared_.textures.size());
+        model_.meshes.reserve(prepared_.meshes.size());
+        meshSlots_.reserve(prepared_.meshes.size());
+    }
+
+    bool ModelUpload::step(ModelRenderer &renderer, const ModelUploadBudget &budget)
+    {
+        const std::span<const std::byte> data = prepared_.bytes();
+        std::size_t bytes = 0;
+        uint32_t resources = 0;
+        auto withinBudget = [&]()
+        {
+            return resources == 0 || (bytes < budget.maxBytes && resources < budget.maxResources);
+        };
+
+        while (nextTexture_ < prepared_.textures.size() && withinBudget())
+        {
+            const PreparedTexture &texture = prepared_.textures[nextTexture_++];
+            // A failed texture keeps its slot; the renderer falls back for invalid handles.
+            model_.textures.emplace_back(renderer.createTexture(texture.width, texture.height, texture.mipCount, texture.srgb,
+                                                               data.subspan(texture.offset, texture.size)));
+            bytes += texture.size;
+            ++resources;
+        }
+
+        while (nextTexture_ == prepared_.textures.size() && nextMesh_ < prepared_.meshes.size() && withinBudget())
+        {
+            const PreparedMesh &mesh = prepared_.meshes[nextMesh_++];
+            const bgfx::Memory *vbm = bgfx::copy(data.data() + mesh.vertexOffset, static_cast<uint32_t>(mesh.vertexSize()));
+            BgfxHandle<bgfx::VertexBufferHandle> vbh(bgfx::createVertexBuffer(vbm, renderer.vertexLayout(mesh.vertexFormat)));
+            const bgfx::Memory *ibm = bgfx::copy(data.data() + mesh.indexOffset, static_cast<uint32_t>(mesh.indexSize()));
+            BgfxHandle<bgfx::IndexBufferHandle> ibh(bgfx::createIndexBuffer(ibm, mesh.index32 ? BGFX_BUFFER_INDEX32 : BGFX_BUFFER_NONE));
+            bytes += mesh.vertexSize() + mesh.indexSize();
+            resources += 2;
+
+            meshSlots_.push_back(kNoSlot);
+            if (vbh.isValid() && ibh.isValid())
+            {
+                meshSlots_.back() = static_cast<uint32_t>(model_.meshes.size());
+                ModelMesh outMesh{};
+                outMesh.vertexBuffer = std::move(vbh);
+                outMesh.indexBuffer = std::move(ibh);
+                outMesh.indexCount = mesh.lods[0].indexCount;
+                outMesh.index32 = mesh.index32;
+                outMesh.vertexFormat = mesh.vertexFormat;
+                outMesh.materialIndex = mesh.materialIndex;
+                outMesh.boundsMin = mesh.boundsMin;
+                outMesh.boundsMax = mesh.boundsMax;
+                outMesh.lods = mesh.lods;
+                outMesh.lodCount = mesh.lodCount;
+                model_.meshes.push_back(std::move(outMesh));
+            }
+        }
+
+        uploadedBytes_ += bytes;
+        return finished();
+    }
+
+    bool ModelUpload::finished() const
+    {
+        return nextTexture_ == prepared_.textures.size() && nextMesh_ == prepared_.meshes.size();
+    }
+
+    float ModelUpload::progress() const
+    {
+        if (totalBytes_ == 0)
+        {
+            return finished() ? 1.0f : 0.0f;
+        }
+        return std::min(1.0f, static_cast<float>(uploadedBytes_) / static_cast<float>(totalBytes_));
+    }
+
+    Model ModelUpload::take()
+    {
+        // Instances of meshes that failed to upload are dropped; the rest follow
+        // their mesh to its new index.
+        std::vector<MeshInstance> instances;
+        instances.reserve(prepared_.instances.size());
+        for (MeshInstance instance : prepared_.instances)
+        {
+            if (meshSlots_[instance.mesh] != kNoSlot)
+            {
+                instance.mesh = meshSlots_[instance.mesh];
+                instances.push_back(instance);
+            }
+        }
+        model_.setNodes(prepared_.nodes, std::move(instances));
+
+        // bgfx has its own copy of every stream now.
+        prepared_ = {};
+        return std::move(model_);
     }
 
     ModelBuilder::ModelBuilder(ModelRenderer &renderer)
@@ -43,10 +502,38 @@ namespace openchordix::render
     {
     }
 
-    Model ModelBuilder::build(const openchordix::assets::GltfAsset &asset)
+    Model ModelBuilder::build(openchordix::assets::GltfAsset asset)
     {
-        Model model;
-        model.materials.reserve(asset.materials.size());
+        ModelUpload upload(prepare(std::move(asset), {.packVertices = renderer_.supportsPackedVertices()}));
+        const ModelUploadBudget unlimited{std::numeric_limits<std::size_t>::max(), std::numeric_limits<uint32_t>::max()};
+        while (!upload.step(renderer_, unlimited))
+        {
+        }
+        return upload.take();
+    }
+
+    PreparedModel ModelBuilder::prepare(openchordix::assets::GltfAsset asset, const ModelPrepareOptions &options)
+    {
+        PreparedModel prepared;
+        const VertexFormat vertexFormat =
+            options.packVertices && canPackVertices(asset, options) ? VertexFormat::Packed : VertexFormat::Full;
+        prepared.materials.reserve(asset.materials.size());
+
+        // Rough size of the packed streams, so the blob rarely reallocates; a full
+        // mip chain adds a third to each image.
+        std::size_t estimate = 0;
+        for (const auto &image : asset.images)
+        {
+            estimate += image.rgba.size() + image.rgba.size() / 3;
+        }
+        for (const auto &mesh : asset.meshes)
+        {
+            for (const auto &prim : mesh.primitives)
+            {
+                estimate += prim.vertices.size() * vertexStride(vertexFormat) + prim.indices.size() * sizeof(uint32_t);
+            }
+        }
+        prepared.blob.reserve(estimate);
 
         std::vector<ImageTextures> imageTextures(asset.images.size());
 
@@ -63,14 +550,22 @@ namespace openchordix::render
                 return slot;
             }
 
-            bgfx::TextureHandle handle = renderer_.createTextureFromImage(asset.images[imageIndex], srgb);
-            if (!bgfx::isValid(handle))
+            const auto &image = asset.images[imageIndex];
+            if (image.width <= 0 || image.height <= 0 || image.width > 0xFFFF || image.height > 0xFFFF ||
+                image.rgba.size() != static_cast<std::size_t>(image.width) * image.height * 4)
             {
                 return Model::kInvalidTextureIndex;
             }
 
-            model.textures.emplace_back(handle);
-            slot = static_cast<uint32_t>(model.textures.size() - 1);
+            PreparedTexture texture{};
+            texture.width = static_cast<uint16_t>(image.width);
+            texture.height = static_cast<uint16_t>(image.height);
+            texture.srgb = srgb;
+            const std::vector<std::byte> levels = buildMipChain(image, srgb, texture.mipCount);
+            texture.offset = appendStream(prepared.blob, levels.data(), levels.size());
+            texture.size = levels.size();
+            prepared.textures.push_back(texture);
+            slot = static_cast<uint32_t>(prepared.textures.size() - 1);
             return slot;
         };
 
@@ -85,45 +580,22 @@ namespace openchordix::render
             return indices;
         };
 
-        auto createVertexBuffer = [&](const std::vector<openchordix::assets::Vertex> &vertices)
-        {
-            const bgfx::Memory *vbm = bgfx::copy(vertices.data(),
-                                                 static_cast<uint32_t>(vertices.size() * sizeof(openchordix::assets::Vertex)));
-            return BgfxHandle<bgfx::VertexBufferHandle>(bgfx::createVertexBuffer(vbm, renderer_.vertexLayout()));
-        };
-
-        struct IndexBufferResult
-        {
-            BgfxHandle<bgfx::IndexBufferHandle> handle{};
-            bool index32 = false;
-        };
-
-        auto createIndexBuffer = [](const std::vector<uint32_t> &indices)
+        auto packIndices = [&](const std::vector<uint32_t> &indices, PreparedMesh &mesh)
         {
-            IndexBufferResult result{};
-            if (indices.empty())
-            {
-                return result;
-            }
-
             uint32_t maxIndex = *std::max_element(indices.begin(), indices.end());
-            result.index32 = maxIndex > std::numeric_limits<uint16_t>::max();
+            mesh.index32 = maxIndex > std::numeric_limits<uint16_t>::max();
+            mesh.indexCount = static_cast<uint32_t>(indices.size());
 
-            if (result.index32)
+            if (mesh.index32)
             {
-                const bgfx::Memory *ibm = bgfx::copy(indices.data(),
-                                                     static_cast<uint32_t>(indices.size() * sizeof(uint32_t)));
-                result.handle.reset(bgfx::createIndexBuffer(ibm, BGFX_BUFFER_INDEX32));
-                return result;
+                mesh.indexOffset = appendStream(prepared.blob, indices.data(), indices.size() * sizeof(uint32_t));
+                return;
             }
 
             std::vector<uint16_t> indices16(indices.size());
             std::transform(indices.begin(), indices.end(), indices16.begin(),
                            [](uint32_t value) { return static_cast<uint16_t>(value); });
-            const bgfx::Memory *ibm = bgfx::copy(indices16.data(),
-                                                 static_cast<uint32_t>(indices16.size() * sizeof(uint16_t)));
-            result.handle.reset(bgfx::createIndexBuffer(ibm));
-            return result;
+            mesh.indexOffset = appendStream(prepared.blob, indices16.data(), indices16.size() * sizeof(uint16_t));
         };
 
         auto computeBounds = [](const std::vector<openchordix::assets::Vertex> &vertices)
@@ -142,27 +614,6 @@ namespace openchordix::render
             return std::pair{min, max};
         };
 
-        auto mergeBounds = [](ModelBounds &bounds,
-                              const std::array<float, 3> &min,
-                              const std::array<float, 3> &max,
-                              bool &boundsInit)
-        {
-            if (!boundsInit)
-            {
-                bounds.min = min;
-                bounds.max = max;
-                boundsInit = true;
-                return;
-            }
-
-            bounds.min[0] = std::min(bounds.min[0], min[0]);
-            bounds.min[1] = std::min(bounds.min[1], min[1]);
-            bounds.min[2] = std::min(bounds.min[2], min[2]);
-            bounds.max[0] = std::max(bounds.max[0], max[0]);
-            bounds.max[1] = std::max(bounds.max[1], max[1]);
-            bounds.max[2] = std::max(bounds.max[2], max[2]);
-        };
-
         auto applyTextureIndex = [&](uint32_t &target,
                                      const std::optional<std::size_t> &imageIndex,
                                      bool srgb)
@@ -196,18 +647,17 @@ namespace openchordix::render
             return out;
         };
 
-        std::ranges::transform(asset.materials, std::back_inserter(model.materials), buildMaterial);
+        std::ranges::transform(asset.materials, std::back_inserter(prepared.materials), buildMaterial);
+        // An empty material list gets a default one at upload, so index 0 stays valid.
+        const std::size_t materialCount = std::max<std::size_t>(prepared.materials.size(), 1);
 
-        if (model.materials.empty())
+        // Prepared meshes of asset mesh i are [meshFirst[i], meshFirst[i + 1]).
+        std::vector<uint32_t> meshFirst;
+        meshFirst.reserve(asset.meshes.size() + 1);
+        for (auto &mesh : asset.meshes)
         {
-            model.materials.push_back(ModelMaterial{});
-        }
-
-        bool boundsInit = false;
-
-        for (const auto &mesh : asset.meshes)
-        {
-            for (const auto &prim : mesh.primitives)
+            meshFirst.push_back(static_cast<uint32_t>(prepared.meshes.size()));
+            for (auto &prim : mesh.primitives)
             {
                 if (prim.vertices.empty())
                 {
@@ -215,48 +665,72 @@ namespace openchordix::render
                 }
 
                 std::vector<uint32_t> indices = buildIndices(prim);
-                auto vbh = createVertexBuffer(prim.vertices);
-                auto indexBuffer = createIndexBuffer(indices);
-
-                if (!vbh.isValid() || !indexBuffer.handle.isValid())
+                const bool triangleList = indices.size() % 3 == 0 &&
+                                          std::ranges::all_of(indices, [&](uint32_t index)
+                                                              { return index < prim.vertices.size(); });
+                if (options.optimizeMeshes && triangleList)
                 {
-                    continue;
+                    prepared.optimization += optimizeMesh(prim.vertices, indices);
                 }
 
-                ModelMesh outMesh{};
-                outMesh.vertexBuffer = std::move(vbh);
-                outMesh.indexBuffer = std::move(indexBuffer.handle);
-                outMesh.indexCount = static_cast<uint32_t>(indices.size());
-                outMesh.index32 = indexBuffer.index32;
-                if (prim.materialIndex && *prim.materialIndex < model.materials.size())
+                PreparedMesh outMesh{};
+                outMesh.lods[0].indexCount = static_cast<uint32_t>(indices.size());
+                if (options.lodLevels > 0 && triangleList)
+                {
+                    appendLods(indices, prim.vertices, options, outMesh);
+                }
+                packIndices(indices, outMesh);
+                if (prim.materialIndex && *prim.materialIndex < materialCount)
                 {
                     outMesh.materialIndex = static_cast<uint16_t>(*prim.materialIndex);
                 }
 
                 auto [minBounds, maxBounds] = computeBounds(prim.vertices);
-
                 outMesh.boundsMin = minBounds;
                 outMesh.boundsMax = maxBounds;
-                model.meshes.push_back(std::move(outMesh));
-
-                mergeBounds(model.bounds, minBounds, maxBounds, boundsInit);
+                outMesh.vertexCount = static_cast<uint32_t>(prim.vertices.size());
+                outMesh.vertexFormat = vertexFormat;
+                if (vertexFormat == VertexFormat::Packed)
+                {
+                    std::vector<PackedVertex> packed(prim.vertices.size());
+                    std::ranges::transform(prim.vertices, packed.begin(), packVertex);
+                    outMesh.vertexOffset = appendStream(prepared.blob, packed.data(), outMesh.vertexSize());
+                }
+                else
+                {
+                    outMesh.vertexOffset = appendStream(prepared.blob, prim.vertices.data(), outMesh.vertexSize());
+                }
+                prepared.meshes.push_back(outMesh);
             }
         }
+        meshFirst.push_back(static_cast<uint32_t>(prepared.meshes.size()));
 
-        if (boundsInit)
+        // Each node draws its mesh's primitives; nodes arrive depth first, so the
+        // instances come out sorted by node.
+        for (std::size_t node = 0; node < asset.nodes.size(); ++node)
         {
-            model.bounds.center = {
-                0.5f * (model.bounds.min[0] + model.bounds.max[0]),
-                0.5f * (model.bounds.min[1] + model.bounds.max[1]),
-                0.5f * (model.bounds.min[2] + model.bounds.max[2])};
-
-            float dx = model.bounds.max[0] - model.bounds.min[0];
-            float dy = model.bounds.max[1] - model.bounds.min[1];
-            float dz = model.bounds.max[2] - model.bounds.min[2];
-            model.bounds.maxExtent = std::max(dx, std::max(dy, dz));
-            model.bounds.radius = 0.5f * std::sqrt(dx * dx + dy * dy + dz * dz);
+            const auto &source = asset.nodes[node];
+            prepared.nodes.push_back({source.parent, source.translation, source.rotation, source.scale});
+            if (source.meshIndex && *source.meshIndex < asset.meshes.size())
+            {
+                for (uint32_t mesh = meshFirst[*source.meshIndex]; mesh < meshFirst[*source.meshIndex + 1]; ++mesh)
+                {
+                    prepared.instances.push_back({mesh, static_cast<uint32_t>(node)});
+                }
+            }
+        }
+        // Without a usable scene every mesh is drawn once where it stands, as
+        // before nodes were read.
+        if (prepared.instances.empty() || !isDepthFirst(prepared.nodes))
+        {
+            prepared.nodes.assign(1, NodeTransform{});
+            prepared.instances.clear();
+            for (uint32_t mesh = 0; mesh < prepared.meshes.size(); ++mesh)
+            {
+                prepared.instances.push_back({mesh, 0});
+            }
         }
 
-        return model;
+        return prepared;
     }
 }
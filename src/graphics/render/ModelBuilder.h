@@ -1,17 +1,146 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+#include "MappedFile.h"
 #include "gltf/GltfAsset.h"
+#include "render/MeshOptimizer.h"
 #include "render/Model.h"
 
 namespace openchordix::render
 {
     class ModelRenderer;
 
+    // Compact vertex decoded by vs_standard_packed: half-float position (w unused),
+    // normal and tangent as snorm16 octahedral pairs with the bitangent sign folded
+    // into the last one, and half-float uv.
+    struct PackedVertex
+    {
+        uint16_t position[4];
+        int16_t frame[4];
+        uint16_t uv[2];
+    };
+
+    static_assert(sizeof(PackedVertex) == 20);
+
+    inline uint32_t vertexStride(VertexFormat format)
+    {
+        return format == VertexFormat::Packed ? sizeof(PackedVertex) : sizeof(openchordix::assets::Vertex);
+    }
+
+    struct ModelPrepareOptions
+    {
+        // Weld duplicate vertices and reorder triangles and vertices; see MeshOptimizer.h.
+        bool optimizeMeshes = true;
+        // Coarser index lists per mesh, each aiming for half the triangles of the
+        // previous one; at most kMaxMeshLods - 1.
+        uint32_t lodLevels = 3;
+        float lodMaxError = 0.02f; // Largest error a level may add, as a fraction of the mesh's extent
+        // Use PackedVertex when every mesh stays within tolerance; needs a renderer
+        // with supportsPackedVertices().
+        bool packVertices = false;
+        float positionTolerance = 1.0f / 2048.0f; // Largest position error, as a fraction of the model's extent
+        float uvTolerance = 1.0f / 2048.0f;       // Largest uv error, in uv units
+    };
+
+    // Offsets and sizes below are byte ranges of PreparedModel::bytes().
+    struct PreparedTexture
+    {
+        uint16_t width = 0;
+        uint16_t height = 0;
+        uint8_t mipCount = 1; // RGBA8 levels, largest first
+        bool srgb = false;
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
+
+    struct PreparedMesh
+    {
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0; // Every level, back to back
+        uint64_t vertexOffset = 0;
+        uint64_t indexOffset = 0; // 16-bit unless index32
+        bool index32 = false;
+        VertexFormat vertexFormat = VertexFormat::Full;
+        uint16_t materialIndex = 0;
+        std::array<float, 3> boundsMin{0.0f, 0.0f, 0.0f};
+        std::array<float, 3> boundsMax{0.0f, 0.0f, 0.0f};
+        std::array<MeshLod, kMaxMeshLods> lods{};
+        uint8_t lodCount = 1;
+
+        uint64_t vertexSize() const { return static_cast<uint64_t>(vertexCount) * vertexStride(vertexFormat); }
+        uint64_t indexSize() const { return static_cast<uint64_t>(indexCount) * (index32 ? 4u : 2u); }
+    };
+
+    // Everything a Model needs except the GPU handles: GPU-ready vertex and index
+    // streams and mipped textures, packed back to back. Materials already refer to
+    // texture slots, which are created in `textures` order. The streams live in
+    // `blob` after prepare(), or in `mapping` when read from the model cache.
+    struct PreparedModel
+    {
+        std::vector<ModelMaterial> materials;
+        std::vector<PreparedTexture> textures;
+        std::vector<PreparedMesh> meshes;
+        std::vector<std::byte> blob;
+        std::vector<NodeTransform> nodes;     // Depth first; at least one when there are meshes
+        std::vector<MeshInstance> instances;  // Sorted by node
+        MappedFile mapping;
+        uint64_t mappingOffset = 0; // Where the streams start in the mapping
+        MeshOptimizationStats optimization; // Summed over meshes; empty when read from the cache
+
+        std::span<const std::byte> bytes() const
+        {
+            return mapping.isOpen() ? mapping.bytes().subspan(mappingOffset) : std::span<const std::byte>(blob);
+        }
+        std::size_t uploadBytes() const;
+        ModelBounds bounds() const; // Of every instance, placed by its node
+    };
+
+    struct ModelUploadBudget
+    {
+        std::size_t maxBytes = 8u * 1024u * 1024u; // Copied into bgfx per step
+        uint32_t maxResources = 16;                // Textures and buffers created per step
+    };
+
+    // Creates the bgfx resources of a prepared model a few at a time, so a large
+    // model spreads over several frames. Each step makes at least one resource.
+    class ModelUpload
+    {
+    public:
+        explicit ModelUpload(PreparedModel prepared);
+
+        // Main thread only. Returns true once every resource exists.
+        bool step(ModelRenderer &renderer, const ModelUploadBudget &budget);
+        bool finished() const;
+        float progress() const;
+        // Valid once finished; meshes whose buffers failed are left out.
+        Model take();
+
+    private:
+        PreparedModel prepared_;
+        Model model_;
+        std::size_t nextTexture_ = 0;
+        std::size_t nextMesh_ = 0;
+        static constexpr uint32_t kNoSlot = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> meshSlots_; // Model mesh index of each prepared mesh, kNoSlot if it failed
+        std::size_t uploadedBytes_ = 0;
+        std::size_t totalBytes_ = 0;
+    };
+
     class ModelBuilder
     {
     public:
         explicit ModelBuilder(ModelRenderer &renderer);
-        Model build(const openchordix::assets::GltfAsset &asset);
+        Model build(openchordix::assets::GltfAsset asset);
+
+        // CPU side of build(): vertex and index packing, bounds, mip chains and
+        // texture slots. Safe off the main thread; nothing here touches bgfx.
+        static PreparedModel prepare(openchordix::assets::GltfAsset asset, const ModelPrepareOptions &options = {});
 
     private:
         ModelRenderer &renderer_;
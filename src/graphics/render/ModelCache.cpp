@@ -0,0 +1,563 @@
+#include "render/ModelCache.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "render/ModelCacheFormat.h"
+
+using namespace modelcache;
+
+namespace openchordix::render
+{
+    namespace
+    {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t alignUp(uint64_t value)
+        {
+            return (value + kAlignment - 1) & ~(kAlignment - 1);
+        }
+
+        template <typename T>
+        void put(std::vector<std::byte> &out, uint64_t offset, const T &value)
+        {
+            std::memcpy(out.data() + offset, &value, sizeof(T));
+        }
+
+        bool sectionFits(uint64_t offset, uint64_t count, uint64_t elementSize, uint64_t fileSize)
+        {
+            if (offset % kAlignment != 0 || offset > fileSize)
+            {
+                return false;
+            }
+            return count <= (fileSize - offset) / elementSize;
+        }
+
+        bool rangeFits(uint64_t offset, uint64_t size, uint64_t limit)
+        {
+            return offset <= limit && size <= limit - offset;
+        }
+
+        uint64_t mipChainSize(uint32_t width, uint32_t height, uint32_t mipCount)
+        {
+            uint64_t size = 0;
+            for (uint32_t level = 0; level < mipCount; ++level)
+            {
+                size += static_cast<uint64_t>(std::max(width >> level, 1u)) * std::max(height >> level, 1u) * 4;
+            }
+            return size;
+        }
+
+        // Word-at-a-time multiplicative hash; it only has to tell files apart.
+        uint64_t hashBytes(uint64_t hash, const std::byte *data, std::size_t size)
+        {
+            constexpr uint64_t kPrime = 0x9E3779B97F4A7C15ull;
+            std::size_t i = 0;
+            for (; i + 8 <= size; i += 8)
+            {
+                uint64_t word = 0;
+                std::memcpy(&word, data + i, sizeof(word));
+                hash = (hash ^ word) * kPrime;
+                hash ^= hash >> 32;
+            }
+            for (; i < size; ++i)
+            {
+                hash = (hash ^ static_cast<uint8_t>(data[i])) * kPrime;
+            }
+            return (hash ^ size) * kPrime;
+        }
+
+        uint64_t hashValue(uint64_t hash, uint64_t value)
+        {
+            return hashBytes(hash, reinterpret_cast<const std::byte *>(&value), sizeof(value));
+        }
+
+        uint64_t hashString(uint64_t hash, std::string_view text)
+        {
+            return hashBytes(hash, reinterpret_cast<const std::byte *>(text.data()), text.size());
+        }
+
+        int hexDigit(char c)
+        {
+            if (c >= '0' && c <= '9')
+            {
+                return c - '0';
+            }
+            if (c >= 'a' && c <= 'f')
+            {
+                return c - 'a' + 10;
+            }
+            if (c >= 'A' && c <= 'F')
+            {
+                return c - 'A' + 10;
+            }
+            return -1;
+        }
+
+        // Local files named by "uri" members of a .gltf document. A light scan rather
+        // than a parse: it only has to notice buffers and images that change.
+        std::vector<std::string> externalUris(std::string_view json)
+        {
+            std::vector<std::string> uris;
+            constexpr std::string_view kKey = "\"uri\"";
+            for (std::size_t pos = json.find(kKey); pos != std::string_view::npos; pos = json.find(kKey, pos))
+            {
+                pos += kKey.size();
+                while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\t' || json[pos] == '\r' ||
+                                             json[pos] == '\n' || json[pos] == ':'))
+                {
+                    ++pos;
+                }
+                if (pos >= json.size() || json[pos] != '"')
+                {
+                    continue;
+                }
+                std::string uri;
+                for (++pos; pos < json.size() && json[pos] != '"'; ++pos)
+                {
+                    char c = json[pos];
+                    if (c == '\\' && pos + 1 < json.size())
+                    {
+                        c = json[++pos];
+                    }
+                    else if (c == '%' && pos + 2 < json.size() && hexDigit(json[pos + 1]) >= 0 && hexDigit(json[pos + 2]) >= 0)
+                    {
+                        c = static_cast<char>(hexDigit(json[pos + 1]) * 16 + hexDigit(json[pos + 2]));
+                        pos += 2;
+                    }
+                    uri.push_back(c);
+                }
+                if (uri.rfind("data:", 0) != 0)
+                {
+                    uris.push_back(std::move(uri));
+                }
+            }
+            return uris;
+        }
+
+        CookedMaterial cookMaterial(const ModelMaterial &material)
+        {
+            CookedMaterial out{};
+            std::copy(material.baseColorFactor.begin(), material.baseColorFactor.end(), out.baseColorFactor);
+            std::copy(material.emissiveFactor.begin(), material.emissiveFactor.end(), out.emissiveFactor);
+            out.metallicFactor = material.metallicFactor;
+            out.roughnessFactor = material.roughnessFactor;
+            out.emissiveStrength = material.emissiveStrength;
+            out.alphaCutoff = material.alphaCutoff;
+            out.normalScale = material.normalScale;
+            out.occlusionStrength = material.occlusionStrength;
+            out.alphaMode = static_cast<uint32_t>(material.alphaMode);
+            out.doubleSided = material.doubleSided ? 1u : 0u;
+            out.textures[0] = material.baseColorTexture;
+            out.textures[1] = material.metallicRoughnessTexture;
+            out.textures[2] = material.normalTexture;
+            out.textures[3] = material.occlusionTexture;
+            out.textures[4] = material.emissiveTexture;
+            return out;
+        }
+
+        ModelMaterial uncookMaterial(const CookedMaterial &material)
+        {
+            ModelMaterial out{};
+            std::copy(std::begin(material.baseColorFactor), std::end(material.baseColorFactor), out.baseColorFactor.begin());
+            std::copy(std::begin(material.emissiveFactor), std::end(material.emissiveFactor), out.emissiveFactor.begin());
+            out.metallicFactor = material.metallicFactor;
+            out.roughnessFactor = material.roughnessFactor;
+            out.emissiveStrength = material.emissiveStrength;
+            out.alphaCutoff = material.alphaCutoff;
+            out.normalScale = material.normalScale;
+            out.occlusionStrength = material.occlusionStrength;
+            out.alphaMode = static_cast<AlphaMode>(material.alphaMode);
+            out.doubleSided = material.doubleSided != 0;
+            out.baseColorTexture = material.textures[0];
+            out.metallicRoughnessTexture = material.textures[1];
+            out.normalTexture = material.textures[2];
+            out.occlusionTexture = material.textures[3];
+            out.emissiveTexture = material.textures[4];
+            return out;
+        }
+
+        template <typename Index>
+        bool indicesInRange(std::span<const std::byte> bytes, uint64_t offset, uint32_t count, uint32_t vertexCount)
+        {
+            const std::byte *data = bytes.data() + offset;
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                Index index;
+                std::memcpy(&index, data + static_cast<std::size_t>(i) * sizeof(Index), sizeof(Index));
+                if (index >= vertexCount)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    bool hashModelSource(const std::filesystem::path &source, const ModelPrepareOptions &prepare, uint64_t &hash,
+                         std::string &error)
+    {
+        MappedFile file;
+        if (!file.open(source, error))
+        {
+            return false;
+        }
+        hash = hashValue(0xCBF29CE484222325ull, kVersion);
+        hash = hashValue(hash, sizeof(openchordix::assets::Vertex));
+        hash = hashValue(hash, prepare.optimizeMeshes ? 1 : 0);
+        hash = hashValue(hash, prepare.lodLevels);
+        hash = hashValue(hash, std::bit_cast<uint32_t>(prepare.lodMaxError));
+        if (prepare.packVertices)
+        {
+            hash = hashValue(hash, std::bit_cast<uint32_t>(prepare.positionTolerance));
+            hash = hashValue(hash, std::bit_cast<uint32_t>(prepare.uvTolerance));
+        }
+        hash = hashBytes(hash, file.bytes().data(), file.size());
+
+        std::string extension = source.extension().string();
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        if (extension != ".gltf")
+        {
+            return true;
+        }
+
+        // A .glb carries its buffers, but a .gltf usually points at .bin and image
+        // files; a change to any of them has to miss the cache too.
+        const std::string_view json(reinterpret_cast<const char *>(file.bytes().data()), file.size());
+        for (const std::string &uri : externalUris(json))
+        {
+            const std::filesystem::path dependency = source.parent_path() / uri;
+            std::error_code ec;
+            const uint64_t size = std::filesystem::file_size(dependency, ec);
+            const auto mtime = std::filesystem::last_write_time(dependency, ec);
+            hash = hashString(hash, uri);
+            hash = hashValue(hash, ec ? ~0ull : size);
+            hash = hashValue(hash, ec ? 0 : static_cast<uint64_t>(mtime.time_since_epoch().count()));
+        }
+        return true;
+    }
+
+    std::filesystem::path cookedModelPath(const std::filesystem::path &cacheDir, uint64_t sourceHash)
+    {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.ocmodel", static_cast<unsigned long long>(sourceHash));
+        return cacheDir / name;
+    }
+
+    bool writeCookedModel(const std::filesystem::path &path, const PreparedModel &model, uint64_t sourceHash,
+                          std::string &error)
+    {
+        const std::span<const std::byte> streams = model.bytes();
+
+        CookedModelHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.vertexStride = sizeof(openchordix::assets::Vertex);
+        header.sourceHash = sourceHash;
+        header.materialCount = static_cast<uint32_t>(model.materials.size());
+        header.textureCount = static_cast<uint32_t>(model.textures.size());
+        header.meshCount = static_cast<uint32_t>(model.meshes.size());
+        header.nodeCount = static_cast<uint32_t>(model.nodes.size());
+        header.instanceCount = static_cast<uint32_t>(model.instances.size());
+        header.materialOffset = alignUp(sizeof(CookedModelHeader));
+        header.textureOffset = alignUp(header.materialOffset + model.materials.size() * sizeof(CookedMaterial));
+        header.meshOffset = alignUp(header.textureOffset + model.textures.size() * sizeof(CookedTexture));
+        header.nodeOffset = alignUp(header.meshOffset + model.meshes.size() * sizeof(CookedMesh));
+        header.instanceOffset = alignUp(header.nodeOffset + model.nodes.size() * sizeof(CookedNode));
+        header.streamOffset = alignUp(header.instanceOffset + model.instances.size() * sizeof(CookedInstance));
+        header.streamSize = streams.size();
+        header.fileSize = header.streamOffset + header.streamSize;
+
+        std::vector<std::byte> tables(header.streamOffset);
+        put(tables, 0, header);
+        for (std::size_t i = 0; i < model.materials.size(); ++i)
+        {
+            put(tables, header.materialOffset + i * sizeof(CookedMaterial), cookMaterial(model.materials[i]));
+        }
+        for (std::size_t i = 0; i < model.textures.size(); ++i)
+        {
+            const PreparedTexture &texture = model.textures[i];
+            CookedTexture out{};
+            out.width = texture.width;
+            out.height = texture.height;
+            out.mipCount = texture.mipCount;
+            out.srgb = texture.srgb ? 1 : 0;
+            out.offset = texture.offset;
+            out.size = texture.size;
+            put(tables, header.textureOffset + i * sizeof(CookedTexture), out);
+        }
+        for (std::size_t i = 0; i < model.meshes.size(); ++i)
+        {
+            const PreparedMesh &mesh = model.meshes[i];
+            CookedMesh out{};
+            out.vertexCount = mesh.vertexCount;
+            out.indexCount = mesh.indexCount;
+            out.vertexOffset = mesh.vertexOffset;
+            out.indexOffset = mesh.indexOffset;
+            out.materialIndex = mesh.materialIndex;
+            out.index32 = mesh.index32 ? 1 : 0;
+            out.vertexFormat = static_cast<uint8_t>(mesh.vertexFormat);
+            std::copy(mesh.boundsMin.begin(), mesh.boundsMin.end(), out.boundsMin);
+            std::copy(mesh.boundsMax.begin(), mesh.boundsMax.end(), out.boundsMax);
+            out.lodCount = mesh.lodCount;
+            for (std::size_t level = 0; level < mesh.lodCount; ++level)
+            {
+                out.lods[level] = {mesh.lods[level].firstIndex, mesh.lods[level].indexCount, mesh.lods[level].error};
+            }
+            put(tables, header.meshOffset + i * sizeof(CookedMesh), out);
+        }
+        for (std::size_t i = 0; i < model.nodes.size(); ++i)
+        {
+            const NodeTransform &node = model.nodes[i];
+            CookedNode out{};
+            out.parent = node.parent;
+            std::copy(node.translation.begin(), node.translation.end(), out.translation);
+            std::copy(node.rotation.begin(), node.rotation.end(), out.rotation);
+            std::copy(node.scale.begin(), node.scale.end(), out.scale);
+            put(tables, header.nodeOffset + i * sizeof(CookedNode), out);
+        }
+        for (std::size_t i = 0; i < model.instances.size(); ++i)
+        {
+            put(tables, header.instanceOffset + i * sizeof(CookedInstance),
+                CookedInstance{model.instances[i].mesh, model.instances[i].node});
+        }
+
+        // Write beside the target and rename, so a mapped reader never sees a partial file.
+        std::filesystem::path temp = path;
+        temp += ".tmp";
+        {
+            std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char *>(tables.data()), static_cast<std::streamsize>(tables.size()));
+            out.write(reinterpret_cast<const char *>(streams.data()), static_cast<std::streamsize>(streams.size()));
+            if (!out.good())
+            {
+                error = "Failed to write " + temp.string() + ".";
+                return false;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp, path, ec);
+        if (ec)
+        {
+            error = "Failed to replace " + path.string() + ": " + ec.message() + ".";
+            std::filesystem::remove(temp, ec);
+            return false;
+        }
+        return true;
+    }
+
+    std::optional<PreparedModel> readCookedModel(const std::filesystem::path &path, uint64_t sourceHash,
+                                                 std::string &error)
+    {
+        PreparedModel model;
+        if (!model.mapping.open(path, error))
+        {
+            return std::nullopt;
+        }
+
+        const std::span<const std::byte> bytes = model.mapping.bytes();
+        if (bytes.size() < sizeof(CookedModelHeader))
+        {
+            error = "file too small for a cooked model header";
+            return std::nullopt;
+        }
+        CookedModelHeader header{};
+        std::memcpy(&header, bytes.data(), sizeof(header));
+        if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0)
+        {
+            error = "not a cooked model";
+            return std::nullopt;
+        }
+        if (header.version != kVersion || header.vertexStride != sizeof(openchordix::assets::Vertex) ||
+            header.sourceHash != sourceHash)
+        {
+            error = "cooked model is stale";
+            return std::nullopt;
+        }
+        const uint64_t size = bytes.size();
+        if (header.fileSize != size || header.meshCount == 0 || header.nodeCount == 0 ||
+            !sectionFits(header.materialOffset, header.materialCount, sizeof(CookedMaterial), size) ||
+            !sectionFits(header.textureOffset, header.textureCount, sizeof(CookedTexture), size) ||
+            !sectionFits(header.meshOffset, header.meshCount, sizeof(CookedMesh), size) ||
+            !sectionFits(header.nodeOffset, header.nodeCount, sizeof(CookedNode), size) ||
+            !sectionFits(header.instanceOffset, header.instanceCount, sizeof(CookedInstance), size) ||
+            !sectionFits(header.streamOffset, header.streamSize, 1, size))
+        {
+            error = "corrupt cooked model header";
+            return std::nullopt;
+        }
+        model.mappingOffset = header.streamOffset;
+        const std::span<const std::byte> streams = model.bytes();
+
+        model.materials.reserve(header.materialCount);
+        for (uint32_t i = 0; i < header.materialCount; ++i)
+        {
+            CookedMaterial material{};
+            std::memcpy(&material, bytes.data() + header.materialOffset + i * sizeof(CookedMaterial), sizeof(material));
+            bool ok = material.alphaMode <= static_cast<uint32_t>(AlphaMode::Blend);
+            for (uint32_t texture : material.textures)
+            {
+                ok = ok && (texture == Model::kInvalidTextureIndex || texture < header.textureCount);
+            }
+            if (!ok)
+            {
+                error = "corrupt cooked material table";
+                return std::nullopt;
+            }
+            model.materials.push_back(uncookMaterial(material));
+        }
+
+        model.textures.reserve(header.textureCount);
+        for (uint32_t i = 0; i < header.textureCount; ++i)
+        {
+            CookedTexture texture{};
+            std::memcpy(&texture, bytes.data() + header.textureOffset + i * sizeof(CookedTexture), sizeof(texture));
+            if (texture.width == 0 || texture.height == 0 || texture.mipCount == 0 || texture.mipCount > 17 ||
+                texture.size != mipChainSize(texture.width, texture.height, texture.mipCount) ||
+                !rangeFits(texture.offset, texture.size, streams.size()))
+            {
+                error = "corrupt cooked texture table";
+                return std::nullopt;
+            }
+            model.textures.push_back({texture.width, texture.height, texture.mipCount, texture.srgb != 0,
+                                      texture.offset, texture.size});
+        }
+
+        const uint32_t materialLimit = std::max<uint32_t>(header.materialCount, 1);
+        model.meshes.reserve(header.meshCount);
+        for (uint32_t i = 0; i < header.meshCount; ++i)
+        {
+            CookedMesh cooked{};
+            std::memcpy(&cooked, bytes.data() + header.meshOffset + i * sizeof(CookedMesh), sizeof(cooked));
+            PreparedMesh mesh{};
+            mesh.vertexCount = cooked.vertexCount;
+            mesh.indexCount = cooked.indexCount;
+            mesh.vertexOffset = cooked.vertexOffset;
+            mesh.indexOffset = cooked.indexOffset;
+            mesh.index32 = cooked.index32 != 0;
+            mesh.vertexFormat = static_cast<VertexFormat>(cooked.vertexFormat);
+            mesh.materialIndex = cooked.materialIndex;
+            std::copy(std::begin(cooked.boundsMin), std::end(cooked.boundsMin), mesh.boundsMin.begin());
+            std::copy(std::begin(cooked.boundsMax), std::end(cooked.boundsMax), mesh.boundsMax.begin());
+            mesh.lodCount = static_cast<uint8_t>(std::min<uint32_t>(cooked.lodCount, kMaxMeshLods));
+            bool lodsValid = cooked.lodCount >= 1 && cooked.lodCount <= kMaxMeshLods;
+            for (std::size_t level = 0; level < mesh.lodCount; ++level)
+            {
+                const CookedLod &lod = cooked.lods[level];
+                mesh.lods[level] = {lod.firstIndex, lod.indexCount, lod.error};
+                lodsValid = lodsValid && lod.indexCount > 0 && rangeFits(lod.firstIndex, lod.indexCount, mesh.indexCount);
+            }
+
+            // Index values are checked too: a bad one would read past the vertex
+            // buffer on the GPU. The scan also faults the pages in on this thread
+            // rather than during upload.
+            bool ok = mesh.vertexCount > 0 && mesh.indexCount > 0 && mesh.materialIndex < materialLimit && lodsValid &&
+                      cooked.vertexFormat <= static_cast<uint8_t>(VertexFormat::Packed) &&
+                      rangeFits(mesh.vertexOffset, mesh.vertexSize(), streams.size()) &&
+                      rangeFits(mesh.indexOffset, mesh.indexSize(), streams.size());
+            ok = ok && (mesh.index32 ? indicesInRange<uint32_t>(streams, mesh.indexOffset, mesh.indexCount, mesh.vertexCount)
+                                     : indicesInRange<uint16_t>(streams, mesh.indexOffset, mesh.indexCount, mesh.vertexCount));
+            if (!ok)
+            {
+                error = "corrupt cooked mesh table";
+                return std::nullopt;
+            }
+            model.meshes.push_back(mesh);
+        }
+
+        model.nodes.reserve(header.nodeCount);
+        for (uint32_t i = 0; i < header.nodeCount; ++i)
+        {
+            CookedNode cooked{};
+            std::memcpy(&cooked, bytes.data() + header.nodeOffset + i * sizeof(CookedNode), sizeof(cooked));
+            NodeTransform node{};
+            node.parent = cooked.parent;
+            std::copy(std::begin(cooked.translation), std::end(cooked.translation), node.translation.begin());
+            std::copy(std::begin(cooked.rotation), std::end(cooked.rotation), node.rotation.begin());
+            std::copy(std::begin(cooked.scale), std::end(cooked.scale), node.scale.begin());
+            model.nodes.push_back(node);
+        }
+        model.instances.reserve(header.instanceCount);
+        bool instancesValid = isDepthFirst(model.nodes);
+        for (uint32_t i = 0; i < header.instanceCount && instancesValid; ++i)
+        {
+            CookedInstance cooked{};
+            std::memcpy(&cooked, bytes.data() + header.instanceOffset + i * sizeof(CookedInstance), sizeof(cooked));
+            instancesValid = cooked.mesh < header.meshCount && cooked.node < header.nodeCount &&
+                             (model.instances.empty() || model.instances.back().node <= cooked.node);
+            model.instances.push_back({cooked.mesh, cooked.node});
+        }
+        if (!instancesValid)
+        {
+            error = "corrupt cooked node table";
+            return std::nullopt;
+        }
+
+        // Touch every page of the texture and vertex streams for the same reason.
+        volatile uint8_t sink = 0;
+        for (std::size_t offset = 0; offset < streams.size(); offset += 4096)
+        {
+            sink = sink ^ static_cast<uint8_t>(streams[offset]);
+        }
+        return model;
+    }
+
+    PreparedModelResult loadPreparedModel(const std::filesystem::path &source, const ModelLoadOptions &options)
+    {
+        const auto start = Clock::now();
+        PreparedModelResult result;
+        auto finish = [&]()
+        {
+            result.millis = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            return std::move(result);
+        };
+
+        uint64_t hash = 0;
+        std::filesystem::path cooked;
+        std::string error;
+        // A source that cannot be hashed cannot be read either; the import reports why.
+        if (!options.cacheDir.empty() && hashModelSource(source, options.prepare, hash, error))
+        {
+            cooked = cookedModelPath(options.cacheDir, hash);
+            std::error_code ec;
+            if (std::filesystem::exists(cooked, ec))
+            {
+                if (auto model = readCookedModel(cooked, hash, error))
+                {
+                    result.model = std::move(model);
+                    result.fromCache = true;
+                    return finish();
+                }
+                std::cerr << "ModelCache: Ignoring " << cooked.string() << ": " << error << "." << std::endl;
+            }
+        }
+
+        auto loaded = openchordix::assets::loadGltfAsset(source, options.gltf);
+        if (!loaded.ok())
+        {
+            result.error = loaded.error;
+            return finish();
+        }
+        result.model = ModelBuilder::prepare(std::move(*loaded.asset), options.prepare);
+
+        if (!cooked.empty() && !result.model->meshes.empty())
+        {
+            std::error_code ec;
+            std::filesystem::create_directories(options.cacheDir, ec);
+            if (!writeCookedModel(cooked, *result.model, hash, error))
+            {
+                std::cerr << "ModelCache: " << error << std::endl;
+            }
+        }
+        return finish();
+    }
+}
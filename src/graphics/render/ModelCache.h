@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "gltf/GltfAsset.h"
+#include "render/ModelBuilder.h"
+
+namespace openchordix::render
+{
+    struct ModelLoadOptions
+    {
+        openchordix::assets::GltfLoadOptions gltf;
+        ModelPrepareOptions prepare;
+        std::filesystem::path cacheDir; // Cooked models; empty always imports
+    };
+
+    struct PreparedModelResult
+    {
+        std::optional<PreparedModel> model;
+        std::string error;
+        bool fromCache = false;
+        double millis = 0.0;
+    };
+
+    // Cache key of a glTF source: its bytes, the path, size and modification time of
+    // every external file its JSON references, the cooked format version and the
+    // prepare options that change what gets cooked.
+    bool hashModelSource(const std::filesystem::path &source, const ModelPrepareOptions &prepare, uint64_t &hash,
+                         std::string &error);
+    std::filesystem::path cookedModelPath(const std::filesystem::path &cacheDir, uint64_t sourceHash);
+
+    bool writeCookedModel(const std::filesystem::path &path, const PreparedModel &model, uint64_t sourceHash,
+                          std::string &error);
+    // Maps the file and validates every table against it; the result uploads
+    // straight from the mapping.
+    std::optional<PreparedModel> readCookedModel(const std::filesystem::path &path, uint64_t sourceHash,
+                                                 std::string &error);
+
+    // The cooked copy when a valid one exists; otherwise imports and prepares the
+    // glTF and cooks it for next time. Runs on any thread.
+    PreparedModelResult loadPreparedModel(const std::filesystem::path &source, const ModelLoadOptions &options = {});
+}
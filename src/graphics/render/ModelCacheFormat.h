@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of cooked .ocmodel files. Everything is little-endian and every
+// section starts on an 8-byte boundary, so a mapped file is uploaded in place.
+//
+//   CookedModelHeader
+//   CookedMaterial[materialCount]
+//   CookedTexture[textureCount]
+//   CookedMesh[meshCount]
+//   CookedNode[nodeCount], depth first
+//   CookedInstance[instanceCount], sorted by node
+//   streams: mipped RGBA8 textures, vertex and index buffers; offsets in the
+//            tables are relative to streamOffset
+namespace modelcache
+{
+    inline constexpr char kMagic[8] = {'O', 'C', 'M', 'O', 'D', 'E', 'L', '\0'};
+    // Bump whenever the loader, prepare() or this layout changes what gets cooked.
+    inline constexpr uint32_t kVersion = 5;
+    inline constexpr uint64_t kAlignment = 8;
+
+    struct CookedModelHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t vertexStride; // Of VertexFormat::Full
+        uint64_t sourceHash;
+        uint32_t materialCount;
+        uint32_t textureCount;
+        uint32_t meshCount;
+        uint32_t nodeCount;
+        uint32_t instanceCount;
+        uint32_t reserved;
+        uint64_t materialOffset;
+        uint64_t textureOffset;
+        uint64_t meshOffset;
+        uint64_t nodeOffset;
+        uint64_t instanceOffset;
+        uint64_t streamOffset;
+        uint64_t streamSize;
+        uint64_t fileSize;
+    };
+
+    struct CookedMaterial
+    {
+        float baseColorFactor[4];
+        float emissiveFactor[3];
+        float metallicFactor;
+        float roughnessFactor;
+        float emissiveStrength;
+        float alphaCutoff;
+        float normalScale;
+        float occlusionStrength;
+        uint32_t alphaMode;
+        uint32_t doubleSided;
+        uint32_t textures[5]; // Base colour, metallic-roughness, normal, occlusion, emissive
+    };
+
+    struct CookedTexture
+    {
+        uint16_t width;
+        uint16_t height;
+        uint8_t mipCount;
+        uint8_t srgb;
+        uint16_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    struct CookedLod
+    {
+        uint32_t firstIndex;
+        uint32_t indexCount;
+        float error;
+    };
+
+    struct CookedMesh
+    {
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint16_t materialIndex;
+        uint8_t index32;
+        uint8_t vertexFormat; // VertexFormat; the stride follows from it
+        float boundsMin[3];
+        float boundsMax[3];
+        uint32_t lodCount;
+        CookedLod lods[4]; // Index ranges within indexCount, level 0 first
+    };
+
+    struct CookedNode
+    {
+        int32_t parent; // -1 for a root
+        float translation[3];
+        float rotation[4]; // Quaternion, xyzw
+        float scale[3];
+        uint32_t reserved;
+    };
+
+    struct CookedInstance
+    {
+        uint32_t mesh;
+        uint32_t node;
+    };
+
+    static_assert(sizeof(CookedModelHeader) == 112);
+    static_assert(sizeof(CookedMaterial) == 80);
+    static_assert(sizeof(CookedTexture) == 24);
+    static_assert(sizeof(CookedLod) == 12);
+    static_assert(sizeof(CookedMesh) == 104);
+    static_assert(sizeof(CookedNode) == 48);
+    static_assert(sizeof(CookedInstance) == 8);
+}
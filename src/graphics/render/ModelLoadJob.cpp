@@ -0,0 +1,92 @@
+#include "render/ModelLoadJob.h"
+
+#include <chrono>
+#include <exception>
+#include <utility>
+
+namespace openchordix::render
+{
+    ModelLoadJob::ModelLoadJob(std::filesystem::path path, ModelLoadOptions options)
+        : path_(std::move(path))
+    {
+        read_ = std::async(std::launch::async, [path = path_, options = std::move(options)]()
+                           {
+                               try
+                               {
+                                   return loadPreparedModel(path, options);
+                               }
+                               catch (const std::exception &ex)
+                               {
+                                   PreparedModelResult result;
+                                   result.error = ex.what();
+                                   return result;
+                               } });
+    }
+
+    bool ModelLoadJob::update(ModelRenderer &renderer, const ModelUploadBudget &budget)
+    {
+        if (stage_ == ModelLoadStage::Reading)
+        {
+            if (!idle())
+            {
+                return false;
+            }
+
+            PreparedModelResult result = read_.get();
+            if (!result.model)
+            {
+                error_ = std::move(result.error);
+                stage_ = ModelLoadStage::Failed;
+                return true;
+            }
+            if (result.model->meshes.empty())
+            {
+                error_ = "Model contains no mesh primitives.";
+                stage_ = ModelLoadStage::Failed;
+                return true;
+            }
+            fromCache_ = result.fromCache;
+            upload_.emplace(std::move(*result.model));
+            stage_ = ModelLoadStage::Uploading;
+            // The first upload step waits for the next frame, so the frame that
+            // finished reading does not also pay for it.
+            return false;
+        }
+
+        if (stage_ == ModelLoadStage::Uploading && upload_->step(renderer, budget))
+        {
+            stage_ = ModelLoadStage::Done;
+        }
+        return stage_ == ModelLoadStage::Done || stage_ == ModelLoadStage::Failed;
+    }
+
+    bool ModelLoadJob::idle() const
+    {
+        return !read_.valid() || read_.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    ModelLoadProgress ModelLoadJob::progress() const
+    {
+        ModelLoadProgress progress{stage_, 0.0f};
+        if (stage_ == ModelLoadStage::Uploading)
+        {
+            progress.fraction = upload_->progress();
+        }
+        else if (stage_ == ModelLoadStage::Done)
+        {
+            progress.fraction = 1.0f;
+        }
+        return progress;
+    }
+
+    Model ModelLoadJob::take()
+    {
+        if (stage_ != ModelLoadStage::Done || !upload_)
+        {
+            return {};
+        }
+        Model model = upload_->take();
+        upload_.reset();
+        return model;
+    }
+}
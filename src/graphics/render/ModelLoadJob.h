@@ -0,0 +1,64 @@
+#pragma once
+
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <string>
+
+#include "render/Model.h"
+#include "render/ModelBuilder.h"
+#include "render/ModelCache.h"
+
+namespace openchordix::render
+{
+    class ModelRenderer;
+
+    enum class ModelLoadStage
+    {
+        Reading,   // Cooked model or glTF import on a background thread
+        Uploading, // Creating bgfx resources, a budget's worth per update()
+        Done,
+        Failed
+    };
+
+    struct ModelLoadProgress
+    {
+        ModelLoadStage stage = ModelLoadStage::Reading;
+        float fraction = 0.0f; // Of the upload; 0 while reading
+    };
+
+    // Loads a glTF model without stalling the frame. The constructor starts the CPU
+    // work on its own thread; update() is called once per frame on the main thread
+    // and creates GPU resources within the budget once that work is ready.
+    class ModelLoadJob
+    {
+    public:
+        ModelLoadJob(std::filesystem::path path, ModelLoadOptions options = {});
+        // Waits for the background read if it is still running.
+        ~ModelLoadJob() = default;
+
+        ModelLoadJob(const ModelLoadJob &) = delete;
+        ModelLoadJob &operator=(const ModelLoadJob &) = delete;
+
+        // Returns true once the job is Done or Failed.
+        bool update(ModelRenderer &renderer, const ModelUploadBudget &budget = {});
+        // True when the background read has finished, so destroying the job is cheap.
+        bool idle() const;
+
+        ModelLoadProgress progress() const;
+        const std::filesystem::path &path() const { return path_; }
+        const std::string &error() const { return error_; }
+        // Once past Reading: whether the model came from the cooked cache.
+        bool fromCache() const { return fromCache_; }
+        // Valid once Done; leaves the job empty.
+        Model take();
+
+    private:
+        std::filesystem::path path_;
+        std::future<PreparedModelResult> read_;
+        std::optional<ModelUpload> upload_;
+        ModelLoadStage stage_ = ModelLoadStage::Reading;
+        std::string error_;
+        bool fromCache_ = false;
+    };
+}
@@ -0,0 +1,109 @@
+#include "render/ModelRenderQueue.h"
+
+#include <algorithm>
+#include <tuple>
+
+namespace openchordix::render
+{
+    namespace
+    {
+        std::array<uint16_t, 5> textureKey(const std::array<bgfx::TextureHandle, 5> &textures)
+        {
+            std::array<uint16_t, 5> key{};
+            std::ranges::transform(textures, key.begin(), [](bgfx::TextureHandle handle) { return handle.idx; });
+            return key;
+        }
+
+        uint8_t changedUniforms(const ModelRenderQueue::UniformBlock &block,
+                                const ModelRenderQueue::UniformBlock *last,
+                                ModelRenderStats &stats)
+        {
+            uint8_t changed = 0;
+            for (std::size_t i = 0; i < block.size(); ++i)
+            {
+                if (last && (*last)[i] == block[i])
+                {
+                    ++stats.uniformUpdatesSkipped;
+                    continue;
+                }
+                changed |= static_cast<uint8_t>(1u << i);
+                ++stats.uniformUpdates;
+            }
+            return changed;
+        }
+    }
+
+    ModelRenderStats &ModelRenderStats::operator+=(const ModelRenderStats &other)
+    {
+        submitted += other.submitted;
+        culled += other.culled;
+        dropped += other.dropped;
+        uniformUpdates += other.uniformUpdates;
+        uniformUpdatesSkipped += other.uniformUpdatesSkipped;
+        textureBinds += other.textureBinds;
+        textureBindsSkipped += other.textureBindsSkipped;
+        return *this;
+    }
+
+    void ModelRenderQueue::sort()
+    {
+        std::sort(draws.begin(), draws.end(),
+                  [](const Draw &a, const Draw &b)
+                  {
+                      if (a.viewId != b.viewId || a.pass != b.pass)
+                      {
+                          return std::tie(a.viewId, a.pass) < std::tie(b.viewId, b.pass);
+                      }
+                      if (a.pass == AlphaMode::Blend && a.distance != b.distance)
+                      {
+                          return a.distance > b.distance;
+                      }
+                      const auto aTextures = textureKey(a.textures);
+                      const auto bTextures = textureKey(b.textures);
+                      return std::tie(a.program.idx, a.state, a.material, aTextures, a.vertexBuffer.idx) <
+                             std::tie(b.program.idx, b.state, b.material, bTextures, b.vertexBuffer.idx);
+                  });
+    }
+
+    void ModelRenderQueue::clear()
+    {
+        frames.clear();
+        materials.clear();
+        draws.clear();
+        stats = {};
+    }
+
+    void ModelBindState::beginView()
+    {
+        frame_ = nullptr;
+        material_ = nullptr;
+        texturesBound_ = false;
+    }
+
+    ModelBindChanges ModelBindState::bind(const ModelRenderQueue &queue,
+                                          const ModelRenderQueue::Draw &draw,
+                                          ModelRenderStats &stats)
+    {
+        ModelBindChanges changes;
+        const ModelRenderQueue::UniformBlock &frame = queue.frames[draw.frame];
+        const ModelRenderQueue::UniformBlock &material = queue.materials[draw.material];
+        changes.frame = changedUniforms(frame, frame_, stats);
+        changes.material = changedUniforms(material, material_, stats);
+        frame_ = &frame;
+        material_ = &material;
+
+        for (std::size_t stage = 0; stage < draw.textures.size(); ++stage)
+        {
+            if (texturesBound_ && textures_[stage].idx == draw.textures[stage].idx)
+            {
+                ++stats.textureBindsSkipped;
+                continue;
+            }
+            changes.textures |= static_cast<uint8_t>(1u << stage);
+            ++stats.textureBinds;
+        }
+        textures_ = draw.textures;
+        texturesBound_ = true;
+        return changes;
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <bgfx/bgfx.h>
+
+#include "render/FrustumCull.h"
+#include "render/Matrix4.h"
+#include "render/Model.h"
+
+namespace openchordix::render
+{
+    struct ModelRenderStats
+    {
+        uint32_t submitted = 0; // Draw calls, one per mesh instance drawn
+        uint32_t culled = 0;    // Outside the view frustum; whole copies for queueInstances
+        uint32_t dropped = 0;   // Visible copies the transient instance buffer had no room for
+        uint32_t uniformUpdates = 0;
+        uint32_t uniformUpdatesSkipped = 0; // Value already set by the previous draw
+        uint32_t textureBinds = 0;
+        uint32_t textureBindsSkipped = 0; // Texture already bound to the stage
+
+        ModelRenderStats &operator+=(const ModelRenderStats &other);
+    };
+
+    // Draws gathered by ModelRenderer::queueModel, from any number of models, and
+    // issued together by ModelRenderer::submit in an order that lets consecutive
+    // draws share uniforms and textures. Keep one around to reuse its storage.
+    struct ModelRenderQueue
+    {
+        // Six vec4 uniforms: camera and lighting for a frame, or a material's
+        // factors followed by the glow colour and parameters.
+        using UniformBlock = std::array<std::array<float, 4>, 6>;
+
+        struct Draw
+        {
+            uint16_t viewId = 0;
+            AlphaMode pass = AlphaMode::Opaque; // Opaque, then mask, then blend
+            float distance = 0.0f;              // Camera to bounds centre; blend draws go far to near
+            bgfx::ProgramHandle program = BGFX_INVALID_HANDLE;
+            uint64_t state = 0;
+            uint32_t material = 0; // Into materials
+            uint32_t frame = 0;    // Into frames
+            std::array<bgfx::TextureHandle, 5> textures{}; // Sampler stage order
+            bgfx::VertexBufferHandle vertexBuffer = BGFX_INVALID_HANDLE;
+            bgfx::IndexBufferHandle indexBuffer = BGFX_INVALID_HANDLE;
+            MeshLod lod{};
+            Matrix4 transform{};
+            bgfx::InstanceDataBuffer instances{}; // num == 0 unless instanced
+        };
+
+        std::vector<UniformBlock> frames;
+        std::vector<UniformBlock> materials;
+        std::vector<Draw> draws;
+        std::vector<uint8_t> visible; // Cull results of the model being queued
+        CullBoxes copies;             // Bounds of each copy queued by queueInstances
+        ModelRenderStats stats;       // Culling so far; submit() adds the rest
+
+        // Orders draws by view, pass, program, state, material and textures, with
+        // blend draws back to front instead.
+        void sort();
+        void clear();
+    };
+
+    // Bit i is set for uniform i of a block, or sampler stage i, that has to be set.
+    struct ModelBindChanges
+    {
+        uint8_t frame = 0;
+        uint8_t material = 0;
+        uint8_t textures = 0;
+    };
+
+    // What the previous draw of a view left bound, so a draw only sets what differs.
+    // Nothing is assumed at the start of a view: other renderers may have set the
+    // same uniforms.
+    class ModelBindState
+    {
+    public:
+        void beginView();
+        // Compares the draw's bindings with the bound ones, counts them into `stats`
+        // and takes the draw's as bound.
+        ModelBindChanges bind(const ModelRenderQueue &queue, const ModelRenderQueue::Draw &draw, ModelRenderStats &stats);
+
+    private:
+        const ModelRenderQueue::UniformBlock *frame_ = nullptr;
+        const ModelRenderQueue::UniformBlock *material_ = nullptr;
+        std::array<bgfx::TextureHandle, 5> textures_{};
+        bool texturesBound_ = false;
+    };
+}
@@ -1,8 +1,12 @@
 #include "render/ModelRenderer.h"
 
 #include <algorithm>
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #include "render/ShaderLoader.h"
 
@@ -110,15 +114,19 @@ namespace openchordix::render
             return alpha < kAlphaEpsilon ? true : materialDoubleSided;
         }
 
+        // `tintAlpha` is the lowest alpha of the instance tints, which the shader
+        // applies on top of the base colour; it only picks the pass and state.
         MaterialParams buildMaterialParams(const ModelMaterial &material,
-                                            const ModelRenderSettings &settings)
+                                            const ModelRenderSettings &settings,
+                                            float tintAlpha)
         {
             MaterialParams params{};
             params.baseColor = computeBaseColor(material, settings);
             params.metallicRoughness = computeMetallicRoughness(material, settings);
             params.emissive = computeEmissive(material, settings);
-            params.alphaMode = resolveAlphaMode(material.alphaMode, settings.alphaModeOverride, params.baseColor[3]);
-            params.doubleSided = resolveDoubleSided(material.doubleSided, params.baseColor[3]);
+            const float alpha = params.baseColor[3] * tintAlpha;
+            params.alphaMode = resolveAlphaMode(material.alphaMode, settings.alphaModeOverride, alpha);
+            params.doubleSided = resolveDoubleSided(material.doubleSided, alpha);
 
             float alphaCutoff = params.alphaMode == AlphaMode::Mask ? material.alphaCutoff : -1.0f;
             params.miscParams = {alphaCutoff,
@@ -156,6 +164,133 @@ namespace openchordix::render
             }
             return state;
         }
+
+        // Per-copy data of an instanced draw, read as i_data0..i_data4.
+        struct InstanceData
+        {
+            Matrix4 transform{};
+            std::array<float, 4> tint{};
+        };
+        static_assert(sizeof(InstanceData) == 80, "instance stride must match i_data0..i_data4");
+        constexpr uint16_t kInstanceStride = sizeof(InstanceData);
+
+        // Everything a draw takes from its material, resolved once per material.
+        struct MaterialDraw
+        {
+            uint32_t uniforms = 0;
+            AlphaMode pass = AlphaMode::Opaque;
+            uint64_t state = 0;
+            std::array<bgfx::TextureHandle, 5> textures{};
+        };
+
+        uint32_t queueFrameUniforms(ModelRenderQueue &queue, const ModelFrame &frame)
+        {
+            const ModelRenderQueue::UniformBlock uniforms{{
+                {frame.cameraPos[0], frame.cameraPos[1], frame.cameraPos[2], 1.0f},
+                {frame.lightDir[0], frame.lightDir[1], frame.lightDir[2], 0.0f},
+                {frame.lightColor[0], frame.lightColor[1], frame.lightColor[2], frame.lightIntensity},
+                {frame.envTopColor[0], frame.envTopColor[1], frame.envTopColor[2], 1.0f},
+                {frame.envBottomColor[0], frame.envBottomColor[1], frame.envBottomColor[2], 1.0f},
+                {frame.envIntensity, 0.0f, 0.0f, 0.0f}}};
+            if (queue.frames.empty() || queue.frames.back() != uniforms)
+            {
+                queue.frames.push_back(uniforms);
+            }
+            return static_cast<uint32_t>(queue.frames.size() - 1);
+        }
+
+        std::vector<MaterialDraw> queueMaterials(ModelRenderQueue &queue,
+                                                 const Model &model,
+                                                 const ModelRenderSettings &settings,
+                                                 const ModelRenderer::DefaultTextures &defaults,
+                                                 float tintAlpha = 1.0f)
+        {
+            const GlowParams glow = buildGlowParams(settings);
+            std::vector<MaterialDraw> draws;
+            draws.reserve(model.materials.size());
+            for (const ModelMaterial &material : model.materials)
+            {
+                const MaterialParams params = buildMaterialParams(material, settings, tintAlpha);
+                MaterialDraw draw;
+                draw.uniforms = static_cast<uint32_t>(queue.materials.size());
+                draw.pass = params.alphaMode;
+                draw.state = computeState(params.alphaMode, params.doubleSided);
+                draw.textures = {resolveTexture(model, material.baseColorTexture, defaults.baseColor.get()),
+                                 resolveTexture(model, material.metallicRoughnessTexture, defaults.metallicRoughness.get()),
+                                 resolveTexture(model, material.normalTexture, defaults.normal.get()),
+                                 resolveTexture(model, material.emissiveTexture, defaults.emissive.get()),
+                                 resolveTexture(model, material.occlusionTexture, defaults.occlusion.get())};
+                queue.materials.push_back({params.baseColor, params.metallicRoughness, params.emissive, params.miscParams,
+                                           glow.color, glow.params});
+                draws.push_back(draw);
+            }
+            return draws;
+        }
+
+        // A draw of the mesh's full index range; the caller sets transform, LOD and distance.
+        ModelRenderQueue::Draw &queueMeshDraw(ModelRenderQueue &queue,
+                                              uint16_t viewId,
+                                              const ModelMesh &mesh,
+                                              const std::vector<MaterialDraw> &materials,
+                                              bgfx::ProgramHandle program,
+                                              uint32_t frameIndex)
+        {
+            const MaterialDraw &material = materials[mesh.materialIndex < materials.size() ? mesh.materialIndex : 0];
+            ModelRenderQueue::Draw &draw = queue.draws.emplace_back();
+            draw.viewId = viewId;
+            draw.pass = material.pass;
+            draw.program = program;
+            draw.state = material.state;
+            draw.material = material.uniforms;
+            draw.frame = frameIndex;
+            draw.textures = material.textures;
+            draw.vertexBuffer = mesh.vertexBuffer.get();
+            draw.indexBuffer = mesh.indexBuffer.get();
+            draw.lod = {0, mesh.indexCount, 0.0f};
+            return draw;
+        }
+
+        // LOD errors are in the mesh's own units, which the node may scale.
+        MeshLod selectLod(const ModelMesh &mesh, float pixelsPerUnit, const Matrix4 &nodeWorld, const ModelRenderSettings &settings)
+        {
+            if (mesh.lodCount <= 1 || settings.lodErrorPixels <= 0.0f)
+            {
+                return {0, mesh.indexCount, 0.0f};
+            }
+            const std::span<const MeshLod> lods(mesh.lods.data(), mesh.lodCount);
+            return lods[selectMeshLod(lods, pixelsPerUnit * maxAxisScale(nodeWorld.data()), settings.lodErrorPixels)];
+        }
+
+        float squaredDistance(float x, float y, float z, const ModelFrame &frame)
+        {
+            const float dx = x - frame.cameraPos[0];
+            const float dy = y - frame.cameraPos[1];
+            const float dz = z - frame.cameraPos[2];
+            return dx * dx + dy * dy + dz * dz;
+        }
+    }
+
+    float projectedPixelsPerUnit(const ModelBounds &bounds, const float *modelMtx, const ModelFrame &frame)
+    {
+        const float *m = modelMtx;
+        const std::array<float, 3> &c = bounds.center;
+        const float center[3] = {c[0] * m[0] + c[1] * m[4] + c[2] * m[8] + m[12],
+                                 c[0] * m[1] + c[1] * m[5] + c[2] * m[9] + m[13],
+                                 c[0] * m[2] + c[1] * m[6] + c[2] * m[10] + m[14]};
+        const float scale = maxAxisScale(m);
+        const float dx = center[0] - frame.cameraPos[0];
+        const float dy = center[1] - frame.cameraPos[1];
+        const float dz = center[2] - frame.cameraPos[2];
+        const float distance = std::sqrt(dx * dx + dy * dy + dz * dz);
+        const float radius = bounds.radius * scale;
+        if (bounds.radius <= 0.0f || distance <= radius)
+        {
+            return std::numeric_limits<float>::infinity();
+        }
+
+        // proj[5] is cot(fovy / 2), so this is the sphere's radius in pixels.
+        const float projectedRadius = radius / distance * frame.proj[5] * 0.5f * frame.viewportHeight;
+        return projectedRadius / bounds.radius;
     }
 
     bool ModelRenderer::initialize()
@@ -172,6 +307,13 @@ namespace openchordix::render
             .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Float)
             .end();
 
+        // PackedVertex: the normal/tangent frame rides in TexCoord1.
+        packedLayout_.begin()
+            .add(bgfx::Attrib::Position, 4, bgfx::AttribType::Half)
+            .add(bgfx::Attrib::TexCoord1, 4, bgfx::AttribType::Int16, true)
+            .add(bgfx::Attrib::TexCoord0, 2, bgfx::AttribType::Half)
+            .end();
+
         BgfxHandle<bgfx::ProgramHandle> program(loadEmbeddedProgram("vs_standard.bin", "fs_standard.bin"));
         if (!program.isValid())
         {
@@ -179,6 +321,34 @@ namespace openchordix::render
             return false;
         }
 
+        BgfxHandle<bgfx::ProgramHandle> packedProgram{};
+        if (bgfx::getCaps()->supported & BGFX_CAPS_VERTEX_ATTRIB_HALF)
+        {
+            packedProgram.reset(loadEmbeddedProgram("vs_standard_packed.bin", "fs_standard.bin"));
+            if (!packedProgram.isValid())
+            {
+                std::cerr << "ModelRenderer: Failed to load packed vertex shader, using full vertices." << std::endl;
+            }
+        }
+
+        BgfxHandle<bgfx::ProgramHandle> instancedProgram{};
+        BgfxHandle<bgfx::ProgramHandle> packedInstancedProgram{};
+        if (bgfx::getCaps()->supported & BGFX_CAPS_INSTANCING)
+        {
+            instancedProgram.reset(loadEmbeddedProgram("vs_standard_instanced.bin", "fs_standard.bin"));
+            if (packedProgram.isValid())
+            {
+                packedInstancedProgram.reset(loadEmbeddedProgram("vs_standard_packed_instanced.bin", "fs_standard.bin"));
+            }
+            // Models are built packed whenever they can be, so both variants are needed.
+            if (!instancedProgram.isValid() || (packedProgram.isValid() && !packedInstancedProgram.isValid()))
+            {
+                std::cerr << "ModelRenderer: Failed to load instanced vertex shaders, drawing copies one by one." << std::endl;
+                instancedProgram.reset();
+                packedInstancedProgram.reset();
+            }
+        }
+
         UniformSet uniforms{};
         uniforms.baseColorFactor.reset(bgfx::createUniform("u_baseColorFactor", bgfx::UniformType::Vec4));
         uniforms.metallicRoughness.reset(bgfx::createUniform("u_metallicRoughness", bgfx::UniformType::Vec4));
@@ -213,6 +383,9 @@ namespace openchordix::render
         }
 
         program_ = std::move(program);
+        packedProgram_ = std::move(packedProgram);
+        instancedProgram_ = std::move(instancedProgram);
+        packedInstancedProgram_ = std::move(packedInstancedProgram);
         uniforms_ = std::move(uniforms);
         samplers_ = std::move(samplers);
         defaults_ = std::move(defaults);
@@ -226,6 +399,9 @@ namespace openchordix::render
         defaults_.reset();
         samplers_.reset();
         uniforms_.reset();
+        packedInstancedProgram_.reset();
+        instancedProgram_.reset();
+        packedProgram_.reset();
         program_.reset();
         initialized_ = false;
     }
@@ -254,78 +430,296 @@ namespace openchordix::render
                                      mem);
     }
 
-    void ModelRenderer::renderModel(uint16_t viewId,
-                                    const Model &model,
-                                    const float *modelMtx,
-                                    const ModelFrame &frame,
-                                    const ModelRenderSettings &settings) const
+    bgfx::TextureHandle ModelRenderer::createTexture(uint16_t width,
+                                                     uint16_t height,
+                                                     uint8_t mipCount,
+                                                     bool srgb,
+                                                     std::span<const std::byte> levels) const
+    {
+        if (width == 0 || height == 0 || levels.empty())
+        {
+            return BGFX_INVALID_HANDLE;
+        }
+
+        uint64_t flags = 0;
+        if (srgb)
+        {
+            flags |= BGFX_TEXTURE_SRGB;
+        }
+
+        const bgfx::Memory *mem = bgfx::copy(levels.data(), static_cast<uint32_t>(levels.size()));
+        return bgfx::createTexture2D(width, height, mipCount > 1, 1, bgfx::TextureFormat::RGBA8, flags, mem);
+    }
+
+    ModelRenderStats ModelRenderer::renderModel(uint16_t viewId,
+                                                const Model &model,
+                                                const float *modelMtx,
+                                                const ModelFrame &frame,
+                                                const ModelRenderSettings &settings) const
+    {
+        queue_.clear();
+        queueModel(queue_, viewId, model, modelMtx, frame, settings);
+        return submit(queue_);
+    }
+
+    void ModelRenderer::queueModel(ModelRenderQueue &queue,
+                                   uint16_t viewId,
+                                   const Model &model,
+                                   const float *modelMtx,
+                                   const ModelFrame &frame,
+                                   const ModelRenderSettings &settings) const
     {
         if (!initialized_ || !program_.isValid() || model.meshes.empty() || model.materials.empty())
         {
             return;
         }
 
+        const std::size_t instanceCount = model.instances.size();
+        if (settings.frustumCulling)
+        {
+            queue.visible.resize(instanceCount);
+            const Frustum frustum = extractFrustum(frame.view.data(), frame.proj.data(), bgfx::getCaps()->homogeneousDepth);
+            const uint32_t culled = static_cast<uint32_t>(instanceCount) -
+                                    cullBoxes(frustum, modelMtx, model.instanceBoxes, queue.visible);
+            queue.stats.culled += culled;
+            if (culled == instanceCount)
+            {
+                return;
+            }
+        }
+
         bgfx::setViewTransform(viewId, frame.view.data(), frame.proj.data());
+        const uint32_t frameIndex = queueFrameUniforms(queue, frame);
+        const std::vector<MaterialDraw> materials = queueMaterials(queue, model, settings, defaults_);
 
-        float cameraPos[4] = {frame.cameraPos[0], frame.cameraPos[1], frame.cameraPos[2], 1.0f};
-        bgfx::setUniform(uniforms_.cameraPos.get(), cameraPos);
+        const float pixelsPerUnit = projectedPixelsPerUnit(model.bounds, modelMtx, frame);
+        const CullBoxes &boxes = model.instanceBoxes;
+        for (std::size_t instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
+        {
+            const MeshInstance &instance = model.instances[instanceIndex];
+            const ModelMesh &mesh = model.meshes[instance.mesh];
+            if ((settings.frustumCulling && !queue.visible[instanceIndex]) || !mesh.vertexBuffer.isValid() ||
+                !mesh.indexBuffer.isValid() || mesh.indexCount == 0 ||
+                (mesh.vertexFormat == VertexFormat::Packed && !packedProgram_.isValid()))
+            {
+                continue;
+            }
 
-        float lightDir[4] = {frame.lightDir[0], frame.lightDir[1], frame.lightDir[2], 0.0f};
-        bgfx::setUniform(uniforms_.lightDir.get(), lightDir);
+            const bgfx::ProgramHandle program =
+                mesh.vertexFormat == VertexFormat::Packed ? packedProgram_.get() : program_.get();
+            ModelRenderQueue::Draw &draw = queueMeshDraw(queue, viewId, mesh, materials, program, frameIndex);
+            const Matrix4 &nodeWorld = model.nodes.world(instance.node);
+            multiplyMatrices(draw.transform.data(), nodeWorld.data(), modelMtx);
+            draw.lod = selectLod(mesh, pixelsPerUnit, nodeWorld, settings);
 
-        float lightColor[4] = {frame.lightColor[0], frame.lightColor[1], frame.lightColor[2], frame.lightIntensity};
-        bgfx::setUniform(uniforms_.lightColor.get(), lightColor);
+            if (draw.pass == AlphaMode::Blend && instanceIndex < boxes.count)
+            {
+                const float *m = modelMtx;
+                const float x = boxes.centerX[instanceIndex];
+                const float y = boxes.centerY[instanceIndex];
+                const float z = boxes.centerZ[instanceIndex];
+                draw.distance = squaredDistance(x * m[0] + y * m[4] + z * m[8] + m[12],
+                                                x * m[1] + y * m[5] + z * m[9] + m[13],
+                                                x * m[2] + y * m[6] + z * m[10] + m[14], frame);
+            }
+        }
+    }
 
-        float envTop[4] = {frame.envTopColor[0], frame.envTopColor[1], frame.envTopColor[2], 1.0f};
-        float envBottom[4] = {frame.envBottomColor[0], frame.envBottomColor[1], frame.envBottomColor[2], 1.0f};
-        float envParams[4] = {frame.envIntensity, 0.0f, 0.0f, 0.0f};
-        bgfx::setUniform(uniforms_.envTop.get(), envTop);
-        bgfx::setUniform(uniforms_.envBottom.get(), envBottom);
-        bgfx::setUniform(uniforms_.envParams.get(), envParams);
+    ModelRenderStats ModelRenderer::renderInstances(uint16_t viewId,
+                                                    const Model &model,
+                                                    std::span<const Matrix4> transforms,
+                                                    const ModelFrame &frame,
+                                                    const ModelRenderSettings &settings,
+                                                    std::span<const std::array<float, 4>> tints) const
+    {
+        queue_.clear();
+        queueInstances(queue_, viewId, model, transforms, frame, settings, tints);
+        return submit(queue_);
+    }
 
-        GlowParams glow = buildGlowParams(settings);
+    void ModelRenderer::queueInstances(ModelRenderQueue &queue,
+                                       uint16_t viewId,
+                                       const Model &model,
+                                       std::span<const Matrix4> transforms,
+                                       const ModelFrame &frame,
+                                       const ModelRenderSettings &settings,
+                                       std::span<const std::array<float, 4>> tints) const
+    {
+        if (!initialized_ || !program_.isValid() || model.meshes.empty() || model.materials.empty() || transforms.empty())
+        {
+            return;
+        }
 
-        for (const auto &mesh : model.meshes)
+        if (!instancedProgram_.isValid())
         {
-            if (!mesh.vertexBuffer.isValid() || !mesh.indexBuffer.isValid() || mesh.indexCount == 0)
+            ModelRenderSettings copySettings = settings;
+            for (std::size_t copy = 0; copy < transforms.size(); ++copy)
             {
-                continue;
+                if (copy < tints.size())
+                {
+                    for (std::size_t channel = 0; channel < 4; ++channel)
+                    {
+                        copySettings.tint[channel] = settings.tint[channel] * tints[copy][channel];
+                    }
+                }
+                queueModel(queue, viewId, model, transforms[copy].data(), frame, copySettings);
             }
+            return;
+        }
+
+        // Copies are culled whole, by the model's bounds placed by each transform.
+        const std::size_t copyCount = transforms.size();
+        CullBoxes &copies = queue.copies;
+        copies.resize(copyCount);
+        for (std::size_t copy = 0; copy < copyCount; ++copy)
+        {
+            std::array<float, 3> min{};
+            std::array<float, 3> max{};
+            transformBounds(transforms[copy].data(), model.bounds.min, model.bounds.max, min, max);
+            copies.set(copy, min, max);
+        }
+
+        queue.visible.assign(copyCount, 1);
+        uint32_t visibleCount = static_cast<uint32_t>(copyCount);
+        if (settings.frustumCulling)
+        {
+            const Frustum frustum = extractFrustum(frame.view.data(), frame.proj.data(), bgfx::getCaps()->homogeneousDepth);
+            visibleCount = cullBoxes(frustum, kIdentityMatrix.data(), copies, queue.visible);
+            queue.stats.culled += static_cast<uint32_t>(copyCount) - visibleCount;
+        }
 
-            const ModelMaterial &material = mesh.materialIndex < model.materials.size()
-                                                ? model.materials[mesh.materialIndex]
-                                                : model.materials.front();
+        const uint32_t available = bgfx::getAvailInstanceDataBuffer(visibleCount, kInstanceStride);
+        queue.stats.dropped += visibleCount - available;
+        if (available == 0)
+        {
+            return;
+        }
 
-            MaterialParams params = buildMaterialParams(material, settings);
+        bgfx::InstanceDataBuffer buffer;
+        bgfx::allocInstanceDataBuffer(&buffer, available, kInstanceStride);
+        uint32_t written = 0;
+        float pixelsPerUnit = 0.0f;
+        float nearest = std::numeric_limits<float>::max();
+        float tintAlpha = 1.0f;
+        for (std::size_t copy = 0; copy < copyCount && written < available; ++copy)
+        {
+            if (!queue.visible[copy])
+            {
+                continue;
+            }
+            InstanceData instance;
+            instance.transform = transforms[copy];
+            instance.tint = copy < tints.size() ? tints[copy] : std::array<float, 4>{1.0f, 1.0f, 1.0f, 1.0f};
+            std::memcpy(buffer.data + static_cast<std::size_t>(written++) * kInstanceStride, &instance, kInstanceStride);
+            tintAlpha = std::min(tintAlpha, instance.tint[3]);
+            pixelsPerUnit = std::max(pixelsPerUnit, projectedPixelsPerUnit(model.bounds, transforms[copy].data(), frame));
+            nearest = std::min(nearest, squaredDistance(copies.centerX[copy], copies.centerY[copy], copies.centerZ[copy], frame));
+        }
+
+        bgfx::setViewTransform(viewId, frame.view.data(), frame.proj.data());
+        const uint32_t frameIndex = queueFrameUniforms(queue, frame);
+        const std::vector<MaterialDraw> materials = queueMaterials(queue, model, settings, defaults_, tintAlpha);
 
-            bgfx::setTransform(modelMtx);
-            bgfx::setVertexBuffer(0, mesh.vertexBuffer.get());
-            bgfx::setIndexBuffer(mesh.indexBuffer.get(), 0, mesh.indexCount);
+        // The buffer lives for the whole frame, so every mesh instance shares it;
+        // u_model carries the node transform and the instance places the copy.
+        for (const MeshInstance &instance : model.instances)
+        {
+            const ModelMesh &mesh = model.meshes[instance.mesh];
+            if (!mesh.vertexBuffer.isValid() || !mesh.indexBuffer.isValid() || mesh.indexCount == 0 ||
+                (mesh.vertexFormat == VertexFormat::Packed && !packedInstancedProgram_.isValid()))
+            {
+                continue;
+            }
 
-            bgfx::setUniform(uniforms_.baseColorFactor.get(), params.baseColor.data());
-            bgfx::setUniform(uniforms_.metallicRoughness.get(), params.metallicRoughness.data());
-            bgfx::setUniform(uniforms_.emissiveFactor.get(), params.emissive.data());
-            bgfx::setUniform(uniforms_.miscParams.get(), params.miscParams.data());
-            bgfx::setUniform(uniforms_.glowColor.get(), glow.color.data());
-            bgfx::setUniform(uniforms_.glowParams.get(), glow.params.data());
+            const bgfx::ProgramHandle program =
+                mesh.vertexFormat == VertexFormat::Packed ? packedInstancedProgram_.get() : instancedProgram_.get();
+            ModelRenderQueue::Draw &draw = queueMeshDraw(queue, viewId, mesh, materials, program, frameIndex);
+            const Matrix4 &nodeWorld = model.nodes.world(instance.node);
+            draw.transform = nodeWorld;
+            draw.lod = selectLod(mesh, pixelsPerUnit, nodeWorld, settings);
+            draw.distance = draw.pass == AlphaMode::Blend ? nearest : 0.0f;
+            draw.instances = buffer;
+        }
+    }
 
-            bgfx::TextureHandle baseColorTex = resolveTexture(model, material.baseColorTexture, defaults_.baseColor.get());
-            bgfx::TextureHandle metallicRoughnessTex = resolveTexture(model, material.metallicRoughnessTexture, defaults_.metallicRoughness.get());
-            bgfx::TextureHandle normalTex = resolveTexture(model, material.normalTexture, defaults_.normal.get());
-            bgfx::TextureHandle emissiveTex = resolveTexture(model, material.emissiveTexture, defaults_.emissive.get());
-            bgfx::TextureHandle occlusionTex = resolveTexture(model, material.occlusionTexture, defaults_.occlusion.get());
+    ModelRenderStats ModelRenderer::submit(ModelRenderQueue &queue) const
+    {
+        ModelRenderStats stats = queue.stats;
+        std::vector<ModelRenderQueue::Draw> &draws = queue.draws;
+        if (draws.empty())
+        {
+            queue.clear();
+            return stats;
+        }
 
-            bgfx::setTexture(0, samplers_.baseColor.get(), baseColorTex);
-            bgfx::setTexture(1, samplers_.metallicRoughness.get(), metallicRoughnessTex);
-            bgfx::setTexture(2, samplers_.normal.get(), normalTex);
-            bgfx::setTexture(3, samplers_.emissive.get(), emissiveTex);
-            bgfx::setTexture(4, samplers_.occlusion.get(), occlusionTex);
+        queue.sort();
+
+        const std::array<bgfx::UniformHandle, 6> frameHandles{uniforms_.cameraPos.get(), uniforms_.lightDir.get(),
+                                                               uniforms_.lightColor.get(), uniforms_.envTop.get(),
+                                                               uniforms_.envBottom.get(), uniforms_.envParams.get()};
+        const std::array<bgfx::UniformHandle, 6> materialHandles{uniforms_.baseColorFactor.get(),
+                                                                  uniforms_.metallicRoughness.get(),
+                                                                  uniforms_.emissiveFactor.get(),
+                                                                  uniforms_.miscParams.get(),
+                                                                  uniforms_.glowColor.get(),
+                                                                  uniforms_.glowParams.get()};
+        const std::array<bgfx::UniformHandle, 5> samplerHandles{samplers_.baseColor.get(), samplers_.metallicRoughness.get(),
+                                                                 samplers_.normal.get(), samplers_.emissive.get(),
+                                                                 samplers_.occlusion.get()};
+
+        ModelBindState binds;
+        for (std::size_t i = 0; i < draws.size(); ++i)
+        {
+            const ModelRenderQueue::Draw &draw = draws[i];
+            if (i == 0 || draws[i - 1].viewId != draw.viewId)
+            {
+                binds.beginView();
+            }
 
-            uint64_t state = computeState(params.alphaMode, params.doubleSided);
+            const ModelBindChanges changes = binds.bind(queue, draw, stats);
+            const ModelRenderQueue::UniformBlock &frameBlock = queue.frames[draw.frame];
+            const ModelRenderQueue::UniformBlock &materialBlock = queue.materials[draw.material];
+            for (std::size_t k = 0; k < frameBlock.size(); ++k)
+            {
+                if (changes.frame & (1u << k))
+                {
+                    bgfx::setUniform(frameHandles[k], frameBlock[k].data());
+                }
+                if (changes.material & (1u << k))
+                {
+                    bgfx::setUniform(materialHandles[k], materialBlock[k].data());
+                }
+            }
+            for (std::size_t stage = 0; stage < draw.textures.size(); ++stage)
+            {
+                if (changes.textures & (1u << stage))
+                {
+                    bgfx::setTexture(static_cast<uint8_t>(stage), samplerHandles[stage], draw.textures[stage]);
+                }
+            }
 
-            bgfx::setState(state);
-            bgfx::submit(viewId, program_.get());
+            bgfx::setTransform(draw.transform.data());
+            bgfx::setVertexBuffer(0, draw.vertexBuffer);
+            const bool instanced = draw.instances.num > 0;
+            if (instanced)
+            {
+                bgfx::setInstanceDataBuffer(&draw.instances);
+            }
+            bgfx::setIndexBuffer(draw.indexBuffer, draw.lod.firstIndex, draw.lod.indexCount);
+            bgfx::setState(draw.state);
+
+            // Keep bindings for the next draw of the view; its last draw clears
+            // everything so nothing leaks into other renderers. Instance data is
+            // always dropped, or the next non-instanced draw would inherit it.
+            const bool lastOfView = i + 1 == draws.size() || draws[i + 1].viewId != draw.viewId;
+            const uint8_t discard = lastOfView ? BGFX_DISCARD_ALL
+                                               : (instanced ? BGFX_DISCARD_INSTANCE_DATA : BGFX_DISCARD_NONE);
+            bgfx::submit(draw.viewId, draw.program, 0, discard);
+            ++stats.submitted;
         }
+
+        queue.clear();
+        return stats;
     }
 
     bgfx::TextureHandle ModelRenderer::createSolidTexture(uint32_t rgba, bool srgb)
@@ -1,13 +1,17 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <span>
+#include <vector>
 
 #include <bgfx/bgfx.h>
 
 #include "gltf/GltfAsset.h"
 #include "render/BgfxHandle.h"
 #include "render/Model.h"
+#include "render/ModelRenderQueue.h"
 
 namespace openchordix::render
 {
@@ -22,6 +26,7 @@ namespace openchordix::render
         std::array<float, 3> envTopColor{0.12f, 0.14f, 0.18f};
         std::array<float, 3> envBottomColor{0.03f, 0.03f, 0.04f};
         float envIntensity = 1.2f;
+        float viewportHeight = 720.0f; // Pixels; scales LOD selection
     };
 
     struct ModelRenderSettings
@@ -47,8 +52,14 @@ namespace openchordix::render
         std::array<float, 3> glowColor{1.0f, 1.0f, 1.0f};
         float glowIntensity = 1.0f;
         float glowPower = 2.0f;
+        float lodErrorPixels = 1.0f; // Largest on-screen error a coarser LOD may show; 0 keeps full detail
+        bool frustumCulling = true;  // Skip meshes whose bounds are outside the view
     };
 
+    // Screen pixels covered by one object-space unit of the model, from the
+    // projected size of its bounding sphere. Infinite with the camera inside it.
+    float projectedPixelsPerUnit(const ModelBounds &bounds, const float *modelMtx, const ModelFrame &frame);
+
     class ModelRenderer
     {
     public:
@@ -159,24 +170,80 @@ namespace openchordix::render
 
         bool isInitialized() const { return initialized_; }
         const bgfx::VertexLayout &vertexLayout() const { return layout_; }
+        const bgfx::VertexLayout &vertexLayout(VertexFormat format) const
+        {
+            return format == VertexFormat::Packed ? packedLayout_ : layout_;
+        }
+        // Half-float attributes and the packed shader variant are both available.
+        bool supportsPackedVertices() const { return packedProgram_.isValid(); }
+        // queueInstances draws every copy of a mesh in one submit; without it,
+        // each copy is queued as a model of its own.
+        bool supportsInstancing() const { return instancedProgram_.isValid(); }
         const DefaultTextures &defaults() const { return defaults_; }
 
         bgfx::TextureHandle createTextureFromImage(const openchordix::assets::ImageData &image,
                                                    bool srgb) const;
-
-        void renderModel(uint16_t viewId,
-                         const Model &model,
-                         const float *modelMtx,
-                         const ModelFrame &frame,
-                         const ModelRenderSettings &settings) const;
+        // RGBA8 texture from `mipCount` levels packed largest first.
+        bgfx::TextureHandle createTexture(uint16_t width,
+                                          uint16_t height,
+                                          uint8_t mipCount,
+                                          bool srgb,
+                                          std::span<const std::byte> levels) const;
+
+        // queueModel then submit on an internal queue, for a model drawn on its own.
+        ModelRenderStats renderModel(uint16_t viewId,
+                                     const Model &model,
+                                     const float *modelMtx,
+                                     const ModelFrame &frame,
+                                     const ModelRenderSettings &settings) const;
+
+        // Culls the model's instances and adds the visible ones to `queue`; sets
+        // the view transform right away.
+        void queueModel(ModelRenderQueue &queue,
+                        uint16_t viewId,
+                        const Model &model,
+                        const float *modelMtx,
+                        const ModelFrame &frame,
+                        const ModelRenderSettings &settings) const;
+        // queueInstances then submit on the internal queue.
+        ModelRenderStats renderInstances(uint16_t viewId,
+                                         const Model &model,
+                                         std::span<const Matrix4> transforms,
+                                         const ModelFrame &frame,
+                                         const ModelRenderSettings &settings,
+                                         std::span<const std::array<float, 4>> tints = {}) const;
+
+        // Queues one copy of the model per transform, each mesh instance as a
+        // single instanced draw. Copies are culled and packed with their tint
+        // (white past the end of `tints`) into one transient instance buffer that
+        // all the model's draws share. Every draw uses the LOD the nearest copy
+        // asks for, and blended draws sort by the nearest copy too. A tint alpha
+        // below one on any copy moves all the model's draws to the blend pass,
+        // as queueModel does for a translucent tint.
+        void queueInstances(ModelRenderQueue &queue,
+                            uint16_t viewId,
+                            const Model &model,
+                            std::span<const Matrix4> transforms,
+                            const ModelFrame &frame,
+                            const ModelRenderSettings &settings,
+                            std::span<const std::array<float, 4>> tints = {}) const;
+        // Sorts the queue, submits everything and empties it. Draws rely on the
+        // uniforms and textures the previous one set, so the views must be in
+        // sequential mode, as GraphicsContext sets kViewIdScene up.
+        ModelRenderStats submit(ModelRenderQueue &queue) const;
 
     private:
         BgfxHandle<bgfx::ProgramHandle> program_{};
+        BgfxHandle<bgfx::ProgramHandle> packedProgram_{};
+        BgfxHandle<bgfx::ProgramHandle> instancedProgram_{};
+        BgfxHandle<bgfx::ProgramHandle> packedInstancedProgram_{};
         UniformSet uniforms_{};
         SamplerSet samplers_{};
         bgfx::VertexLayout layout_{};
+        bgfx::VertexLayout packedLayout_{};
         DefaultTextures defaults_{};
         bool initialized_ = false;
+        mutable ModelRenderQueue queue_; // renderModel's, reused across calls
 
         static bgfx::TextureHandle createSolidTexture(uint32_t rgba, bool srgb);
     };
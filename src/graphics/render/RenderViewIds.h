@@ -4,6 +4,7 @@
 
 namespace openchordix::render
 {
+    // Sequential: draws run in submission order, set up once with the renderer.
     constexpr uint16_t kViewIdScene = 0;
     constexpr uint16_t kViewIdUi = 1;
 }
@@ -0,0 +1,165 @@
+#include "render/TransformHierarchy.h"
+
+#include <algorithm>
+
+namespace openchordix::render
+{
+    bool isDepthFirst(std::span<const NodeTransform> nodes)
+    {
+        for (std::size_t i = 0; i < nodes.size(); ++i)
+        {
+            const int32_t parent = nodes[i].parent;
+            if (parent < -1 || parent >= static_cast<int32_t>(i))
+            {
+                return false;
+            }
+            // The node before a child is its parent or one of the parent's
+            // descendants; anything else would split the parent's run.
+            if (parent >= 0)
+            {
+                int32_t ancestor = static_cast<int32_t>(i) - 1;
+                while (ancestor > parent)
+                {
+                    ancestor = nodes[ancestor].parent;
+                }
+                if (ancestor != parent)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void TransformHierarchy::assign(std::span<const NodeTransform> nodes)
+    {
+        clear();
+        const std::size_t count = nodes.size();
+        parent_.resize(count);
+        subtreeEnd_.resize(count);
+        for (auto *component : {&translationX_, &translationY_, &translationZ_, &rotationX_, &rotationY_, &rotationZ_,
+                                &rotationW_, &scaleX_, &scaleY_, &scaleZ_})
+        {
+            component->resize(count);
+        }
+        world_.assign(count, kIdentityMatrix);
+        isDirty_.assign(count, 0);
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const NodeTransform &node = nodes[i];
+            parent_[i] = node.parent;
+            subtreeEnd_[i] = static_cast<uint32_t>(i + 1);
+            translationX_[i] = node.translation[0];
+            translationY_[i] = node.translation[1];
+            translationZ_[i] = node.translation[2];
+            rotationX_[i] = node.rotation[0];
+            rotationY_[i] = node.rotation[1];
+            rotationZ_[i] = node.rotation[2];
+            rotationW_[i] = node.rotation[3];
+            scaleX_[i] = node.scale[0];
+            scaleY_[i] = node.scale[1];
+            scaleZ_[i] = node.scale[2];
+        }
+        // Children come after parents, so one backward pass carries each run's end up.
+        for (std::size_t i = count; i-- > 0;)
+        {
+            if (parent_[i] >= 0)
+            {
+                uint32_t &end = subtreeEnd_[static_cast<std::size_t>(parent_[i])];
+                end = std::max(end, subtreeEnd_[i]);
+            }
+            else
+            {
+                dirty_.push_back(static_cast<uint32_t>(i));
+                isDirty_[i] = 1;
+            }
+        }
+    }
+
+    void TransformHierarchy::clear()
+    {
+        parent_.clear();
+        subtreeEnd_.clear();
+        for (auto *component : {&translationX_, &translationY_, &translationZ_, &rotationX_, &rotationY_, &rotationZ_,
+                                &rotationW_, &scaleX_, &scaleY_, &scaleZ_})
+        {
+            component->clear();
+        }
+        world_.clear();
+        dirty_.clear();
+        isDirty_.clear();
+        updated_.clear();
+    }
+
+    NodeTransform TransformHierarchy::local(uint32_t node) const
+    {
+        return {parent_[node],
+                {translationX_[node], translationY_[node], translationZ_[node]},
+                {rotationX_[node], rotationY_[node], rotationZ_[node], rotationW_[node]},
+                {scaleX_[node], scaleY_[node], scaleZ_[node]}};
+    }
+
+    void TransformHierarchy::setLocal(uint32_t node,
+                                      const std::array<float, 3> &translation,
+                                      const std::array<float, 4> &rotation,
+                                      const std::array<float, 3> &scale)
+    {
+        translationX_[node] = translation[0];
+        translationY_[node] = translation[1];
+        translationZ_[node] = translation[2];
+        rotationX_[node] = rotation[0];
+        rotationY_[node] = rotation[1];
+        rotationZ_[node] = rotation[2];
+        rotationW_[node] = rotation[3];
+        scaleX_[node] = scale[0];
+        scaleY_[node] = scale[1];
+        scaleZ_[node] = scale[2];
+        if (!isDirty_[node])
+        {
+            isDirty_[node] = 1;
+            dirty_.push_back(node);
+        }
+    }
+
+    std::span<const NodeRange> TransformHierarchy::update()
+    {
+        updated_.clear();
+        if (dirty_.empty())
+        {
+            return updated_;
+        }
+
+        // Ascending order puts an ancestor before its descendants, whose runs it covers.
+        std::sort(dirty_.begin(), dirty_.end());
+        uint32_t covered = 0;
+        for (uint32_t root : dirty_)
+        {
+            isDirty_[root] = 0;
+            if (root < covered)
+            {
+                continue;
+            }
+            const uint32_t end = subtreeEnd_[root];
+            for (uint32_t node = root; node < end; ++node)
+            {
+                const Matrix4 local = composeTransform({translationX_[node], translationY_[node], translationZ_[node]},
+                                                       {rotationX_[node], rotationY_[node], rotationZ_[node], rotationW_[node]},
+                                                       {scaleX_[node], scaleY_[node], scaleZ_[node]});
+                const int32_t parent = parent_[node];
+                if (parent >= 0)
+                {
+                    multiplyMatrices(world_[node].data(), local.data(), world_[static_cast<std::size_t>(parent)].data());
+                }
+                else
+                {
+                    world_[node] = local;
+                }
+            }
+            updated_.push_back({root, end});
+            covered = end;
+        }
+        dirty_.clear();
+        return updated_;
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "render/Matrix4.h"
+
+namespace openchordix::render
+{
+    struct NodeTransform
+    {
+        int32_t parent = -1; // Earlier node, or -1 for a root
+        std::array<float, 3> translation{0.0f, 0.0f, 0.0f};
+        std::array<float, 4> rotation{0.0f, 0.0f, 0.0f, 1.0f}; // Quaternion, xyzw
+        std::array<float, 3> scale{1.0f, 1.0f, 1.0f};
+    };
+
+    // True when every node follows its parent and each subtree is a contiguous
+    // run, i.e. the nodes are in depth-first order.
+    bool isDepthFirst(std::span<const NodeTransform> nodes);
+
+    // Nodes [first, end).
+    struct NodeRange
+    {
+        uint32_t first = 0;
+        uint32_t end = 0;
+    };
+
+    // A scene graph flattened depth first: parent indices, local TRS one array
+    // per component, and world matrices relative to the model. Because every
+    // subtree is one contiguous run, update() walks only the runs below nodes
+    // changed since the last call, parents before children.
+    class TransformHierarchy
+    {
+    public:
+        // `nodes` must satisfy isDepthFirst. Every node starts dirty.
+        void assign(std::span<const NodeTransform> nodes);
+        void clear();
+
+        std::size_t size() const { return parent_.size(); }
+        int32_t parent(uint32_t node) const { return parent_[node]; }
+        // One past the last node of `node`'s subtree.
+        uint32_t subtreeEnd(uint32_t node) const { return subtreeEnd_[node]; }
+
+        NodeTransform local(uint32_t node) const;
+        void setLocal(uint32_t node,
+                      const std::array<float, 3> &translation,
+                      const std::array<float, 4> &rotation,
+                      const std::array<float, 3> &scale);
+
+        // Recomputes the world matrices of dirty subtrees and returns the runs it
+        // touched, valid until the next call. Empty when nothing changed.
+        std::span<const NodeRange> update();
+        const Matrix4 &world(uint32_t node) const { return world_[node]; }
+
+    private:
+        std::vector<int32_t> parent_;
+        std::vector<uint32_t> subtreeEnd_;
+        std::vector<float> translationX_;
+        std::vector<float> translationY_;
+        std::vector<float> translationZ_;
+        std::vector<float> rotationX_;
+        std::vector<float> rotationY_;
+        std::vector<float> rotationZ_;
+        std::vector<float> rotationW_;
+        std::vector<float> scaleX_;
+        std::vector<float> scaleY_;
+        std::vector<float> scaleZ_;
+        std::vector<Matrix4> world_;
+        std::vector<uint32_t> dirty_;  // Nodes changed since the last update, unordered
+        std::vector<uint8_t> isDirty_; // Keeps dirty_ free of repeats
+        std::vector<NodeRange> updated_;
+    };
+}
@@ -0,0 +1,23 @@
+$input v_worldPos, v_normal, v_color0
+
+#include <common.sh>
+
+uniform vec4 u_lightDir;
+uniform vec4 u_highwayParams; // x: hit glow, y: miss dim
+
+void main()
+{
+    vec3 N = normalize(v_normal);
+    vec3 L = normalize(-u_lightDir.xyz);
+    float light = 0.35 + 0.65 * max(dot(N, L), 0.0);
+
+    // Instance state in alpha: 0 upcoming, 1 hit, 2 missed.
+    float state = v_color0.a;
+    float hit = step(0.5, state) * (1.0 - step(1.5, state));
+    float missed = step(1.5, state);
+    vec3 color = v_color0.rgb * light;
+    color = mix(color, color * u_highwayParams.y, missed);
+    color += v_color0.rgb * u_highwayParams.x * hit;
+
+    gl_FragColor = vec4(color, 1.0);
+}
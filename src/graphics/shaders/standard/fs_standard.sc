@@ -1,4 +1,4 @@
-$input v_worldPos, v_normal, v_tangent, v_uv
+$input v_worldPos, v_normal, v_tangent, v_uv, v_color0
 
 #include <common.sh>
 
@@ -23,7 +23,7 @@ uniform vec4 u_envParams;
 
 void main()
 {
-    vec4 baseColor = u_baseColorFactor;
+    vec4 baseColor = u_baseColorFactor * v_color0;
     vec4 baseTex = texture2D(s_baseColor, v_uv);
     baseColor *= mix(vec4(1.0, 1.0, 1.0, 1.0), baseTex, u_miscParams.y);
 
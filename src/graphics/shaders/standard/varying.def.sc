@@ -2,8 +2,16 @@ vec3 a_position : POSITION;
 vec3 a_normal : NORMAL;
 vec4 a_tangent : TANGENT;
 vec2 a_texcoord0 : TEXCOORD0;
+vec4 a_texcoord1 : TEXCOORD1;
 
 vec3 v_worldPos : TEXCOORD0;
 vec3 v_normal : TEXCOORD1;
 vec4 v_tangent : TEXCOORD2;
 vec2 v_uv : TEXCOORD3;
+vec4 v_color0 : COLOR0;
+
+vec4 i_data0 : TEXCOORD7;
+vec4 i_data1 : TEXCOORD6;
+vec4 i_data2 : TEXCOORD5;
+vec4 i_data3 : TEXCOORD4;
+vec4 i_data4 : TEXCOORD3;
@@ -0,0 +1,15 @@
+$input a_position, a_normal, i_data0, i_data1, i_data2, i_data3, i_data4
+$output v_worldPos, v_normal, v_color0
+
+#include <common.sh>
+
+void main()
+{
+    mat4 model = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+    vec4 worldPos = mul(model, vec4(a_position, 1.0));
+    v_worldPos = worldPos.xyz;
+    v_normal = normalize(mul(model, vec4(a_normal, 0.0)).xyz);
+    v_color0 = i_data4;
+
+    gl_Position = mul(u_viewProj, worldPos);
+}
@@ -1,5 +1,5 @@
 $input a_position, a_normal, a_tangent, a_texcoord0
-$output v_worldPos, v_normal, v_tangent, v_uv
+$output v_worldPos, v_normal, v_tangent, v_uv, v_color0
 
 #include <common.sh>
 
@@ -12,6 +12,7 @@ void main()
     vec3 tangent = normalize(mul(u_model[0], vec4(a_tangent.xyz, 0.0)).xyz);
     v_tangent = vec4(tangent, a_tangent.w);
     v_uv = a_texcoord0;
+    v_color0 = vec4_splat(1.0);
 
     gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
 }
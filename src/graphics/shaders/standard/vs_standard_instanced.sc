@@ -0,0 +1,20 @@
+$input a_position, a_normal, a_tangent, a_texcoord0, i_data0, i_data1, i_data2, i_data3, i_data4
+$output v_worldPos, v_normal, v_tangent, v_uv, v_color0
+
+#include <common.sh>
+
+void main()
+{
+    // u_model places the mesh within the model, the instance places the model.
+    mat4 instance = mtxFromCols(i_data0, i_data1, i_data2, i_data3);
+    vec4 worldPos = mul(instance, mul(u_model[0], vec4(a_position, 1.0)));
+    v_worldPos = worldPos.xyz;
+    v_normal = normalize(mul(instance, mul(u_model[0], vec4(a_normal, 0.0))).xyz);
+
+    vec3 tangent = normalize(mul(instance, mul(u_model[0], vec4(a_tangent.xyz, 0.0))).xyz);
+    v_tangent = vec4(tangent, a_tangent.w);
+    v_uv = a_texcoord0;
+    v_color0 = i_data4;
+
+    gl_Position = mul(u_viewProj, worldPos);
+}
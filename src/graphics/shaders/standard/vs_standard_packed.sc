@@ -0,0 +1,33 @@
+$input a_position, a_texcoord1, a_texcoord0
+$output v_worldPos, v_normal, v_tangent, v_uv, v_color0
+
+#include <common.sh>
+
+// Inverse of the octahedral mapping in ModelBuilder.
+vec3 octDecode(vec2 e)
+{
+    vec3 n = vec3(e.x, e.y, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+void main()
+{
+    // a_texcoord1: normal octahedral xy, tangent octahedral x, then tangent y
+    // remapped to [0.5, 1] and signed with the bitangent sign.
+    vec3 normal = octDecode(a_texcoord1.xy);
+    float tangentY = abs(a_texcoord1.w) * 4.0 - 3.0;
+    vec3 tangent = octDecode(vec2(a_texcoord1.z, tangentY));
+    float handedness = a_texcoord1.w < 0.0 ? -1.0 : 1.0;
+
+    vec4 worldPos = mul(u_model[0], vec4(a_position, 1.0));
+    v_worldPos = worldPos.xyz;
+    v_normal = normalize(mul(u_model[0], vec4(normal, 0.0)).xyz);
+    v_tangent = vec4(normalize(mul(u_model[0], vec4(tangent, 0.0)).xyz), handedness);
+    v_uv = a_texcoord0;
+    v_color0 = vec4_splat(1.0);
+
+    gl_Position = mul(u_modelViewProj, vec4(a_position, 1.0));
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "audio/AudioSession.h"
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    void printUsage()
+    {
+        std::cerr << "Usage: openchordix_audio_startup_bench [--runs N]" << std::endl
+                  << "       Picks the default duplex devices, then times launch to first audio callback"
+                  << std::endl
+                  << "       for the full probe path and for the fast restore path, and how long the"
+                  << std::endl
+                  << "       fast path takes to deliver the full device list" << std::endl;
+    }
+
+    struct StartupRun
+    {
+        double firstCallbackMs = 0.0;
+        double deviceListMs = 0.0;
+    };
+
+    AudioSession makeSession()
+    {
+        return AudioSession({22050, 32000, 44100, 48000, 88200, 96000}, {64, 128, 256, 512, 1024, 2048});
+    }
+
+    double msSince(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    std::optional<Clock::time_point> waitForFirstCallback(const AudioSession &session)
+    {
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (Clock::now() < deadline)
+        {
+            if (auto first = session.firstCallbackTime())
+            {
+                return first;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return std::nullopt;
+    }
+
+    // What the app does without a usable saved config: enumerate, select, open.
+    std::optional<StartupRun> runFullProbe(const AudioConfig &config)
+    {
+        auto start = Clock::now();
+        AudioSession session = makeSession();
+        session.refreshDevices(config.api);
+        auto listed = Clock::now();
+        if (!session.applyConfig(config) || !session.startMonitoring())
+        {
+            return std::nullopt;
+        }
+        auto first = waitForFirstCallback(session);
+        if (!first)
+        {
+            return std::nullopt;
+        }
+        return StartupRun{msSince(start, *first), msSince(start, listed)};
+    }
+
+    std::optional<StartupRun> runFastRestore(const AudioConfig &config)
+    {
+        auto start = Clock::now();
+        AudioSession session = makeSession();
+        if (!session.restoreMonitoring(config))
+        {
+            return std::nullopt;
+        }
+        auto first = waitForFirstCallback(session);
+        if (!first)
+        {
+            return std::nullopt;
+        }
+        auto deadline = Clock::now() + std::chrono::seconds(5);
+        while (session.scanning() && Clock::now() < deadline)
+        {
+            session.pollDevices();
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        if (session.scanning())
+        {
+            return std::nullopt;
+        }
+        return StartupRun{msSince(start, *first), msSince(start, Clock::now())};
+    }
+
+    void printRuns(const char *label, std::vector<StartupRun> runs)
+    {
+        if (runs.empty())
+        {
+            std::printf("%-12s  no successful runs\n", label);
+            return;
+        }
+        auto median = [&](double StartupRun::*field)
+        {
+            std::vector<double> values;
+            for (const StartupRun &run : runs)
+            {
+                values.push_back(run.*field);
+            }
+            std::sort(values.begin(), values.end());
+            return std::make_pair(values.front(), values[values.size() / 2]);
+        };
+        auto [bestFirst, medianFirst] = median(&StartupRun::firstCallbackMs);
+        auto [bestList, medianList] = median(&StartupRun::deviceListMs);
+        std::printf("%-12s  first callback %8.1f ms best %8.1f ms median   device list %8.1f ms best %8.1f ms median\n",
+                    label, bestFirst, medianFirst, bestList, medianList);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int runs = 5;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if (arg == "--runs" && i + 1 < argc)
+        {
+            runs = std::max(1, std::atoi(argv[++i]));
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    // The audio stack logs every open and close; keep the report readable.
+    std::ostringstream discarded;
+    std::streambuf *console = std::cout.rdbuf(discarded.rdbuf());
+
+    AudioConfig config{};
+    {
+        AudioSession session = makeSession();
+        session.refreshDevices(RtAudio::Api::UNSPECIFIED);
+        config = session.currentConfig();
+    }
+    if (!config.isUsable() || !config.hasDeviceNames())
+    {
+        std::cout.rdbuf(console);
+        std::cerr << "No default input and output device to benchmark with." << std::endl;
+        return 1;
+    }
+
+    // Alternate the paths so backend warm-up and caching favour neither.
+    std::vector<StartupRun> full;
+    std::vector<StartupRun> fast;
+    for (int run = 0; run < runs; ++run)
+    {
+        if (auto result = runFullProbe(config))
+        {
+            full.push_back(*result);
+        }
+        if (auto result = runFastRestore(config))
+        {
+            fast.push_back(*result);
+        }
+    }
+    std::cout.rdbuf(console);
+
+    std::cout << "Devices: " << config.inputDeviceName << " -> " << config.outputDeviceName << " at "
+              << config.sampleRate << " Hz, " << config.bufferFrames << " frames, " << runs << " runs" << std::endl;
+    printRuns("full probe", full);
+    printRuns("fast restore", fast);
+    return full.empty() || fast.empty() ? 1 : 0;
+}
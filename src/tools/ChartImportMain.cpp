@@ -0,0 +1,125 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "track/ChartImportBatch.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: openchordix_chart_import <input dir|file> <output dir> [--jobs N] [--force] [--quiet]"
+                  << std::endl
+                  << "       [--midi-channel N]  MIDI channel (1-16) of the highest string, default 1"
+                  << std::endl;
+    }
+
+    const char *statusLabel(ChartImportStatus status)
+    {
+        switch (status)
+        {
+        case ChartImportStatus::Converted:
+            return "converted";
+        case ChartImportStatus::Unchanged:
+            return "unchanged";
+        case ChartImportStatus::Failed:
+            return "failed";
+        }
+        return "";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    ChartImportOptions options;
+    bool quiet = false;
+    int positional = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if (arg == "--force")
+        {
+            options.force = true;
+        }
+        else if (arg == "--quiet")
+        {
+            quiet = true;
+        }
+        else if (arg == "--jobs" && i + 1 < argc)
+        {
+            try
+            {
+                options.jobs = static_cast<unsigned>(std::stoul(argv[++i]));
+            }
+            catch (const std::exception &)
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (arg == "--midi-channel" && i + 1 < argc)
+        {
+            try
+            {
+                options.midi.firstChannel = std::stoi(argv[++i]) - 1;
+            }
+            catch (const std::exception &)
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (!arg.empty() && arg[0] != '-' && positional < 2)
+        {
+            (positional++ == 0 ? options.input : options.output) = std::string(arg);
+        }
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (positional != 2)
+    {
+        printUsage();
+        return 2;
+    }
+
+    ChartImportReport report = importCharts(options);
+    if (!report.error.empty() && report.results.empty())
+    {
+        std::cerr << "Error: " << report.error << std::endl;
+        return 1;
+    }
+
+    char timing[32];
+    for (const ChartImportResult &result : report.results)
+    {
+        if (quiet && result.status != ChartImportStatus::Failed)
+        {
+            continue;
+        }
+        std::snprintf(timing, sizeof(timing), "%8.2f ms", result.millis);
+        std::cout << timing << "  " << statusLabel(result.status) << "  " << result.source.string();
+        if (result.status == ChartImportStatus::Converted)
+        {
+            std::cout << " -> " << result.chart.string() << " (" << result.parts << " parts)";
+        }
+        else if (result.status == ChartImportStatus::Failed)
+        {
+            std::cout << ": " << result.error;
+        }
+        std::cout << std::endl;
+    }
+
+    std::snprintf(timing, sizeof(timing), "%.1f ms", report.totalMillis);
+    std::cout << report.results.size() << " files: " << report.converted << " converted, " << report.unchanged
+              << " unchanged, " << report.failed << " failed in " << timing << " on " << report.jobs << " threads"
+              << std::endl;
+    if (!report.error.empty())
+    {
+        std::cerr << "Error: " << report.error << std::endl;
+    }
+    return report.failed == 0 && report.error.empty() ? 0 : 1;
+}
@@ -0,0 +1,227 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "gltf/GltfAsset.h"
+#include "render/ModelCache.h"
+#include "render/ModelRenderer.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr << "Usage: openchordix_model_bench <model.gltf|glb> [--jobs N] [--runs N] [--cache DIR [--packed]]"
+                  << std::endl
+                  << "       Loads the model with 1..N decode threads and reports the best time of each,"
+                  << std::endl
+                  << "       then the mesh optimization figures (vertex cache ACMR, vertex fetch overfetch)"
+                  << std::endl
+                  << "       and the triangles drawn per frame at several distances after LOD selection;"
+                  << std::endl
+                  << "       with --cache, also compares a cold import and cook against a cooked load,"
+                  << std::endl
+                  << "       cooking packed 20-byte vertices with --packed" << std::endl;
+    }
+
+    // Triangles drawn per frame at 1080p with a 60 degree lens as the camera backs
+    // away, using the renderer's own LOD selection.
+    void printLodTable(const openchordix::render::PreparedModel &model, double lodMillis)
+    {
+        const openchordix::render::ModelBounds bounds = model.bounds();
+        openchordix::render::ModelFrame frame{};
+        frame.proj[5] = 1.0f / std::tan(30.0f * 3.14159265f / 180.0f);
+        frame.viewportHeight = 1080.0f;
+        const float identity[16] = {1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1};
+        const openchordix::render::ModelRenderSettings settings{};
+
+        uint64_t fullDetail = 0;
+        std::size_t chains = 0;
+        for (const openchordix::render::PreparedMesh &mesh : model.meshes)
+        {
+            fullDetail += mesh.lods[0].indexCount / 3;
+            chains += mesh.lodCount > 1 ? 1 : 0;
+        }
+        char line[160];
+        std::snprintf(line, sizeof(line), "lods    %7.1f ms  %zu of %zu meshes have coarser levels", lodMillis, chains,
+                      model.meshes.size());
+        std::cout << line << std::endl;
+
+        for (float radii : {1.5f, 3.0f, 6.0f, 12.0f, 24.0f, 48.0f, 96.0f})
+        {
+            frame.cameraPos = {bounds.center[0], bounds.center[1], bounds.center[2] + bounds.radius * radii};
+            const float pixelsPerUnit = openchordix::render::projectedPixelsPerUnit(bounds, identity, frame);
+            uint64_t triangles = 0;
+            std::array<uint32_t, openchordix::render::kMaxMeshLods> levels{};
+            for (const openchordix::render::PreparedMesh &mesh : model.meshes)
+            {
+                const std::span<const openchordix::render::MeshLod> lods(mesh.lods.data(), mesh.lodCount);
+                const uint32_t level = openchordix::render::selectMeshLod(lods, pixelsPerUnit, settings.lodErrorPixels);
+                triangles += lods[level].indexCount / 3;
+                ++levels[level];
+            }
+            std::snprintf(line, sizeof(line), "  %5.1f radii  %9llu triangles/frame  %5.1f%%  meshes per level %u/%u/%u/%u",
+                          radii, static_cast<unsigned long long>(triangles),
+                          fullDetail ? 100.0 * static_cast<double>(triangles) / static_cast<double>(fullDetail) : 100.0,
+                          levels[0], levels[1], levels[2], levels[3]);
+            std::cout << line << std::endl;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string path;
+    std::string cacheDir;
+    bool packed = false;
+    unsigned maxJobs = std::max(1u, std::thread::hardware_concurrency());
+    unsigned runs = 3;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg(argv[i]);
+        if ((arg == "--jobs" || arg == "--runs") && i + 1 < argc)
+        {
+            try
+            {
+                const unsigned long value = std::stoul(argv[++i]);
+                if (value == 0)
+                {
+                    printUsage();
+                    return 2;
+                }
+                (arg == "--jobs" ? maxJobs : runs) = static_cast<unsigned>(value);
+            }
+            catch (const std::exception &)
+            {
+                printUsage();
+                return 2;
+            }
+        }
+        else if (arg == "--cache" && i + 1 < argc)
+        {
+            cacheDir = argv[++i];
+        }
+        else if (arg == "--packed")
+        {
+            packed = true;
+        }
+        else if (!arg.empty() && arg[0] != '-' && path.empty())
+        {
+            path = std::string(arg);
+        }
+        else
+        {
+            printUsage();
+            return 2;
+        }
+    }
+    if (path.empty())
+    {
+        printUsage();
+        return 2;
+    }
+
+    char line[160];
+    double baseline = 0.0;
+    std::optional<openchordix::assets::GltfAsset> asset;
+    for (unsigned jobs = 1; jobs <= maxJobs; jobs = jobs < maxJobs ? std::min(jobs * 2, maxJobs) : jobs + 1)
+    {
+        openchordix::assets::GltfLoadStats best{};
+        std::size_t images = 0;
+        for (unsigned run = 0; run < runs; ++run)
+        {
+            openchordix::assets::GltfLoadResult result = openchordix::assets::loadGltfAsset(path, {jobs});
+            if (!result.ok())
+            {
+                std::cerr << "Error: " << result.error << std::endl;
+                return 1;
+            }
+            images = result.asset->images.size();
+            if (run == 0 || result.stats.totalMillis < best.totalMillis)
+            {
+                best = result.stats;
+            }
+            asset = std::move(result.asset);
+        }
+        if (jobs == 1)
+        {
+            baseline = best.totalMillis;
+        }
+        std::snprintf(line, sizeof(line),
+                      "%2u threads  %4zu images  parse %7.1f ms  meshes %7.1f ms  decode %7.1f ms  total %7.1f ms  x%.2f",
+                      best.jobs, images, best.parseMillis, best.meshMillis, best.decodeMillis, best.totalMillis,
+                      best.totalMillis > 0.0 ? baseline / best.totalMillis : 1.0);
+        std::cout << line << std::endl;
+    }
+
+    const auto prepareStart = std::chrono::steady_clock::now();
+    const openchordix::render::PreparedModel prepared = openchordix::render::ModelBuilder::prepare(std::move(*asset));
+    const double prepareMillis =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - prepareStart).count();
+    const openchordix::render::MeshOptimizationStats &mesh = prepared.optimization;
+    std::snprintf(line, sizeof(line),
+                  "optimize %7.1f ms  vertices %llu -> %llu  ACMR %.3f -> %.3f  overfetch %.2f -> %.2f", mesh.millis,
+                  static_cast<unsigned long long>(mesh.cacheBefore.vertices),
+                  static_cast<unsigned long long>(mesh.cacheAfter.vertices), mesh.cacheBefore.acmr(),
+                  mesh.cacheAfter.acmr(), mesh.fetchBefore.overfetch(), mesh.fetchAfter.overfetch());
+    std::cout << line << std::endl;
+    printLodTable(prepared, prepareMillis - mesh.millis);
+
+    if (cacheDir.empty())
+    {
+        return 0;
+    }
+
+    openchordix::render::ModelLoadOptions options;
+    options.cacheDir = cacheDir;
+    options.prepare.packVertices = packed;
+    uint64_t hash = 0;
+    std::string error;
+    if (!openchordix::render::hashModelSource(path, options.prepare, hash, error))
+    {
+        std::cerr << "Error: " << error << std::endl;
+        return 1;
+    }
+    const std::filesystem::path cooked = openchordix::render::cookedModelPath(cacheDir, hash);
+    double cold = 1e9;
+    double warm = 1e9;
+    uint64_t vertexBytes = 0;
+    bool packedVertices = false;
+    for (unsigned run = 0; run < runs; ++run)
+    {
+        std::error_code ec;
+        std::filesystem::remove(cooked, ec);
+        openchordix::render::PreparedModelResult first = openchordix::render::loadPreparedModel(path, options);
+        openchordix::render::PreparedModelResult second = openchordix::render::loadPreparedModel(path, options);
+        if (!first.model || !second.model || !second.fromCache)
+        {
+            std::cerr << "Error: " << (first.error.empty() ? "cooked model was not reused" : first.error) << std::endl;
+            return 1;
+        }
+        cold = std::min(cold, first.millis);
+        warm = std::min(warm, second.millis);
+        vertexBytes = 0;
+        for (const openchordix::render::PreparedMesh &mesh : second.model->meshes)
+        {
+            vertexBytes += mesh.vertexSize();
+            packedVertices = mesh.vertexFormat == openchordix::render::VertexFormat::Packed;
+        }
+    }
+    std::error_code ec;
+    std::snprintf(line, sizeof(line), "import + cook %7.1f ms  cooked %7.1f ms  x%.1f  (%llu bytes)", cold, warm,
+                  warm > 0.0 ? cold / warm : 1.0, static_cast<unsigned long long>(std::filesystem::file_size(cooked, ec)));
+    std::cout << line << std::endl;
+    std::snprintf(line, sizeof(line), "vertices %llu bytes (%s)", static_cast<unsigned long long>(vertexBytes),
+                  packedVertices ? "packed" : packed ? "full, outside packing tolerance" : "full");
+    std::cout << line << std::endl;
+    return 0;
+}
@@ -0,0 +1,186 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "audio/AudioManager.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+} // namespace
+
+TEST_CASE("AudioManager reports device info from the last probe", "[audio]")
+{
+    AudioManager manager;
+    std::vector<unsigned int> ids = manager.getDeviceIds();
+
+    for (unsigned int id : ids)
+    {
+        RtAudio::DeviceInfo info = manager.getDeviceInfo(id);
+        CHECK(info.ID == id);
+        CHECK_FALSE(info.name.empty());
+    }
+
+    unsigned int defaultInput = manager.getDefaultInputDeviceId();
+    unsigned int defaultOutput = manager.getDefaultOutputDeviceId();
+    CHECK((defaultInput == 0 || std::find(ids.begin(), ids.end(), defaultInput) != ids.end()));
+    CHECK((defaultOutput == 0 || std::find(ids.begin(), ids.end(), defaultOutput) != ids.end()));
+}
+
+TEST_CASE("AudioManager answers stream queries while another thread probes devices", "[audio]")
+{
+    AudioManager manager;
+
+    auto probeStart = Clock::now();
+    manager.getDeviceIds();
+    const double probeMs = elapsedMs(probeStart);
+
+    std::atomic<bool> stop{false};
+    std::atomic<int> probes{0};
+    std::thread monitor([&]
+                        {
+        while (!stop.load())
+        {
+            manager.getDeviceIds();
+            probes.fetch_add(1);
+        } });
+
+    // Cover a few probes so the queries land inside one.
+    double worstQueryMs = 0.0;
+    auto deadline = Clock::now() + std::chrono::milliseconds(static_cast<int>(probeMs * 3.0) + 20);
+    while (Clock::now() < deadline || probes.load() < 2)
+    {
+        auto queryStart = Clock::now();
+        manager.isStreamOpen();
+        manager.isStreamRunning();
+        manager.getDeviceInfo(manager.getDefaultOutputDeviceId());
+        manager.closeStream();
+        worstQueryMs = std::max(worstQueryMs, elapsedMs(queryStart));
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    stop.store(true);
+    monitor.join();
+
+    // Only meaningful when a probe takes long enough to tell waiting apart from scheduling noise.
+    if (probeMs >= 20.0)
+    {
+        CHECK(worstQueryMs < probeMs / 2.0);
+    }
+    CHECK_FALSE(manager.isStreamOpen());
+}
+
+TEST_CASE("AudioManager opens streams with device IDs from enumeration", "[audio]")
+{
+    AudioManager manager;
+    unsigned int inputId = 0;
+    unsigned int outputId = 0;
+    for (unsigned int id : manager.getDeviceIds())
+    {
+        RtAudio::DeviceInfo info = manager.getDeviceInfo(id);
+        if (inputId == 0 && info.inputChannels > 0)
+        {
+            inputId = id;
+        }
+        if (outputId == 0 && info.outputChannels > 0)
+        {
+            outputId = id;
+        }
+    }
+    if (inputId == 0 || outputId == 0)
+    {
+        return; // No duplex-capable devices on this machine
+    }
+
+    // The stream instance numbers devices on its own probe; the manager maps by name.
+    REQUIRE(manager.openMonitoringStream(inputId, outputId, 48000, 256));
+    CHECK(manager.isStreamOpen());
+    REQUIRE(manager.startStream());
+    CHECK(manager.isStreamRunning());
+    manager.closeStream();
+    CHECK_FALSE(manager.isStreamOpen());
+}
+
+TEST_CASE("AudioManager opens and swaps streams on a standby instance probed off-thread", "[audio]")
+{
+    AudioManager manager;
+    unsigned int inputId = 0;
+    unsigned int outputId = 0;
+    for (unsigned int id : manager.getDeviceIds())
+    {
+        RtAudio::DeviceInfo info = manager.getDeviceInfo(id);
+        if (inputId == 0 && info.inputChannels > 0)
+        {
+            inputId = id;
+        }
+        if (outputId == 0 && info.outputChannels > 0)
+        {
+            outputId = id;
+        }
+    }
+    if (inputId == 0 || outputId == 0)
+    {
+        return; // No duplex-capable devices on this machine
+    }
+
+    // As the device monitor does: probe the standby on another thread.
+    std::thread([&manager] { manager.prepareStandbyInstance(); }).join();
+    REQUIRE(manager.openMonitoringStream(inputId, outputId, 48000, 256));
+    REQUIRE(manager.startStream());
+
+    std::thread([&manager] { manager.prepareStandbyInstance(); }).join();
+    REQUIRE(manager.reconfigureMonitoringStream(inputId, outputId, 44100, 256));
+    CHECK(manager.isStreamRunning());
+    CHECK(manager.getStreamSampleRate() == 44100);
+    manager.closeStream();
+    CHECK_FALSE(manager.isStreamOpen());
+}
+
+TEST_CASE("AudioManager keeps the previous stream when a reconfigure fails", "[audio]")
+{
+    AudioManager manager;
+    unsigned int inputId = 0;
+    unsigned int outputId = 0;
+    unsigned int outputOnlyId = 0;
+    for (unsigned int id : manager.getDeviceIds())
+    {
+        RtAudio::DeviceInfo info = manager.getDeviceInfo(id);
+        if (inputId == 0 && info.inputChannels > 0)
+        {
+            inputId = id;
+        }
+        if (outputId == 0 && info.outputChannels > 0)
+        {
+            outputId = id;
+        }
+        if (outputOnlyId == 0 && info.inputChannels == 0 && info.outputChannels > 0)
+        {
+            outputOnlyId = id;
+        }
+    }
+    if (inputId == 0 || outputId == 0)
+    {
+        return; // No duplex-capable devices on this machine
+    }
+
+    // Opened but not started takes the close-and-reopen path.
+    REQUIRE(manager.openMonitoringStream(inputId, outputId, 48000, 256));
+    // An output-only device, or 0 when there is none: neither can capture.
+    const unsigned int badInput = outputOnlyId;
+    CHECK_FALSE(manager.reconfigureMonitoringStream(badInput, outputId, 44100, 256));
+    CHECK(manager.isStreamOpen());
+    CHECK(manager.getStreamSampleRate() == 48000);
+
+    REQUIRE(manager.startStream());
+    CHECK_FALSE(manager.reconfigureMonitoringStream(badInput, outputId, 44100, 256));
+    CHECK(manager.isStreamRunning());
+    CHECK(manager.getStreamSampleRate() == 48000);
+    manager.closeStream();
+}
@@ -0,0 +1,62 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <thread>
+
+#include "audio/AudioSession.h"
+
+namespace {
+AudioSession makeSession()
+{
+    return AudioSession({44100, 48000}, {256, 512, 1024});
+}
+} // namespace
+
+TEST_CASE("AudioSession restores saved devices by name after their IDs change", "[audio]")
+{
+    AudioConfig config{};
+    {
+        AudioSession session = makeSession();
+        session.refreshDevices(RtAudio::Api::UNSPECIFIED);
+        config = session.currentConfig();
+    }
+    if (!config.isUsable())
+    {
+        return; // No duplex-capable devices on this machine
+    }
+    REQUIRE(config.hasDeviceNames());
+
+    // IDs from another process's probe mean nothing to a fresh RtAudio instance.
+    config.inputDeviceId += 1000;
+    config.outputDeviceId += 1000;
+
+    AudioSession session = makeSession();
+    REQUIRE(session.restoreMonitoring(config));
+    CHECK(session.monitoring());
+    CHECK(session.scanning());
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (session.scanning() && std::chrono::steady_clock::now() < deadline)
+    {
+        session.pollDevices();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    REQUIRE_FALSE(session.scanning());
+
+    AudioConfig restored = session.currentConfig();
+    CHECK(restored.inputDeviceName == config.inputDeviceName);
+    CHECK(restored.outputDeviceName == config.outputDeviceName);
+    CHECK(restored.isUsable());
+    CHECK(restored.inputDeviceId != config.inputDeviceId);
+}
+
+TEST_CASE("AudioSession leaves configs without device names to the full probe", "[audio]")
+{
+    AudioConfig config{};
+    config.inputDeviceId = 129;
+    config.outputDeviceId = 130;
+
+    AudioSession session = makeSession();
+    CHECK_FALSE(session.restoreMonitoring(config));
+    CHECK_FALSE(session.monitoring());
+}
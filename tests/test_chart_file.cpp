@@ -0,0 +1,195 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "track/ChartFile.h"
+#include "track/ChartWriter.h"
+
+namespace {
+std::filesystem::path chartPath(const char *name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+// 120 BPM for four beats, then 60 BPM. One note per beat over twelve beats.
+ChartData makeChart()
+{
+    ChartData chart;
+    chart.ticksPerQuarter = 480;
+    chart.tempo = {{4 * 480, 1000000}, {0, 500000}};
+
+    ChartPartData lead{"Lead Guitar", {}};
+    for (uint32_t beat = 12; beat-- > 0;)
+    {
+        ChartNote note;
+        note.tick = beat * 480;
+        note.duration = 240;
+        note.string = static_cast<uint8_t>(beat % 6);
+        note.fret = static_cast<uint8_t>(beat + 1);
+        note.flags = beat % 2 == 0 ? ChartNoteHammerOn : ChartNoteNone;
+        lead.notes.push_back(note);
+    }
+    chart.parts.push_back(lead);
+    chart.parts.push_back(ChartPartData{"Bass", {}});
+    return chart;
+}
+
+void writeBytes(const std::filesystem::path &path, const std::vector<std::byte> &bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+template <typename T>
+void pokeColumn(std::vector<std::byte> &bytes, uint64_t offset, std::size_t index, T value)
+{
+    std::memcpy(bytes.data() + offset + index * sizeof(T), &value, sizeof(T));
+}
+
+chartformat::ChartFilePart firstPart(const std::vector<std::byte> &bytes)
+{
+    chartformat::ChartFileHeader header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    chartformat::ChartFilePart part;
+    std::memcpy(&part, bytes.data() + header.partOffset, sizeof(part));
+    return part;
+}
+}
+
+TEST_CASE("Chart round-trips through a mapped file", "[chart]")
+{
+    const auto path = chartPath("openchordix_chart_roundtrip.occhart");
+    std::string error;
+    REQUIRE(writeChart(path, makeChart(), error));
+
+    auto chart = ChartFile::open(path, error);
+    REQUIRE(chart);
+    CHECK(chart->ticksPerQuarter() == 480);
+    REQUIRE(chart->tempo().size() == 2);
+    CHECK(chart->tempo()[1].startSeconds == Catch::Approx(2.0));
+    CHECK(chart->tickToSeconds(6 * 480) == Catch::Approx(4.0));
+
+    REQUIRE(chart->partCount() == 2);
+    CHECK(chart->findPart("Bass") == 1);
+    CHECK(chart->findPart("Drums") == -1);
+
+    ChartPartView lead = chart->part(0);
+    CHECK(lead.name == "Lead Guitar");
+    REQUIRE(lead.size() == 12);
+    for (std::size_t i = 0; i < lead.size(); ++i)
+    {
+        CHECK(lead.startTick[i] == i * 480); // Sorted on write
+        CHECK(lead.duration[i] == 240);
+        CHECK(lead.fret[i] == i + 1);
+        CHECK(lead.string[i] == i % 6);
+    }
+    CHECK(lead.flags[2] == ChartNoteHammerOn);
+    CHECK(lead.flags[3] == ChartNoteNone);
+
+    CHECK(chart->part(1).size() == 0);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Per-second index seeks to the first note at or after a time", "[chart]")
+{
+    const auto path = chartPath("openchordix_chart_seek.occhart");
+    std::string error;
+    REQUIRE(writeChart(path, makeChart(), error));
+    auto chart = ChartFile::open(path, error);
+    REQUIRE(chart);
+    ChartPartView lead = chart->part(0);
+
+    // Beats 0-3 fall every 0.5 s, beats 4-11 every 1 s starting at 2 s.
+    CHECK(chart->firstNoteAtOrAfter(lead, 0.0) == 0);
+    CHECK(chart->firstNoteAtOrAfter(lead, 0.25) == 1);
+    CHECK(chart->firstNoteAtOrAfter(lead, 1.5) == 3);
+    CHECK(chart->firstNoteAtOrAfter(lead, 1.6) == 4);
+    CHECK(chart->firstNoteAtOrAfter(lead, 5.0) == 7);
+    CHECK(chart->firstNoteAtOrAfter(lead, 9.0) == 11);
+    CHECK(chart->firstNoteAtOrAfter(lead, 9.5) == 12);
+    CHECK(chart->firstNoteAtOrAfter(lead, 600.0) == 12);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Corrupt or truncated charts are rejected", "[chart]")
+{
+    const auto path = chartPath("openchordix_chart_bad.occhart");
+    std::string error;
+    auto bytes = serializeChart(makeChart());
+
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size() / 2));
+    }
+    CHECK_FALSE(ChartFile::open(path, error));
+    CHECK_FALSE(error.empty());
+
+    bytes[0] = std::byte{'X'};
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+    error.clear();
+    CHECK_FALSE(ChartFile::open(path, error));
+    CHECK(error.find("not a chart") != std::string::npos);
+
+    error.clear();
+    CHECK_FALSE(ChartFile::open(chartPath("openchordix_chart_missing.occhart"), error));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Charts whose lookups would read out of order or out of bounds are rejected", "[chart]")
+{
+    const auto path = chartPath("openchordix_chart_unordered.occhart");
+    const std::vector<std::byte> good = serializeChart(makeChart());
+    const chartformat::ChartFilePart lead = firstPart(good);
+    std::string error;
+
+    std::vector<std::byte> bytes = good;
+    pokeColumn<uint32_t>(bytes, lead.startTickOffset, 0, 5 * 480);
+    writeBytes(path, bytes);
+    CHECK_FALSE(ChartFile::open(path, error));
+    CHECK(error.find("out of order") != std::string::npos);
+
+    bytes = good;
+    pokeColumn<uint32_t>(bytes, lead.indexOffset, lead.indexCount - 1, lead.noteCount + 1);
+    writeBytes(path, bytes);
+    error.clear();
+    CHECK_FALSE(ChartFile::open(path, error));
+    CHECK(error.find("seek index") != std::string::npos);
+
+    bytes = good;
+    pokeColumn<uint32_t>(bytes, lead.indexOffset, 1, 0);
+    pokeColumn<uint32_t>(bytes, lead.indexOffset, 0, 3);
+    writeBytes(path, bytes);
+    error.clear();
+    CHECK_FALSE(ChartFile::open(path, error));
+    CHECK(error.find("seek index") != std::string::npos);
+
+    writeBytes(path, good);
+    error.clear();
+    CHECK(ChartFile::open(path, error));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Catalog parts resolve through their chart block", "[chart]")
+{
+    const auto path = chartPath("openchordix_chart_blocks.occhart");
+    std::string error;
+    REQUIRE(writeChart(path, makeChart(), error));
+    auto chart = ChartFile::open(path, error);
+    REQUIRE(chart);
+
+    CHECK(chart->findPart(TrackPart{"Bass", path.string(), 1}) == 1);
+    CHECK(chart->findPart(TrackPart{"Bass", path.string(), -1}) == 1);
+    // A stale block from before the parts were reordered falls back to the name.
+    CHECK(chart->findPart(TrackPart{"Bass", path.string(), 0}) == 1);
+    CHECK(chart->findPart(TrackPart{"Bass", path.string(), 7}) == 1);
+    CHECK(chart->findPart(TrackPart{"Drums", path.string(), 0}) == -1);
+    std::filesystem::remove(path);
+}
@@ -25,6 +25,8 @@ TEST_CASE("ConfigStore saves and loads audio config", "[config]")
     config.api = RtAudio::Api::UNSPECIFIED;
     config.inputDeviceId = 1;
     config.outputDeviceId = 2;
+    config.inputDeviceName = "hw:USB Audio=Line In";
+    config.outputDeviceName = "Built-in Speakers";
     config.sampleRate = 44100;
     config.bufferFrames = 512;
 
@@ -35,6 +37,8 @@ TEST_CASE("ConfigStore saves and loads audio config", "[config]")
     CHECK(loaded->api == config.api);
     CHECK(loaded->inputDeviceId == config.inputDeviceId);
     CHECK(loaded->outputDeviceId == config.outputDeviceId);
+    CHECK(loaded->inputDeviceName == config.inputDeviceName);
+    CHECK(loaded->outputDeviceName == config.outputDeviceName);
     CHECK(loaded->sampleRate == config.sampleRate);
     CHECK(loaded->bufferFrames == config.bufferFrames);
 
@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "render/FrustumCull.h"
+#include "render/Matrix4.h"
+
+using namespace openchordix::render;
+
+namespace {
+using Box = std::array<std::array<float, 3>, 2>;
+
+// Left-handed perspective in bx's layout with clip z in 0..w, as bx::mtxProj builds it.
+Matrix4 perspective(float fovY, float aspect, float nearZ, float farZ)
+{
+    const float height = 1.0f / std::tan(fovY * 0.5f);
+    const float depth = farZ / (farZ - nearZ);
+    Matrix4 m{};
+    m[0] = height / aspect;
+    m[5] = height;
+    m[10] = depth;
+    m[11] = 1.0f;
+    m[14] = -nearZ * depth;
+    return m;
+}
+
+std::vector<uint8_t> runCull(const Frustum &frustum, const float *model, const std::vector<Box> &boxes,
+                             uint32_t &visibleCount)
+{
+    CullBoxes cull;
+    cull.resize(boxes.size());
+    for (std::size_t i = 0; i < boxes.size(); ++i)
+    {
+        cull.set(i, boxes[i][0], boxes[i][1]);
+    }
+    std::vector<uint8_t> visible(boxes.size(), 0xFF);
+    visibleCount = cullBoxes(frustum, model, cull, visible);
+    return visible;
+}
+
+// Scalar reference: a box is culled when all eight of its corners, taken to world
+// space, are behind one plane. Returns -1 when a corner sits too close to a plane
+// for float rounding to agree.
+int referenceVisible(const Frustum &frustum, const float *model, const Box &box)
+{
+    for (const auto &plane : frustum.planes)
+    {
+        float nearest = -INFINITY;
+        float farthest = INFINITY;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const float x = box[corner & 1][0];
+            const float y = box[(corner >> 1) & 1][1];
+            const float z = box[(corner >> 2) & 1][2];
+            float world[3];
+            for (int k = 0; k < 3; ++k)
+            {
+                world[k] = x * model[k] + y * model[4 + k] + z * model[8 + k] + model[12 + k];
+            }
+            const float distance = plane[0] * world[0] + plane[1] * world[1] + plane[2] * world[2] + plane[3];
+            nearest = std::max(nearest, distance);
+            farthest = std::min(farthest, distance);
+        }
+        const float scale = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+        if (std::fabs(nearest) < 1e-3f * scale)
+        {
+            return -1;
+        }
+        if (nearest < 0.0f)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+}
+
+TEST_CASE("Boxes inside, outside and across a frustum plane", "[cull]")
+{
+    // Identity view and projection with homogeneous depth: the frustum is the cube [-1, 1].
+    const Frustum cube = extractFrustum(kIdentityMatrix.data(), kIdentityMatrix.data(), true);
+    const std::vector<Box> boxes{
+        Box{{{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}}},   // Inside
+        Box{{{2.0f, -0.5f, -0.5f}, {3.0f, 0.5f, 0.5f}}},    // Past the right plane
+        Box{{{0.5f, -0.5f, -0.5f}, {1.5f, 0.5f, 0.5f}}},    // Across the right plane
+        Box{{{-0.5f, -3.0f, -0.5f}, {0.5f, -1.5f, 0.5f}}},  // Below the bottom plane
+        Box{{{-0.5f, -0.5f, 0.9f}, {0.5f, 0.5f, 4.0f}}},    // Across the far plane
+        Box{{{-4.0f, -4.0f, -4.0f}, {4.0f, 4.0f, 4.0f}}},   // Around the whole frustum
+        Box{{{1.5f, 1.5f, -0.5f}, {2.5f, 2.5f, 0.5f}}},     // Outside past a corner
+        Box{{{0.2f, 0.2f, 0.2f}, {0.2f, 0.2f, 0.2f}}},      // A point inside
+        Box{{{-1.2f, -0.1f, -0.1f}, {-1.1f, 0.1f, 0.1f}}}}; // Just past the left plane
+    const std::vector<uint8_t> expected{1, 0, 1, 0, 1, 1, 0, 1, 0};
+
+    uint32_t count = 0;
+    CHECK(runCull(cube, kIdentityMatrix.data(), boxes, count) == expected);
+    CHECK(count == 5);
+
+    // Moving the model moves its boxes: two units left brings the first outside
+    // box into view and pushes the inside one out.
+    const Matrix4 left = composeTransform({-2.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    const std::vector<uint8_t> moved = runCull(cube, left.data(), boxes, count);
+    CHECK(moved[0] == 0);
+    CHECK(moved[1] == 1);
+    CHECK(moved[5] == 1);
+}
+
+TEST_CASE("Perspective frustum culls behind the camera and past the far plane", "[cull]")
+{
+    const Matrix4 proj = perspective(1.0f, 1.5f, 0.1f, 100.0f);
+    const Frustum frustum = extractFrustum(kIdentityMatrix.data(), proj.data(), false);
+    const std::vector<Box> boxes{
+        Box{{{-1.0f, -1.0f, 9.0f}, {1.0f, 1.0f, 11.0f}}},     // Straight ahead
+        Box{{{-1.0f, -1.0f, -11.0f}, {1.0f, 1.0f, -9.0f}}},   // Behind the camera
+        Box{{{-1.0f, -1.0f, -1.0f}, {1.0f, 1.0f, 1.0f}}},     // Around the near plane
+        Box{{{-1.0f, -1.0f, 120.0f}, {1.0f, 1.0f, 130.0f}}},  // Past the far plane
+        Box{{{-1.0f, -1.0f, 95.0f}, {1.0f, 1.0f, 105.0f}}},   // Across the far plane
+        Box{{{40.0f, -1.0f, 9.0f}, {42.0f, 1.0f, 11.0f}}},    // Off to the side
+        Box{{{7.0f, -1.0f, 9.0f}, {12.0f, 1.0f, 11.0f}}}};    // Across the right plane
+    const std::vector<uint8_t> expected{1, 0, 1, 0, 1, 0, 1};
+
+    uint32_t count = 0;
+    CHECK(runCull(frustum, kIdentityMatrix.data(), boxes, count) == expected);
+    CHECK(count == 4);
+}
+
+TEST_CASE("Batched culling matches the scalar corner test", "[cull]")
+{
+    // A count that leaves a partial last batch, so padding lanes are exercised.
+    constexpr std::size_t boxCount = 1003;
+    const Matrix4 proj = perspective(1.2f, 1.0f, 0.5f, 60.0f);
+    const Matrix4 view = composeTransform({0.0f, -2.0f, 5.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    const Frustum frustum = extractFrustum(view.data(), proj.data(), false);
+    // A rotated, scaled model so the planes really move into the model's space.
+    const float half = 0.5f * 0.7f;
+    const Matrix4 model = composeTransform({3.0f, 1.0f, 20.0f}, {0.0f, std::sin(half), 0.0f, std::cos(half)},
+                                           {1.5f, 0.5f, 2.0f});
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> position(-40.0f, 40.0f);
+    std::uniform_real_distribution<float> size(0.0f, 6.0f);
+    std::vector<Box> boxes(boxCount);
+    for (Box &box : boxes)
+    {
+        for (int k = 0; k < 3; ++k)
+        {
+            box[0][k] = position(random);
+            box[1][k] = box[0][k] + size(random);
+        }
+    }
+
+    uint32_t count = 0;
+    const std::vector<uint8_t> visible = runCull(frustum, model.data(), boxes, count);
+    uint32_t compared = 0;
+    uint32_t inside = 0;
+    uint32_t sum = 0;
+    for (std::size_t i = 0; i < boxCount; ++i)
+    {
+        REQUIRE(visible[i] <= 1);
+        sum += visible[i];
+        const int expected = referenceVisible(frustum, model.data(), boxes[i]);
+        if (expected < 0)
+        {
+            continue;
+        }
+        ++compared;
+        inside += static_cast<uint32_t>(expected);
+        CHECK(visible[i] == expected);
+    }
+    CHECK(count == sum);
+    // Enough of both outcomes for the comparison to mean something.
+    CHECK(compared > boxCount * 9 / 10);
+    CHECK(inside > 50);
+    CHECK(inside < compared - 50);
+}
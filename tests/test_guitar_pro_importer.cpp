@@ -0,0 +1,450 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "track/ChartFile.h"
+#include "track/ChartImportBatch.h"
+#include "track/GuitarProImporter.h"
+
+namespace {
+// Writes just enough of a Guitar Pro file for the importer: two measures, a
+// guitar track and a drum track.
+class GpBuilder
+{
+public:
+    explicit GpBuilder(int version) : version_(version) {}
+
+    std::vector<std::byte> build()
+    {
+        const char *versions[] = {"FICHIER GUITAR PRO v3.00", "FICHIER GUITAR PRO v4.06",
+                                  "FICHIER GUITAR PRO v5.00", "FICHIER GUITAR PRO v5.10"};
+        int index = version_ == 300 ? 0 : version_ == 406 ? 1 : version_ == 500 ? 2 : 3;
+        byteSizeString(versions[index], 30);
+
+        intByteSizeString("Test Song");
+        intByteSizeString("");
+        intByteSizeString("Test Artist");
+        intByteSizeString("Test Album");
+        intByteSizeString("");
+        if (version_ >= 500)
+        {
+            intByteSizeString("");
+        }
+        intByteSizeString("");
+        intByteSizeString("");
+        intByteSizeString("");
+        i32(0);
+        if (version_ < 500)
+        {
+            u8(0);
+        }
+        if (version_ >= 400)
+        {
+            i32(0);
+            for (int i = 0; i < 5; ++i)
+            {
+                i32(1);
+                i32(0);
+            }
+        }
+        if (version_ >= 510)
+        {
+            zeros(19);
+        }
+        if (version_ >= 500)
+        {
+            zeros(30);
+            for (int i = 0; i < 10; ++i)
+            {
+                intByteSizeString("");
+            }
+            intByteSizeString("Moderate");
+        }
+        i32(120);
+        if (version_ >= 510)
+        {
+            u8(0);
+        }
+        zeros(version_ >= 400 ? 5 : 4);
+        zeros(64 * 12);
+        if (version_ >= 500)
+        {
+            zeros(42);
+        }
+        i32(2); // Measures
+        i32(2); // Tracks
+
+        measureHeader(true);
+        measureHeader(false);
+
+        track(0, "Lead");
+        track(1, "Drums");
+        if (version_ >= 500)
+        {
+            zeros(version_ == 500 ? 2 : 1);
+        }
+
+        // Measure 1, guitar: hammer-on pair, dead note, bend with palm mute.
+        i32(4);
+        beat(0x00, 0, 1 << 6);
+        note(0x20, 1, 5, 0x02, 0);
+        beatEnd();
+        beat(0x00, 0, 1 << 6);
+        note(0x20, 1, 7);
+        beatEnd();
+        beat(0x00, 0, 1 << 1);
+        note(0x20, 3, 3);
+        beatEnd();
+        beat(0x00, 0, 1 << 4);
+        note(0x20, 1, 2, 0x01, 0x02);
+        beatEnd();
+        endMeasure();
+        // Measure 1, drums: ignored.
+        i32(1);
+        beat(0x00, -2, 1 << 6);
+        note(0x20, 1, 36);
+        beatEnd();
+        endMeasure();
+
+        // Measure 2, guitar: tempo drops to 60 and a half note is tied over.
+        i32(2);
+        beat(0x10, -1, 1 << 5, 60);
+        note(0x20, 1, 0);
+        beatEnd();
+        beat(0x00, -1, 1 << 5);
+        note(0x20, 2, 0);
+        beatEnd();
+        endMeasure();
+        i32(1);
+        rest();
+        endMeasure();
+        return bytes_;
+    }
+
+private:
+    void u8(int value) { bytes_.push_back(static_cast<std::byte>(value & 0xFF)); }
+    void zeros(int count) { bytes_.insert(bytes_.end(), static_cast<std::size_t>(count), std::byte{0}); }
+    void i16(int value)
+    {
+        u8(value);
+        u8(value >> 8);
+    }
+    void i32(int32_t value)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            u8(static_cast<int>(static_cast<uint32_t>(value) >> (8 * i)));
+        }
+    }
+    void chars(const std::string &text)
+    {
+        for (char c : text)
+        {
+            u8(c);
+        }
+    }
+    void byteSizeString(const std::string &text, int size)
+    {
+        u8(static_cast<int>(text.size()));
+        chars(text);
+        zeros(size - static_cast<int>(text.size()));
+    }
+    void intByteSizeString(const std::string &text)
+    {
+        i32(static_cast<int32_t>(text.size()) + 1);
+        u8(static_cast<int>(text.size()));
+        chars(text);
+    }
+
+    void measureHeader(bool first)
+    {
+        if (version_ >= 500 && !first)
+        {
+            u8(0);
+        }
+        u8(first ? 0x03 : 0x00);
+        if (first)
+        {
+            u8(4);
+            u8(4);
+        }
+        if (version_ >= 500)
+        {
+            if (first)
+            {
+                zeros(4); // Beams
+            }
+            u8(0); // No alternate ending
+            u8(0); // Triplet feel
+        }
+    }
+
+    void track(int number, const std::string &name)
+    {
+        if (version_ >= 500 && (number == 0 || version_ == 500))
+        {
+            u8(0);
+        }
+        u8(number == 1 ? 0x01 : 0x00);
+        byteSizeString(name, 40);
+        i32(6);
+        for (int note : {64, 59, 55, 50, 45, 40, 0})
+        {
+            i32(note);
+        }
+        i32(1);
+        i32(number);
+        i32(number);
+        i32(24);
+        i32(0);
+        zeros(4);
+        if (version_ >= 500)
+        {
+            zeros(4 + 25);
+            zeros(version_ == 500 ? 15 : 16);
+            if (version_ > 500)
+            {
+                zeros(4);
+                intByteSizeString("");
+                intByteSizeString("");
+            }
+        }
+    }
+
+    void beat(int flags, int duration, int strings, int tempo = -1)
+    {
+        u8(flags);
+        u8(duration);
+        if (flags & 0x10)
+        {
+            u8(-1);
+            if (version_ >= 500)
+            {
+                zeros(16);
+            }
+            for (int i = 0; i < 6; ++i)
+            {
+                u8(-1);
+            }
+            if (version_ >= 500)
+            {
+                intByteSizeString("");
+            }
+            i32(tempo);
+            u8(0);
+            if (version_ >= 510)
+            {
+                u8(0);
+            }
+            if (version_ >= 400)
+            {
+                u8(0);
+            }
+            if (version_ >= 500)
+            {
+                u8(0); // Wah
+            }
+            if (version_ >= 510)
+            {
+                intByteSizeString("");
+                intByteSizeString("");
+            }
+        }
+        u8(strings);
+    }
+
+    void rest()
+    {
+        u8(0x40);
+        u8(2);
+        u8(-2);
+        u8(0);
+        beatEnd();
+    }
+
+    void note(int flags, int type, int fret, int effects1 = -1, int effects2 = 0)
+    {
+        if (effects1 >= 0)
+        {
+            flags |= 0x08;
+        }
+        u8(flags);
+        u8(type);
+        u8(fret);
+        if (version_ >= 500)
+        {
+            u8(0);
+        }
+        if (effects1 >= 0)
+        {
+            u8(effects1);
+            if (version_ >= 400)
+            {
+                u8(effects2);
+            }
+            if (effects1 & 0x01)
+            {
+                u8(1);
+                i32(50);
+                i32(1);
+                i32(0);
+                i32(50);
+                u8(0);
+            }
+        }
+    }
+
+    void beatEnd()
+    {
+        if (version_ >= 500)
+        {
+            i16(0);
+        }
+    }
+
+    void endMeasure()
+    {
+        if (version_ >= 500)
+        {
+            i32(0); // Second voice
+            u8(0);
+        }
+    }
+
+    int version_;
+    std::vector<std::byte> bytes_;
+};
+
+void writeBytes(const std::filesystem::path &path, const std::vector<std::byte> &bytes)
+{
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+}
+
+TEST_CASE("Guitar Pro files compile to chart parts", "[guitarpro]")
+{
+    for (int version : {300, 406, 500, 510})
+    {
+        CAPTURE(version);
+        GuitarProSong song;
+        std::string error;
+        REQUIRE(parseGuitarPro(GpBuilder(version).build(), song, error));
+        CHECK(song.version == version);
+        CHECK(song.title == "Test Song");
+        CHECK(song.artist == "Test Artist");
+        CHECK(song.bpm == 120);
+
+        REQUIRE(song.chart.parts.size() == 1);
+        CHECK(song.chart.parts[0].name == "Lead");
+        const std::vector<ChartNote> &notes = song.chart.parts[0].notes;
+        REQUIRE(notes.size() == 5);
+
+        CHECK(notes[0].tick == 0);
+        CHECK(notes[0].fret == 5);
+        CHECK(notes[0].flags == ChartNoteNone);
+        CHECK(notes[1].tick == 960);
+        CHECK(notes[1].flags == ChartNoteHammerOn);
+        CHECK(notes[2].string == 5);
+        CHECK((notes[2].flags & ChartNoteDead) != 0);
+        CHECK(notes[3].string == 2);
+        CHECK((notes[3].flags & ChartNoteBend) != 0);
+        CHECK(((notes[3].flags & ChartNotePalmMute) != 0) == (version >= 400));
+        CHECK(notes[4].tick == 3840);
+        CHECK(notes[4].string == 1);
+        CHECK(notes[4].duration == 3840); // Tied half notes merge
+
+        REQUIRE(song.chart.tempo.size() == 2);
+        CHECK(song.chart.tempo[1].tick == 3840);
+        CHECK(song.chart.tempo[1].microsPerQuarter == 1000000);
+
+        TrackInfo info = guitarProTrackInfo(song, "charts/test.occhart");
+        REQUIRE(info.parts.size() == 1);
+        CHECK(info.parts[0].chartBlock == 0);
+        CHECK(info.parts[0].chartPath == "charts/test.occhart");
+        CHECK(info.length == "0:06");
+    }
+}
+
+TEST_CASE("Truncated Guitar Pro data is rejected", "[guitarpro]")
+{
+    std::vector<std::byte> bytes = GpBuilder(510).build();
+    bytes.resize(bytes.size() - 20);
+    GuitarProSong song;
+    std::string error;
+    CHECK_FALSE(parseGuitarPro(bytes, song, error));
+    CHECK_FALSE(error.empty());
+}
+
+TEST_CASE("Batch import skips unchanged files", "[guitarpro]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_gp_batch";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "in" / "nested");
+    writeBytes(root / "in" / "a.gp5", GpBuilder(510).build());
+    writeBytes(root / "in" / "nested" / "b.GP3", GpBuilder(300).build());
+    writeBytes(root / "in" / "broken.gp4", std::vector<std::byte>(16, std::byte{0}));
+
+    ChartImportOptions options;
+    options.input = root / "in";
+    options.output = root / "out";
+    options.jobs = 2;
+
+    ChartImportReport first = importCharts(options);
+    CHECK(first.error.empty());
+    REQUIRE(first.results.size() == 3);
+    CHECK(first.converted == 2);
+    CHECK(first.failed == 1);
+
+    std::string error;
+    auto chart = ChartFile::open(root / "out" / "nested" / "b.occhart", error);
+    REQUIRE(chart);
+    CHECK(chart->findPart("Lead") == 0);
+    CHECK(chart->part(0).size() == 5);
+
+    ChartImportReport second = importCharts(options);
+    CHECK(second.converted == 0);
+    CHECK(second.unchanged == 2);
+    CHECK(second.failed == 1);
+
+    writeBytes(root / "in" / "a.gp5", GpBuilder(500).build());
+    ChartImportReport third = importCharts(options);
+    CHECK(third.converted == 1);
+    CHECK(third.unchanged == 1);
+
+    options.force = true;
+    CHECK(importCharts(options).converted == 2);
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Batch import fails a source whose chart another source already writes", "[guitarpro]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_gp_batch_clash";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "in");
+    writeBytes(root / "in" / "song.gp4", GpBuilder(406).build());
+    writeBytes(root / "in" / "song.gp5", GpBuilder(510).build());
+
+    ChartImportOptions options;
+    options.input = root / "in";
+    options.output = root / "out";
+    options.jobs = 2;
+
+    ChartImportReport report = importCharts(options);
+    REQUIRE(report.results.size() == 2);
+    CHECK(report.converted == 1);
+    CHECK(report.failed == 1);
+    CHECK(report.results[0].status == ChartImportStatus::Converted);
+    CHECK(report.results[1].status == ChartImportStatus::Failed);
+    CHECK(report.results[1].error.find("song.gp4") != std::string::npos);
+
+    std::string error;
+    auto chart = ChartFile::open(root / "out" / "song.occhart", error);
+    REQUIRE(chart);
+    CHECK(chart->part(0).size() == 5);
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,161 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "gameplay/HighwayLayout.h"
+#include "track/ChartFile.h"
+#include "track/ChartWriter.h"
+
+namespace {
+// 120 BPM, so a beat is 0.5 s. A four second sustain on string 0 from the top,
+// then one short note per beat from beat 2 to beat 20, cycling the strings.
+std::shared_ptr<const ChartFile> openLayoutChart(const std::filesystem::path &path)
+{
+    ChartData chart;
+    chart.ticksPerQuarter = 480;
+    chart.tempo = {{0, 500000}};
+
+    ChartPartData lead{"Lead Guitar", {}};
+    ChartNote sustain;
+    sustain.tick = 0;
+    sustain.duration = 8 * 480;
+    lead.notes.push_back(sustain);
+    for (uint32_t beat = 2; beat <= 20; ++beat)
+    {
+        ChartNote note;
+        note.tick = beat * 480;
+        note.string = static_cast<uint8_t>(beat % 6);
+        note.fret = 3;
+        lead.notes.push_back(note);
+    }
+    chart.parts.push_back(lead);
+
+    std::string error;
+    REQUIRE(writeChart(path, chart, error));
+    auto file = ChartFile::open(path, error);
+    REQUIRE(file);
+    return file;
+}
+
+HighwaySettings layoutSettings()
+{
+    HighwaySettings settings;
+    settings.lookBehind = 0.25f;
+    settings.lookAhead = 2.4f;
+    settings.unitsPerSecond = 10.0f;
+    return settings;
+}
+}
+
+TEST_CASE("Highway layout selects the notes inside the window", "[highway]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "openchordix_highway_window.occhart";
+    HighwayLayout layout;
+    layout.setChart(openLayoutChart(path), 0);
+    REQUIRE(layout.hasChart());
+
+    // Window [2.75 s, 5.4 s]: beats 6 to 10 are in it, beat 5 has just passed.
+    const HighwaySettings settings = layoutSettings();
+    layout.build(3.0, settings);
+
+    const auto &gems = layout.instances(HighwayDrawType::Gem);
+    REQUIRE(gems.size() == 5);
+    for (std::size_t i = 0; i < gems.size(); ++i)
+    {
+        const uint32_t beat = static_cast<uint32_t>(6 + i);
+        const float seconds = 0.5f * static_cast<float>(beat);
+        CHECK(gems[i].transform[12] == Catch::Approx((static_cast<float>(beat % 6) - 2.5f) * settings.laneSpacing));
+        CHECK(gems[i].transform[13] == Catch::Approx(0.5f * settings.gemScale[1]));
+        CHECK(gems[i].transform[14] == Catch::Approx(-(seconds - 3.0f) * settings.unitsPerSecond));
+    }
+
+    // The sustain started at 0 s, long before the window, and is clipped to it.
+    const auto &sustains = layout.instances(HighwayDrawType::Sustain);
+    REQUIRE(sustains.size() == 1);
+    const float zFrom = 2.5f;   // 2.75 s, the window start
+    const float zTo = -10.0f;   // 4.0 s, the sustain end
+    CHECK(sustains[0].transform[14] == Catch::Approx(0.5f * (zFrom + zTo)));
+    CHECK(sustains[0].transform[10] == Catch::Approx(zFrom - zTo));
+    CHECK(sustains[0].transform[12] == Catch::Approx(-2.5f * settings.laneSpacing));
+
+    // Beats 6 to 10, with beat 8 opening a measure.
+    const auto &lines = layout.instances(HighwayDrawType::BeatLine);
+    REQUIRE(lines.size() == 5);
+    int measures = 0;
+    for (const HighwayInstance &line : lines)
+    {
+        if (line.colorState[0] == settings.measureColor[0])
+        {
+            ++measures;
+            CHECK(line.transform[14] == Catch::Approx(-10.0f));
+        }
+    }
+    CHECK(measures == 1);
+
+    layout.build(600.0, settings);
+    CHECK(layout.instances(HighwayDrawType::Gem).empty());
+    CHECK(layout.instances(HighwayDrawType::Sustain).empty());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Highway instances pack transform, colour and note state", "[highway]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "openchordix_highway_pack.occhart";
+    HighwayLayout layout;
+    layout.setChart(openLayoutChart(path), 0);
+    const HighwaySettings settings = layoutSettings();
+
+    // Note 5 is beat 6; note 6 is beat 7.
+    std::vector<uint8_t> states(7, static_cast<uint8_t>(HighwayNoteState::Upcoming));
+    states[5] = static_cast<uint8_t>(HighwayNoteState::Hit);
+    states[6] = static_cast<uint8_t>(HighwayNoteState::Missed);
+    layout.build(3.0, settings, states);
+
+    const auto &gems = layout.instances(HighwayDrawType::Gem);
+    REQUIRE(gems.size() == 5);
+    CHECK(gems[0].colorState[3] == 1.0f);
+    CHECK(gems[1].colorState[3] == 2.0f);
+    CHECK(gems[2].colorState[3] == 0.0f); // Past the end of the state list
+    CHECK(gems[0].colorState[0] == settings.stringColors[0][0]);
+    CHECK(gems[1].colorState[0] == settings.stringColors[1][0]);
+
+    // Column-major scale then translation, as the instanced vertex shader reads it.
+    const HighwayInstance &gem = gems[0];
+    CHECK(gem.transform[0] == settings.gemScale[0]);
+    CHECK(gem.transform[5] == settings.gemScale[1]);
+    CHECK(gem.transform[10] == settings.gemScale[2]);
+    CHECK(gem.transform[15] == 1.0f);
+    CHECK(gem.transform[1] == 0.0f);
+    CHECK(gem.transform[3] == 0.0f);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Highway layout ignores missing parts", "[highway]")
+{
+    const auto path = std::filesystem::temp_directory_path() / "openchordix_highway_parts.occhart";
+    HighwayLayout layout;
+    auto chart = openLayoutChart(path);
+
+    layout.setChart(chart, 3);
+    CHECK_FALSE(layout.hasChart());
+    layout.build(3.0, layoutSettings());
+    CHECK(layout.instances(HighwayDrawType::Gem).empty());
+    CHECK(layout.instances(HighwayDrawType::BeatLine).empty());
+
+    layout.setChart(chart, -1);
+    CHECK_FALSE(layout.hasChart());
+    layout.setChart(chart, 0);
+    CHECK(layout.hasChart());
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("Speed setting maps to highway units per second", "[highway]")
+{
+    CHECK(HighwaySettings::unitsPerSecondForSpeed(1) == Catch::Approx(5.5f));
+    CHECK(HighwaySettings::unitsPerSecondForSpeed(10) == Catch::Approx(19.0f));
+    CHECK(HighwaySettings::unitsPerSecondForSpeed(0) == HighwaySettings::unitsPerSecondForSpeed(1));
+    CHECK(HighwaySettings::unitsPerSecondForSpeed(42) == HighwaySettings::unitsPerSecondForSpeed(10));
+}
@@ -0,0 +1,186 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gameplay/HitJudge.h"
+#include "track/ChartWriter.h"
+
+namespace {
+constexpr double kHop = 256.0 / 48000.0;
+
+JudgeOptions testOptions()
+{
+    JudgeOptions options;
+    options.window = 0.080;
+    options.chartStart = 0.5;
+    options.inputLatency = 0.05;
+    return options;
+}
+
+// Pitch timeline in stream time: each (chartSeconds, midi) pair starts sounding at
+// that chart time and rings until the next one.
+void play(HitJudge &judge, const JudgeOptions &options, const std::vector<std::pair<double, int>> &strikes, double end)
+{
+    std::size_t next = 0;
+    int sounding = -1;
+    for (double stream = 0.0; stream < end; stream += kHop)
+    {
+        const double chart = stream - options.chartStart - options.inputLatency;
+        while (next < strikes.size() && strikes[next].first <= chart)
+        {
+            sounding = strikes[next++].second;
+        }
+        judge.onPitch(stream, sounding);
+    }
+}
+}
+
+TEST_CASE("Hit judge grades latency-compensated onsets", "[judge]")
+{
+    const JudgeOptions options = testOptions();
+    HitJudge judge({{1.0, 1.2, 64}, {2.0, 2.2, 66}, {3.0, 3.2, 67}}, options);
+
+    // On time, 60 ms late, and the third note never played.
+    play(judge, options, {{1.0, 64}, {1.5, -1}, {2.06, 66}, {2.5, -1}}, 5.0);
+
+    REQUIRE(judge.finished());
+    const JudgeStats &stats = judge.stats();
+    CHECK(stats.perfect == 1);
+    CHECK(stats.good == 1);
+    CHECK(stats.miss == 1);
+    CHECK(stats.maxCombo == 2);
+    CHECK(stats.combo == 0);
+    CHECK(stats.score == 150);
+
+    REQUIRE(judge.judgements().size() == 3);
+    CHECK(judge.judgements()[0].offset == Catch::Approx(0.0).margin(kHop));
+    CHECK(judge.judgements()[1].offset == Catch::Approx(0.06).margin(kHop));
+    CHECK(judge.judgements()[2].grade == JudgeGrade::Miss);
+}
+
+TEST_CASE("Hit judge resolves chords and stray onsets", "[judge]")
+{
+    JudgeOptions options = testOptions();
+    options.inputLatency = 0.0;
+    options.chartStart = 0.0;
+    HitJudge judge({{1.0, 1.5, 52}, {1.0, 1.5, 59}, {1.0, 1.5, 64}, {1.1, 1.5, 70}}, options);
+
+    judge.onOnset(0.5, 59);   // Before any window opens
+    judge.onOnset(1.01, 64);  // Judges the whole chord
+    judge.onOnset(1.02, 52);  // Chord already consumed
+    judge.advance(2.0);
+
+    CHECK(judge.stats().stray == 2);
+    CHECK(judge.stats().perfect == 3);
+    CHECK(judge.stats().miss == 1);
+    CHECK(judge.judgements().back().note == 3);
+    CHECK(judge.finished());
+}
+
+TEST_CASE("Hit judge replays deterministically with a bounded active set", "[judge]")
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> gap(0.05, 0.6);
+    std::uniform_int_distribution<int> pitch(40, 88);
+    std::normal_distribution<double> timing(0.0, 0.04);
+
+    std::vector<JudgeNote> notes;
+    std::vector<std::pair<double, int>> strikes;
+    double t = 2.0;
+    for (int i = 0; i < 5000; ++i)
+    {
+        JudgeNote note{t, t + 0.1, pitch(rng)};
+        notes.push_back(note);
+        if (i % 7 != 0)
+        {
+            strikes.push_back({t + timing(rng), note.midiNote});
+        }
+        t += gap(rng);
+    }
+    std::sort(strikes.begin(), strikes.end());
+
+    const JudgeOptions options = testOptions();
+    HitJudge first(notes, options);
+    HitJudge second(notes, options);
+    std::size_t maxActive = 0;
+    std::size_t next = 0;
+    int sounding = -1;
+    for (double stream = 0.0; stream < t + 2.0; stream += kHop)
+    {
+        const double chart = first.chartTime(stream);
+        while (next < strikes.size() && strikes[next].first <= chart)
+        {
+            sounding = strikes[next++].second;
+        }
+        first.onPitch(stream, sounding);
+        second.onPitch(stream, sounding);
+        maxActive = std::max(maxActive, first.active().size());
+    }
+
+    REQUIRE(first.finished());
+    CHECK(first.judgements().size() == notes.size());
+    CHECK(first.stats().score == second.stats().score);
+    CHECK(first.stats().perfect + first.stats().good + first.stats().miss == notes.size());
+    CHECK(first.stats().miss >= notes.size() / 7);
+    CHECK(maxActive <= 4);
+
+    // Replaying into the same judge after reset reproduces every judgement.
+    std::vector<Judgement> before = first.judgements();
+    first.reset();
+    next = 0;
+    sounding = -1;
+    for (double stream = 0.0; stream < t + 2.0; stream += kHop)
+    {
+        while (next < strikes.size() && strikes[next].first <= first.chartTime(stream))
+        {
+            sounding = strikes[next++].second;
+        }
+        first.onPitch(stream, sounding);
+    }
+    REQUIRE(first.judgements().size() == before.size());
+    for (std::size_t i = 0; i < before.size(); ++i)
+    {
+        REQUIRE(first.judgements()[i].note == before[i].note);
+        REQUIRE(first.judgements()[i].grade == before[i].grade);
+        REQUIRE(first.judgements()[i].offset == before[i].offset);
+    }
+}
+
+TEST_CASE("Judge notes are built from a mapped chart part", "[judge]")
+{
+    ChartData chart;
+    chart.ticksPerQuarter = 480;
+    chart.tempo = {{0, 500000}, {960, 1000000}};
+    ChartPartData part{"Lead", {}};
+    part.notes.push_back(ChartNote{0, 240, 0, 0, ChartNoteNone});
+    part.notes.push_back(ChartNote{480, 240, 5, 3, ChartNoteDead});
+    part.notes.push_back(ChartNote{1440, 480, 5, 3, ChartNoteHammerOn});
+    chart.parts.push_back(part);
+
+    const auto path = std::filesystem::temp_directory_path() / "openchordix_judge_notes.occhart";
+    std::string error;
+    REQUIRE(writeChart(path, chart, error));
+    auto file = ChartFile::open(path, error);
+    REQUIRE(file);
+
+    const JudgeOptions options;
+    std::vector<JudgeNote> notes = buildJudgeNotes(file->part(0), file->tempoMap(), options.tuning);
+    REQUIRE(notes.size() == 2);
+    CHECK(notes[0].midiNote == 64);
+    CHECK(notes[1].midiNote == 43);
+    CHECK(notes[1].seconds == Catch::Approx(2.0));
+    CHECK(notes[1].endSeconds == Catch::Approx(3.0));
+    CHECK(notes[1].flags == ChartNoteHammerOn);
+
+    CHECK(hitWindowSeconds(-3) == hitWindowSeconds(0));
+    CHECK(hitWindowSeconds(2) == Catch::Approx(0.080));
+    CHECK(pitchInputLatency(48000, 480, 2048) == Catch::Approx((480 + 1024) / 48000.0));
+
+    file.reset();
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,420 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "net/HttpClient.h"
+#include "net/TcpSocket.h"
+#include "score/ScoreServiceOnline.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// Loopback stand-in for the leaderboard server. Accepted submissions are served
+// back as the online board; failStatus makes every POST answer with that status.
+class StandInServer
+{
+public:
+    StandInServer()
+    {
+        std::string error;
+        listener_ = TcpSocket::listenLoopback(0, error);
+        REQUIRE(listener_.valid());
+        thread_ = std::thread([this]
+                              { serve(); });
+    }
+
+    ~StandInServer()
+    {
+        stop_ = true;
+        thread_.join();
+    }
+
+    std::string baseUrl() const { return "http://127.0.0.1:" + std::to_string(listener_.localPort()) + "/api"; }
+
+    std::atomic<int> failStatus{0};
+    std::atomic<int> fetches{0};
+    std::atomic<int> posts{0};
+
+    std::vector<std::string> rows() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rows_;
+    }
+
+private:
+    void serve()
+    {
+        while (!stop_)
+        {
+            TcpSocket client = listener_.accept(20ms);
+            if (!client.valid())
+            {
+                continue;
+            }
+            std::string request;
+            std::size_t headerEnd = std::string::npos;
+            std::size_t length = 0;
+            while (client.receive(request, 500ms) > 0)
+            {
+                headerEnd = request.find("\r\n\r\n");
+                if (headerEnd == std::string::npos)
+                {
+                    continue;
+                }
+                const std::size_t lengthAt = request.find("Content-Length: ");
+                length = lengthAt < headerEnd ? std::stoul(request.substr(lengthAt + 16)) : 0;
+                if (request.size() >= headerEnd + 4 + length)
+                {
+                    break;
+                }
+            }
+            if (headerEnd == std::string::npos)
+            {
+                continue;
+            }
+            client.sendAll(respond(request.substr(0, request.find("\r\n")), request.substr(headerEnd + 4, length)), 500ms);
+        }
+    }
+
+    std::string respond(const std::string &requestLine, const std::string &body)
+    {
+        std::string status = "200 OK";
+        std::string content;
+        if (requestLine.rfind("POST /api/scores ", 0) == 0)
+        {
+            ++posts;
+            if (failStatus != 0)
+            {
+                status = std::to_string(failStatus.load()) + " Unavailable";
+            }
+            else
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                std::size_t start = 0;
+                while (start < body.size())
+                {
+                    const std::size_t end = body.find('\n', start);
+                    rows_.push_back(body.substr(start, end - start));
+                    start = end + 1;
+                }
+            }
+        }
+        else if (requestLine.rfind("GET /api/leaderboard?", 0) == 0)
+        {
+            ++fetches;
+            if (requestLine.find("scope=country") != std::string::npos)
+            {
+                content = "1\tLocalHero\t40\t5000\n";
+            }
+            else
+            {
+                content = "1\tAria\t590\t1234900\r\n2\tRune\t560\t1120540\r\nnot a row\n";
+            }
+        }
+        else
+        {
+            status = "404 Not Found";
+        }
+        return "HTTP/1.1 " + status + "\r\nContent-Length: " + std::to_string(content.size()) +
+               "\r\nConnection: close\r\n\r\n" + content;
+    }
+
+    TcpSocket listener_;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    mutable std::mutex mutex_;
+    std::vector<std::string> rows_;
+};
+
+// Accepts one connection, reads the request headers and hands the socket to script.
+class ScriptedServer
+{
+public:
+    explicit ScriptedServer(std::function<void(TcpSocket &)> script)
+    {
+        std::string error;
+        listener_ = TcpSocket::listenLoopback(0, error);
+        REQUIRE(listener_.valid());
+        thread_ = std::thread([this, script = std::move(script)]
+                              {
+                                  TcpSocket client = listener_.accept(2000ms);
+                                  if (!client.valid())
+                                  {
+                                      return;
+                                  }
+                                  std::string request;
+                                  while (request.find("\r\n\r\n") == std::string::npos && client.receive(request, 500ms) > 0)
+                                  {
+                                  }
+                                  script(client);
+                              });
+    }
+
+    ~ScriptedServer() { thread_.join(); }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(listener_.localPort()) + "/"; }
+
+private:
+    TcpSocket listener_;
+    std::thread thread_;
+};
+
+HttpResponse fetchFrom(const ScriptedServer &server, std::chrono::milliseconds timeout = 1000ms)
+{
+    HttpRequest request;
+    request.url = server.url();
+    request.timeout = timeout;
+    return httpRequest(request);
+}
+
+TrackInfo onlineTrack()
+{
+    TrackInfo track;
+    track.title = "Night & Day";
+    track.artist = "Tester";
+    return track;
+}
+}
+
+TEST_CASE("HTTP URLs are parsed and encoded", "[leaderboard]")
+{
+    HttpUrl url;
+    REQUIRE(parseHttpUrl("http://example.org:8080/api/x?y=1", url));
+    CHECK(url.host == "example.org");
+    CHECK(url.port == 8080);
+    CHECK(url.target == "/api/x?y=1");
+    REQUIRE(parseHttpUrl("http://localhost", url));
+    CHECK(url.port == 80);
+    CHECK(url.target == "/");
+    CHECK_FALSE(parseHttpUrl("https://example.org/", url));
+    CHECK(urlEncode("Night & Day/1") == "Night%20%26%20Day%2F1");
+}
+
+TEST_CASE("Sockets report timeouts apart from orderly close", "[leaderboard]")
+{
+    std::string error;
+    TcpSocket listener = TcpSocket::listenLoopback(0, error);
+    REQUIRE(listener.valid());
+    TcpSocket client = TcpSocket::connect("127.0.0.1", listener.localPort(), 500ms, error);
+    REQUIRE(client.valid());
+    TcpSocket peer = listener.accept(500ms);
+    REQUIRE(peer.valid());
+
+    std::string data;
+    CHECK(client.receive(data, 20ms) == TcpSocket::kReceiveTimedOut);
+    REQUIRE(peer.sendAll("ping", 500ms));
+    CHECK(client.receive(data, 500ms) == 4);
+    CHECK(data == "ping");
+    peer.close();
+    CHECK(client.receive(data, 500ms) == 0);
+}
+
+TEST_CASE("HTTP responses cut short are errors, not short bodies", "[leaderboard]")
+{
+    SECTION("Content-Length not reached")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\nabc", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 0);
+        CHECK(response.body.empty());
+        CHECK(response.error == "response truncated");
+    }
+    SECTION("Chunked body without its terminator")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\n", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 0);
+        CHECK(response.error == "response truncated");
+    }
+    SECTION("Chunk size that is not hex")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabc\r\nzz\r\n\r\n", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 0);
+        CHECK(response.body.empty());
+        CHECK(response.error == "malformed chunked body");
+    }
+    SECTION("Chunk size with trailing garbage")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3x\r\nabc\r\n0\r\n\r\n", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 0);
+        CHECK(response.error == "malformed chunked body");
+    }
+    SECTION("Neither length nor chunked")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\n\r\nabc", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 0);
+        CHECK_FALSE(response.error.empty());
+    }
+    SECTION("Complete chunked body")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\n3;name=v\r\nabc\r\nA\r\n0123456789\r\n0\r\n\r\n", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.ok());
+        CHECK(response.body == "abc0123456789");
+    }
+    SECTION("No Content body")
+    {
+        ScriptedServer server([](TcpSocket &client)
+                              { client.sendAll("HTTP/1.1 204 No Content\r\n\r\n", 500ms); });
+        const HttpResponse response = fetchFrom(server);
+        CHECK(response.status == 204);
+        CHECK(response.error.empty());
+    }
+}
+
+TEST_CASE("HTTP timeout bounds the whole request", "[leaderboard]")
+{
+    // One byte every 50 ms never stalls a single read past the timeout.
+    std::atomic<bool> done{false};
+    ScriptedServer server([&](TcpSocket &client)
+                          {
+                              client.sendAll("HTTP/1.1 200 OK\r\nContent-Length: 1000\r\n\r\n", 500ms);
+                              for (int i = 0; i < 100 && !done; ++i)
+                              {
+                                  if (!client.sendAll("x", 500ms))
+                                  {
+                                      break;
+                                  }
+                                  std::this_thread::sleep_for(50ms);
+                              } });
+
+    const auto start = std::chrono::steady_clock::now();
+    const HttpResponse response = fetchFrom(server, 300ms);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    done = true;
+    CHECK(response.status == 0);
+    CHECK(response.error == "timed out");
+    CHECK(elapsed < 1000ms);
+}
+
+TEST_CASE("Leaderboards are fetched off-thread and cached with a TTL", "[leaderboard]")
+{
+    StandInServer server;
+    LeaderboardOptions options;
+    options.baseUrl = server.baseUrl();
+    options.ttl = 200ms;
+    TrackScoreServiceOnline service(options);
+    const TrackInfo track = onlineTrack();
+
+    // The first call only queues the fetch.
+    CHECK(service.scoresFor(track, "Lead", ScoreCategory::Online).empty());
+    CHECK(service.scoresFor(track, "Lead", ScoreCategory::Local).empty());
+    REQUIRE(service.waitIdle(2s));
+    std::vector<ScoreEntry> online = service.scoresFor(track, "Lead", ScoreCategory::Online);
+    REQUIRE(online.size() == 2);
+    CHECK(online[0].name == "Aria");
+    CHECK(online[1].score == 1120540);
+    CHECK(service.cacheVersion() == 1);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        service.scoresFor(track, "Lead", ScoreCategory::Online);
+    }
+    REQUIRE(service.waitIdle(2s));
+    CHECK(server.fetches == 1);
+
+    service.scoresFor(track, "Lead", ScoreCategory::Country);
+    REQUIRE(service.waitIdle(2s));
+    std::vector<ScoreEntry> country = service.scoresFor(track, "Lead", ScoreCategory::Country);
+    REQUIRE(country.size() == 1);
+    CHECK(country[0].name == "LocalHero");
+
+    // Past the TTL the stale board is still served while it refreshes.
+    std::this_thread::sleep_for(250ms);
+    CHECK(service.scoresFor(track, "Lead", ScoreCategory::Online).size() == 2);
+    REQUIRE(service.waitIdle(2s));
+    CHECK(server.fetches == 3);
+}
+
+TEST_CASE("Submissions queue offline, persist and drain in batches", "[leaderboard]")
+{
+    const auto queuePath = std::filesystem::temp_directory_path() / "openchordix_score_queue.tsv";
+    std::filesystem::remove(queuePath);
+    StandInServer server;
+    server.failStatus = 503;
+
+    LeaderboardOptions options;
+    options.baseUrl = server.baseUrl();
+    options.batchSize = 10;
+    options.retryInitial = 20ms;
+    options.retryMax = 80ms;
+    options.queuePath = queuePath;
+    const TrackInfo track = onlineTrack();
+    {
+        TrackScoreServiceOnline service(options);
+        for (int i = 0; i < 25; ++i)
+        {
+            REQUIRE(service.recordScore(track, "Lead", ScoreEntry{0, "Pix\tTab", i, 1000 + i}));
+        }
+        std::this_thread::sleep_for(300ms);
+        CHECK(service.pendingSubmissions() == 25);
+        CHECK(server.posts >= 2);
+        CHECK(server.posts < 20); // Backoff, not a hot loop
+    }
+
+    std::ifstream queued(queuePath);
+    CHECK(std::count(std::istreambuf_iterator<char>(queued), std::istreambuf_iterator<char>(), '\n') == 25);
+
+    server.failStatus = 0;
+    const int failedPosts = server.posts;
+    TrackScoreServiceOnline service(options);
+    CHECK(service.pendingSubmissions() == 25);
+    service.flush();
+    for (int i = 0; i < 200 && service.pendingSubmissions() > 0; ++i)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+    CHECK(service.pendingSubmissions() == 0);
+    CHECK(server.posts - failedPosts == 3);
+    std::vector<std::string> rows = server.rows();
+    REQUIRE(rows.size() == 25);
+    CHECK(rows.front() == "Night & Day\tTester\tLead\tPix Tab\t0\t1000");
+    CHECK(std::filesystem::file_size(queuePath) == 0);
+}
+
+TEST_CASE("Rejected batches are dropped and unreachable servers never block", "[leaderboard]")
+{
+    StandInServer server;
+    server.failStatus = 400;
+    LeaderboardOptions options;
+    options.baseUrl = server.baseUrl();
+    TrackScoreServiceOnline rejecting(options);
+    REQUIRE(rejecting.recordScore(onlineTrack(), "Lead", ScoreEntry{0, "Pix", 1, 1}));
+    for (int i = 0; i < 200 && rejecting.pendingSubmissions() > 0; ++i)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+    CHECK(rejecting.pendingSubmissions() == 0);
+
+    std::string error;
+    TcpSocket closed = TcpSocket::listenLoopback(0, error);
+    options.baseUrl = "http://127.0.0.1:" + std::to_string(closed.localPort());
+    closed.close();
+    options.timeout = 200ms;
+    TrackScoreServiceOnline offline(options);
+
+    const auto start = std::chrono::steady_clock::now();
+    CHECK(offline.scoresFor(onlineTrack(), "Lead", ScoreCategory::Online).empty());
+    CHECK(std::chrono::steady_clock::now() - start < 50ms);
+    REQUIRE(offline.waitIdle(2s));
+    CHECK(offline.scoresFor(onlineTrack(), "Lead", ScoreCategory::Online).empty());
+    CHECK(offline.cacheVersion() == 0);
+}
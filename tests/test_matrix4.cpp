@@ -0,0 +1,96 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <random>
+
+#include <bx/math.h>
+
+#include "render/Matrix4.h"
+
+using namespace openchordix::render;
+
+namespace {
+using Quaternion = std::array<float, 4>;
+
+Quaternion axisAngle(int axis, float angle)
+{
+    Quaternion q{0.0f, 0.0f, 0.0f, std::cos(0.5f * angle)};
+    q[axis] = std::sin(0.5f * angle);
+    return q;
+}
+
+// Hamilton product, xyzw: rotating by the result is rotating by b, then by a.
+Quaternion multiply(const Quaternion &a, const Quaternion &b)
+{
+    return {a[3] * b[0] + a[0] * b[3] + a[1] * b[2] - a[2] * b[1],
+            a[3] * b[1] - a[0] * b[2] + a[1] * b[3] + a[2] * b[0],
+            a[3] * b[2] + a[0] * b[1] - a[1] * b[0] + a[2] * b[3],
+            a[3] * b[3] - a[0] * b[0] - a[1] * b[1] - a[2] * b[2]};
+}
+
+void checkMatrix(const float *actual, const float *expected)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        CHECK(actual[i] == Catch::Approx(expected[i]).margin(1e-5));
+    }
+}
+}
+
+TEST_CASE("Matrix product matches bx::mtxMul", "[matrix]")
+{
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+    for (int round = 0; round < 16; ++round)
+    {
+        float a[16];
+        float b[16];
+        for (int i = 0; i < 16; ++i)
+        {
+            a[i] = value(random);
+            b[i] = value(random);
+        }
+        float expected[16];
+        bx::mtxMul(expected, a, b);
+        float actual[16];
+        multiplyMatrices(actual, a, b);
+        checkMatrix(actual, expected);
+    }
+}
+
+TEST_CASE("Composed transforms match bx scale, rotation and translation", "[matrix]")
+{
+    float scale[16];
+    float rotation[16];
+    float translation[16];
+    float scaled[16];
+    float expected[16];
+
+    bx::mtxScale(scale, 2.0f, 0.5f, 3.0f);
+    bx::mtxTranslate(translation, 1.0f, -2.0f, 4.0f);
+    bx::mtxMul(expected, scale, translation);
+    checkMatrix(composeTransform({1.0f, -2.0f, 4.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {2.0f, 0.5f, 3.0f}).data(), expected);
+
+    // glTF quaternions turn counter-clockwise about their axis; bx's mtxRotate*
+    // turn the other way, so a quaternion by `angle` is bx's rotation by -angle.
+    const float ax = 0.3f;
+    const float ay = -1.1f;
+    const float az = 2.0f;
+    bx::mtxRotateXYZ(rotation, -ax, 0.0f, 0.0f);
+    checkMatrix(composeTransform({0.0f, 0.0f, 0.0f}, axisAngle(0, ax), {1.0f, 1.0f, 1.0f}).data(), rotation);
+    bx::mtxRotateXYZ(rotation, 0.0f, -ay, 0.0f);
+    checkMatrix(composeTransform({0.0f, 0.0f, 0.0f}, axisAngle(1, ay), {1.0f, 1.0f, 1.0f}).data(), rotation);
+    bx::mtxRotateXYZ(rotation, 0.0f, 0.0f, -az);
+    checkMatrix(composeTransform({0.0f, 0.0f, 0.0f}, axisAngle(2, az), {1.0f, 1.0f, 1.0f}).data(), rotation);
+
+    // bx applies x, then y, then z.
+    const Quaternion q = multiply(axisAngle(2, az), multiply(axisAngle(1, ay), axisAngle(0, ax)));
+    bx::mtxRotateXYZ(rotation, -ax, -ay, -az);
+    bx::mtxMul(scaled, scale, rotation);
+    bx::mtxMul(expected, scaled, translation);
+    const Matrix4 composed = composeTransform({1.0f, -2.0f, 4.0f}, q, {2.0f, 0.5f, 3.0f});
+    checkMatrix(composed.data(), expected);
+    CHECK(maxAxisScale(composed.data()) == Catch::Approx(3.0f));
+}
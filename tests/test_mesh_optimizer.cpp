@@ -0,0 +1,159 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "render/MeshOptimizer.h"
+
+using openchordix::assets::Vertex;
+using namespace openchordix::render;
+
+namespace {
+Vertex gridVertex(int x, int y, int size)
+{
+    Vertex vertex;
+    vertex.position[0] = static_cast<float>(x);
+    vertex.position[1] = static_cast<float>(y);
+    vertex.position[2] = static_cast<float>((x * 7 + y * 3) % 5) * 0.1f;
+    vertex.normal[2] = 1.0f;
+    vertex.uv[0] = static_cast<float>(x) / static_cast<float>(size);
+    vertex.uv[1] = static_cast<float>(y) / static_cast<float>(size);
+    return vertex;
+}
+
+// A size x size quad grid the way an unindexed export stores it: every corner of
+// every triangle is its own vertex. Triangles come out in a shuffled order.
+void gridSoup(int size, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+    std::vector<std::array<Vertex, 3>> triangles;
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            triangles.push_back({gridVertex(x, y, size), gridVertex(x + 1, y, size), gridVertex(x + 1, y + 1, size)});
+            triangles.push_back({gridVertex(x, y, size), gridVertex(x + 1, y + 1, size), gridVertex(x, y + 1, size)});
+        }
+    }
+    std::mt19937 random(7);
+    std::shuffle(triangles.begin(), triangles.end(), random);
+
+    vertices.clear();
+    indices.clear();
+    for (const auto &triangle : triangles)
+    {
+        for (const Vertex &vertex : triangle)
+        {
+            indices.push_back(static_cast<uint32_t>(vertices.size()));
+            vertices.push_back(vertex);
+        }
+    }
+}
+
+// Each triangle as its corner positions, rotated so the smallest corner leads,
+// which keeps the winding but ignores where the triangle starts.
+std::vector<std::array<float, 9>> trianglePositions(const std::vector<Vertex> &vertices, const std::vector<uint32_t> &indices)
+{
+    std::vector<std::array<float, 9>> out;
+    for (std::size_t i = 0; i + 3 <= indices.size(); i += 3)
+    {
+        std::array<std::array<float, 3>, 3> corners;
+        for (int c = 0; c < 3; ++c)
+        {
+            const Vertex &vertex = vertices[indices[i + c]];
+            corners[c] = {vertex.position[0], vertex.position[1], vertex.position[2]};
+        }
+        const auto first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+        std::array<float, 9> triangle;
+        for (int c = 0; c < 3; ++c)
+        {
+            std::copy(corners[(first + c) % 3].begin(), corners[(first + c) % 3].end(), triangle.begin() + c * 3);
+        }
+        out.push_back(triangle);
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}
+}
+
+TEST_CASE("Vertex cache analysis counts transforms per triangle", "[mesh]")
+{
+    // Two triangles sharing an edge: four transforms, two triangles.
+    const std::vector<uint32_t> quad{0, 1, 2, 2, 1, 3};
+    const VertexCacheStats stats = analyzeVertexCache(quad, 4);
+    CHECK(stats.triangles == 2);
+    CHECK(stats.vertices == 4);
+    CHECK(stats.transforms == 4);
+    CHECK(stats.acmr() == 2.0f);
+    CHECK(stats.atvr() == 1.0f);
+
+    // With a three-entry cache, the first triangle is gone by the time it repeats.
+    const std::vector<uint32_t> repeat{0, 1, 2, 3, 4, 5, 0, 1, 2};
+    CHECK(analyzeVertexCache(repeat, 6, 3).transforms == 9);
+    CHECK(analyzeVertexCache(repeat, 6, 16).transforms == 6);
+}
+
+TEST_CASE("Welding merges identical vertices and keeps the triangles", "[mesh]")
+{
+    constexpr int size = 8;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    gridSoup(size, vertices, indices);
+    REQUIRE(vertices.size() == size * size * 6);
+    const auto before = trianglePositions(vertices, indices);
+
+    weldVertices(vertices, indices);
+    CHECK(vertices.size() == (size + 1) * (size + 1));
+    CHECK(trianglePositions(vertices, indices) == before);
+    for (uint32_t index : indices)
+    {
+        REQUIRE(index < vertices.size());
+    }
+
+    // A UV seam keeps two vertices at one position apart.
+    std::vector<Vertex> seam{gridVertex(0, 0, size), gridVertex(1, 0, size), gridVertex(0, 1, size),
+                             gridVertex(1, 0, size), gridVertex(1, 1, size), gridVertex(0, 1, size)};
+    seam[3].uv[0] = 0.0f;
+    std::vector<uint32_t> seamIndices{0, 1, 2, 3, 4, 5};
+    weldVertices(seam, seamIndices);
+    CHECK(seam.size() == 5);
+    CHECK(seamIndices[5] == seamIndices[2]);
+    CHECK(seamIndices[3] != seamIndices[1]);
+}
+
+TEST_CASE("Mesh optimization brings ACMR near the grid's bound", "[mesh]")
+{
+    constexpr int size = 32;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    gridSoup(size, vertices, indices);
+    const auto before = trianglePositions(vertices, indices);
+
+    const MeshOptimizationStats stats = optimizeMesh(vertices, indices);
+    CHECK(vertices.size() == (size + 1) * (size + 1));
+    CHECK(trianglePositions(vertices, indices) == before);
+
+    // Unwelded, every corner is a transform. A regular grid cannot go below
+    // vertices / triangles, about 0.53 here; a 16-entry FIFO lands well under 1.
+    CHECK(stats.cacheBefore.acmr() == 3.0f);
+    CHECK(stats.cacheAfter.triangles == size * size * 2);
+    CHECK(stats.cacheAfter.acmr() >= static_cast<float>(vertices.size()) / static_cast<float>(size * size * 2));
+    CHECK(stats.cacheAfter.acmr() < 0.9f);
+    CHECK(stats.cacheAfter.atvr() < 1.7f);
+
+    // The soup reads each vertex once, in order. After welding the shared vertices
+    // are read again on cache misses, but first-use order keeps them on nearby lines.
+    CHECK(stats.fetchBefore.overfetch() == 1.0f);
+    CHECK(stats.fetchAfter.referencedBytes == vertices.size() * sizeof(Vertex));
+    CHECK(stats.fetchAfter.overfetch() < 1.6f);
+    CHECK(stats.fetchAfter.fetchedBytes < stats.fetchBefore.fetchedBytes / 4);
+
+    uint32_t highest = 0;
+    for (std::size_t i = 0; i < indices.size(); ++i)
+    {
+        CHECK(indices[i] <= highest);
+        highest = std::max(highest, indices[i] + 1);
+    }
+}
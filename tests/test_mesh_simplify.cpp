@@ -0,0 +1,160 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "render/MeshOptimizer.h"
+
+using openchordix::assets::Vertex;
+using namespace openchordix::render;
+
+namespace {
+// An indexed size x size grid over [0, size] in x and y. Columns left of `seam`
+// and from `seam` on get their own vertices, so column `seam` is stored twice
+// with different UVs, like a texture seam. Heights come from `height(x, y)`.
+template <typename Height>
+void indexedGrid(int size, int seam, Height height, std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+    vertices.clear();
+    indices.clear();
+    const int columns = size + 1;
+    auto add = [&](int x, int y, float u)
+    {
+        Vertex vertex;
+        vertex.position[0] = static_cast<float>(x);
+        vertex.position[1] = static_cast<float>(y);
+        vertex.position[2] = height(x, y);
+        vertex.normal[2] = 1.0f;
+        vertex.uv[0] = u;
+        vertex.uv[1] = static_cast<float>(y) / static_cast<float>(size);
+        vertices.push_back(vertex);
+    };
+    for (int y = 0; y <= size; ++y)
+    {
+        for (int x = 0; x <= size; ++x)
+        {
+            add(x, y, static_cast<float>(x) / static_cast<float>(size));
+        }
+    }
+    const uint32_t seamBase = static_cast<uint32_t>(vertices.size());
+    for (int y = 0; y <= size && seam > 0; ++y)
+    {
+        add(seam, y, 1.0f);
+    }
+
+    auto at = [&](int x, int y, bool rightOfSeam)
+    {
+        if (x == seam && !rightOfSeam && seam > 0)
+        {
+            return seamBase + static_cast<uint32_t>(y);
+        }
+        return static_cast<uint32_t>(y * columns + x);
+    };
+    for (int y = 0; y < size; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            const bool right = x >= seam;
+            indices.insert(indices.end(), {at(x, y, right), at(x + 1, y, right), at(x + 1, y + 1, right),
+                                           at(x, y, right), at(x + 1, y + 1, right), at(x, y + 1, right)});
+        }
+    }
+}
+
+std::set<uint32_t> referenced(const std::vector<uint32_t> &indices)
+{
+    return {indices.begin(), indices.end()};
+}
+}
+
+TEST_CASE("Simplification collapses a flat interior but keeps borders and seams", "[mesh][simplify]")
+{
+    constexpr int size = 16;
+    constexpr int seam = 8;
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    indexedGrid(size, seam, [](int, int) { return 0.0f; }, vertices, indices);
+
+    std::vector<uint32_t> out;
+    const float error = simplifyMesh(indices, vertices, 0, 0.01f, out);
+    CHECK(error < 1e-4f);
+    CHECK(out.size() % 3 == 0);
+    CHECK(out.size() < indices.size() / 2);
+
+    const std::set<uint32_t> kept = referenced(out);
+    for (uint32_t v = 0; v < vertices.size(); ++v)
+    {
+        const float x = vertices[v].position[0];
+        const float y = vertices[v].position[1];
+        const bool border = x == 0.0f || y == 0.0f || x == size || y == size;
+        const bool onSeam = x == seam;
+        if (border || onSeam)
+        {
+            CHECK(kept.count(v) == 1);
+        }
+    }
+
+    // Triangles touching the seam still use their own side's copy of it.
+    const uint32_t firstLeftCopy = (size + 1) * (size + 1);
+    for (std::size_t i = 0; i < out.size(); i += 3)
+    {
+        float sumX = 0.0f;
+        for (int c = 0; c < 3; ++c)
+        {
+            REQUIRE(out[i + c] < vertices.size());
+            sumX += vertices[out[i + c]].position[0];
+        }
+        const bool left = sumX < 3.0f * seam;
+        for (int c = 0; c < 3; ++c)
+        {
+            if (vertices[out[i + c]].position[0] == seam)
+            {
+                CHECK((out[i + c] >= firstLeftCopy) == left);
+            }
+        }
+        CHECK(out[i] != out[i + 1]);
+        CHECK(out[i + 1] != out[i + 2]);
+        CHECK(out[i] != out[i + 2]);
+    }
+}
+
+TEST_CASE("Simplification stops at the error budget", "[mesh][simplify]")
+{
+    constexpr int size = 24;
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> bump(0.0f, 0.6f);
+    std::vector<float> heights((size + 1) * (size + 1));
+    for (float &height : heights)
+    {
+        height = bump(random);
+    }
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+    indexedGrid(size, 0, [&](int x, int y) { return heights[y * (size + 1) + x]; }, vertices, indices);
+
+    // Errors are returned in position units; the budget is relative to the extent.
+    const float extent = static_cast<float>(size);
+    std::vector<uint32_t> tight;
+    const float tightError = simplifyMesh(indices, vertices, 0, 0.005f, tight);
+    CHECK(tightError <= 0.005f * extent + 1e-5f);
+
+    std::vector<uint32_t> loose;
+    const float looseError = simplifyMesh(indices, vertices, 0, 0.05f, loose);
+    CHECK(looseError <= 0.05f * extent + 1e-5f);
+    CHECK(looseError >= tightError);
+    CHECK(loose.size() < tight.size());
+    CHECK(tight.size() <= indices.size());
+
+    // A reachable target is met without using the whole budget.
+    std::vector<uint32_t> target;
+    simplifyMesh(indices, vertices, indices.size() * 3 / 4, 1.0f, target);
+    CHECK(target.size() <= indices.size() * 3 / 4);
+    CHECK(target.size() > indices.size() / 4);
+
+    // Nothing to do when already under the target.
+    std::vector<uint32_t> same;
+    CHECK(simplifyMesh(indices, vertices, indices.size(), 1.0f, same) == 0.0f);
+    CHECK(same == indices);
+}
@@ -0,0 +1,266 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "track/ChartImportBatch.h"
+#include "track/MidiImporter.h"
+
+namespace {
+class SmfBuilder
+{
+public:
+    SmfBuilder(int format, int division) : format_(format), division_(division) {}
+
+    SmfBuilder &beginTrack()
+    {
+        track_.clear();
+        return *this;
+    }
+
+    SmfBuilder &event(uint32_t delta, std::initializer_list<int> bytes)
+    {
+        vlq(delta);
+        for (int b : bytes)
+        {
+            track_.push_back(static_cast<std::byte>(b));
+        }
+        return *this;
+    }
+
+    SmfBuilder &meta(uint32_t delta, int type, const std::vector<int> &data)
+    {
+        vlq(delta);
+        track_.push_back(std::byte{0xFF});
+        track_.push_back(static_cast<std::byte>(type));
+        vlq(static_cast<uint32_t>(data.size()));
+        for (int b : data)
+        {
+            track_.push_back(static_cast<std::byte>(b));
+        }
+        return *this;
+    }
+
+    SmfBuilder &name(const std::string &text)
+    {
+        return meta(0, 0x03, std::vector<int>(text.begin(), text.end()));
+    }
+
+    SmfBuilder &endTrack(uint32_t delta = 0)
+    {
+        meta(delta, 0x2F, {});
+        tracks_.push_back(track_);
+        return *this;
+    }
+
+    std::vector<std::byte> build() const
+    {
+        std::vector<std::byte> out;
+        chunk(out, "MThd", {static_cast<std::byte>(format_ >> 8), static_cast<std::byte>(format_),
+                            static_cast<std::byte>(tracks_.size() >> 8), static_cast<std::byte>(tracks_.size()),
+                            static_cast<std::byte>(division_ >> 8), static_cast<std::byte>(division_)});
+        for (const auto &track : tracks_)
+        {
+            chunk(out, "MTrk", track);
+        }
+        return out;
+    }
+
+private:
+    void vlq(uint32_t value)
+    {
+        std::byte buffer[4];
+        int count = 0;
+        do
+        {
+            buffer[count++] = static_cast<std::byte>(value & 0x7F);
+            value >>= 7;
+        } while (value > 0);
+        while (count > 0)
+        {
+            std::byte b = buffer[--count];
+            track_.push_back(count > 0 ? (b | std::byte{0x80}) : b);
+        }
+    }
+
+    static void chunk(std::vector<std::byte> &out, const char *id, const std::vector<std::byte> &body)
+    {
+        for (int i = 0; i < 4; ++i)
+        {
+            out.push_back(static_cast<std::byte>(id[i]));
+        }
+        uint32_t size = static_cast<uint32_t>(body.size());
+        for (int shift = 24; shift >= 0; shift -= 8)
+        {
+            out.push_back(static_cast<std::byte>(size >> shift));
+        }
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    int format_;
+    int division_;
+    std::vector<std::byte> track_;
+    std::vector<std::vector<std::byte>> tracks_;
+};
+
+// Roughly 1 MB: one track per string, each note an on/off pair under running status.
+std::vector<std::byte> buildLargeSmf(std::size_t notesPerString)
+{
+    SmfBuilder smf(1, 480);
+    smf.beginTrack().meta(0, 0x51, {0x07, 0xA1, 0x20}).endTrack();
+    const int open[] = {64, 59, 55, 50, 45, 40};
+    for (int string = 0; string < 6; ++string)
+    {
+        smf.beginTrack().name("String " + std::to_string(string + 1));
+        smf.event(0, {0x90 | string, open[string], 100});
+        smf.event(60, {open[string], 0});
+        for (std::size_t i = 1; i < notesPerString; ++i)
+        {
+            if (i % 4000 == 0)
+            {
+                smf.meta(0, 0x51, {0x07, 0xA1, 0x20}); // Tempo events break running status
+                smf.event(60, {0x90 | string, open[string] + static_cast<int>(i % 12), 100});
+            }
+            else
+            {
+                smf.event(60, {open[string] + static_cast<int>(i % 12), 100});
+            }
+            smf.event(60, {open[string] + static_cast<int>(i % 12), 0});
+        }
+        smf.endTrack();
+    }
+    return smf.build();
+}
+}
+
+TEST_CASE("MIDI notes map channels to strings and compile the tempo map", "[midi]")
+{
+    SmfBuilder smf(1, 480);
+    smf.beginTrack()
+        .name("Song")
+        .meta(0, 0x58, {3, 2, 24, 8})
+        .meta(0, 0x51, {0x07, 0xA1, 0x20})  // 120 BPM
+        .meta(960, 0x51, {0x0F, 0x42, 0x40}) // 60 BPM
+        .endTrack();
+    smf.beginTrack()
+        .name("Guitar")
+        .event(0, {0x90, 69, 100})  // String 1, fret 5
+        .event(240, {0x80, 69, 0})
+        .event(240, {0x91, 62, 90}) // String 2, fret 3
+        .event(240, {62, 0})        // Running status, velocity 0 is note-off
+        .event(0, {0x99, 36, 100})  // Channel 10 is not a string
+        .event(0, {0x92, 50, 100})  // Below open G
+        .event(240, {0x95, 40, 100}) // String 6 open, never released
+        .endTrack(240);
+
+    MidiSong song;
+    std::string error;
+    REQUIRE(parseMidi(smf.build(), MidiImportOptions{}, song, error));
+    CHECK(song.format == 1);
+    CHECK(song.title == "Song");
+    CHECK(song.skippedNotes == 2);
+
+    REQUIRE(song.chart.parts.size() == 1);
+    CHECK(song.chart.parts[0].name == "Guitar");
+    const auto &notes = song.chart.parts[0].notes;
+    REQUIRE(notes.size() == 3);
+    CHECK(notes[0].tick == 0);
+    CHECK(notes[0].duration == 240);
+    CHECK(notes[0].string == 0);
+    CHECK(notes[0].fret == 5);
+    CHECK(notes[1].tick == 480);
+    CHECK(notes[1].duration == 240);
+    CHECK(notes[1].string == 1);
+    CHECK(notes[1].fret == 3);
+    CHECK(notes[2].tick == 960);
+    CHECK(notes[2].duration == 240);
+    CHECK(notes[2].string == 5);
+    CHECK(notes[2].fret == 0);
+
+    REQUIRE(song.tempoMap.segments().size() == 2);
+    CHECK(song.tempoMap.segments()[1].startSeconds == Catch::Approx(1.0));
+    CHECK(song.tempoMap.tickToSeconds(1440) == Catch::Approx(2.0));
+    REQUIRE(song.timeSignatures.size() == 1);
+    CHECK(song.timeSignatures[0].numerator == 3);
+    CHECK(song.timeSignatures[0].denominator == 4);
+}
+
+TEST_CASE("Malformed MIDI data is rejected", "[midi]")
+{
+    MidiSong song;
+    std::string error;
+    std::vector<std::byte> junk(32, std::byte{0x42});
+    CHECK_FALSE(parseMidi(junk, MidiImportOptions{}, song, error));
+
+    SmfBuilder smf(0, 480);
+    smf.beginTrack().event(0, {64, 100}).endTrack(); // Data byte with no status
+    error.clear();
+    CHECK_FALSE(parseMidi(smf.build(), MidiImportOptions{}, song, error));
+    CHECK_FALSE(error.empty());
+}
+
+TEST_CASE("Batch import reconverts MIDI files when the string mapping changes", "[midi]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_midi_batch";
+    std::filesystem::remove_all(root);
+    std::filesystem::create_directories(root / "in");
+    SmfBuilder smf(0, 480);
+    smf.beginTrack().event(0, {0x90, 69, 100}).event(240, {0x80, 69, 0}).endTrack();
+    const std::vector<std::byte> bytes = smf.build();
+    {
+        std::ofstream out(root / "in" / "song.mid", std::ios::binary);
+        out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    ChartImportOptions options;
+    options.input = root / "in";
+    options.output = root / "out";
+    options.jobs = 1;
+    CHECK(importCharts(options).converted == 1);
+    CHECK(importCharts(options).unchanged == 1);
+
+    options.midi.firstChannel = 1;
+    CHECK(importCharts(options).converted == 1);
+    CHECK(importCharts(options).unchanged == 1);
+
+    options.midi.tuning[0] = 62;
+    CHECK(importCharts(options).converted == 1);
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("MIDI import of a 1 MB file", "[midi][benchmark]")
+{
+    const std::vector<std::byte> bytes = buildLargeSmf(30000);
+    REQUIRE(bytes.size() > 1000000);
+
+    MidiSong song;
+    std::string error;
+    double bestMillis = 1e9;
+    for (int run = 0; run < 3; ++run)
+    {
+        auto start = std::chrono::steady_clock::now();
+        REQUIRE(parseMidi(bytes, MidiImportOptions{}, song, error));
+        auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start);
+        bestMillis = std::min(bestMillis, elapsed.count());
+    }
+    REQUIRE(song.chart.parts.size() == 6);
+    CHECK(song.chart.parts[5].notes.size() == 30000);
+    CHECK(song.skippedNotes == 0);
+    // Generous bound so sanitizer and debug builds pass; release parses in a few ms.
+    CHECK(bestMillis < 250.0);
+
+    BENCHMARK("parseMidi 1 MB")
+    {
+        MidiSong out;
+        std::string benchError;
+        parseMidi(bytes, MidiImportOptions{}, out, benchError);
+        return out.chart.parts.size();
+    };
+}
@@ -0,0 +1,119 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include "render/ModelRenderQueue.h"
+
+using namespace openchordix::render;
+
+namespace {
+ModelRenderQueue::Draw makeDraw(uint16_t viewId, AlphaMode pass, uint16_t program, uint32_t material,
+                                uint16_t texture, float distance = 0.0f)
+{
+    ModelRenderQueue::Draw draw;
+    draw.viewId = viewId;
+    draw.pass = pass;
+    draw.program = {program};
+    draw.material = material;
+    draw.distance = distance;
+    draw.textures = {bgfx::TextureHandle{texture}, bgfx::TextureHandle{1}, bgfx::TextureHandle{2},
+                     bgfx::TextureHandle{3}, bgfx::TextureHandle{4}};
+    return draw;
+}
+
+ModelRenderQueue::UniformBlock block(float value)
+{
+    ModelRenderQueue::UniformBlock out{};
+    for (auto &uniform : out)
+    {
+        uniform = {value, value, value, 1.0f};
+    }
+    return out;
+}
+
+std::vector<uint16_t> queuedOrder(const ModelRenderQueue &queue)
+{
+    std::vector<uint16_t> order;
+    for (const ModelRenderQueue::Draw &draw : queue.draws)
+    {
+        order.push_back(draw.vertexBuffer.idx);
+    }
+    return order;
+}
+}
+
+TEST_CASE("Render queue sorts by view, pass and state, blends back to front", "[render]")
+{
+    ModelRenderQueue queue;
+    const std::vector<ModelRenderQueue::Draw> draws{
+        makeDraw(1, AlphaMode::Opaque, 0, 0, 10),
+        makeDraw(0, AlphaMode::Blend, 0, 0, 10, 2.0f),
+        makeDraw(0, AlphaMode::Opaque, 1, 0, 10),
+        makeDraw(0, AlphaMode::Blend, 1, 1, 11, 8.0f),
+        makeDraw(0, AlphaMode::Opaque, 0, 1, 10),
+        makeDraw(0, AlphaMode::Mask, 0, 0, 10),
+        makeDraw(0, AlphaMode::Opaque, 0, 0, 12),
+        makeDraw(0, AlphaMode::Opaque, 0, 0, 10),
+        makeDraw(0, AlphaMode::Blend, 0, 0, 10, 5.0f)};
+    // Each draw's vertex buffer records where it was queued.
+    for (std::size_t i = 0; i < draws.size(); ++i)
+    {
+        queue.draws.push_back(draws[i]);
+        queue.draws.back().vertexBuffer = {static_cast<uint16_t>(i)};
+    }
+
+    queue.sort();
+    // View 0 first. Opaque by program, then material, then textures; then mask;
+    // then blend from the farthest in, whatever their state. View 1 last.
+    CHECK(queuedOrder(queue) == std::vector<uint16_t>{7, 6, 4, 2, 5, 3, 8, 1, 0});
+}
+
+TEST_CASE("Bind state skips uniforms and textures the previous draw set", "[render]")
+{
+    ModelRenderQueue queue;
+    queue.frames = {block(0.5f)};
+    queue.materials = {block(1.0f), block(1.0f), block(1.0f)};
+    queue.materials[1][2] = {0.0f, 0.0f, 0.0f, 1.0f}; // Differs from material 0 in one uniform
+    queue.draws = {makeDraw(0, AlphaMode::Opaque, 0, 0, 10), makeDraw(0, AlphaMode::Opaque, 0, 0, 10),
+                   makeDraw(0, AlphaMode::Opaque, 0, 1, 10), makeDraw(0, AlphaMode::Opaque, 0, 2, 11),
+                   makeDraw(1, AlphaMode::Opaque, 0, 2, 11)};
+
+    ModelRenderStats stats;
+    ModelBindState binds;
+    std::vector<ModelBindChanges> changes;
+    for (std::size_t i = 0; i < queue.draws.size(); ++i)
+    {
+        if (i == 0 || queue.draws[i - 1].viewId != queue.draws[i].viewId)
+        {
+            binds.beginView();
+        }
+        changes.push_back(binds.bind(queue, queue.draws[i], stats));
+    }
+
+    // The first draw of a view sets everything.
+    CHECK(changes[0].frame == 0x3F);
+    CHECK(changes[0].material == 0x3F);
+    CHECK(changes[0].textures == 0x1F);
+    // An identical draw sets nothing.
+    CHECK(changes[1].frame == 0);
+    CHECK(changes[1].material == 0);
+    CHECK(changes[1].textures == 0);
+    // Another material only sets the uniform that differs.
+    CHECK(changes[2].frame == 0);
+    CHECK(changes[2].material == 0x04);
+    CHECK(changes[2].textures == 0);
+    // Equal values count as bound even from another material; a new base colour
+    // texture only rebinds stage 0.
+    CHECK(changes[3].material == 0x04);
+    CHECK(changes[3].textures == 0x01);
+    // A new view assumes nothing.
+    CHECK(changes[4].frame == 0x3F);
+    CHECK(changes[4].material == 0x3F);
+    CHECK(changes[4].textures == 0x1F);
+
+    CHECK(stats.uniformUpdates == 12 + 0 + 1 + 1 + 12);
+    CHECK(stats.uniformUpdatesSkipped == 5 * 12 - stats.uniformUpdates);
+    CHECK(stats.textureBinds == 5 + 0 + 0 + 1 + 5);
+    CHECK(stats.textureBindsSkipped == 5 * 5 - stats.textureBinds);
+}
@@ -0,0 +1,72 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include "render/FrustumCull.h"
+#include "render/Matrix4.h"
+#include "render/Model.h"
+
+using namespace openchordix::render;
+
+namespace {
+// Meshes without GPU buffers: only their bounds matter here.
+Model twoNodeModel()
+{
+    Model model;
+    for (int i = 0; i < 2; ++i)
+    {
+        ModelMesh mesh;
+        mesh.boundsMin = {-0.5f, -0.5f, -0.5f};
+        mesh.boundsMax = {0.5f, 0.5f, 0.5f};
+        model.meshes.push_back(std::move(mesh));
+    }
+    NodeTransform root;
+    NodeTransform child;
+    child.parent = 0;
+    const std::vector<NodeTransform> nodes{root, child};
+    model.setNodes(nodes, {MeshInstance{0, 0}, MeshInstance{1, 1}});
+    return model;
+}
+
+// How queueInstances culls a copy: the model's bounds placed by the copy's transform.
+bool copyVisible(const Model &model, const Matrix4 &transform)
+{
+    const Frustum cube = extractFrustum(kIdentityMatrix.data(), kIdentityMatrix.data(), true);
+    std::array<float, 3> min{};
+    std::array<float, 3> max{};
+    transformBounds(transform.data(), model.bounds.min, model.bounds.max, min, max);
+    CullBoxes copies;
+    copies.resize(1);
+    copies.set(0, min, max);
+    std::vector<uint8_t> visible(1, 0);
+    return cullBoxes(cube, kIdentityMatrix.data(), copies, visible) == 1;
+}
+}
+
+TEST_CASE("Model bounds follow nodes moved after loading", "[render]")
+{
+    Model model = twoNodeModel();
+    CHECK(model.bounds.min[0] == Catch::Approx(-0.5f));
+    CHECK(model.bounds.max[0] == Catch::Approx(0.5f));
+
+    // Animate the child ten units along x, outside the box it was loaded with.
+    model.nodes.setLocal(1, {10.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    model.updateTransforms();
+    CHECK(model.bounds.min[0] == Catch::Approx(-0.5f));
+    CHECK(model.bounds.max[0] == Catch::Approx(10.5f));
+    CHECK(model.bounds.center[0] == Catch::Approx(5.0f));
+    CHECK(model.bounds.maxExtent == Catch::Approx(11.0f));
+
+    // A copy placed so only the moved child lands in view is still drawn.
+    const Matrix4 placement = composeTransform({-10.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    CHECK(copyVisible(model, placement));
+    const Matrix4 away = composeTransform({-20.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    CHECK_FALSE(copyVisible(model, away));
+
+    // Nothing dirty: bounds stay as they are.
+    model.updateTransforms();
+    CHECK(model.bounds.max[0] == Catch::Approx(10.5f));
+}
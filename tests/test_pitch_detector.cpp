@@ -2,6 +2,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <cmath>
+#include <thread>
 #include <vector>
 
 #include "PitchDetector.h"
@@ -56,3 +57,82 @@ TEST_CASE("PitchDetector detects a steady sine wave", "[pitch]")
     float cents = 1200.0f * std::log2(normalized / frequency);
     REQUIRE(std::fabs(cents) <= 250.0f);
 }
+
+TEST_CASE("PitchDetector accumulates blocks smaller than the hop size", "[pitch]")
+{
+    const uint_t hopSize = 1024;
+    const uint_t blockSize = 300;
+    const uint_t sampleRate = 48000;
+    const float frequency = 220.0f;
+
+    PitchDetector detector(hopSize, hopSize, sampleRate);
+
+    std::vector<float> buffer(blockSize, 0.0f);
+    double phase = 0.0;
+    const double phaseInc = 2.0 * M_PI * frequency / static_cast<double>(sampleRate);
+
+    for (int block = 0; block < 240; ++block)
+    {
+        for (uint_t i = 0; i < blockSize; ++i)
+        {
+            buffer[i] = static_cast<float>(std::sin(phase));
+            phase += phaseInc;
+            if (phase > 2.0 * M_PI)
+            {
+                phase -= 2.0 * M_PI;
+            }
+        }
+        detector.process(buffer.data(), blockSize, 1);
+    }
+
+    float detected = detector.getPitchHz();
+    REQUIRE(detected > 0.0f);
+
+    float normalized = detected;
+    while (normalized > frequency * 1.5f)
+    {
+        normalized *= 0.5f;
+    }
+    while (normalized < frequency / 1.5f)
+    {
+        normalized *= 2.0f;
+    }
+    float cents = 1200.0f * std::log2(normalized / frequency);
+    REQUIRE(std::fabs(cents) <= 250.0f);
+}
+
+TEST_CASE("PitchDetector keeps blocks that arrive while another caller is analysing", "[pitch]")
+{
+    const uint_t hopSize = 512;
+    const uint_t blockSize = 128;
+    const uint_t sampleRate = 48000;
+    const int blocksPerCaller = 4000;
+
+    PitchDetector detector(hopSize * 2, hopSize, sampleRate);
+
+    // Two streams overlap during a hot-swap; neither may silently lose samples.
+    auto feed = [&](float frequency)
+    {
+        std::vector<float> buffer(blockSize, 0.0f);
+        double phase = 0.0;
+        const double phaseInc = 2.0 * M_PI * frequency / static_cast<double>(sampleRate);
+        for (int block = 0; block < blocksPerCaller; ++block)
+        {
+            for (uint_t i = 0; i < blockSize; ++i)
+            {
+                buffer[i] = static_cast<float>(std::sin(phase));
+                phase += phaseInc;
+            }
+            detector.process(buffer.data(), blockSize, 1);
+        }
+    };
+
+    std::thread first(feed, 220.0f);
+    std::thread second(feed, 330.0f);
+    first.join();
+    second.join();
+
+    const uint64_t total = static_cast<uint64_t>(blocksPerCaller) * blockSize * 2;
+    REQUIRE(detector.samplesProcessed() + detector.samplesDropped() == total);
+    REQUIRE(detector.samplesProcessed() > total / 2);
+}
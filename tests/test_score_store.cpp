@@ -0,0 +1,191 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "FileSync.h"
+#include "score/ScoreServiceFile.h"
+
+namespace {
+std::filesystem::path freshLog(const char *name)
+{
+    auto path = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove(path);
+    std::filesystem::remove(path.string() + ".corrupt");
+    return path;
+}
+
+TrackInfo testTrack(const char *title)
+{
+    TrackInfo track;
+    track.title = title;
+    track.artist = "Tester";
+    return track;
+}
+
+class FixedRemote : public TrackScoreService
+{
+public:
+    std::vector<ScoreEntry> scoresFor(const TrackInfo &, const std::string &, ScoreCategory) const override
+    {
+        return {{1, "Remote", 10, 1000}};
+    }
+};
+}
+
+TEST_CASE("Score store answers top-K and personal bests across reopen", "[scores]")
+{
+    const auto path = freshLog("openchordix_scores_basic.log");
+    const TrackInfo track = testTrack("Song A");
+    {
+        TrackScoreServiceFile store(path, std::make_unique<FixedRemote>());
+        REQUIRE(store.ok());
+        const char *players[] = {"Pix", "Juno", "Riff"};
+        for (int i = 0; i < 30; ++i)
+        {
+            REQUIRE(store.recordScore(track, "Lead", ScoreEntry{0, players[i % 3], i, 1000 + (i * 37) % 101}));
+        }
+        REQUIRE(store.recordScore(testTrack("Song B"), "Lead", ScoreEntry{0, "Pix", 5, 5}));
+        CHECK_FALSE(store.recordScore(track, "Lead", ScoreEntry{0, "", 1, 1}));
+
+        std::vector<ScoreEntry> online = store.scoresFor(track, "Lead", ScoreCategory::Online);
+        REQUIRE(online.size() == 1);
+        CHECK(online[0].name == "Remote");
+    }
+
+    TrackScoreServiceFile store(path);
+    CHECK(store.logRecords() == 31);
+    std::vector<ScoreEntry> top = store.scoresFor(track, "Lead", ScoreCategory::Local);
+    REQUIRE(top.size() == 10);
+    for (std::size_t i = 0; i < top.size(); ++i)
+    {
+        CHECK(top[i].place == static_cast<int>(i + 1));
+        if (i > 0)
+        {
+            CHECK(top[i - 1].score >= top[i].score);
+        }
+    }
+    CHECK(top[0].score == 1097); // i = 19: 19 * 37 % 101 == 97
+    CHECK(store.scoresFor(track, "Bass", ScoreCategory::Local).empty());
+    CHECK(store.scoresFor(track, "Lead", ScoreCategory::Country).empty());
+
+    auto best = store.personalBest(track, "Lead", top[0].name);
+    REQUIRE(best);
+    CHECK(best->score == top[0].score);
+    CHECK(best->place == 1);
+    CHECK_FALSE(store.personalBest(track, "Lead", "Nobody"));
+    CHECK(store.topScores(testTrack("Song B"), "Lead", 5).size() == 1);
+}
+
+TEST_CASE("Score store truncates a torn tail and keeps appending", "[scores]")
+{
+    const auto path = freshLog("openchordix_scores_torn.log");
+    const TrackInfo track = testTrack("Torn");
+    {
+        TrackScoreServiceFile store(path);
+        for (int i = 0; i < 5; ++i)
+        {
+            REQUIRE(store.recordScore(track, "Lead", ScoreEntry{0, "Pix", i, 100 * i}));
+        }
+    }
+    const auto intact = std::filesystem::file_size(path);
+    {
+        // Half of a record frame, as if the process died mid-write.
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("\x20\x00\x00\x00\x12\x34", 6);
+    }
+
+    {
+        TrackScoreServiceFile store(path);
+        CHECK(store.logRecords() == 5);
+        CHECK(std::filesystem::file_size(path) == intact);
+        REQUIRE(store.recordScore(track, "Lead", ScoreEntry{0, "Juno", 1, 900}));
+    }
+
+    TrackScoreServiceFile store(path);
+    CHECK(store.logRecords() == 6);
+    CHECK(store.topScores(track, "Lead", 1)[0].name == "Juno");
+}
+
+TEST_CASE("Score store moves a foreign file aside", "[scores]")
+{
+    const auto path = freshLog("openchordix_scores_foreign.log");
+    {
+        std::ofstream out(path);
+        out << "not a score log";
+    }
+    TrackScoreServiceFile store(path);
+    CHECK(store.ok());
+    CHECK(store.logRecords() == 0);
+    CHECK(std::filesystem::exists(path.string() + ".corrupt"));
+}
+
+TEST_CASE("Score store compacts in the background without losing indexed runs", "[scores]")
+{
+    const auto path = freshLog("openchordix_scores_compact.log");
+    const TrackInfo track = testTrack("Compact");
+    ScoreStoreOptions options;
+    options.retainPerPart = 5;
+    options.compactMinRecords = 64;
+
+    std::vector<ScoreEntry> before;
+    {
+        TrackScoreServiceFile store(path, nullptr, options);
+        for (int i = 0; i < 1000; ++i)
+        {
+            const std::string player = "P" + std::to_string(i % 4);
+            REQUIRE(store.recordScore(track, i % 2 ? "Lead" : "Rhythm", ScoreEntry{0, player, i, (i * 7919) % 5003}));
+        }
+        store.waitForCompaction();
+        CHECK(store.logRecords() < 200);
+        REQUIRE(store.compact());
+        CHECK(store.logRecords() <= 2 * (5 + 4));
+        before = store.topScores(track, "Lead", 5);
+    }
+
+    TrackScoreServiceFile store(path, nullptr, options);
+    std::vector<ScoreEntry> after = store.topScores(track, "Lead", 5);
+    REQUIRE(after.size() == before.size());
+    for (std::size_t i = 0; i < after.size(); ++i)
+    {
+        CHECK(after[i].name == before[i].name);
+        CHECK(after[i].score == before[i].score);
+        CHECK(after[i].combo == before[i].combo);
+    }
+    // Even runs went to Rhythm, so only P0 and P2 played it.
+    CHECK(store.personalBest(track, "Rhythm", "P0"));
+    CHECK(store.personalBest(track, "Rhythm", "P2"));
+    CHECK_FALSE(store.personalBest(track, "Rhythm", "P1"));
+    CHECK_FALSE(std::filesystem::exists(path.string() + ".compact"));
+}
+
+TEST_CASE("Durable replace swaps in the synced file", "[scores]")
+{
+    const auto target = freshLog("openchordix_scores_replace.log");
+    const auto temp = std::filesystem::path(target.string() + ".compact");
+    {
+        std::ofstream out(target);
+        out << "old";
+    }
+    {
+        std::ofstream out(temp);
+        out << "new";
+    }
+
+    std::error_code ec;
+    REQUIRE(replaceFileDurably(temp, target, ec));
+    CHECK_FALSE(ec);
+    CHECK_FALSE(std::filesystem::exists(temp));
+    std::ifstream in(target);
+    std::string contents;
+    in >> contents;
+    CHECK(contents == "new");
+
+    CHECK_FALSE(replaceFileDurably(temp, target, ec));
+    CHECK(ec);
+    CHECK(syncDirectory(target.parent_path()));
+    std::filesystem::remove(target);
+}
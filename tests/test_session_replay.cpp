@@ -0,0 +1,140 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "audio/SessionCapture.h"
+#include "audio/SessionReplay.h"
+
+namespace {
+CaptureHeader makeHeader()
+{
+    CaptureHeader header{};
+    header.audio.sampleRate = 48000;
+    header.audio.bufferFrames = 256;
+    header.detector = PitchDetectorConfig{1024, 1024, 48000, "yin"};
+    header.referenceA4 = 440.0f;
+    header.channels = 1;
+    return header;
+}
+
+// 256-frame blocks of a sine that glides from 196 Hz to 330 Hz.
+std::vector<CaptureBlock> makeBlocks(std::size_t count)
+{
+    std::vector<CaptureBlock> blocks(count);
+    double phase = 0.0;
+    for (std::size_t b = 0; b < count; ++b)
+    {
+        double frequency = 196.0 + (330.0 - 196.0) * static_cast<double>(b) / static_cast<double>(count);
+        blocks[b].streamTime = static_cast<double>(b * 256) / 48000.0;
+        blocks[b].samples.resize(256);
+        for (float &sample : blocks[b].samples)
+        {
+            sample = static_cast<float>(0.5 * std::sin(phase));
+            phase += 2.0 * M_PI * frequency / 48000.0;
+        }
+    }
+    return blocks;
+}
+}
+
+TEST_CASE("Session capture round-trips blocks, timestamps, and setup", "[capture]")
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "openchordix_session_test.occap";
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    CaptureHeader header = makeHeader();
+    std::vector<CaptureBlock> blocks = makeBlocks(64);
+
+    SessionCaptureWriter writer;
+    REQUIRE(writer.start(path, header));
+    for (const CaptureBlock &block : blocks)
+    {
+        writer.push(block.streamTime, block.samples.data(), static_cast<unsigned int>(block.samples.size()));
+    }
+    writer.stop();
+    CHECK(writer.droppedBlocks() == 0);
+
+    SessionCaptureData loaded;
+    std::string error;
+    REQUIRE(readSessionCapture(path, loaded, error));
+    CHECK(loaded.header.audio.sampleRate == header.audio.sampleRate);
+    CHECK(loaded.header.detector.hopSize == header.detector.hopSize);
+    CHECK(loaded.header.detector.method == header.detector.method);
+    CHECK(loaded.header.referenceA4 == header.referenceA4);
+    REQUIRE(loaded.blocks.size() == blocks.size());
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+        CHECK(loaded.blocks[i].streamTime == blocks[i].streamTime);
+        CHECK(loaded.blocks[i].samples == blocks[i].samples);
+    }
+
+    std::filesystem::remove(path, ec);
+}
+
+TEST_CASE("Session capture rejects a block larger than the file", "[capture]")
+{
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "openchordix_session_corrupt.occap";
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    SessionCaptureWriter writer;
+    REQUIRE(writer.start(path, makeHeader()));
+    std::vector<CaptureBlock> blocks = makeBlocks(2);
+    for (const CaptureBlock &block : blocks)
+    {
+        writer.push(block.streamTime, block.samples.data(), static_cast<unsigned int>(block.samples.size()));
+    }
+    writer.stop();
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        const double streamTime = 1.0;
+        const uint32_t frames = 0x40000000u; // 4 GiB of samples
+        out.write(reinterpret_cast<const char *>(&streamTime), sizeof(streamTime));
+        out.write(reinterpret_cast<const char *>(&frames), sizeof(frames));
+        out.write(reinterpret_cast<const char *>(blocks[0].samples.data()), 64);
+    }
+
+    SessionCaptureData loaded;
+    std::string error;
+    CHECK_FALSE(readSessionCapture(path, loaded, error));
+    CHECK_FALSE(error.empty());
+    std::filesystem::remove(path, ec);
+}
+
+TEST_CASE("Session replay is deterministic and diffs against a golden timeline", "[capture]")
+{
+    SessionCaptureData capture{makeHeader(), makeBlocks(400)};
+
+    std::vector<PitchSample> first = replaySessionCapture(capture);
+    std::vector<PitchSample> second = replaySessionCapture(capture);
+    REQUIRE(first.size() == capture.blocks.size());
+    CHECK(diffPitchTimelines(first, second).identical());
+
+    std::filesystem::path golden = std::filesystem::temp_directory_path() / "openchordix_session_golden.txt";
+    REQUIRE(writePitchTimeline(golden, first));
+    auto loaded = readPitchTimeline(golden);
+    REQUIRE(loaded.has_value());
+    TimelineDiff exact = diffPitchTimelines(*loaded, second);
+    INFO(exact.summary);
+    CHECK(exact.identical());
+
+    // Silencing one whole hop (four blocks) must show up as a diff from that hop onward.
+    for (std::size_t b = 200; b < 204; ++b)
+    {
+        capture.blocks[b].samples.assign(capture.blocks[b].samples.size(), 0.0f);
+    }
+    TimelineDiff changed = diffPitchTimelines(first, replaySessionCapture(capture));
+    CHECK_FALSE(changed.identical());
+    REQUIRE(changed.firstMismatch.has_value());
+    CHECK(*changed.firstMismatch >= 200);
+
+    std::error_code ec;
+    std::filesystem::remove(golden, ec);
+}
@@ -0,0 +1,178 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <csignal>
+#include <sys/resource.h>
+#endif
+
+#include "audio/SpscRingBuffer.h"
+#include "audio/TakeRecorder.h"
+
+namespace {
+std::filesystem::path takePath(const char *name)
+{
+    return std::filesystem::temp_directory_path() / name;
+}
+
+uint32_t readLe32(const std::vector<char> &bytes, std::size_t offset)
+{
+    uint32_t value = 0;
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        value |= static_cast<uint32_t>(static_cast<unsigned char>(bytes[offset + i])) << (8 * i);
+    }
+    return value;
+}
+
+std::vector<char> readFile(const std::filesystem::path &path)
+{
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+}
+
+TEST_CASE("SpscRingBuffer wraps around and reports partial writes", "[recorder]")
+{
+    SpscRingBuffer<int> ring(4);
+    int in[] = {1, 2, 3};
+    int out[4] = {};
+
+    REQUIRE(ring.write(in, 3) == 3);
+    REQUIRE(ring.read(out, 2) == 2);
+    CHECK(out[0] == 1);
+    CHECK(out[1] == 2);
+
+    // Head wraps past the end of storage here.
+    REQUIRE(ring.write(in, 3) == 3);
+    CHECK(ring.write(in, 3) == 0);
+    REQUIRE(ring.read(out, 4) == 4);
+    CHECK(out[0] == 3);
+    CHECK(out[1] == 1);
+    CHECK(out[2] == 2);
+    CHECK(out[3] == 3);
+    CHECK(ring.readAvailable() == 0);
+}
+
+TEST_CASE("TakeRecorder writes a float WAV with every pushed frame", "[recorder]")
+{
+    std::filesystem::path path = takePath("openchordix_take_test.wav");
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    TakeRecorder recorder(1);
+    REQUIRE(recorder.start(path, 48000, 1));
+
+    std::vector<float> block(256);
+    for (int i = 0; i < 40; ++i)
+    {
+        for (std::size_t n = 0; n < block.size(); ++n)
+        {
+            block[n] = static_cast<float>(i * block.size() + n);
+        }
+        recorder.push(block.data(), static_cast<unsigned int>(block.size()));
+    }
+    recorder.stop();
+
+    CHECK(recorder.dropouts() == 0);
+    CHECK(recorder.framesWritten() == 40 * block.size());
+
+    std::vector<char> bytes = readFile(path);
+    REQUIRE(bytes.size() == 44 + 40 * block.size() * sizeof(float));
+    CHECK(std::memcmp(bytes.data(), "RIFF", 4) == 0);
+    CHECK(std::memcmp(bytes.data() + 8, "WAVE", 4) == 0);
+    CHECK(readLe32(bytes, 24) == 48000);
+    CHECK(readLe32(bytes, 40) == 40 * block.size() * sizeof(float));
+
+    float last = 0.0f;
+    std::memcpy(&last, bytes.data() + bytes.size() - sizeof(float), sizeof(float));
+    CHECK(last == static_cast<float>(40 * block.size() - 1));
+
+    std::filesystem::remove(path, ec);
+}
+
+TEST_CASE("TakeRecorder counts dropouts instead of blocking when the ring is full", "[recorder]")
+{
+    std::filesystem::path path = takePath("openchordix_take_overflow.wav");
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+
+    // One second at 100 Hz: far smaller than a single pushed block.
+    TakeRecorder recorder(1);
+    REQUIRE(recorder.start(path, 100, 1));
+
+    std::vector<float> block(1000, 0.5f);
+    recorder.push(block.data(), static_cast<unsigned int>(block.size()));
+    recorder.stop();
+
+    CHECK(recorder.dropouts() == 1);
+    CHECK(recorder.droppedFrames() == 900);
+    CHECK(recorder.framesWritten() == 100);
+
+    // The ring is sized per channel, so a stereo take buffers the same second.
+    REQUIRE(recorder.start(path, 100, 2));
+    std::vector<float> stereo(2000, 0.5f);
+    recorder.push(stereo.data(), 1000);
+    recorder.stop();
+
+    CHECK(recorder.droppedFrames() == 900);
+    CHECK(recorder.framesWritten() == 100);
+
+    std::filesystem::remove(path, ec);
+}
+
+TEST_CASE("TakeRecorder reports a take it could not write", "[recorder]")
+{
+    // Every write to /dev/full fails with ENOSPC, so the header already fails.
+    TakeRecorder recorder(1);
+    if (std::filesystem::exists("/dev/full"))
+    {
+        CHECK_FALSE(recorder.start("/dev/full", 48000, 1));
+        CHECK_FALSE(recorder.recording());
+    }
+
+#if defined(__unix__)
+    // A file size limit stands in for a disk that fills up mid-take.
+    std::filesystem::path path = takePath("openchordix_take_full.wav");
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    rlimit previous{};
+    REQUIRE(getrlimit(RLIMIT_FSIZE, &previous) == 0);
+    auto previousHandler = std::signal(SIGXFSZ, SIG_IGN);
+    rlimit limited = previous;
+    limited.rlim_cur = 64 * 1024;
+    REQUIRE(setrlimit(RLIMIT_FSIZE, &limited) == 0);
+
+    REQUIRE(recorder.start(path, 48000, 1));
+    std::vector<float> block(48000, 0.25f);
+    recorder.push(block.data(), static_cast<unsigned int>(block.size()));
+    for (int i = 0; i < 200 && !recorder.writeFailed(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const bool failed = recorder.writeFailed();
+    const bool stillRecording = recorder.recording();
+    const bool saved = recorder.stop();
+    setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, previousHandler);
+
+    CHECK(failed);
+    CHECK_FALSE(stillRecording);
+    CHECK_FALSE(saved);
+    CHECK(recorder.status().find("incomplete") != std::string::npos);
+
+    // The failed take is finalized, so the next one starts cleanly.
+    REQUIRE(recorder.start(path, 48000, 1));
+    CHECK(recorder.stop());
+    CHECK_FALSE(recorder.writeFailed());
+    std::filesystem::remove(path, ec);
+#endif
+}
@@ -0,0 +1,129 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "track/TempoMap.h"
+
+namespace {
+// Integrates tick by tick segment so the reference shares no code with TempoMap.
+double referenceSeconds(const std::vector<ChartTempoChange> &sorted, uint32_t ticksPerQuarter, double tick)
+{
+    double seconds = 0.0;
+    for (std::size_t i = 0; i < sorted.size(); ++i)
+    {
+        double from = sorted[i].tick;
+        double to = i + 1 < sorted.size() ? sorted[i + 1].tick : tick;
+        if (tick <= from)
+        {
+            break;
+        }
+        double span = std::min(tick, to) - from;
+        seconds += span * sorted[i].microsPerQuarter / (1e6 * ticksPerQuarter);
+    }
+    return seconds;
+}
+
+std::vector<ChartTempoChange> randomTempo(std::size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> gap(1, 4 * 960);
+    std::uniform_int_distribution<uint32_t> bpm(40, 260);
+    std::vector<ChartTempoChange> changes;
+    uint32_t tick = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        changes.push_back(ChartTempoChange{tick, 60000000u / bpm(rng)});
+        tick += gap(rng);
+    }
+    return changes;
+}
+}
+
+TEST_CASE("Tempo map defaults and normalises its input", "[tempo]")
+{
+    TempoMap fallback;
+    CHECK(fallback.ticksPerQuarter() == 480);
+    CHECK(fallback.tickToSeconds(960) == Catch::Approx(1.0));
+    CHECK(fallback.bpmAtSeconds(10.0) == Catch::Approx(120.0));
+
+    // Unsorted, missing tick 0, and a duplicate tick where the later entry wins.
+    std::vector<ChartTempoChange> changes{{960, 250000}, {480, 1000000}, {960, 1000000}};
+    TempoMap map(480, changes);
+    REQUIRE(map.segments().size() == 3);
+    CHECK(map.segments()[0].tick == 0);
+    CHECK(map.segments()[2].microsPerQuarter == 1000000);
+    CHECK(map.tickToSeconds(480) == Catch::Approx(0.5));
+    CHECK(map.tickToSeconds(960) == Catch::Approx(1.5));
+    CHECK(map.secondsToTick(2.5) == Catch::Approx(1440.0));
+    CHECK(map.secondsToBeat(1.5) == Catch::Approx(2.0));
+    CHECK(map.beatToSeconds(3.0) == Catch::Approx(2.5));
+
+    // Before zero the first segment is extrapolated for lead-ins.
+    CHECK(map.tickToSeconds(-480) == Catch::Approx(-0.5));
+    CHECK(map.secondsToTick(-1.0) == Catch::Approx(-960.0));
+
+    TempoMap steady = TempoMap::constant(90.0, 960);
+    CHECK(steady.beatToSeconds(3.0) == Catch::Approx(2.0));
+}
+
+TEST_CASE("Tempo map matches a reference across hundreds of changes", "[tempo]")
+{
+    const uint32_t tpq = 960;
+    std::vector<ChartTempoChange> changes = randomTempo(600, 1234);
+    TempoMap map(tpq, changes);
+    REQUIRE(map.segments().size() == changes.size());
+
+    const double lastTick = changes.back().tick + 10000.0;
+    for (double tick = 0.0; tick < lastTick; tick += 997.0)
+    {
+        double expected = referenceSeconds(changes, tpq, tick);
+        double seconds = map.tickToSeconds(tick);
+        REQUIRE(seconds == Catch::Approx(expected).epsilon(1e-12));
+        REQUIRE(map.secondsToTick(seconds) == Catch::Approx(tick).margin(1e-6));
+    }
+}
+
+TEST_CASE("Tempo cursor agrees with binary search forwards and after seeks", "[tempo]")
+{
+    std::vector<ChartTempoChange> changes = randomTempo(400, 99);
+    TempoMap map(960, changes);
+    TempoMap::Cursor cursor = map.cursor();
+
+    const double end = map.tickToSeconds(changes.back().tick + 5000.0);
+    for (double seconds = -0.5; seconds < end; seconds += 1.0 / 240.0)
+    {
+        double tick = cursor.secondsToTick(seconds);
+        REQUIRE(tick == map.secondsToTick(seconds));
+        REQUIRE(cursor.tickToSeconds(tick + 480.0) == map.tickToSeconds(tick + 480.0));
+    }
+
+    // Loop back to the start, then jump far ahead.
+    CHECK(cursor.secondsToTick(1.0) == map.secondsToTick(1.0));
+    CHECK(cursor.tickToSeconds(5.0) == map.tickToSeconds(5.0));
+    CHECK(cursor.secondsToTick(end - 1.0) == map.secondsToTick(end - 1.0));
+    cursor.reset();
+    CHECK(cursor.tickToSeconds(100.0) == map.tickToSeconds(100.0));
+}
+
+TEST_CASE("Tempo map round-trips through chart file tables", "[tempo]")
+{
+    std::vector<ChartTempoChange> changes = randomTempo(200, 7);
+    TempoMap map(480, changes);
+
+    std::vector<chartformat::ChartFileTempo> table;
+    for (const TempoSegment &segment : map.segments())
+    {
+        table.push_back(chartformat::ChartFileTempo{segment.tick, segment.microsPerQuarter, segment.startSeconds});
+    }
+    TempoMap restored(480, std::span<const chartformat::ChartFileTempo>(table));
+    REQUIRE(restored.segments().size() == map.segments().size());
+    for (std::size_t i = 0; i < table.size(); ++i)
+    {
+        CHECK(restored.segments()[i].startSeconds == map.segments()[i].startSeconds);
+        CHECK(restored.tickToSeconds(table[i].tick + 7.0) == Catch::Approx(map.tickToSeconds(table[i].tick + 7.0)));
+    }
+}
@@ -0,0 +1,258 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "track/ChartWriter.h"
+#include "track/TrackCatalogFile.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+// Two parts at the given tempo; the last note ends `beats` beats in.
+ChartData makeSong(uint32_t microsPerQuarter, uint32_t beats)
+{
+    ChartData chart;
+    chart.tempo = {{0, microsPerQuarter}};
+    ChartPartData lead{"Lead Guitar", {}};
+    for (uint32_t beat = 0; beat < beats; ++beat)
+    {
+        lead.notes.push_back(ChartNote{beat * 480, 480, 0, 5, ChartNoteNone});
+    }
+    chart.parts.push_back(lead);
+    chart.parts.push_back(ChartPartData{"Bass", {{0, 480, 4, 0, ChartNoteNone}}});
+    return chart;
+}
+
+void writeSong(const std::filesystem::path &path, const ChartData &chart)
+{
+    std::filesystem::create_directories(path.parent_path());
+    std::string error;
+    REQUIRE(writeChart(path, chart, error));
+}
+
+void writeText(const std::filesystem::path &path, const std::string &text)
+{
+    std::ofstream out(path, std::ios::trunc);
+    out << text;
+}
+
+const TrackInfo *findTrack(const std::vector<TrackInfo> &tracks, const std::string &title)
+{
+    auto it = std::find_if(tracks.begin(), tracks.end(), [&](const TrackInfo &track)
+                           { return track.title == title; });
+    return it == tracks.end() ? nullptr : &*it;
+}
+
+TrackLibraryOptions libraryOptions(const std::filesystem::path &root)
+{
+    TrackLibraryOptions options;
+    options.roots = {root / "songs"};
+    options.cachePath = root / "library.cache";
+    options.jobs = 3;
+    return options;
+}
+
+// Library of `count` one-part songs, each in its own directory with a song.ini.
+void writeLibrary(const std::filesystem::path &songs, int count)
+{
+    const std::vector<std::byte> bytes = serializeChart(makeSong(500000, 64));
+    for (int i = 0; i < count; ++i)
+    {
+        const auto dir = songs / ("band" + std::to_string(i % 100)) / ("song" + std::to_string(i));
+        std::filesystem::create_directories(dir);
+        std::ofstream chart(dir / "notes.occhart", std::ios::binary);
+        chart.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        writeText(dir / "song.ini", "[song]\nname = Song " + std::to_string(i) + "\nartist = Band " +
+                                        std::to_string(i % 100) + "\n");
+    }
+}
+}
+
+TEST_CASE("Library scan reads chart metadata and sidecars", "[library]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_library_scan";
+    std::filesystem::remove_all(root);
+    writeSong(root / "songs" / "Raine - Opening Act.occhart", makeSong(500000, 130));
+    writeSong(root / "songs" / "pack" / "anthem" / "notes.occhart", makeSong(400000, 12));
+    writeText(root / "songs" / "pack" / "anthem" / "song.ini",
+              "[song]\nname = Anthem\nartist=Lux\r\ngenre = Power Metal\ncharter = Mara\nicon=\n");
+    writeSong(root / "songs" / "pack" / "solo.occhart", makeSong(1000000, 4));
+    writeText(root / "songs" / "pack" / "solo.ini", "title = Solo Run\n");
+    writeText(root / "songs" / "pack" / "broken.occhart", "not a chart");
+
+    TrackCatalogFile catalog(libraryOptions(root));
+    REQUIRE(catalog.waitForScan(5s));
+    CHECK_FALSE(catalog.scanning());
+    CHECK(catalog.poll());
+    CHECK_FALSE(catalog.poll());
+
+    const TrackLibraryStats stats = catalog.scanStats();
+    CHECK(stats.charts == 4);
+    CHECK(stats.cached == 0);
+    CHECK(stats.parsed == 4);
+    CHECK(stats.failed == 1);
+
+    const auto &tracks = catalog.tracks();
+    REQUIRE(tracks.size() == 3);
+    const TrackInfo *opening = findTrack(tracks, "Opening Act");
+    REQUIRE(opening);
+    CHECK(opening->artist == "Raine");
+    CHECK(opening->bpm == 120);
+    CHECK(opening->length == "1:05");
+    REQUIRE(opening->parts.size() == 2);
+    CHECK(opening->parts[1].name == "Bass");
+    CHECK(opening->parts[1].chartBlock == 1);
+
+    const TrackInfo *anthem = findTrack(tracks, "Anthem");
+    REQUIRE(anthem);
+    CHECK(anthem->artist == "Lux");
+    CHECK(anthem->source == "Power Metal");
+    CHECK(anthem->mapper == "Mara");
+    CHECK(anthem->bpm == 150);
+
+    const TrackInfo *solo = findTrack(tracks, "Solo Run");
+    REQUIRE(solo);
+    CHECK(solo->bpm == 60);
+    CHECK(solo->length == "0:04");
+    CHECK(catalog.openChart(solo->parts[0]) != nullptr);
+    CHECK(catalog.filter("LUX").size() == 1);
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Warm library scans only reopen changed charts", "[library]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_library_warm";
+    std::filesystem::remove_all(root);
+    writeLibrary(root / "songs", 40);
+    {
+        TrackCatalogFile cold(libraryOptions(root));
+        REQUIRE(cold.waitForScan(5s));
+        CHECK(cold.scanStats().parsed == 40);
+    }
+    {
+        TrackCatalogFile warm(libraryOptions(root));
+        REQUIRE(warm.waitForScan(5s));
+        CHECK(warm.scanStats().cached == 40);
+        CHECK(warm.scanStats().parsed == 0);
+        warm.poll();
+        REQUIRE(warm.tracks().size() == 40);
+        const TrackInfo *song = findTrack(warm.tracks(), "Song 7");
+        REQUIRE(song);
+        CHECK(song->artist == "Band 7");
+        CHECK(song->parts[0].chartPath == (root / "songs" / "band7" / "song7" / "notes.occhart").generic_string());
+    }
+
+    writeSong(root / "songs" / "band3" / "song3" / "notes.occhart", makeSong(500000, 8));
+    writeText(root / "songs" / "band4" / "song4" / "song.ini", "name = Renamed Song\n");
+    std::filesystem::remove_all(root / "songs" / "band5");
+    {
+        TrackCatalogFile changed(libraryOptions(root));
+        REQUIRE(changed.waitForScan(5s));
+        CHECK(changed.scanStats().charts == 40 - 1);
+        CHECK(changed.scanStats().parsed == 2);
+        changed.poll();
+        CHECK(findTrack(changed.tracks(), "Renamed Song"));
+        REQUIRE(findTrack(changed.tracks(), "Song 3"));
+        CHECK(findTrack(changed.tracks(), "Song 3")->length == "0:04");
+    }
+
+    // A damaged cache is ignored and rebuilt.
+    {
+        std::fstream cache(root / "library.cache", std::ios::in | std::ios::out | std::ios::binary);
+        cache.seekp(40);
+        cache.put('\x7f');
+    }
+    TrackCatalogFile rebuilt(libraryOptions(root));
+    REQUIRE(rebuilt.waitForScan(5s));
+    CHECK(rebuilt.scanStats().parsed == 39);
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Library tracks are published in batches while scanning", "[library]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_library_batches";
+    std::filesystem::remove_all(root);
+    writeLibrary(root / "songs", 120);
+
+    TrackLibraryOptions options = libraryOptions(root);
+    options.cachePath.clear();
+    options.publishBatch = 8;
+    TrackCatalogFile catalog(options);
+    std::vector<std::string> seen;
+    while (catalog.scanning() || catalog.poll())
+    {
+        // Earlier entries never move as more arrive.
+        for (std::size_t i = 0; i < seen.size(); ++i)
+        {
+            REQUIRE(catalog.tracks()[i].title == seen[i]);
+        }
+        for (std::size_t i = seen.size(); i < catalog.tracks().size(); ++i)
+        {
+            seen.push_back(catalog.tracks()[i].title);
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    catalog.poll();
+    CHECK(catalog.tracks().size() == 120);
+    std::sort(seen.begin(), seen.end());
+    CHECK(std::unique(seen.begin(), seen.end()) == seen.end());
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Cancelled library scans say so and keep the cache", "[library]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_library_cancel";
+    std::filesystem::remove_all(root);
+    writeLibrary(root / "songs", 300);
+
+    TrackLibraryOptions options = libraryOptions(root);
+    options.jobs = 1;
+    TrackCatalogFile catalog(options);
+    catalog.cancelScan();
+    REQUIRE(catalog.waitForScan(5s));
+    const TrackLibraryStats stats = catalog.scanStats();
+    CHECK(stats.cancelled);
+    CHECK(stats.parsed + stats.cached < 300);
+    CHECK(stats.failed == 0);
+    CHECK_FALSE(std::filesystem::exists(options.cachePath));
+
+    TrackCatalogFile full(options);
+    REQUIRE(full.waitForScan(5s));
+    CHECK_FALSE(full.scanStats().cancelled);
+    CHECK(full.scanStats().parsed == 300);
+    std::filesystem::remove_all(root);
+}
+
+TEST_CASE("Library scan of 10k songs, cold and warm", "[library][benchmark][.]")
+{
+    const auto root = std::filesystem::temp_directory_path() / "openchordix_library_bench";
+    std::filesystem::remove_all(root);
+    writeLibrary(root / "songs", 10000);
+
+    TrackLibraryOptions options = libraryOptions(root);
+    options.jobs = 0;
+    auto scan = [&]()
+    {
+        TrackCatalogFile catalog(options);
+        REQUIRE(catalog.waitForScan(120s));
+        catalog.poll();
+        CHECK(catalog.tracks().size() == 10000);
+        return catalog.scanStats();
+    };
+    // Page cache is warm for both; "cold" means no metadata cache.
+    const TrackLibraryStats cold = scan();
+    const TrackLibraryStats warm = scan();
+    CHECK(cold.parsed == 10000);
+    CHECK(warm.cached == 10000);
+    std::cout << "10k songs on " << cold.jobs << " jobs: cold " << cold.totalMillis << " ms (walk "
+              << cold.walkMillis << " ms), warm " << warm.totalMillis << " ms (walk " << warm.walkMillis
+              << " ms)" << std::endl;
+    CHECK(warm.totalMillis < cold.totalMillis);
+    std::filesystem::remove_all(root);
+}
@@ -0,0 +1,193 @@
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "track/TrackSearchIndex.h"
+
+namespace {
+TrackInfo track(const std::string &title, const std::string &artist)
+{
+    TrackInfo info;
+    info.title = title;
+    info.artist = artist;
+    return info;
+}
+
+TrackSearchIndex sampleIndex()
+{
+    TrackSearchIndex index;
+    index.add(track("Master of Puppets", "Metallica"));
+    index.add(track("Back in Black", "AC/DC"));
+    index.add(track("Painkiller", "Judas Priest"));
+    index.add(track("Paranoid", "Black Sabbath"));
+    index.add(track("Holy Wars... The Punishment Due", "Megadeth"));
+    return index;
+}
+
+// Brute-force reference: folded substring over title and artist.
+std::vector<int> linearMatches(const std::vector<TrackInfo> &tracks, const std::string &query)
+{
+    const std::string folded = TrackSearchIndex::fold(query);
+    std::vector<int> out;
+    for (std::size_t i = 0; i < tracks.size(); ++i)
+    {
+        if (TrackSearchIndex::fold(tracks[i].title).find(folded) != std::string::npos ||
+            TrackSearchIndex::fold(tracks[i].artist).find(folded) != std::string::npos)
+        {
+            out.push_back(static_cast<int>(i));
+        }
+    }
+    return out;
+}
+
+std::vector<TrackInfo> syntheticCatalog(std::size_t count)
+{
+    static const char *kWords[] = {"night", "fire", "steel", "black", "river", "ghost", "storm", "heart",
+                                   "iron", "echo", "shadow", "thunder", "crystal", "wolf", "glass", "dream",
+                                   "silver", "empire", "machine", "ocean", "highway", "winter", "angel", "zero"};
+    constexpr std::size_t kWordCount = sizeof(kWords) / sizeof(kWords[0]);
+    std::vector<TrackInfo> tracks;
+    tracks.reserve(count);
+    uint32_t state = 12345;
+    auto next = [&]()
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    };
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::string title = std::string(kWords[next() % kWordCount]) + " " + kWords[next() % kWordCount];
+        if (next() % 2 == 0)
+        {
+            title += " " + std::string(kWords[next() % kWordCount]);
+        }
+        title += " " + std::to_string(i);
+        std::string artist = "The " + std::string(kWords[next() % kWordCount]) + "s";
+        tracks.push_back(track(title, artist));
+    }
+    return tracks;
+}
+}
+
+TEST_CASE("Search folds case and punctuation", "[search]")
+{
+    CHECK(TrackSearchIndex::fold("Holy Wars... The  Punishment-Due!") == "holy wars the punishment due");
+    CHECK(TrackSearchIndex::fold("AC/DC") == "ac dc");
+    CHECK(TrackSearchIndex::fold("  ...  ").empty());
+
+    TrackSearchIndex index = sampleIndex();
+    CHECK(index.search("").size() == 5);
+    CHECK(index.search("acdc").empty());
+    CHECK(index.search("ac/dc") == std::vector<int>{1});
+    CHECK(index.search("WARS the") == std::vector<int>{4});
+    CHECK(index.search("z").empty());
+}
+
+TEST_CASE("Search ranks field starts, then word starts, then inner matches", "[search]")
+{
+    TrackSearchIndex index = sampleIndex();
+    CHECK(index.search("pa") == std::vector<int>{2, 3});
+    // Black Sabbath is an artist start, Back in Black a word start.
+    CHECK(index.search("black") == std::vector<int>{3, 1});
+    // "ain" only appears inside words.
+    CHECK(index.search("ain") == std::vector<int>{2});
+}
+
+TEST_CASE("Search tolerates typos once exact hits run out", "[search]")
+{
+    TrackSearchIndex index = sampleIndex();
+    CHECK(index.search("metalica") == std::vector<int>{0});
+    CHECK(index.search("painkilller") == std::vector<int>{2});
+    CHECK(index.search("megadeht").front() == 4);
+    CHECK(index.search("qqqqq").empty());
+}
+
+TEST_CASE("Incremental search matches a linear scan while typing", "[search]")
+{
+    const std::vector<TrackInfo> tracks = syntheticCatalog(3000);
+    TrackSearchIndex index;
+    for (std::size_t i = 0; i < 2000; ++i)
+    {
+        index.add(tracks[i]);
+    }
+
+    auto exactPart = [](std::vector<int> results, std::size_t exactCount)
+    {
+        results.resize(std::min(results.size(), exactCount));
+        std::sort(results.begin(), results.end());
+        return results;
+    };
+
+    const std::string typed = "thunder wolf 1";
+    std::vector<TrackInfo> indexed(tracks.begin(), tracks.begin() + 2000);
+    for (std::size_t length = 1; length <= typed.size(); ++length)
+    {
+        const std::string query = typed.substr(0, length);
+        if (length == 8)
+        {
+            // Tracks published mid-typing are still searched.
+            for (std::size_t i = 2000; i < tracks.size(); ++i)
+            {
+                index.add(tracks[i]);
+            }
+            indexed = tracks;
+        }
+        const std::vector<int> expected = linearMatches(indexed, query);
+        const std::vector<int> results = index.search(query);
+        CHECK(exactPart(results, expected.size()) == expected);
+    }
+
+    // Backspacing must not narrow from the longer query's matches.
+    const std::vector<int> expected = linearMatches(indexed, "thun");
+    CHECK(exactPart(index.search("thun"), expected.size()) == expected);
+}
+
+TEST_CASE("Search over 50k tracks", "[search][benchmark]")
+{
+    const std::vector<TrackInfo> tracks = syntheticCatalog(50000);
+    TrackSearchIndex index;
+    index.reserve(tracks.size());
+    for (const TrackInfo &info : tracks)
+    {
+        index.add(info);
+    }
+
+    const std::vector<std::string> queries = {"s", "st", "storm", "storm hea", "the wolfs", "thundr", "crystl echo", "49999"};
+    double worstMillis = 0.0;
+    for (const std::string &query : queries)
+    {
+        double bestMillis = 1e9;
+        for (int run = 0; run < 3; ++run)
+        {
+            index.search(""); // Reset the narrowing so every run starts cold
+            auto start = std::chrono::steady_clock::now();
+            const std::vector<int> results = index.search(query);
+            bestMillis = std::min(bestMillis, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+            CHECK_FALSE(results.empty());
+        }
+        worstMillis = std::max(worstMillis, bestMillis);
+    }
+    // Generous bound so sanitizer and debug builds pass; release stays under 1 ms.
+    CHECK(worstMillis < 25.0);
+
+    BENCHMARK("search 50k typing \"storm heart\"")
+    {
+        std::size_t found = 0;
+        const std::string typed = "storm heart";
+        for (std::size_t length = 1; length <= typed.size(); ++length)
+        {
+            found += index.search(typed.substr(0, length)).size();
+        }
+        return found;
+    };
+    BENCHMARK("search 50k fuzzy \"thundr wlf\"")
+    {
+        index.search("");
+        return index.search("thundr wlf").size();
+    };
+}
@@ -0,0 +1,158 @@
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "render/TransformHierarchy.h"
+
+using namespace openchordix::render;
+
+namespace {
+NodeTransform node(int32_t parent, float x, float y, float z)
+{
+    NodeTransform out;
+    out.parent = parent;
+    out.translation = {x, y, z};
+    return out;
+}
+
+// Two roots. Root 0 has children 1 (with 2 and 3 below it) and 4; root 5 has 6.
+std::vector<NodeTransform> sampleNodes()
+{
+    return {node(-1, 1.0f, 0.0f, 0.0f), node(0, 0.0f, 2.0f, 0.0f), node(1, 0.0f, 0.0f, 3.0f),
+            node(1, 4.0f, 0.0f, 0.0f), node(0, 0.0f, 5.0f, 0.0f), node(-1, 0.0f, 0.0f, 6.0f),
+            node(5, 7.0f, 0.0f, 0.0f)};
+}
+
+// Worlds from scratch: a fresh hierarchy with the same locals, fully updated.
+std::vector<Matrix4> recompute(const TransformHierarchy &hierarchy)
+{
+    std::vector<NodeTransform> nodes;
+    for (uint32_t i = 0; i < hierarchy.size(); ++i)
+    {
+        nodes.push_back(hierarchy.local(i));
+    }
+    TransformHierarchy fresh;
+    fresh.assign(nodes);
+    fresh.update();
+    std::vector<Matrix4> worlds;
+    for (uint32_t i = 0; i < fresh.size(); ++i)
+    {
+        worlds.push_back(fresh.world(i));
+    }
+    return worlds;
+}
+
+void checkMatchesRecompute(const TransformHierarchy &hierarchy)
+{
+    const std::vector<Matrix4> expected = recompute(hierarchy);
+    for (uint32_t i = 0; i < hierarchy.size(); ++i)
+    {
+        for (std::size_t k = 0; k < 16; ++k)
+        {
+            CHECK(hierarchy.world(i)[k] == Catch::Approx(expected[i][k]).margin(1e-5));
+        }
+    }
+}
+}
+
+TEST_CASE("Depth-first order keeps every subtree contiguous", "[transform]")
+{
+    CHECK(isDepthFirst(sampleNodes()));
+    CHECK(isDepthFirst(std::vector<NodeTransform>{}));
+
+    // A parent that comes after its child.
+    CHECK_FALSE(isDepthFirst(std::vector<NodeTransform>{node(-1, 0, 0, 0), node(2, 0, 0, 0), node(0, 0, 0, 0)}));
+    // A node that is its own parent, and one with an invalid parent.
+    CHECK_FALSE(isDepthFirst(std::vector<NodeTransform>{node(0, 0, 0, 0)}));
+    CHECK_FALSE(isDepthFirst(std::vector<NodeTransform>{node(-2, 0, 0, 0)}));
+    // Node 3 belongs to 1, but 2 (a child of 0) splits 1's run.
+    CHECK_FALSE(isDepthFirst(std::vector<NodeTransform>{node(-1, 0, 0, 0), node(0, 0, 0, 0), node(0, 0, 0, 0),
+                                                        node(1, 0, 0, 0)}));
+    // Going back up to an ancestor's sibling is fine.
+    CHECK(isDepthFirst(std::vector<NodeTransform>{node(-1, 0, 0, 0), node(0, 0, 0, 0), node(1, 0, 0, 0),
+                                                  node(0, 0, 0, 0), node(-1, 0, 0, 0)}));
+}
+
+TEST_CASE("Hierarchy composes children after their parents", "[transform]")
+{
+    TransformHierarchy hierarchy;
+    hierarchy.assign(sampleNodes());
+    REQUIRE(hierarchy.size() == 7);
+    CHECK(hierarchy.subtreeEnd(0) == 5);
+    CHECK(hierarchy.subtreeEnd(1) == 4);
+    CHECK(hierarchy.subtreeEnd(2) == 3);
+    CHECK(hierarchy.subtreeEnd(5) == 7);
+
+    // Every node starts dirty, so the first update is one run per root.
+    const auto first = hierarchy.update();
+    REQUIRE(first.size() == 2);
+    CHECK(first[0].first == 0);
+    CHECK(first[0].end == 5);
+    CHECK(first[1].first == 5);
+    CHECK(first[1].end == 7);
+
+    const Matrix4 &deep = hierarchy.world(3);
+    CHECK(deep[12] == Catch::Approx(5.0f));
+    CHECK(deep[13] == Catch::Approx(2.0f));
+    CHECK(deep[14] == Catch::Approx(0.0f));
+
+    // A quarter turn about z on the root swings its children's offsets with it.
+    const float half = 0.25f * 3.14159265f;
+    hierarchy.setLocal(0, {1.0f, 0.0f, 0.0f}, {0.0f, 0.0f, std::sin(half), std::cos(half)}, {2.0f, 2.0f, 2.0f});
+    hierarchy.update();
+    const Matrix4 &child = hierarchy.world(1);
+    CHECK(child[12] == Catch::Approx(-3.0f));
+    CHECK(child[13] == Catch::Approx(0.0f).margin(1e-5));
+    CHECK(hierarchy.world(6)[12] == Catch::Approx(7.0f));
+    checkMatchesRecompute(hierarchy);
+}
+
+TEST_CASE("Update recomputes only the dirty runs", "[transform]")
+{
+    TransformHierarchy hierarchy;
+    hierarchy.assign(sampleNodes());
+    hierarchy.update();
+    CHECK(hierarchy.update().empty());
+
+    // Node 1's run is nodes 1 to 3; root 0, node 4 and the second root keep their worlds.
+    const Matrix4 rootBefore = hierarchy.world(0);
+    const Matrix4 siblingBefore = hierarchy.world(4);
+    const Matrix4 otherBefore = hierarchy.world(6);
+    hierarchy.setLocal(1, {0.0f, 3.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    auto runs = hierarchy.update();
+    REQUIRE(runs.size() == 1);
+    CHECK(runs[0].first == 1);
+    CHECK(runs[0].end == 4);
+    CHECK(hierarchy.world(0) == rootBefore);
+    CHECK(hierarchy.world(4) == siblingBefore);
+    CHECK(hierarchy.world(6) == otherBefore);
+    CHECK(hierarchy.world(3)[13] == Catch::Approx(3.0f));
+    checkMatchesRecompute(hierarchy);
+
+    // A dirty node inside a dirty ancestor's run is covered by that run.
+    hierarchy.setLocal(2, {0.0f, 0.0f, -3.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    hierarchy.setLocal(0, {2.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    runs = hierarchy.update();
+    REQUIRE(runs.size() == 1);
+    CHECK(runs[0].first == 0);
+    CHECK(runs[0].end == 5);
+    checkMatchesRecompute(hierarchy);
+
+    // Separate subtrees give separate runs, in node order.
+    hierarchy.setLocal(6, {8.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    hierarchy.setLocal(4, {0.0f, 6.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    hierarchy.setLocal(4, {0.0f, 7.0f, 0.0f}, {0.0f, 0.0f, 0.0f, 1.0f}, {1.0f, 1.0f, 1.0f});
+    runs = hierarchy.update();
+    REQUIRE(runs.size() == 2);
+    CHECK(runs[0].first == 4);
+    CHECK(runs[0].end == 5);
+    CHECK(runs[1].first == 6);
+    CHECK(runs[1].end == 7);
+    CHECK(hierarchy.world(4)[13] == Catch::Approx(7.0f));
+    checkMatchesRecompute(hierarchy);
+    CHECK(hierarchy.update().empty());
+}